@@ -52,6 +52,8 @@
 
 #include <rtprocessing/filter.h>
 
+#include <algorithm>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
@@ -59,6 +61,7 @@
 #include <QtConcurrent/QtConcurrent>
 #include <QElapsedTimer>
 #include <QFile>
+#include <QMutexLocker>
 #include <QBrush>
 #include <QFileDialog>
 
@@ -112,7 +115,6 @@ FiffRawViewModel::FiffRawViewModel(const QString &sFilePath,
 , m_bDispAnnotation(true)
 , m_bPerformFiltering(false)
 , m_pAnnotationModel(QSharedPointer<AnnotationModel>::create())
-, m_pRtFilter(FilterOverlapAdd::SPtr::create())
 {
     Q_UNUSED(sFilePath)
 
@@ -138,7 +140,7 @@ FiffRawViewModel::FiffRawViewModel(const QString &sFilePath,
 
 FiffRawViewModel::~FiffRawViewModel()
 {
-
+    m_prefetchFuture.waitForFinished();
 }
 
 //=============================================================================================================
@@ -164,6 +166,12 @@ void FiffRawViewModel::initFiffData(QIODevice& p_IODevice)
     // build datastructure that is to be filled with data from the file
     MatrixXd data, times;
 
+    // Decode the blocks straight from a memory mapping of the file. Byte loaded data is read tag by tag. The
+    // mapping stays valid after the file is closed below.
+    if(qobject_cast<QFileDevice*>(&p_IODevice)) {
+        m_pFiffIO->m_qlistRaw[0]->mapRawData();
+    }
+
     // Fiff file is not empty, set cursor somewhere into Fiff file
     m_iFiffCursorBegin = m_pFiffIO->m_qlistRaw[0]->first_samp;
     m_iSamplesPerBlock = m_pFiffInfo->sfreq;
@@ -175,6 +183,8 @@ void FiffRawViewModel::initFiffData(QIODevice& p_IODevice)
     p_IODevice.close();
 
     m_bIsInit = true;
+
+    prefetchBlocks(1);
 }
 
 //=============================================================================================================
@@ -238,6 +248,11 @@ QVariant FiffRawViewModel::data(const QModelIndex &index,
 
 bool FiffRawViewModel::saveToFile(const QString& sPath)
 {
+    // Saving reads the whole stream, which the prefetch thread reads as well. Let a running prefetch finish and
+    // keep later reads out until the file is written.
+    m_prefetchFuture.waitForFinished();
+    QMutexLocker locker(&m_readMutex);
+
     #ifdef WASMBUILD
     QBuffer* bufferOut = new QBuffer;
 
@@ -583,6 +598,7 @@ void FiffRawViewModel::updateHorizontalScrollPosition(qint32 newScrollPosition)
 
             // and load all the data anew
             reloadAllData();
+            prefetchBlocks(-1);
         } else {
             // there are some blocks in the intersection of the old and the new window that can stay in the buffer:
             // simply load earlier blocks
@@ -599,11 +615,14 @@ void FiffRawViewModel::updateHorizontalScrollPosition(qint32 newScrollPosition)
 
         if (blockDist >= m_iTotalBlockCount) {
             // we must "jump" to the new cursor ...
-            int iResidual = absoluteLastSample() % m_iSamplesPerBlock;
-            m_iFiffCursorBegin = std::min(absoluteLastSample() - (m_iTotalBlockCount * m_iSamplesPerBlock + iResidual), m_iFiffCursorBegin + (blockDist * m_iSamplesPerBlock));
+            // stay on the block grid of the file, so that cached blocks can be reused. The last block may be shorter.
+            int iNumFileBlocks = (absoluteLastSample() - absoluteFirstSample() + m_iSamplesPerBlock) / m_iSamplesPerBlock;
+            int iLastCursor = absoluteFirstSample() + std::max(0, iNumFileBlocks - m_iTotalBlockCount) * m_iSamplesPerBlock;
+            m_iFiffCursorBegin = std::max(absoluteFirstSample(), std::min(iLastCursor, m_iFiffCursorBegin + (blockDist * m_iSamplesPerBlock)));
 
             // and load all the data anew
             reloadAllData();
+            prefetchBlocks(1);
         } else {
             // there are some blocks in the intersection of the old and the new window that can stay in the buffer:
             // simply load later blocks
@@ -615,33 +634,23 @@ void FiffRawViewModel::updateHorizontalScrollPosition(qint32 newScrollPosition)
 
 //=============================================================================================================
 
-bool FiffRawViewModel::filterDataBlock(MatrixXd& matData,
-                                       bool bFilterEnd,
-                                       bool bKeepOverhead)
+void FiffRawViewModel::filterDataBlock(MatrixXd& matData,
+                                       const FilterSettings& settings) const
 {
-    if(!m_bPerformFiltering) {
-        return false;
-    }
-
-    if(m_lFilterChannelList.cols() == 0) {
-        qWarning() << "[FiffRawViewModel::filterDataBlock] No channels to filter specified.";
-        return false;
-    }
-
     // In WASM mode do not use multithreading for filtering
     bool bUseThread = true;
     #ifdef WASMBUILD
     bUseThread = false;
     #endif
 
-    matData = m_pRtFilter->calculate(matData,
-                                     m_filterKernel,
-                                     m_lFilterChannelList,
-                                     bFilterEnd,
-                                     bUseThread,
-                                     bKeepOverhead);
+    // Every read is filtered on its own and possibly in the prefetch thread, so do not carry overlaps between calls
+    FilterOverlapAdd filter;
 
-    return true;
+    matData = filter.calculate(matData,
+                               settings.filterKernel,
+                               settings.vecPicks,
+                               true,
+                               bUseThread);
 }
 
 //=============================================================================================================
@@ -689,75 +698,26 @@ int FiffRawViewModel::loadEarlierBlocks(qint32 numBlocks)
         return -1;
     }
 
-    // build data structures to be filled from file
-    MatrixXd matData, matTimes;
-
-    // initialize start and end indices
+    // initialize start index
     int start = m_iFiffCursorBegin - (numBlocks * m_iSamplesPerBlock);
-    int end = m_iFiffCursorBegin - 1;
-
-    // Update m_iFiffCursorBegin before we account for the filter delay
-    if(start <= absoluteFirstSample()) {
-        m_iFiffCursorBegin = absoluteFirstSample();
-    } else {
-        m_iFiffCursorBegin = start;
-    }
-
-    // When filtering load more data than we need in order to allow arbiritary filter lengths
-    int iFilterDelay = 0;
-    bool bBeforeStartReached = false;
 
-    if(m_bPerformFiltering) {
-        iFilterDelay = m_filterKernel.getFilterOrder()/2;
-        end += m_filterKernel.getFilterOrder()/2;
-
-        // Check if we have reached the beginning/end of the file
-        if(start-iFilterDelay >= absoluteFirstSample()) {
-            start -= m_filterKernel.getFilterOrder()/2;
-        } else {
-            // Add another filter delay because we need enough data to sucessfully filter with arbiritary filter lengths
-            end += m_filterKernel.getFilterOrder()/2;
-            iFilterDelay = 0;
-            bBeforeStartReached = true;
-        }
-    }
+    std::list<BlockCache::Block> lData, lFilteredData;
 
-    // Read the raw data
-    if(m_pFiffIO->m_qlistRaw[0]->read_raw_segment(matData, matTimes, start, end)) {
-        // qDebug() << "[FiffRawViewModel::loadFiffData] Successfully read a block ";
-    } else {
-        qWarning() << "[FiffRawViewModel::loadEarlierBlocks] Could not read block ";
+    if(!loadBlocks(start, numBlocks, currentFilterSettings(), lData, lFilteredData)) {
+        qWarning() << "[FiffRawViewModel::loadEarlierBlocks] Could not load blocks ";
         return -1;
     }
 
-    for(int i = 0; i < numBlocks; ++i) {
-        m_lNewData.push_front(QSharedPointer<QPair<MatrixXd, MatrixXd> >::create(qMakePair(matData.block(0, i*m_iSamplesPerBlock+iFilterDelay, matData.rows(), m_iSamplesPerBlock),
-                                                                                           matTimes.block(0, i*m_iSamplesPerBlock+iFilterDelay, matTimes.rows(), m_iSamplesPerBlock))));
-    }
-
-    // Filter data if activated, otherwise set to raw data
-    if(m_bPerformFiltering) {
-        bool bFilterSuccess = false;
-        if(bBeforeStartReached) {
-            iFilterDelay = m_filterKernel.getFilterOrder()/4;
-            bFilterSuccess = filterDataBlock(matData, true, true);
-        } else {
-            bFilterSuccess = filterDataBlock(matData, true);
-        }
-
-        if(!bFilterSuccess) {
-            m_lFilteredNewData = m_lNewData;
-            return 0;
-        }
-
-        for(int i = 0; i < numBlocks; ++i) {
-            m_lFilteredNewData.push_front(QSharedPointer<QPair<MatrixXd, MatrixXd> >::create(qMakePair(matData.block(0, (i*m_iSamplesPerBlock)+(2*iFilterDelay), matData.rows(), m_iSamplesPerBlock),
-                                                                                                       matTimes.block(0, (i*m_iSamplesPerBlock)+(2*iFilterDelay), matTimes.rows(), m_iSamplesPerBlock))));
-        }
+    if(start <= absoluteFirstSample()) {
+        m_iFiffCursorBegin = absoluteFirstSample();
     } else {
-        m_lFilteredNewData = m_lNewData;
+        m_iFiffCursorBegin = start;
     }
 
+    // postBlockLoad prepends the new blocks one after another, so store the latest block first
+    m_lNewData.assign(lData.rbegin(), lData.rend());
+    m_lFilteredNewData.assign(lFilteredData.rbegin(), lFilteredData.rend());
+
     // return 0, meaning that this was a loading of earlier blocks
     return 0;
 }
@@ -767,11 +727,11 @@ int FiffRawViewModel::loadEarlierBlocks(qint32 numBlocks)
 int FiffRawViewModel::loadLaterBlocks(qint32 numBlocks)
 {
     // check if end of file is reached:
-    int leftSamples = absoluteLastSample() - (m_iFiffCursorBegin + (m_iTotalBlockCount + numBlocks) * m_iSamplesPerBlock);
+    int leftSamples = absoluteLastSample() - (m_iFiffCursorBegin + (m_iTotalBlockCount + numBlocks - 1) * m_iSamplesPerBlock);
     if (leftSamples < 0) {
         qInfo() << "[FiffRawViewModel::loadLaterBlocks] Reached end of file !";
-        // see how many blocks we still can load
-        int maxNumBlocks = (absoluteLastSample() - (m_iFiffCursorBegin + m_iTotalBlockCount * m_iSamplesPerBlock)) / m_iSamplesPerBlock;
+        // see how many blocks we still can load, the last one may be shorter
+        int maxNumBlocks = std::max(0, (absoluteLastSample() - (m_iFiffCursorBegin + m_iTotalBlockCount * m_iSamplesPerBlock) + m_iSamplesPerBlock) / m_iSamplesPerBlock);
         //qInfo() << "[FiffRawViewModel::loadLaterBlocks] Loading " << maxNumBlocks << " later blocks instead of requested " << numBlocks;
         if (maxNumBlocks != 0) {
             numBlocks = maxNumBlocks;
@@ -789,63 +749,21 @@ int FiffRawViewModel::loadLaterBlocks(qint32 numBlocks)
         return -1;
     }
 
-    // build data structures to be filled from file
-    MatrixXd matData, matTimes;
-
-    // initialize start and end indices
+    // initialize start index
     int start = m_iFiffCursorBegin + (m_iTotalBlockCount * m_iSamplesPerBlock);
-    int end = start + (m_iSamplesPerBlock * numBlocks) - 1;
-
-    // adjust fiff cursor
-    m_iFiffCursorBegin += numBlocks * m_iSamplesPerBlock;
 
-    // Account for filter delay of current filter kernel
-    int iFilterDelay = 0;
+    std::list<BlockCache::Block> lData, lFilteredData;
 
-    if(m_bPerformFiltering) {
-        iFilterDelay = m_filterKernel.getFilterOrder()/2;
-
-        // Check if we have reached the beginning/end of the file
-        if(start-iFilterDelay > absoluteFirstSample()) {
-            start -= m_filterKernel.getFilterOrder()/2;
-        } else {
-            iFilterDelay = 0;
-        }
-
-        if(end+iFilterDelay < m_pFiffIO->m_qlistRaw[0]->last_samp) {
-            end += m_filterKernel.getFilterOrder()/2;
-        } else {
-            iFilterDelay = 0;
-        }
-    }
-
-    // read data
-    if(m_pFiffIO->m_qlistRaw[0]->read_raw_segment(matData, matTimes, start, end)) {
-        // qDebug() << "[FiffRawViewModel::loadFiffData] Successfully read a block ";
-    } else {
-        qWarning() << "[FiffRawViewModel::loadLaterBlocks] Could not read block ";
+    if(!loadBlocks(start, numBlocks, currentFilterSettings(), lData, lFilteredData)) {
+        qWarning() << "[FiffRawViewModel::loadLaterBlocks] Could not load blocks ";
         return -1;
     }
 
-    for(int i = 0; i < numBlocks; ++i) {
-        m_lNewData.push_back(QSharedPointer<QPair<MatrixXd, MatrixXd> >::create(qMakePair(matData.block(0, i*m_iSamplesPerBlock+iFilterDelay, matData.rows(), m_iSamplesPerBlock),
-                                                                                          matTimes.block(0, i*m_iSamplesPerBlock+iFilterDelay, matTimes.rows(), m_iSamplesPerBlock))));
-    }
-
-    // Filter data if activated, otherwise set to raw data
-    if(m_bPerformFiltering) {
-        if(!filterDataBlock(matData, true)) {
-            m_lFilteredNewData = m_lNewData;
-            return 1;
-        }
+    // adjust fiff cursor
+    m_iFiffCursorBegin += numBlocks * m_iSamplesPerBlock;
 
-        for(int i = 0; i < numBlocks; ++i) {
-            m_lFilteredNewData.push_back(QSharedPointer<QPair<MatrixXd, MatrixXd> >::create(qMakePair(matData.block(0, i*m_iSamplesPerBlock+(2*iFilterDelay), matData.rows(), m_iSamplesPerBlock),
-                                                                                                      matTimes.block(0, i*m_iSamplesPerBlock+(2*iFilterDelay), matTimes.rows(), m_iSamplesPerBlock))));
-        }
-    } else {
-        m_lFilteredNewData = m_lNewData;
-    }
+    m_lNewData.swap(lData);
+    m_lFilteredNewData.swap(lFilteredData);
 
     // return 1, meaning that this was a loading of later blocks
     return 1;
@@ -916,6 +834,11 @@ void FiffRawViewModel::postBlockLoad(int result)
     updateEndStartFlags();
     m_bCurrentlyLoading = false;
 
+    // earlier blocks were loaded (0) when scrolling backwards, later blocks (1) when scrolling forwards
+    if(result == 0 || result == 1) {
+        prefetchBlocks(result == 0 ? -1 : 1);
+    }
+
     emit dataChanged(createIndex(0,0), createIndex(rowCount(), columnCount()));
 }
 
@@ -923,71 +846,262 @@ void FiffRawViewModel::postBlockLoad(int result)
 
 void FiffRawViewModel::reloadAllData()
 {
-    m_lData.clear();
-    m_lFilteredData.clear();
+    std::list<BlockCache::Block> lData, lFilteredData;
 
-    MatrixXd matData, matTimes;
+    bool bSuccess = loadBlocks(m_iFiffCursorBegin, m_iTotalBlockCount, currentFilterSettings(), lData, lFilteredData);
+
+    m_dataMutex.lock();
+    m_lData.swap(lData);
+    m_lFilteredData.swap(lFilteredData);
+    m_dataMutex.unlock();
+
+    if(!bSuccess) {
+        qWarning() << "[FiffRawViewModel::reloadAllData] Could not load blocks ";
+        return;
+    }
 
-    int start = m_iFiffCursorBegin;
+    emit dataChanged(createIndex(0,0), createIndex(rowCount(), columnCount()));
+}
 
-    // for some reason the read_raw_segment function works with inclusive upper bound
-    int end = start + (m_iSamplesPerBlock * m_iTotalBlockCount) - 1;
+//=============================================================================================================
 
-    // When filtering load more data than we need in order to allow arbiritary filter lengths
-    int iFilterDelay = 0;
-    bool bBeforeStartReached = false;
+FiffRawViewModel::FilterSettings FiffRawViewModel::currentFilterSettings() const
+{
+    FilterSettings settings;
 
-    if(m_bPerformFiltering) {
-        iFilterDelay = m_filterKernel.getFilterOrder()/2;
-        end += m_filterKernel.getFilterOrder()/2;
+    settings.bActive = m_bPerformFiltering;
+    settings.filterKernel = m_filterKernel;
+    settings.vecPicks = m_lFilterChannelList;
 
-        // Check if we have reached the beginning of the file
-        if(start-iFilterDelay >= m_pFiffIO->m_qlistRaw[0]->first_samp) {
-            start -= m_filterKernel.getFilterOrder()/2;
-        } else {
-            // Add another filter delay because we need enough data to sucessfully filter with arbiritary filter lengths
-            end += m_filterKernel.getFilterOrder()/2;
-            iFilterDelay = 0;
-            bBeforeStartReached = true;
-        }
+    if(m_bPerformFiltering && m_lFilterChannelList.cols() == 0) {
+        qWarning() << "[FiffRawViewModel::currentFilterSettings] No channels to filter specified.";
+        settings.bActive = false;
     }
 
-    // read in all blocks
-    if(m_pFiffIO->m_qlistRaw[0]->read_raw_segment(matData, matTimes, start, end)) {
-        // qDebug() << "[FiffRawmodel::loadFiffData] Successfully read a block ";
+    // The cache key of the filtered blocks, blocks filtered with other settings stay cached under their own key
+    if(settings.bActive) {
+        settings.sKey = QString("%1_%2_%3_%4_%5_%6_%7_%8_%9").arg(m_filterKernel.getName())
+                                                            .arg(m_filterKernel.m_Type)
+                                                            .arg(m_filterKernel.m_designMethod)
+                                                            .arg(m_filterKernel.getFilterOrder())
+                                                            .arg(m_filterKernel.getCenterFrequency())
+                                                            .arg(m_filterKernel.getBandwidth())
+                                                            .arg(m_filterKernel.getParksWidth())
+                                                            .arg(m_filterKernel.getSamplingFrequency())
+                                                            .arg(m_sFilterChannelType);
     } else {
-        qWarning() << "[FiffRawViewModel::loadFiffData] Could not read samples " << start << " to " << end;
-        return;
+        settings.sKey = QStringLiteral("raw");
     }
 
-    // append a matrix pair for each block
-    for(int i = 0; i < m_iTotalBlockCount; ++i) {
-        m_lData.push_back(QSharedPointer<QPair<MatrixXd, MatrixXd> >::create(qMakePair(matData.block(0, i*m_iSamplesPerBlock+iFilterDelay, matData.rows(), m_iSamplesPerBlock),
-                                                                                       matTimes.block(0, i*m_iSamplesPerBlock+iFilterDelay, matTimes.rows(), m_iSamplesPerBlock))));
+    return settings;
+}
+
+//=============================================================================================================
+
+bool FiffRawViewModel::loadBlocks(qint32 iFirstSample,
+                                  qint32 numBlocks,
+                                  const FilterSettings& settings,
+                                  std::list<BlockCache::Block>& lData,
+                                  std::list<BlockCache::Block>& lFilteredData)
+{
+    // blocks starting behind the end of the file do not exist, the last one may be shorter
+    numBlocks = std::min(numBlocks, std::max(0, (absoluteLastSample() - iFirstSample + m_iSamplesPerBlock) / m_iSamplesPerBlock));
+
+    std::vector<BlockCache::Block> vecData(numBlocks);
+    std::vector<BlockCache::Block> vecFilteredData(numBlocks);
+
+    // take what is already cached
+    for(int i = 0; i < numBlocks; ++i) {
+        vecData[i] = m_blockCache.find(QStringLiteral("raw"), iFirstSample + i * m_iSamplesPerBlock);
+        vecFilteredData[i] = settings.bActive ? m_blockCache.find(settings.sKey, iFirstSample + i * m_iSamplesPerBlock) : vecData[i];
     }
 
-    // Filter data if activated, otherwise set to raw data
-    if(m_bPerformFiltering) {
-        bool bFilterSuccess = false;
-        if(bBeforeStartReached) {
-            iFilterDelay = m_filterKernel.getFilterOrder()/4;
-            bFilterSuccess = filterDataBlock(matData, true, true);
-        } else {
-            bFilterSuccess = filterDataBlock(matData, true);
+    // read the rest from file, consecutive missing blocks with one read
+    int i = 0;
+    while(i < numBlocks) {
+        if(vecData[i] && vecFilteredData[i]) {
+            ++i;
+            continue;
         }
 
-        if(!bFilterSuccess) {
-            m_lFilteredData = m_lData;
-            return;
+        int j = i + 1;
+        while(j < numBlocks && !(vecData[j] && vecFilteredData[j])) {
+            ++j;
         }
 
-        for(int i = 0; i < m_iTotalBlockCount; ++i) {
-            m_lFilteredData.push_back(QSharedPointer<QPair<MatrixXd, MatrixXd> >::create(qMakePair(matData.block(0, (i*m_iSamplesPerBlock)+(2*iFilterDelay), matData.rows(), m_iSamplesPerBlock),
-                                                                                                   matTimes.block(0, (i*m_iSamplesPerBlock)+(2*iFilterDelay), matTimes.rows(), m_iSamplesPerBlock))));
+        std::vector<BlockCache::Block> vecReadData, vecReadFilteredData;
+
+        if(!readBlocks(iFirstSample + i * m_iSamplesPerBlock, j - i, settings, vecReadData, vecReadFilteredData)) {
+            return false;
+        }
+
+        std::copy(vecReadData.begin(), vecReadData.end(), vecData.begin() + i);
+        std::copy(vecReadFilteredData.begin(), vecReadFilteredData.end(), vecFilteredData.begin() + i);
+
+        i = j;
+    }
+
+    lData.assign(vecData.begin(), vecData.end());
+    lFilteredData.assign(vecFilteredData.begin(), vecFilteredData.end());
+
+    return true;
+}
+
+//=============================================================================================================
+
+bool FiffRawViewModel::readBlocks(qint32 iFirstSample,
+                                  qint32 numBlocks,
+                                  const FilterSettings& settings,
+                                  std::vector<BlockCache::Block>& vecData,
+                                  std::vector<BlockCache::Block>& vecFilteredData)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // for some reason the read_raw_segment function works with inclusive upper bound. The last block of the file
+    // may be shorter than the others.
+    int iLastSample = std::min(iFirstSample + numBlocks * m_iSamplesPerBlock - 1, absoluteLastSample());
+
+    if(iFirstSample < absoluteFirstSample() || iFirstSample + (numBlocks - 1) * m_iSamplesPerBlock > iLastSample) {
+        qWarning() << "[FiffRawViewModel::readBlocks] Samples " << iFirstSample << " to " << iLastSample << " are out of range";
+        return false;
+    }
+
+    // When filtering load more data than we need in order to allow arbiritary filter lengths
+    int iFilterDelay = settings.bActive ? settings.filterKernel.getFilterOrder()/2 : 0;
+    int start = std::max(iFirstSample - iFilterDelay, absoluteFirstSample());
+    int end = std::min(iLastSample + iFilterDelay, absoluteLastSample());
+
+    MatrixXd matData, matTimes;
+
+    // The file is read from the prefetch thread as well
+    m_readMutex.lock();
+    bool bReadSuccess = m_pFiffIO->m_qlistRaw[0]->read_raw_segment(matData, matTimes, start, end);
+    m_readMutex.unlock();
+
+    if(!bReadSuccess) {
+        qWarning() << "[FiffRawViewModel::readBlocks] Could not read samples " << start << " to " << end;
+        return false;
+    }
+
+    int iOffset = iFirstSample - start;
+
+    vecData.clear();
+    vecFilteredData.clear();
+
+    auto blockSize = [&](int i) {
+        return std::min(m_iSamplesPerBlock, iLastSample - (iFirstSample + i * m_iSamplesPerBlock) + 1);
+    };
+
+    for(int i = 0; i < numBlocks; ++i) {
+        vecData.push_back(BlockCache::Block::create(qMakePair(matData.block(0, iOffset + i*m_iSamplesPerBlock, matData.rows(), blockSize(i)),
+                                                              matTimes.block(0, iOffset + i*m_iSamplesPerBlock, matTimes.rows(), blockSize(i)))));
+        m_blockCache.insert(QStringLiteral("raw"), iFirstSample + i * m_iSamplesPerBlock, vecData.back());
+    }
+
+    // Filter data if activated, otherwise set to raw data
+    if(settings.bActive) {
+        // Continue the data with its first and last value where the file does not cover the filter delay
+        int iFront = start - (iFirstSample - iFilterDelay);
+        int iBack = (iLastSample + iFilterDelay) - end;
+
+        MatrixXd matPadded(matData.rows(), iFront + matData.cols() + iBack);
+        matPadded.leftCols(iFront) = matData.col(0).replicate(1, iFront);
+        matPadded.middleCols(iFront, matData.cols()) = matData;
+        matPadded.rightCols(iBack) = matData.col(matData.cols()-1).replicate(1, iBack);
+
+        filterDataBlock(matPadded, settings);
+
+        // The filtered data is delayed by another filter delay
+        for(int i = 0; i < numBlocks; ++i) {
+            vecFilteredData.push_back(BlockCache::Block::create(qMakePair(matPadded.block(0, i*m_iSamplesPerBlock + 2*iFilterDelay, matPadded.rows(), blockSize(i)),
+                                                                          vecData[i]->second)));
+            m_blockCache.insert(settings.sKey, iFirstSample + i * m_iSamplesPerBlock, vecFilteredData.back());
         }
     } else {
-        m_lFilteredData = m_lData;
+        vecFilteredData = vecData;
     }
 
-    emit dataChanged(createIndex(0,0), createIndex(rowCount(), columnCount()));
+    m_blockCache.recordLoad(numBlocks, timer.nsecsElapsed() / 1e6);
+
+    return true;
+}
+
+//=============================================================================================================
+
+void FiffRawViewModel::prefetchBlocks(int iDirection)
+{
+    // In WASM mode there is no thread to prefetch in the background
+    #ifdef WASMBUILD
+    Q_UNUSED(iDirection)
+    #else
+    // Do not queue up prefetches while scrolling quickly, the next scroll step triggers a new one
+    if(!m_pFiffIO || m_prefetchFuture.isRunning()) {
+        return;
+    }
+
+    // Prefetch one visible window ahead in scroll direction
+    int numBlocks = m_iVisibleWindowSize;
+    int iFirstSample = iDirection < 0 ? m_iFiffCursorBegin - numBlocks * m_iSamplesPerBlock
+                                      : m_iFiffCursorBegin + m_iTotalBlockCount * m_iSamplesPerBlock;
+
+    while(numBlocks > 0 && iFirstSample < absoluteFirstSample()) {
+        iFirstSample += m_iSamplesPerBlock;
+        --numBlocks;
+    }
+
+    while(numBlocks > 0 && iFirstSample + (numBlocks - 1) * m_iSamplesPerBlock > absoluteLastSample()) {
+        --numBlocks;
+    }
+
+    if(numBlocks <= 0) {
+        return;
+    }
+
+    m_prefetchFuture = QtConcurrent::run(this, &FiffRawViewModel::prefetchRange, iFirstSample, numBlocks, currentFilterSettings());
+    #endif
+}
+
+//=============================================================================================================
+
+void FiffRawViewModel::prefetchRange(qint32 iFirstSample,
+                                     qint32 numBlocks,
+                                     const FilterSettings& settings)
+{
+    auto isCached = [&](int i) {
+        int iSample = iFirstSample + i * m_iSamplesPerBlock;
+        return m_blockCache.contains(QStringLiteral("raw"), iSample) && (!settings.bActive || m_blockCache.contains(settings.sKey, iSample));
+    };
+
+    int i = 0;
+    while(i < numBlocks) {
+        if(isCached(i)) {
+            ++i;
+            continue;
+        }
+
+        int j = i + 1;
+        while(j < numBlocks && !isCached(j)) {
+            ++j;
+        }
+
+        std::vector<BlockCache::Block> vecData, vecFilteredData;
+        readBlocks(iFirstSample + i * m_iSamplesPerBlock, j - i, settings, vecData, vecFilteredData);
+
+        i = j;
+    }
+}
+
+//=============================================================================================================
+
+BlockCache::Statistics FiffRawViewModel::getBlockCacheStatistics() const
+{
+    return m_blockCache.statistics();
+}
+
+//=============================================================================================================
+
+void FiffRawViewModel::setBlockCacheSize(qint64 iMaxBytes)
+{
+    m_blockCache.setMaxBytes(iMaxBytes);
 }
@@ -45,17 +45,21 @@
 #include "../anshared_global.h"
 #include "../Utils/types.h"
 #include "abstractmodel.h"
+#include "../Utils/blockcache.h"
 
 #include <fiff/fiff_io.h>
 
 #include <rtprocessing/helpers/filterkernel.h>
 
+#include <vector>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
 
 #include <QSharedPointer>
 #include <QFutureWatcher>
+#include <QFuture>
 #include <QMutex>
 #include <QBuffer>
 #include <QFile>
@@ -74,10 +78,6 @@ namespace FIFFLIB {
     class FiffChInfo;
 }
 
-namespace RTPROCESSINGLIB {
-    class FilterOverlapAdd;
-}
-
 //=============================================================================================================
 // DEFINE NAMESPACE ANSHAREDLIB
 //=============================================================================================================
@@ -496,20 +496,42 @@ public:
      */
     void updateHorizontalScrollPosition(qint32 newScrollPosition);
 
+    //=========================================================================================================
+    /**
+     * Returns the hit rate and load latency statistics of the block cache.
+     *
+     * @return The block cache statistics.
+     */
+    BlockCache::Statistics getBlockCacheStatistics() const;
+
+    //=========================================================================================================
+    /**
+     * Sets the maximal memory the block cache may use. Least recently used blocks are evicted first.
+     *
+     * @param[in] iMaxBytes     The maximal memory in bytes.
+     */
+    void setBlockCacheSize(qint64 iMaxBytes);
+
 private:
+    /**
+     * The filter settings blocks are loaded with. Copied when handed to the prefetch thread.
+     */
+    struct FilterSettings {
+        bool                            bActive;        /**< Whether to filter. */
+        RTPROCESSINGLIB::FilterKernel   filterKernel;   /**< The filter kernel. */
+        Eigen::RowVectorXi              vecPicks;       /**< The indices of the channels to be filtered. */
+        QString                         sKey;           /**< The cache key of the filtered blocks. */
+    };
+
     //=========================================================================================================
     /**
      * Calculates the filtered version of one single datablock
      *
-     * @param [in]   matData         The data block to be filtered.
-     * @param [in]   bFilterEnd      Whether to perform the overlap add in the beginning or end of the data.
-     * @param [in]   bKeepOverhead   Whether to keep the overhead.
-     *
-     * @return Returns true if filtering was performed, otherwise returns false
+     * @param [in, out]  matData     The data block to be filtered.
+     * @param [in]       settings    The filter settings.
      */
-    bool filterDataBlock(MatrixXd& matData,
-                         bool bFilterEnd,
-                         bool bKeepOverhead = false);
+    void filterDataBlock(MatrixXd& matData,
+                         const FilterSettings& settings) const;
 
     //=========================================================================================================
     /**
@@ -556,6 +578,71 @@ private:
      */
     void reloadAllData();
 
+    //=========================================================================================================
+    /**
+     * Returns the current filter settings.
+     *
+     * @return The current filter settings.
+     */
+    FilterSettings currentFilterSettings() const;
+
+    //=========================================================================================================
+    /**
+     * Returns consecutive blocks. Blocks which are in the block cache are taken from there, the others are read
+     * from file.
+     *
+     * @param[in] iFirstSample      The first sample of the first block.
+     * @param[in] numBlocks         The number of blocks.
+     * @param[in] settings          The filter settings.
+     * @param[out] lData            The raw blocks.
+     * @param[out] lFilteredData    The filtered blocks, the raw blocks if filtering is not active.
+     *
+     * @return Returns true if all blocks could be loaded.
+     */
+    bool loadBlocks(qint32 iFirstSample,
+                    qint32 numBlocks,
+                    const FilterSettings& settings,
+                    std::list<BlockCache::Block>& lData,
+                    std::list<BlockCache::Block>& lFilteredData);
+
+    //=========================================================================================================
+    /**
+     * Reads consecutive blocks from file, filters them and stores them in the block cache. Can be run concurrently.
+     *
+     * @param[in] iFirstSample          The first sample of the first block.
+     * @param[in] numBlocks             The number of blocks.
+     * @param[in] settings              The filter settings.
+     * @param[out] vecData              The raw blocks.
+     * @param[out] vecFilteredData      The filtered blocks, the raw blocks if filtering is not active.
+     *
+     * @return Returns true if the blocks could be read.
+     */
+    bool readBlocks(qint32 iFirstSample,
+                    qint32 numBlocks,
+                    const FilterSettings& settings,
+                    std::vector<BlockCache::Block>& vecData,
+                    std::vector<BlockCache::Block>& vecFilteredData);
+
+    //=========================================================================================================
+    /**
+     * Starts reading the blocks following the currently loaded ones into the block cache in the background.
+     *
+     * @param[in] iDirection    The scroll direction, negative for the blocks before the current ones.
+     */
+    void prefetchBlocks(int iDirection);
+
+    //=========================================================================================================
+    /**
+     * This is run concurrently. Reads the blocks which are not yet cached into the block cache.
+     *
+     * @param[in] iFirstSample      The first sample of the first block.
+     * @param[in] numBlocks         The number of blocks.
+     * @param[in] settings          The filter settings.
+     */
+    void prefetchRange(qint32 iFirstSample,
+                       qint32 numBlocks,
+                       const FilterSettings& settings);
+
     std::list<QSharedPointer<QPair<MatrixXd, MatrixXd> > > m_lData;             /**< Data */
     std::list<QSharedPointer<QPair<MatrixXd, MatrixXd> > > m_lNewData;          /**< Data that is to be appended or prepended */
     std::list<QSharedPointer<QPair<MatrixXd, MatrixXd> > > m_lFilteredData;     /**< Filtered data */
@@ -580,6 +667,11 @@ private:
     bool m_bCurrentlyLoading;                       /**< Flag to indicate whether or not a background operation is going on. */
     mutable QMutex m_dataMutex;                     /**< Using mutable is not a pretty solution */
 
+    // block cache
+    BlockCache m_blockCache;                        /**< Recently used and prefetched raw and filtered blocks. */
+    QFuture<void> m_prefetchFuture;                 /**< The running prefetch. */
+    QMutex m_readMutex;                             /**< Serializes the reads from file. */
+
     // data stuff
     QFile m_file;
     QByteArray m_byteLoadedData;
@@ -588,7 +680,6 @@ private:
     // Filter stuff
     qint32                                      m_iMaxFilterLength;                         /**< Max order of the current filters */
     QString                                     m_sFilterChannelType;                       /**< Kind of channel which is to be filtered */
-    QSharedPointer<RTPROCESSINGLIB::FilterOverlapAdd>     m_pRtFilter;                                /**< The filter object. */
     Eigen::RowVectorXi                          m_lFilterChannelList;                       /**< The indices of the channels to be filtered.*/
     bool                                        m_bPerformFiltering;                        /**< Flag whether to activate/deactivate filtering. */
     RTPROCESSINGLIB::FilterKernel               m_filterKernel;                             /**< List of currently active filters. */
@@ -0,0 +1,206 @@
+//=============================================================================================================
+/**
+ * @file     blockcache.cpp
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Definition of the BlockCache Class.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "blockcache.h"
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QMutexLocker>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace ANSHAREDLIB;
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+BlockCache::BlockCache(qint64 iMaxBytes)
+: m_iMaxBytes(iMaxBytes)
+, m_iBytes(0)
+, m_iHits(0)
+, m_iMisses(0)
+, m_iLoads(0)
+, m_iLoadedBlocks(0)
+, m_dLoadTimeMs(0.0)
+{
+}
+
+//=============================================================================================================
+
+void BlockCache::setMaxBytes(qint64 iMaxBytes)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_iMaxBytes = iMaxBytes;
+    evict();
+}
+
+//=============================================================================================================
+
+qint64 BlockCache::maxBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_iMaxBytes;
+}
+
+//=============================================================================================================
+
+BlockCache::Block BlockCache::find(const QString& sVariant,
+                                   qint32 iFirstSample)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_hashEntries.constFind(Key(sVariant, iFirstSample));
+
+    if(it == m_hashEntries.constEnd()) {
+        ++m_iMisses;
+        return Block();
+    }
+
+    ++m_iHits;
+
+    // move to the front, this does not invalidate the stored iterators
+    m_lEntries.splice(m_lEntries.begin(), m_lEntries, it.value());
+
+    return m_lEntries.front().block;
+}
+
+//=============================================================================================================
+
+bool BlockCache::contains(const QString& sVariant,
+                          qint32 iFirstSample) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_hashEntries.contains(Key(sVariant, iFirstSample));
+}
+
+//=============================================================================================================
+
+void BlockCache::insert(const QString& sVariant,
+                        qint32 iFirstSample,
+                        const Block& block)
+{
+    if(!block) {
+        return;
+    }
+
+    const Key key(sVariant, iFirstSample);
+    const qint64 iBytes = (block->first.size() + block->second.size()) * qint64(sizeof(double));
+
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_hashEntries.find(key);
+
+    if(it != m_hashEntries.end()) {
+        m_iBytes -= it.value()->iBytes;
+        m_lEntries.erase(it.value());
+        m_hashEntries.erase(it);
+    }
+
+    m_lEntries.push_front(Entry{key, block, iBytes});
+    m_hashEntries.insert(key, m_lEntries.begin());
+    m_iBytes += iBytes;
+
+    evict();
+}
+
+//=============================================================================================================
+
+void BlockCache::recordLoad(int iBlocks,
+                            double dLoadTimeMs)
+{
+    QMutexLocker locker(&m_mutex);
+
+    ++m_iLoads;
+    m_iLoadedBlocks += iBlocks;
+    m_dLoadTimeMs += dLoadTimeMs;
+}
+
+//=============================================================================================================
+
+void BlockCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_lEntries.clear();
+    m_hashEntries.clear();
+    m_iBytes = 0;
+    m_iHits = 0;
+    m_iMisses = 0;
+    m_iLoads = 0;
+    m_iLoadedBlocks = 0;
+    m_dLoadTimeMs = 0.0;
+}
+
+//=============================================================================================================
+
+BlockCache::Statistics BlockCache::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    Statistics stats;
+    stats.iHits = m_iHits;
+    stats.iMisses = m_iMisses;
+    stats.iLoads = m_iLoads;
+    stats.iLoadedBlocks = m_iLoadedBlocks;
+    stats.dMeanLoadTimeMs = m_iLoads > 0 ? m_dLoadTimeMs / double(m_iLoads) : 0.0;
+    stats.iBytes = m_iBytes;
+    stats.iBlocks = static_cast<int>(m_lEntries.size());
+
+    return stats;
+}
+
+//=============================================================================================================
+
+void BlockCache::evict()
+{
+    // always keep the most recently inserted block, even if it alone exceeds the limit
+    while(m_iBytes > m_iMaxBytes && m_lEntries.size() > 1) {
+        const Entry& entry = m_lEntries.back();
+        m_iBytes -= entry.iBytes;
+        m_hashEntries.remove(entry.key);
+        m_lEntries.pop_back();
+    }
+}
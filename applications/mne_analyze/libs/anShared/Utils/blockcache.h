@@ -0,0 +1,215 @@
+//=============================================================================================================
+/**
+ * @file     blockcache.h
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Declaration of the BlockCache Class.
+ *
+ */
+
+#ifndef ANSHAREDLIB_BLOCKCACHE_H
+#define ANSHAREDLIB_BLOCKCACHE_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../anshared_global.h"
+
+#include <list>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QPair>
+#include <QHash>
+#include <QString>
+#include <QMutex>
+
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// DEFINE NAMESPACE ANSHAREDLIB
+//=============================================================================================================
+
+namespace ANSHAREDLIB {
+
+//=============================================================================================================
+/**
+ * Holds data blocks (data and times) which were read from a file, keyed by a variant string (e.g. raw or the
+ * settings of the filter they were processed with) and their first sample. The memory held by the cache is bounded,
+ * when it is exceeded the least recently used blocks are evicted. All methods are thread safe.
+ *
+ * @brief Bounded LRU cache for data blocks.
+ */
+class ANSHAREDSHARED_EXPORT BlockCache
+{
+
+public:
+    typedef QSharedPointer<BlockCache> SPtr;                                    /**< Shared pointer type for BlockCache. */
+    typedef QSharedPointer<const BlockCache> ConstSPtr;                         /**< Const shared pointer type for BlockCache. */
+    typedef QSharedPointer<QPair<Eigen::MatrixXd, Eigen::MatrixXd> > Block;     /**< A data block (data, times). */
+
+    /**
+     * Access and load statistics of the cache.
+     */
+    struct Statistics {
+        qint64  iHits;              /**< Number of lookups which found their block. */
+        qint64  iMisses;            /**< Number of lookups which did not find their block. */
+        qint64  iLoads;             /**< Number of recorded loads. */
+        qint64  iLoadedBlocks;      /**< Number of blocks read by the recorded loads. */
+        double  dMeanLoadTimeMs;    /**< Mean duration of a recorded load in ms. */
+        qint64  iBytes;             /**< Memory currently held by the cache in bytes. */
+        int     iBlocks;            /**< Number of blocks currently held by the cache. */
+
+        double hitRate() const {
+            return (iHits + iMisses) > 0 ? double(iHits) / double(iHits + iMisses) : 0.0;
+        }
+    };
+
+    //=========================================================================================================
+    /**
+     * Constructs a BlockCache object.
+     *
+     * @param[in] iMaxBytes     The maximal memory the cached blocks may use in bytes. Default is 512 MB.
+     */
+    explicit BlockCache(qint64 iMaxBytes = 512 * 1024 * 1024);
+
+    //=========================================================================================================
+    /**
+     * Sets the maximal memory the cached blocks may use. Evicts blocks if necessary.
+     *
+     * @param[in] iMaxBytes     The maximal memory in bytes.
+     */
+    void setMaxBytes(qint64 iMaxBytes);
+
+    //=========================================================================================================
+    /**
+     * Returns the maximal memory the cached blocks may use.
+     *
+     * @return The maximal memory in bytes.
+     */
+    qint64 maxBytes() const;
+
+    //=========================================================================================================
+    /**
+     * Looks up a block and marks it as most recently used. The lookup is counted in the statistics.
+     *
+     * @param[in] sVariant          The variant of the block.
+     * @param[in] iFirstSample      The first sample of the block.
+     *
+     * @return The block, a null pointer if it is not cached.
+     */
+    Block find(const QString& sVariant,
+               qint32 iFirstSample);
+
+    //=========================================================================================================
+    /**
+     * Returns whether a block is cached. Neither the statistics nor the usage order are changed.
+     *
+     * @param[in] sVariant          The variant of the block.
+     * @param[in] iFirstSample      The first sample of the block.
+     *
+     * @return True if the block is cached.
+     */
+    bool contains(const QString& sVariant,
+                  qint32 iFirstSample) const;
+
+    //=========================================================================================================
+    /**
+     * Inserts or replaces a block and marks it as most recently used.
+     *
+     * @param[in] sVariant          The variant of the block.
+     * @param[in] iFirstSample      The first sample of the block.
+     * @param[in] block             The block.
+     */
+    void insert(const QString& sVariant,
+                qint32 iFirstSample,
+                const Block& block);
+
+    //=========================================================================================================
+    /**
+     * Records the duration of a load from disk in the statistics.
+     *
+     * @param[in] iBlocks           The number of blocks which were loaded.
+     * @param[in] dLoadTimeMs       The duration of the load in ms.
+     */
+    void recordLoad(int iBlocks,
+                    double dLoadTimeMs);
+
+    //=========================================================================================================
+    /**
+     * Removes all blocks and resets the statistics.
+     */
+    void clear();
+
+    //=========================================================================================================
+    /**
+     * Returns the access and load statistics.
+     *
+     * @return The statistics.
+     */
+    Statistics statistics() const;
+
+private:
+    typedef QPair<QString, qint32> Key;
+
+    struct Entry {
+        Key     key;            /**< The variant and first sample of the block. */
+        Block   block;          /**< The block. */
+        qint64  iBytes;         /**< The memory used by the block. */
+    };
+
+    //=========================================================================================================
+    /**
+     * Evicts the least recently used blocks until the memory limit is met. Expects the mutex to be locked.
+     */
+    void evict();
+
+    mutable QMutex                                          m_mutex;            /**< Guards all members. */
+    std::list<Entry>                                        m_lEntries;         /**< The entries, most recently used first. */
+    QHash<Key, std::list<Entry>::iterator>                  m_hashEntries;      /**< The entries by key. */
+
+    qint64      m_iMaxBytes;        /**< The maximal memory in bytes. */
+    qint64      m_iBytes;           /**< The memory currently held in bytes. */
+    qint64      m_iHits;            /**< Number of lookups which found their block. */
+    qint64      m_iMisses;          /**< Number of lookups which did not find their block. */
+    qint64      m_iLoads;           /**< Number of recorded loads. */
+    qint64      m_iLoadedBlocks;    /**< Number of blocks read by the recorded loads. */
+    double      m_dLoadTimeMs;      /**< Summed duration of the recorded loads in ms. */
+};
+
+} // namespace ANSHAREDLIB
+
+#endif // ANSHAREDLIB_BLOCKCACHE_H
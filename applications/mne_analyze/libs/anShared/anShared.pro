@@ -92,6 +92,7 @@ SOURCES += \
     Model/fiffrawviewmodel.cpp \
     Model/annotationmodel.cpp \
     Model/analyzedatamodel.cpp \
+    Utils/blockcache.cpp \
 
 HEADERS += \
     anshared_global.h \
@@ -107,6 +108,7 @@ HEADERS += \
     Interfaces/IPlugin.h \
     Utils/metatypes.h \
     Utils/types.h \
+    Utils/blockcache.h \
     Model/fiffrawviewmodel.h \
     Model/annotationmodel.h \
     Model/analyzedatamodel.h \
@@ -81,7 +81,8 @@ using namespace Eigen;
 
 Covariance::Covariance()
 : m_iEstimationSamples(2000)
-, m_pCircularBuffer(CircularBuffer_Matrix_double::SPtr::create(40))
+, m_dForgettingFactor(1.0)
+, m_pCircularBuffer(RingBuffer_Matrix_double::SPtr::create(40))
 {
 }
 
@@ -108,6 +109,7 @@ void Covariance::init()
     // Load Settings
     QSettings settings("MNECPP");
     m_iEstimationSamples = settings.value(QString("MNESCAN/%1/estimationSamples").arg(this->getName()), 5000).toInt();
+    m_dForgettingFactor = settings.value(QString("MNESCAN/%1/forgettingFactor").arg(this->getName()), 1.0).toDouble();
 
     // Input
     m_pCovarianceInput = PluginInputData<RealTimeMultiSampleArray>::create(this, "CovarianceIn", "Covariance input data");
@@ -135,6 +137,9 @@ void Covariance::initPluginControlWidgets()
                 this, &Covariance::changeSamples);
         pCovarianceWidget->setMinSamples(m_pFiffInfo->sfreq);
         pCovarianceWidget->setCurrentSamples(m_iEstimationSamples);
+        pCovarianceWidget->setCurrentForgettingFactor(m_dForgettingFactor);
+        connect(pCovarianceWidget, &CovarianceSettingsView::forgettingFactorChanged,
+                this, &Covariance::changeForgettingFactor);
         pCovarianceWidget->setObjectName("group_Settings");
         plControlWidgets.append(pCovarianceWidget);
 
@@ -151,6 +156,7 @@ void Covariance::unload()
     // Save Settings
     QSettings settings("MNECPP");
     settings.setValue(QString("MNESCAN/%1/estimationSamples").arg(this->getName()), m_iEstimationSamples);
+    settings.setValue(QString("MNESCAN/%1/forgettingFactor").arg(this->getName()), m_dForgettingFactor);
 }
 
 //=============================================================================================================
@@ -239,6 +245,14 @@ void Covariance::changeSamples(qint32 samples)
 
 //=============================================================================================================
 
+void Covariance::changeForgettingFactor(double dForgettingFactor)
+{
+    QMutexLocker locker(&m_mutex);
+    m_dForgettingFactor = dForgettingFactor;
+}
+
+//=============================================================================================================
+
 void Covariance::run()
 {
     // Wait for fiff info
@@ -256,8 +270,10 @@ void Covariance::run()
     FiffCov fiffCov;
     m_mutex.lock();
     int iEstimationSamples = m_iEstimationSamples;
+    double dForgettingFactor = m_dForgettingFactor;
     m_mutex.unlock();
     RTPROCESSINGLIB::RtCov rtCov(m_pFiffInfo);
+    rtCov.setForgettingFactor(dForgettingFactor);
 
     // Start processing data
     while(!isInterruptionRequested()) {
@@ -265,8 +281,15 @@ void Covariance::run()
         if(m_pCircularBuffer->pop(matData)) {
             m_mutex.lock();
             iEstimationSamples = m_iEstimationSamples;
+            dForgettingFactor = m_dForgettingFactor;
             m_mutex.unlock();
 
+            // Changing the forgetting factor starts a new estimate, the accumulated weights do not match anymore
+            if(dForgettingFactor != rtCov.getForgettingFactor()) {
+                rtCov.setForgettingFactor(dForgettingFactor);
+                rtCov.reset();
+            }
+
             fiffCov = rtCov.estimateCovariance(matData, iEstimationSamples);
             if(!fiffCov.names.isEmpty()) {
                 m_pCovarianceOutput->data()->setValue(fiffCov);
@@ -43,7 +43,7 @@
 #include "covariance_global.h"
 
 #include <scShared/Interfaces/IAlgorithm.h>
-#include <utils/generics/circularbuffer.h>
+#include <utils/generics/ringbuffer.h>
 
 //=============================================================================================================
 // EIGEN INCLUDES
@@ -148,14 +148,23 @@ public:
 
     void changeSamples(qint32 samples);
 
+    //=========================================================================================================
+    /**
+     * Sets the per sample forgetting factor of the running covariance.
+     *
+     * @param[in] dForgettingFactor     The forgetting factor in (0, 1]. 1 disables forgetting.
+     */
+    void changeForgettingFactor(double dForgettingFactor);
+
 protected:
     virtual void run();
 
 private:
     QMutex      m_mutex;
     qint32      m_iEstimationSamples;
+    double      m_dForgettingFactor;        /**< Per sample forgetting factor of the running covariance. 1 disables forgetting. */
 
-    IOBUFFER::CircularBuffer_Matrix_double::SPtr        m_pCircularBuffer;              /**< Matrix data circular buffer */
+    IOBUFFER::RingBuffer_Matrix_double::SPtr            m_pCircularBuffer;              /**< Matrix data ring buffer */
 
     QSharedPointer<FIFFLIB::FiffInfo>                   m_pFiffInfo;                    /**< Fiff measurement info.*/
 
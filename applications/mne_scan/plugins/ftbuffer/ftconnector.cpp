@@ -55,6 +55,49 @@
 
 using namespace FTBUFFERPLUGIN;
 
+//=============================================================================================================
+// DEFINE STATIC FUNCTIONS
+//=============================================================================================================
+
+/**
+ * The buffer sends the samples multiplexed, i.e. all channels of a sample next to each other. This is the column
+ * major layout of a channels x samples matrix, so the data is converted without an explicit transpose.
+ */
+template<typename T>
+static void decodeSamples(const char* pData,
+                          int iNumChannels,
+                          int iNumSamples,
+                          Eigen::MatrixXd& matData)
+{
+    typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> MatrixT;
+    matData = Eigen::Map<const MatrixT>(reinterpret_cast<const T*>(pData), iNumChannels, iNumSamples).template cast<double>();
+}
+
+//=============================================================================================================
+
+static int sizeOfDataType(int iDataType)
+{
+    switch (iDataType) {
+        case DATATYPE_CHAR:
+        case DATATYPE_UINT8:
+        case DATATYPE_INT8:
+            return 1;
+        case DATATYPE_UINT16:
+        case DATATYPE_INT16:
+            return 2;
+        case DATATYPE_UINT32:
+        case DATATYPE_INT32:
+        case DATATYPE_FLOAT32:
+            return 4;
+        case DATATYPE_UINT64:
+        case DATATYPE_INT64:
+        case DATATYPE_FLOAT64:
+            return 8;
+        default:
+            return 0;
+    }
+}
+
 //=============================================================================================================
 // DEFINE MEMBER METHODS
 //=============================================================================================================
@@ -62,12 +105,18 @@ using namespace FTBUFFERPLUGIN;
 FtConnector::FtConnector()
 :m_iNumSamples(0)
 ,m_iNumNewSamples(0)
+,m_iMsgSamples(0)
+,m_iMsgChannels(0)
+,m_iMsgDataType(DATATYPE_FLOAT32)
 ,m_iNumChannels(0)
+,m_iDataType(DATATYPE_FLOAT32)
 ,m_iPort(1972)
 ,m_bNewData(false)
+,m_bWaitPending(false)
 ,m_fSampleFreq(0)
 ,m_sAddress("127.0.0.1")
 ,m_pSocket(Q_NULLPTR)
+,m_iMsgLatencyNsecs(0)
 {
 }
 
@@ -120,6 +169,7 @@ bool FtConnector::getHeader()
     qInfo() << "[FtConnector::getHeader] Attempting to get header...";
 
     m_pSocket->readAll(); //Ensure receiving buffer is empty
+    m_bWaitPending = false;
 
     // Defining parameters to send a get header message to buffer
     messagedef_t messagedef;
@@ -208,7 +258,7 @@ bool FtConnector::parseHeaderDef(QBuffer &readBuffer)
 
     qInfo() << "[FtConnector::parseHeaderDef] Got header parameters.";
 
-    if (m_iDataType != 9) {
+    if (m_iDataType == DATATYPE_CHAR || sizeOfDataType(m_iDataType) == 0) {
         qCritical() << "Data type not supported. Plugin will not behave correctly.";
     }
 
@@ -261,7 +311,7 @@ bool FtConnector::getData()
         return false;
     }
 
-    m_pSocket->readAll(); //Ensure receiving buffer is empty
+    m_msgTimer.start();
 
     // Get data message + data selection params
     messagedef_t messagedef;
@@ -276,36 +326,47 @@ bool FtConnector::getData()
     sendDataSel(datasel);
 
     //Waiting for response.
-    while(static_cast<unsigned long>(m_pSocket->bytesAvailable()) < sizeof (messagedef_t)) {
-        m_pSocket->waitForReadyRead(10);
-    }
+    waitForBytes(sizeof (messagedef_t));
 
     //Parse return message from buffer
     QBuffer msgBuffer;
     prepBuffer(msgBuffer, sizeof (messagedef_t));
     int bufsize = parseMessageDef(msgBuffer);
 
-    //Waiting for response.
-    while(m_pSocket->bytesAvailable() < bufsize) {
-        m_pSocket->waitForReadyRead(10);
+    if (bufsize < static_cast<int>(sizeof (datadef_t))) {
+        // GET_ERR, the samples are not in the buffer (anymore)
+        qWarning() << "[FtConnector::getData] Buffer did not return the requested samples.";
+        waitForBytes(bufsize);
+        m_pSocket->read(bufsize);
+        m_iNumSamples = m_iNumNewSamples;
+        return false;
     }
 
+    //Waiting for response.
+    waitForBytes(bufsize);
+
     //Parse return data def from buffer
     QBuffer datadefBuffer;
     prepBuffer(datadefBuffer, sizeof (datadef_t));
     bufsize = parseDataDef(datadefBuffer);
 
-    //Parse actual data from buffer
-    QBuffer datasampBuffer;
-    prepBuffer(datasampBuffer, bufsize);
-    parseData(datasampBuffer, bufsize);
+    //Read actual data from buffer into the reused container
+    m_dataArray.resize(bufsize);
+    m_pSocket->read(m_dataArray.data(), bufsize);
 
     //update sample tracking
     m_iNumSamples = m_iNumNewSamples;
 
+    //Ask for the next samples, the buffer answers while we parse
+    sendWaitRequest();
+
+    parseData(m_dataArray);
+
+    m_iMsgLatencyNsecs = m_msgTimer.nsecsElapsed();
+
     //echoStatus();
 
-    return true;
+    return m_bNewData;
 }
 
 //=============================================================================================================
@@ -369,6 +430,8 @@ int FtConnector::parseDataDef(QBuffer &dataBuffer)
 //    }
 
     m_iMsgSamples = datadef.nsamples;
+    m_iMsgChannels = datadef.nchans;
+    m_iMsgDataType = datadef.data_type;
 
     return datadef.bufsize;
 }
@@ -393,6 +456,7 @@ void FtConnector::echoStatus()
     qInfo() << "| Frequency:   " << m_fSampleFreq;
     qInfo() << "| Samples read:" << m_iNumSamples;
     qInfo() << "| New samples: " << m_iNumNewSamples;
+    qInfo() << "| Latency (us):" << m_iMsgLatencyNsecs / 1000;
     qInfo() << "|================================";
 }
 
@@ -400,8 +464,39 @@ void FtConnector::echoStatus()
 
 int FtConnector::totalBuffSamples()
 {
-    m_pSocket->readAll(); //Ensure receiving buffer is empty
+    if (!m_bWaitPending) {
+        sendWaitRequest();
+    }
+
+    //Waiting for response.
+    waitForBytes(sizeof (messagedef_t));
+
+    //Parse return message from buffer
+    QBuffer msgBuffer;
+    prepBuffer(msgBuffer, sizeof (messagedef_t));
+    parseMessageDef(msgBuffer);
+
+    //Waiting for response.
+    waitForBytes(sizeof (samples_events_t));
+
+    m_bWaitPending = false;
+
+    qint32 iNumSamp;
+
+    QBuffer sampeventsBuffer;
+    prepBuffer(sampeventsBuffer, sizeof(samples_events_t));
+
+    char cSamps[sizeof(iNumSamp)];
+    sampeventsBuffer.read(cSamps, sizeof(iNumSamp));
+    std::memcpy(&iNumSamp, cSamps, sizeof(iNumSamp));
+
+    return iNumSamp;
+}
+
+//=============================================================================================================
 
+void FtConnector::sendWaitRequest()
+{
     messagedef_t messagedef;
     messagedef.bufsize = sizeof(samples_events_t) + sizeof (qint32);
     messagedef.command = WAIT_DAT;
@@ -417,32 +512,18 @@ int FtConnector::totalBuffSamples()
     sendRequest(messagedef);
     sendSampleEvents(threshold);
     m_pSocket->write(reinterpret_cast<char*>(&timeout), sizeof (qint32));
+    m_pSocket->flush();
 
-    //Waiting for response.
-    while(static_cast<quint64>(m_pSocket->bytesAvailable()) < sizeof (messagedef_t)) {
-        m_pSocket->waitForReadyRead(10);
-    }
+    m_bWaitPending = true;
+}
 
-    //Parse return message from buffer
-    QBuffer msgBuffer;
-    prepBuffer(msgBuffer, sizeof (messagedef_t));
-    parseMessageDef(msgBuffer);
+//=============================================================================================================
 
-    //Waiting for response.
-    while(static_cast<quint64>(m_pSocket->bytesAvailable()) < sizeof (samples_events_t)) {
+void FtConnector::waitForBytes(qint64 numBytes)
+{
+    while(m_pSocket->bytesAvailable() < numBytes) {
         m_pSocket->waitForReadyRead(10);
     }
-
-    qint32 iNumSamp;
-
-    QBuffer sampeventsBuffer;
-    prepBuffer(sampeventsBuffer, sizeof(samples_events_t));
-
-    char cSamps[sizeof(iNumSamp)];
-    sampeventsBuffer.read(cSamps, sizeof(iNumSamp));
-    std::memcpy(&iNumSamp, cSamps, sizeof(iNumSamp));
-
-    return iNumSamp;
 }
 
 //=============================================================================================================
@@ -455,41 +536,57 @@ void FtConnector::sendSampleEvents(samples_events_t &threshold)
 
 //=============================================================================================================
 
-bool FtConnector::parseData(QBuffer &datasampBuffer,
-                            int bufsize)
+bool FtConnector::parseData(const QByteArray &dataArray)
 {
-    Q_UNUSED(bufsize)
-    //start interpreting data as float instead of char
-    QByteArray dataArray = datasampBuffer.readAll();
-    float* fdata = reinterpret_cast<float*> (dataArray.data());
-
-//TODO: Implement receiving other types of data
-//    switch (m_iDataType) {
-//        case DATATYPE_FLOAT32:
-//            auto data = reinterpret_cast<float*>(dataArray.data(), bufsize);
-//            qDebug() << "*** Would you look at that, we're all the way here ***";
-//            qDebug() << "Data sample:";
-
-//            for (int i = 0; i < 10 ; i++) {
-//                qDebug() << data[i];
-//            }
-//            break;
-//    }
+    const int iTypeSize = sizeOfDataType(m_iMsgDataType);
+
+    if (iTypeSize == 0 || m_iMsgDataType == DATATYPE_CHAR) {
+        qWarning() << "[FtConnector::parseData] Data type" << m_iMsgDataType << "not supported.";
+        return false;
+    }
+
+    if (static_cast<qint64>(m_iMsgChannels) * m_iMsgSamples * iTypeSize > dataArray.size()) {
+        qWarning() << "[FtConnector::parseData] Received less data than announced.";
+        return false;
+    }
 
     //format data into eigen matrix to pass up
-    Eigen::MatrixXf matData;
-    matData.resize(m_iNumChannels, m_iMsgSamples);
-
-    int count = 0;
-    for (int i = 0; i < int (m_iMsgSamples); i++) {
-        for (int j = 0; j < int (m_iNumChannels); j++) {
-            matData(j,i) = fdata[count];
-            count++;
-        }
+    const char* pData = dataArray.constData();
+
+    switch (m_iMsgDataType) {
+        case DATATYPE_UINT8:
+            decodeSamples<quint8>(pData, m_iMsgChannels, m_iMsgSamples, m_matEmit);
+            break;
+        case DATATYPE_UINT16:
+            decodeSamples<quint16>(pData, m_iMsgChannels, m_iMsgSamples, m_matEmit);
+            break;
+        case DATATYPE_UINT32:
+            decodeSamples<quint32>(pData, m_iMsgChannels, m_iMsgSamples, m_matEmit);
+            break;
+        case DATATYPE_UINT64:
+            decodeSamples<quint64>(pData, m_iMsgChannels, m_iMsgSamples, m_matEmit);
+            break;
+        case DATATYPE_INT8:
+            decodeSamples<qint8>(pData, m_iMsgChannels, m_iMsgSamples, m_matEmit);
+            break;
+        case DATATYPE_INT16:
+            decodeSamples<qint16>(pData, m_iMsgChannels, m_iMsgSamples, m_matEmit);
+            break;
+        case DATATYPE_INT32:
+            decodeSamples<qint32>(pData, m_iMsgChannels, m_iMsgSamples, m_matEmit);
+            break;
+        case DATATYPE_INT64:
+            decodeSamples<qint64>(pData, m_iMsgChannels, m_iMsgSamples, m_matEmit);
+            break;
+        case DATATYPE_FLOAT32:
+            decodeSamples<float>(pData, m_iMsgChannels, m_iMsgSamples, m_matEmit);
+            break;
+        case DATATYPE_FLOAT64:
+            decodeSamples<double>(pData, m_iMsgChannels, m_iMsgSamples, m_matEmit);
+            break;
     }
 
-    //store and flag new data
-    m_pMatEmit = new Eigen::MatrixXd(matData.cast<double>());
+    //flag new data
     m_bNewData = true;
 
     return m_bNewData;
@@ -500,8 +597,6 @@ bool FtConnector::parseData(QBuffer &datasampBuffer,
 void FtConnector::resetEmitData()
 {
     m_bNewData = false;
-    delete m_pMatEmit;
-    m_pMatEmit = Q_NULLPTR;
 }
 
 //=============================================================================================================
@@ -516,9 +611,16 @@ bool FtConnector::disconnect()
 
 //=============================================================================================================
 
-Eigen::MatrixXd FtConnector::getMatrix()
+const Eigen::MatrixXd& FtConnector::getMatrix() const
+{
+    return m_matEmit;
+}
+
+//=============================================================================================================
+
+qint64 FtConnector::getMsgLatencyNsecs() const
 {
-    return *m_pMatEmit;
+    return m_iMsgLatencyNsecs;
 }
 
 //=============================================================================================================
@@ -58,6 +58,8 @@
 #include <QBuffer>
 #include <QThread>
 #include <QFile>
+#include <QByteArray>
+#include <QElapsedTimer>
 
 //=============================================================================================================
 // EIGEN INCLUDES
@@ -98,6 +100,18 @@ namespace FTBUFFERPLUGIN
 #define PUT_DAT_NORESPONSE static_cast<qint16>(0x0502) /* decimal 1282 */
 #define PUT_EVT_NORESPONSE static_cast<qint16>(0x0503) /* decimal 1283 */
 
+#define DATATYPE_CHAR    static_cast<qint32>(0)
+#define DATATYPE_UINT8   static_cast<qint32>(1)
+#define DATATYPE_UINT16  static_cast<qint32>(2)
+#define DATATYPE_UINT32  static_cast<qint32>(3)
+#define DATATYPE_UINT64  static_cast<qint32>(4)
+#define DATATYPE_INT8    static_cast<qint32>(5)
+#define DATATYPE_INT16   static_cast<qint32>(6)
+#define DATATYPE_INT32   static_cast<qint32>(7)
+#define DATATYPE_INT64   static_cast<qint32>(8)
+#define DATATYPE_FLOAT32 static_cast<qint32>(9)
+#define DATATYPE_FLOAT64 static_cast<qint32>(10)
+
 //=============================================================================================================
 // STRUCT DEFINITIONS
 //=============================================================================================================
@@ -188,7 +202,8 @@ public:
 
     //=========================================================================================================
     /**
-     * equests and receives data from buffer, parses it, and stores it in m_pMatEmit
+     * Requests and receives data from buffer, parses it, and stores it in m_matEmit. The request for the next
+     * sample count is sent before the data is parsed, so that the buffer answers it in the meantime.
      *
      * @return true if successful, false if unsuccessful
      */
@@ -238,11 +253,19 @@ public:
 
     //=========================================================================================================
     /**
-     * Returns member m_pMatEmit, newest buffer data formatted as an Eigen MatrixXd
+     * Returns member m_matEmit, newest buffer data formatted as an Eigen MatrixXd
+     *
+     * @return returns m_matEmit
+     */
+    const Eigen::MatrixXd& getMatrix() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the time between requesting the newest data and having it parsed into m_matEmit
      *
-     * @return returns m_pMatEmit
+     * @return returns the latency of the newest data message in nanoseconds
      */
-    Eigen::MatrixXd getMatrix();
+    qint64 getMsgLatencyNsecs() const;
 
     //=========================================================================================================
     /**
@@ -254,7 +277,7 @@ public:
 
     //=========================================================================================================
     /**
-     * Sets m_bNewData to false, deletes m_pMatEmit
+     * Sets m_bNewData to false. m_matEmit is kept to be reused by the next message.
      */
     void resetEmitData();
 
@@ -329,15 +352,27 @@ private:
 
     //=========================================================================================================
     /**
-     * Parses sample data received from buffer, formates it and saves it to m_pMatEmit;
+     * Parses sample data received from buffer, converts it from its data type and saves it to m_matEmit
      *
-     * @param[in] datasampBuffer    QBuffer with return data from buffer
-     * @param[in] bufsize           Buffer size of sample data
+     * @param[in] dataArray     Sample data from buffer, sample-major as sent by the buffer
      *
      * @return true if successful, false if unsuccessful
      */
-    bool parseData(QBuffer &datasampBuffer,
-                   int bufsize);
+    bool parseData(const QByteArray &dataArray);
+
+    //=========================================================================================================
+    /**
+     * Sends a WAIT_DAT request for samples beyond m_iNumSamples. The response is read by totalBuffSamples.
+     */
+    void sendWaitRequest();
+
+    //=========================================================================================================
+    /**
+     * Blocks until numBytes can be read from the socket
+     *
+     * @param[in] numBytes      How many bytes to wait for
+     */
+    void waitForBytes(qint64 numBytes);
 
     //=========================================================================================================
     /**
@@ -360,12 +395,15 @@ private:
     int                                     m_iNumSamples;                          /**< Number of samples we've read from the buffer */
     int                                     m_iNumNewSamples;                       /**< Number of total samples (read and unread) in the buffer */
     int                                     m_iMsgSamples;                          /**< Number of samples in the latest buffer transmission receied */
+    int                                     m_iMsgChannels;                         /**< Number of channels in the latest buffer transmission receied */
+    int                                     m_iMsgDataType;                         /**< Type of data in the latest buffer transmission receied */
     int                                     m_iNumChannels;                         /**< Number of channels in the buffer data */
     int                                     m_iDataType;                            /**< Type of data in the buffer */
     int                                     m_iNeuromagHeader;                      /**< Size of neuromag header chunk */
     quint16                                 m_iPort;                                /**< Port where the ft bufferis found */
 
     bool                                    m_bNewData;                             /**< Indicate whether we've received new data */
+    bool                                    m_bWaitPending;                         /**< Indicate whether a WAIT_DAT request was sent and not answered yet */
 
     float                                   m_fSampleFreq;                          /**< Sampling frequency of data in the buffer */
 
@@ -373,7 +411,11 @@ private:
 
     QTcpSocket*                             m_pSocket;                              /**< Socket that manages the connection to the ft buffer */
 
-    Eigen::MatrixXd*                        m_pMatEmit;                             /**< Container to format data to tansmit to FtBuffProducer */
+    QByteArray                              m_dataArray;                            /**< Reused container for the raw sample data received from the buffer */
+    Eigen::MatrixXd                         m_matEmit;                              /**< Container to format data to tansmit to FtBuffProducer */
+
+    QElapsedTimer                           m_msgTimer;                             /**< Measures the time from the data request until the data is parsed */
+    qint64                                  m_iMsgLatencyNsecs;                     /**< Latency of the latest data message in nanoseconds */
 };
 
 }//namespace end bracket
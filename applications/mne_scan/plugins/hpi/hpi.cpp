@@ -545,6 +545,8 @@ void Hpi::run()
                            fitResult.GoF,
                            fitResult.fittedCoils,
                            m_pFiffInfo);
+                HPI.getLastFitReport(fitResult.vecNumIterations,
+                                     fitResult.fFitDuration);
                 m_mutex.unlock();
 
                 //Check if the error meets distance requirement
@@ -38,12 +38,14 @@
 
 #include "lsladapterproducer.h"
 
+#include <algorithm>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
 
 #include <QDebug>
-#include <QThread>
+#include <QMutexLocker>
 
 //=============================================================================================================
 // EIGEN INCLUDES
@@ -57,6 +59,12 @@ using namespace LSLADAPTERPLUGIN;
 using namespace SCSHAREDLIB;
 using namespace SCMEASLIB;
 
+//=============================================================================================================
+// DEFINE STATIC FUNCTIONS
+//=============================================================================================================
+
+static const double PULL_TIMEOUT_SECS = 0.1;    /**< How long a pull waits for samples before checking whether to stop. */
+
 //=============================================================================================================
 // DEFINE MEMBER METHODS
 //=============================================================================================================
@@ -70,7 +78,8 @@ LSLAdapterProducer::LSLAdapterProducer(QSharedPointer<PluginOutputData<RealTimeM
 , m_bHasStreamInfo(false)
 , m_bIsRunning(false)
 , m_iOutputBlockSize(iOutputBlockSize)
-, m_vBufferedSamples()
+, m_matBlock()
+, m_vecTimestamps()
 , m_pRTMSA(pRTMSA)
 {
 }
@@ -101,38 +110,51 @@ void LSLAdapterProducer::readStream()
         qDebug() << "[LSLAdapterProducer::readStream] Something went wrong when trying to open LSL stream inlet: " << e.what();
     }
 
-    m_bIsRunning = true;
-    while(m_bIsRunning) {
-        try {
-            if(m_StreamInlet->samples_available() == false) {
-                // save CPU time, then check again
-                QThread::msleep(5);
-                continue;
-            }
-            std::vector<std::vector<float>> chunk = m_StreamInlet->pull_chunk<float>();
+    // map the timestamps to the local clock, so that they can be compared to lsl::local_clock()
+    try {
+        m_StreamInlet->set_postprocessing(lsl::post_clocksync);
+    }
+    catch (std::exception& e) {
+        qDebug() << "[LSLAdapterProducer::readStream] Could not enable clock synchronization: " << e.what();
+    }
 
-            // append chunk to buffer
-            m_vBufferedSamples.insert(std::end(m_vBufferedSamples), std::begin(chunk), std::end(chunk));
+    const int iChannels = m_StreamInfo.channel_count();
+    const int iBlockSize = m_iOutputBlockSize;
+    int iFilledSamples = 0;
 
-            // check if we can output another block
-            if(m_vBufferedSamples.size() >= m_iOutputBlockSize) {
-                Eigen::MatrixXd matOutput(m_StreamInfo.channel_count(), m_iOutputBlockSize);
+    if(iChannels <= 0 || iBlockSize <= 0) {
+        qDebug() << "[LSLAdapterProducer::readStream] Stream has no channels or the block size is invalid !";
+        emit finished();
+        return;
+    }
 
-                // copy samples
-                for(int iSampleIdx = 0; iSampleIdx < m_iOutputBlockSize; ++iSampleIdx) {
-                    for(int iChannelIdx = 0; iChannelIdx < m_StreamInfo.channel_count(); ++iChannelIdx) {
-                        matOutput(iChannelIdx, iSampleIdx) = static_cast<double>(m_vBufferedSamples[iSampleIdx][iChannelIdx]);
-                    }
-                }
+    m_matBlock.resize(iChannels, iBlockSize);
+    m_vecTimestamps.resize(iBlockSize);
 
-                // remove copied samples
-                for(int i = 0; i < m_iOutputBlockSize; ++i) {
-                    m_vBufferedSamples.erase(m_vBufferedSamples.begin());
-                }
+    m_statisticsMutex.lock();
+    m_statistics = Statistics();
+    m_statisticsMutex.unlock();
 
-                // publish new block
-                m_pRTMSA->data()->setValue(matOutput);
+    m_bIsRunning = true;
+    while(m_bIsRunning) {
+        try {
+            // pull the missing samples of the block directly into place. Returns as soon as the block is full,
+            // or after the timeout so that stop() is noticed.
+            const std::size_t iElements = m_StreamInlet->pull_chunk_multiplexed(m_matBlock.data() + iFilledSamples * iChannels,
+                                                                                m_vecTimestamps.data() + iFilledSamples,
+                                                                                (iBlockSize - iFilledSamples) * iChannels,
+                                                                                iBlockSize - iFilledSamples,
+                                                                                PULL_TIMEOUT_SECS);
+            iFilledSamples += static_cast<int>(iElements) / iChannels;
+
+            if(iFilledSamples < iBlockSize) {
+                continue;
             }
+            iFilledSamples = 0;
+
+            // publish new block
+            m_pRTMSA->data()->setValue(m_matBlock.cast<double>());
+            updateStatistics(m_vecTimestamps.back());
         }
         catch (std::exception& e) {
             qDebug() << "[LSLAdapterProducer::readStream] Something went wrong while streaming data: " << e.what();
@@ -140,6 +162,10 @@ void LSLAdapterProducer::readStream()
         }
     }
 
+    Statistics statistics = this->statistics();
+    qDebug() << "[LSLAdapterProducer::readStream] Published" << statistics.iBlocks << "blocks with a mean latency of"
+             << statistics.dMeanLatencySecs * 1000.0 << "ms and a max latency of" << statistics.dMaxLatencySecs * 1000.0 << "ms.";
+
     // cleanup: close stream
     try {
         m_StreamInlet->close_stream();
@@ -174,7 +200,8 @@ void LSLAdapterProducer::reset()
     m_bIsRunning = false;
     m_bHasStreamInfo = false;
     // clear buffer
-    m_vBufferedSamples.clear();
+    m_matBlock.resize(0, 0);
+    m_vecTimestamps.clear();
     // reset lsl members
     m_StreamInfo = lsl::stream_info();
     delete m_StreamInlet;
@@ -187,3 +214,25 @@ void LSLAdapterProducer::setOutputBlockSize(const int iNewBlockSize)
 {
     m_iOutputBlockSize = iNewBlockSize;
 }
+
+//=============================================================================================================
+
+LSLAdapterProducer::Statistics LSLAdapterProducer::statistics() const
+{
+    QMutexLocker locker(&m_statisticsMutex);
+    return m_statistics;
+}
+
+//=============================================================================================================
+
+void LSLAdapterProducer::updateStatistics(double dTimestamp)
+{
+    const double dLatency = lsl::local_clock() - dTimestamp;
+
+    QMutexLocker locker(&m_statisticsMutex);
+
+    ++m_statistics.iBlocks;
+    m_statistics.dMeanLatencySecs += (dLatency - m_statistics.dMeanLatencySecs) / m_statistics.iBlocks;
+    m_statistics.dMaxLatencySecs = std::max(m_statistics.dMaxLatencySecs, dLatency);
+    m_statistics.dLastTimestamp = dTimestamp;
+}
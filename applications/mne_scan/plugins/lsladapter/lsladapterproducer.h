@@ -55,6 +55,7 @@
 
 #include <QObject>
 #include <QVector>
+#include <QMutex>
 
 //=============================================================================================================
 // EIGEN INCLUDES
@@ -88,6 +89,13 @@ class LSLADAPTERSHARED_EXPORT LSLAdapterProducer : public QObject
     Q_OBJECT
 
 public:
+    struct Statistics {
+        qint64  iBlocks = 0;                /**< Number of published blocks. */
+        double  dMeanLatencySecs = 0.0;     /**< Mean age of the newest sample of a block when it is published. */
+        double  dMaxLatencySecs = 0.0;      /**< Maximal age of the newest sample of a block when it is published. */
+        double  dLastTimestamp = 0.0;       /**< LSL timestamp of the newest sample of the last block, in local clock time. */
+    };
+
     //=========================================================================================================
     /**
      * Constructs a LSLAdapterProducer which is a child of parent.
@@ -132,6 +140,12 @@ public:
      */
     void setOutputBlockSize(const int iNewBlockSize);
 
+    //=========================================================================================================
+    /**
+     * Returns the latency statistics of the current stream.
+     */
+    Statistics statistics() const;
+
 public slots:
     //=========================================================================================================
     /**
@@ -148,9 +162,20 @@ private:
     // synchronization with main thread
     volatile bool                   m_bIsRunning;
 
+    //=========================================================================================================
+    /**
+     * Updates the latency statistics with the timestamp of the newest sample of a published block.
+     */
+    void updateStatistics(double dTimestamp);
+
     // buffering and output parameters
     int                             m_iOutputBlockSize;
-    std::vector<std::vector<float>> m_vBufferedSamples;
+    Eigen::MatrixXf                 m_matBlock;             /**< The block being filled, channels x samples. Column major storage matches the multiplexed LSL chunks. */
+    std::vector<double>             m_vecTimestamps;        /**< The LSL timestamps of the samples in m_matBlock. */
+
+    // latency measurement
+    mutable QMutex                  m_statisticsMutex;
+    Statistics                      m_statistics;
     QSharedPointer<SCSHAREDLIB::PluginOutputData<SCMEASLIB::RealTimeMultiSampleArray> > m_pRTMSA;
 
 signals:
@@ -49,6 +49,7 @@
 
 #include <rtprocessing/filter.h>
 #include <rtprocessing/sphara.h>
+#include <rtprocessing/preprocessingpipeline.h>
 
 #include <utils/ioutils.h>
 
@@ -83,13 +84,10 @@ using namespace Eigen;
 //=============================================================================================================
 
 NoiseReduction::NoiseReduction()
-: m_bCompActivated(false)
-, m_bSpharaActive(false)
-, m_bProjActivated(false)
-, m_bFilterActivated(false)
-, m_iMaxFilterLength(1)
+: m_iMaxFilterLength(1)
 , m_iMaxFilterTapSize(-1)
 , m_sCurrentSystem("VectorView")
+, m_pPreprocessing(PreprocessingPipeline::SPtr::create())
 , m_pCircularBuffer(QSharedPointer<IOBUFFER::CircularBuffer_Matrix_double>::create(40))
 , m_pNoiseReductionInput(Q_NULLPTR)
 , m_pNoiseReductionOutput(Q_NULLPTR)
@@ -200,19 +198,6 @@ void NoiseReduction::update(SCMEASLIB::Measurement::SPtr pMeasurement)
         if(!m_pFiffInfo) {
             m_pFiffInfo = pRTMSA->info();
 
-            //Init the multiplication matrices
-            m_matSparseProjMult = SparseMatrix<double>(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
-            m_matSparseCompMult = SparseMatrix<double>(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
-            m_matSparseSpharaMult = SparseMatrix<double>(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
-            m_matSparseProjCompMult = SparseMatrix<double>(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
-            m_matSparseFull = SparseMatrix<double>(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
-
-            m_matSparseProjMult.setIdentity();
-            m_matSparseCompMult.setIdentity();
-            m_matSparseSpharaMult.setIdentity();
-            m_matSparseProjCompMult.setIdentity();
-            m_matSparseFull.setIdentity();
-
             //Init output
             m_pNoiseReductionOutput->data()->initFromFiffInfo(m_pFiffInfo);
             m_pNoiseReductionOutput->data()->setMultiArraySize(1);
@@ -314,7 +299,7 @@ void NoiseReduction::initPluginControlWidgets()
 void NoiseReduction::setSpharaActive(bool state)
 {
     m_mutex.lock();
-    m_bSpharaActive = state;
+    m_pPreprocessing->setSpharaActive(state);
     m_mutex.unlock();
 }
 
@@ -343,46 +328,14 @@ void NoiseReduction::run()
 
     // Init
     MatrixXd matData;
-    QScopedPointer<RTPROCESSINGLIB::FilterOverlapAdd> pRtFilter(new RTPROCESSINGLIB::FilterOverlapAdd());
+    MatrixXd matDataOut;
 
     while(!isInterruptionRequested()) {
         // Get the current data
         if(m_pCircularBuffer->pop(matData)) {
             m_mutex.lock();
-            //Do SSP's and compensators here
-            if(m_bCompActivated) {
-                if(m_bProjActivated) {
-                    //Comp + Proj
-                    matData = m_matSparseProjCompMult * matData;
-                } else {
-                    //Comp
-                    matData = m_matSparseCompMult * matData;
-                }
-            } else {
-                if(m_bProjActivated) {
-                    //Proj
-                    matData = m_matSparseProjMult * matData;
-                } else {
-                    //None - Raw
-                }
-            }
-
-            //Do temporal filtering here
-            if(m_bFilterActivated) {
-                matData = pRtFilter->calculate(matData,
-                                                          m_filterKernel,
-                                                          m_lFilterChannelList);
-            }
-
-            //Do SPHARA here
-            if(m_bSpharaActive) {
-                //Set bad channels to zero so they do not get smeared into
-                for(int i = 0; i < m_pFiffInfo->bads.size(); ++i) {
-                    matData.row(m_pFiffInfo->ch_names.indexOf(m_pFiffInfo->bads.at(i))).setZero();
-                }
-
-                matData = m_matSparseSpharaMult * matData;
-            }
+            //Do compensators, SSP's, temporal filtering and SPHARA in one go
+            m_pPreprocessing->process(matData, matDataOut);
 
     //        //Common average
     //        MatrixXd commonAvr = MatrixXd(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
@@ -410,7 +363,7 @@ void NoiseReduction::run()
 
             //Send the data to the connected plugins and the display
             if(!isInterruptionRequested()) {
-                m_pNoiseReductionOutput->data()->setValue(matData);
+                m_pNoiseReductionOutput->data()->setValue(matDataOut);
             }
         }
     }
@@ -422,12 +375,11 @@ void NoiseReduction::updateProjection(const QList<FIFFLIB::FiffProj>& projs)
 {
     //  Update the SSP projector
     if(m_pFiffInfo) {
-        m_mutex.lock();
-        //If a minimum of one projector is active set m_bProjActivated to true so that this model applies the ssp to the incoming data
-        m_bProjActivated = false;
+        //If a minimum of one projector is active set bProjActivated to true so that the ssp is applied to the incoming data
+        bool bProjActivated = false;
         for(qint32 i = 0; i < projs.size(); ++i) {
             if(projs[i].active) {
-                m_bProjActivated = true;
+                bProjActivated = true;
                 break;
             }
         }
@@ -443,32 +395,8 @@ void NoiseReduction::updateProjection(const QList<FIFFLIB::FiffProj>& projs)
             }
         }
 
-        // Make proj sparse
-        qint32 nchan = this->m_pFiffInfo->nchan;
-        qint32 i, k;
-
-        typedef Eigen::Triplet<double> T;
-        std::vector<T> tripletList;
-        tripletList.reserve(nchan);
-
-        tripletList.clear();
-        tripletList.reserve(matProj.rows()*matProj.cols());
-        for(i = 0; i < matProj.rows(); ++i) {
-            for(k = 0; k < matProj.cols(); ++k) {
-                if(matProj(i,k) != 0) {
-                    tripletList.push_back(T(i, k, matProj(i,k)));
-                }
-            }
-        }
-
-        m_matSparseProjMult = SparseMatrix<double>(matProj.rows(),matProj.cols());
-        if(tripletList.size() > 0)
-            m_matSparseProjMult.setFromTriplets(tripletList.begin(), tripletList.end());
-
-        //Create full multiplication matrix
-        m_matSparseProjCompMult = m_matSparseProjMult * m_matSparseCompMult;
-
-        m_matSparseFull = m_matSparseProjMult * m_matSparseCompMult;
+        m_mutex.lock();
+        m_pPreprocessing->setProjector(matProj, bProjActivated);
         m_mutex.unlock();
     }
 }
@@ -480,51 +408,14 @@ void NoiseReduction::updateCompensator(int to)
     // Update the compensator
     if(m_pFiffInfo)
     {
-        if(to == 0) {
-            m_bCompActivated = false;
-        } else {
-            m_bCompActivated = true;
-        }
-
-//        qDebug()<<"to"<<to;
-//        qDebug()<<"from"<<from;
-//        qDebug()<<"m_bCompActivated"<<m_bCompActivated;
-
         FiffCtfComp newComp;
         this->m_pFiffInfo->make_compensator(0, to, newComp);//Do this always from 0 since we always read new raw data, we never actually perform a multiplication on already existing data
 
         this->m_pFiffInfo->set_current_comp(to);
-        MatrixXd matComp = newComp.data->data;
-
-        //
-        // Make proj sparse
-        //
-        qint32 nchan = this->m_pFiffInfo->nchan;
-        qint32 i, k;
-
-        typedef Eigen::Triplet<double> T;
-        std::vector<T> tripletList;
-        tripletList.reserve(nchan);
-
-        tripletList.clear();
-        tripletList.reserve(matComp.rows()*matComp.cols());
-        for(i = 0; i < matComp.rows(); ++i) {
-            for(k = 0; k < matComp.cols(); ++k) {
-                if(matComp(i,k) != 0) {
-                    tripletList.push_back(T(i, k, matComp(i,k)));
-                }
-            }
-        }
-
-        m_matSparseCompMult = SparseMatrix<double>(matComp.rows(),matComp.cols());
-        if(tripletList.size() > 0) {
-            m_matSparseCompMult.setFromTriplets(tripletList.begin(), tripletList.end());
-        }
-
-        //Create full multiplication matrix
-        m_matSparseProjCompMult = m_matSparseProjMult * m_matSparseCompMult;
 
-        m_matSparseFull = m_matSparseProjMult * m_matSparseCompMult;
+        m_mutex.lock();
+        m_pPreprocessing->setCompensator(newComp.data->data, to != 0);
+        m_mutex.unlock();
     }
 }
 
@@ -553,6 +444,8 @@ void NoiseReduction::setFilterChannelType(QString sType)
             }
         }
     }
+
+    m_pPreprocessing->setFilter(m_filterKernel, m_lFilterChannelList);
     m_mutex.unlock();
 }
 
@@ -567,6 +460,8 @@ void NoiseReduction::setFilter(const FilterKernel& filterData)
     if(m_iMaxFilterLength < m_filterKernel.getFilterOrder()) {
         m_iMaxFilterLength = m_filterKernel.getFilterOrder();
     }
+
+    m_pPreprocessing->setFilter(m_filterKernel, m_lFilterChannelList);
     m_mutex.unlock();
 }
 
@@ -574,7 +469,9 @@ void NoiseReduction::setFilter(const FilterKernel& filterData)
 
 void NoiseReduction::setFilterActive(bool state)
 {
-    m_bFilterActivated = state;
+    m_mutex.lock();
+    m_pPreprocessing->setFilterActive(state);
+    m_mutex.unlock();
 }
 
 //=============================================================================================================
@@ -707,10 +604,19 @@ void NoiseReduction::createSpharaOperator()
         matSparseSpharaMultSecond.setFromTriplets(tripletList.begin(), tripletList.end());
     }
 
-    //Create full multiplication matrix
-    m_matSparseSpharaMult = matSparseSpharaMultFirst * matSparseSpharaMultSecond;
+    //Set bad channels to zero before SPHARA so they do not get smeared into the other channels
+    RowVectorXi vecBadIdcs(0);
+    for(int j = 0; j < m_pFiffInfo->bads.size(); ++j) {
+        int index = m_pFiffInfo->ch_names.indexOf(m_pFiffInfo->bads.at(j));
+        if(index >= 0) {
+            vecBadIdcs.conservativeResize(vecBadIdcs.cols() + 1);
+            vecBadIdcs[vecBadIdcs.cols()-1] = index;
+        }
+    }
 
-    m_matSparseFull = m_matSparseProjMult * m_matSparseCompMult;
+    //Create full multiplication matrix
+    m_pPreprocessing->setSpharaOperator(matSparseSpharaMultFirst * matSparseSpharaMultSecond);
+    m_pPreprocessing->setBadChannels(vecBadIdcs);
 
     m_mutex.unlock();
 }
@@ -70,6 +70,7 @@ namespace FIFFLIB{
 
 namespace RTPROCESSINGLIB{
     class Filter;
+    class PreprocessingPipeline;
 }
 
 namespace SCMEASLIB{
@@ -220,11 +221,6 @@ protected:
 private:
     QMutex                          m_mutex;                                    /**< The threads mutex.*/
 
-    bool                            m_bCompActivated;                           /**< Compensator activated */
-    bool                            m_bSpharaActive;                            /**< Flag whether thread is running.*/
-    bool                            m_bProjActivated;                           /**< Projections activated */
-    bool                            m_bFilterActivated;                         /**< Projections activated */
-
     int                             m_iNBaseFctsFirst;                          /**< The number of grad/inner base functions to use for calculating the sphara opreator.*/
     int                             m_iNBaseFctsSecond;                         /**< The number of grad/outer base functions to use for calculating the sphara opreator.*/
     int                             m_iMaxFilterLength;                         /**< Max order of the current filters */
@@ -241,12 +237,6 @@ private:
     Eigen::VectorXi                 m_vecIndicesSecondBabyMEG;                  /**< The indices of the channels to pick for the second SPHARA oerpator in case of a BabyMEG system.*/
     Eigen::VectorXi                 m_vecIndicesFirstEEG;                       /**< The indices of the channels to pick for the second SPHARA operator in case of an EEG system.*/
 
-    Eigen::SparseMatrix<double>     m_matSparseSpharaMult;                      /**< The final sparse SPHARA operator .*/
-    Eigen::SparseMatrix<double>     m_matSparseProjCompMult;                    /**< The final sparse projection + compensator operator.*/
-    Eigen::SparseMatrix<double>     m_matSparseProjMult;                        /**< The final sparse SSP projector */
-    Eigen::SparseMatrix<double>     m_matSparseCompMult;                        /**< The final sparse compensator matrix */
-    Eigen::SparseMatrix<double>     m_matSparseFull;                            /**< The final sparse full multiplication matrix  */
-
     Eigen::MatrixXd                 m_matSpharaVVGradLoaded;                    /**< The loaded VectorView gradiometer basis functions.*/
     Eigen::MatrixXd                 m_matSpharaVVMagLoaded;                     /**< The loaded VectorView magnetometer basis functions.*/
     Eigen::MatrixXd                 m_matSpharaBabyMEGInnerLoaded;              /**< The loaded babyMEG inner layer basis functions.*/
@@ -257,6 +247,8 @@ private:
 
     QSharedPointer<FIFFLIB::FiffInfo>                               m_pFiffInfo;            /**< Fiff measurement info.*/
 
+    QSharedPointer<RTPROCESSINGLIB::PreprocessingPipeline>          m_pPreprocessing;       /**< Applies compensator, projector, filter and SPHARA with precomposed operators. */
+
     QSharedPointer<IOBUFFER::CircularBuffer_Matrix_double>          m_pCircularBuffer;      /**< Holds incoming raw data. */
 
     SCSHAREDLIB::PluginInputData<SCMEASLIB::RealTimeMultiSampleArray>::SPtr      m_pNoiseReductionInput;      /**< The RealTimeMultiSampleArray of the NoiseReduction input.*/
@@ -93,7 +93,7 @@ using namespace Eigen;
 //=============================================================================================================
 
 RtcMne::RtcMne()
-: m_pCircularMatrixBuffer(CircularBuffer_Matrix_double::SPtr(new CircularBuffer_Matrix_double(40)))
+: m_pCircularMatrixBuffer(RingBuffer_Matrix_double::SPtr::create(40))
 , m_pCircularEvokedBuffer(CircularBuffer<FIFFLIB::FiffEvoked>::SPtr::create(40))
 , m_bEvokedInput(false)
 , m_bRawInput(false)
@@ -572,10 +572,8 @@ void RtcMne::run()
     qint32 skip_count = 0;
     FiffEvoked evoked;
     MatrixXd matData;
-    MatrixXd matDataResized;
-    qint32 j;
+    MatrixXd matSol;
     int iTimePointSps = 0;
-    int iNumberChannels = 0;
     int iDownSample = 1;
     float tstep;
     float lambda2 = 1.0f / pow(1.0f, 2); //ToDo estimate lambda using covariance
@@ -585,7 +583,6 @@ void RtcMne::run()
     bool bUpdateMinimumNorm = false;
     QSharedPointer<INVERSELIB::MinimumNorm> pMinimumNorm;
     QStringList lChNamesFiffInfo;
-    QStringList lChNamesInvOp;
 
     // Start processing data
     while(!isInterruptionRequested()) {
@@ -594,10 +591,8 @@ void RtcMne::run()
         bEvokedInput = m_bEvokedInput;
         bRawInput = m_bRawInput;
         iDownSample = m_iDownSample;
-        iNumberChannels = m_invOp.noise_cov->names.size();
         tstep = 1.0f / m_pFiffInfoInput->sfreq;
         lChNamesFiffInfo = m_pFiffInfoInput->ch_names;
-        lChNamesInvOp = m_invOp.noise_cov->names;
         bUpdateMinimumNorm = m_bUpdateMinimumNorm;
         m_qMutex.unlock();
 
@@ -610,6 +605,9 @@ void RtcMne::run()
             // Set up the inverse according to the parameters.
             // Use 1 nave here because in case of evoked data as input the minimum norm will always be updated when the source estimate is calculated (see run method).
             pMinimumNorm->doInverseSetup(1,true);
+
+            // Cache the channel picking and the noise normalization for the raw data input
+            pMinimumNorm->prepareRealTimeInverse(lChNamesFiffInfo);
         }
 
         //Process data from raw data input
@@ -617,26 +615,24 @@ void RtcMne::run()
             if(((skip_count % iDownSample) == 0)) {
                 // Get the current raw data
                 if(m_pCircularMatrixBuffer->pop(matData)) {
-                    //Pick the same channels as in the inverse operator
-                    matDataResized.resize(iNumberChannels, matData.cols());
-
-                    for(j = 0; j < iNumberChannels; ++j) {
-                        matDataResized.row(j) = matData.row(lChNamesFiffInfo.indexOf(lChNamesInvOp.at(j)));
+                    // The channel picking is cached in the prepared inverse. If only one time point is shown,
+                    // only this sample is projected.
+                    bool bSuccess = false;
+                    float tmin = 0.0f;
+
+                    if(iTimePointSps < matData.cols() && iTimePointSps >= 0) {
+                        tmin = iTimePointSps * tstep;
+                        bSuccess = pMinimumNorm->calculateInverseRealTime(matData.col(iTimePointSps), matSol);
+                    } else {
+                        bSuccess = pMinimumNorm->calculateInverseRealTime(matData, matSol);
                     }
 
-                    //TODO: Add picking here. See evoked part as input.
-                    sourceEstimate = pMinimumNorm->calculateInverse(matDataResized,
-                                                                    0.0f,
-                                                                    tstep,
-                                                                    true);
-
-                    if(!sourceEstimate.isEmpty()) {
-                        if(iTimePointSps < sourceEstimate.data.cols() && iTimePointSps >= 0) {
-                            sourceEstimate = sourceEstimate.reduce(iTimePointSps,1);
-                            m_pRTSEOutput->data()->setValue(sourceEstimate);
-                        } else {
-                            m_pRTSEOutput->data()->setValue(sourceEstimate);
-                        }
+                    if(bSuccess) {
+                        sourceEstimate = MNESourceEstimate(matSol,
+                                                           pMinimumNorm->getRealTimeVertices(),
+                                                           tmin,
+                                                           tstep);
+                        m_pRTSEOutput->data()->setValue(sourceEstimate);
                     }
                 }
             } else {
@@ -105,6 +105,7 @@ RtFwd::RtFwd()
     m_pFwdSettings->include_eeg = true;
     m_pFwdSettings->accurate = true;
     m_pFwdSettings->mindist = 5.0f/1000.0f;
+    m_pFwdSettings->fast_head_pos_update = true;
 
     m_sAtlasDir = QCoreApplication::applicationDirPath() + "/MNE-sample-data/subjects/sample/label";
 }
@@ -38,6 +38,8 @@
 
 #include "writetofilesetupwidget.h"
 
+#include <fiff/fiff_file.h>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
@@ -59,6 +61,15 @@ WriteToFileSetupWidget::WriteToFileSetupWidget(WriteToFile* toolbox, QWidget *pa
 , m_pWriteToFile(toolbox)
 {
     ui.setupUi(this);
+
+    ui.m_qComboBox_DataType->addItem("Float (32 bit)", FIFFT_FLOAT);
+    ui.m_qComboBox_DataType->addItem("Integer (32 bit)", FIFFT_INT);
+    ui.m_qComboBox_DataType->addItem("Short (16 bit)", FIFFT_SHORT);
+    ui.m_qComboBox_DataType->addItem("DAU pack (16 bit)", FIFFT_DAU_PACK16);
+    ui.m_qComboBox_DataType->setCurrentIndex(ui.m_qComboBox_DataType->findData(m_pWriteToFile->getDataType()));
+
+    connect(ui.m_qComboBox_DataType, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+            this, &WriteToFileSetupWidget::onDataTypeChanged);
 }
 
 //=============================================================================================================
@@ -67,3 +78,9 @@ WriteToFileSetupWidget::~WriteToFileSetupWidget()
 {
 }
 
+//=============================================================================================================
+
+void WriteToFileSetupWidget::onDataTypeChanged(int index)
+{
+    m_pWriteToFile->setDataType(ui.m_qComboBox_DataType->itemData(index).toInt());
+}
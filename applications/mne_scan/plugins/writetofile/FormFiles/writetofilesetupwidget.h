@@ -90,6 +90,14 @@ public:
     ~WriteToFileSetupWidget();
 
 private:
+    //=========================================================================================================
+    /**
+     * Sets the storage type selected in the combo box.
+     *
+     * @param[in] index      The index of the selected storage type.
+     */
+    void onDataTypeChanged(int index);
+
 
     WriteToFile* m_pWriteToFile;	/**< Holds a pointer to corresponding WriteToFile.*/
 
@@ -0,0 +1,318 @@
+//=============================================================================================================
+/**
+ * @file     fiffrawwriter.cpp
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    FiffRawWriter class definition.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiffrawwriter.h"
+
+#include <fiff/fiff_stream.h>
+#include <fiff/fiff_file.h>
+
+#include <algorithm>
+
+#if defined(Q_OS_WIN)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QFileDevice>
+#include <QMutexLocker>
+#include <QDebug>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace WRITETOFILEPLUGIN;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FiffRawWriter::FiffRawWriter(int iNumBuffers)
+: m_iDataType(FIFFT_FLOAT)
+, m_syncPolicy(NoSync)
+, m_iSyncIntervalMSecs(1000)
+, m_bWriting(false)
+, m_bStop(false)
+{
+    for(int i = 0; i < std::max(iNumBuffers, 2); ++i) {
+        m_queueFree.enqueue(QByteArray());
+    }
+
+    m_timerStatistics.start();
+}
+
+//=============================================================================================================
+
+FiffRawWriter::~FiffRawWriter()
+{
+    stop();
+}
+
+//=============================================================================================================
+
+void FiffRawWriter::setFormat(fiff_int_t iDataType,
+                              const RowVectorXd& vecCals)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_iDataType = iDataType;
+
+    // Zero calibrations are not inverted, the samples of these channels are written as is
+    m_vecInvCals = vecCals;
+    for(int i = 0; i < m_vecInvCals.size(); ++i) {
+        m_vecInvCals[i] = m_vecInvCals[i] != 0.0 ? 1.0 / m_vecInvCals[i] : 1.0;
+    }
+}
+
+//=============================================================================================================
+
+fiff_int_t FiffRawWriter::dataType() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_iDataType;
+}
+
+//=============================================================================================================
+
+void FiffRawWriter::setSyncPolicy(SyncPolicy policy,
+                                  int iIntervalMSecs)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_syncPolicy = policy;
+    m_iSyncIntervalMSecs = iIntervalMSecs;
+}
+
+//=============================================================================================================
+
+void FiffRawWriter::setStream(QSharedPointer<FiffStream> pStream)
+{
+    flush();
+
+    QMutexLocker locker(&m_mutex);
+    m_pStream = pStream;
+}
+
+//=============================================================================================================
+
+qint64 FiffRawWriter::write(const MatrixXd& matData)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if(m_queueFree.isEmpty()) {
+        ++m_statistics.iStalls;
+        while(m_queueFree.isEmpty()) {
+            m_condWritten.wait(&m_mutex);
+        }
+    }
+
+    QByteArray tag = m_queueFree.dequeue();
+    const fiff_int_t iDataType = m_iDataType;
+    const RowVectorXd vecInvCals = m_vecInvCals;
+
+    // Pack outside of the lock, so that the writer thread can go on with the previous buffer
+    locker.unlock();
+    const qint64 iClipped = FiffStream::pack_raw_buffer(matData, vecInvCals, iDataType, tag);
+    locker.relock();
+
+    if(iClipped < 0) {
+        m_queueFree.enqueue(tag);
+        return 0;
+    }
+
+    const qint64 iBytes = tag.size();
+    m_statistics.iClippedSamples += iClipped;
+
+    m_queueWrite.enqueue(tag);
+    m_statistics.iMaxQueueDepth = std::max(m_statistics.iMaxQueueDepth, m_queueWrite.size());
+    m_condQueued.wakeOne();
+
+    return iBytes;
+}
+
+//=============================================================================================================
+
+void FiffRawWriter::flush()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if(!isRunning()) {
+        // Nobody is going to write the queue, do it here
+        while(!m_queueWrite.isEmpty()) {
+            QByteArray tag = m_queueWrite.dequeue();
+            if(m_pStream) {
+                m_pStream->device()->write(tag);
+            }
+            m_queueFree.enqueue(tag);
+        }
+    }
+
+    while(!m_queueWrite.isEmpty() || m_bWriting) {
+        m_condWritten.wait(&m_mutex);
+    }
+
+    if(m_pStream) {
+        if(QFileDevice* pFile = qobject_cast<QFileDevice*>(m_pStream->device())) {
+            pFile->flush();
+        }
+    }
+}
+
+//=============================================================================================================
+
+void FiffRawWriter::stop()
+{
+    m_mutex.lock();
+    m_bStop = true;
+    m_condQueued.wakeAll();
+    m_mutex.unlock();
+
+    wait();
+
+    // Write what was queued while the thread was not running
+    flush();
+
+    // Allow the writer to be started again
+    m_mutex.lock();
+    m_bStop = false;
+    m_mutex.unlock();
+}
+
+//=============================================================================================================
+
+FiffRawWriter::Statistics FiffRawWriter::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    Statistics statistics = m_statistics;
+    statistics.iQueueDepth = m_queueWrite.size();
+
+    const qint64 iNsecs = m_timerStatistics.nsecsElapsed();
+    if(iNsecs > 0) {
+        statistics.dMBytesPerSec = (static_cast<double>(m_statistics.iBytes) / (1024.0 * 1024.0)) / (iNsecs / 1.0e9);
+    }
+
+    return statistics;
+}
+
+//=============================================================================================================
+
+void FiffRawWriter::resetStatistics()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_statistics = Statistics();
+    m_timerStatistics.restart();
+}
+
+//=============================================================================================================
+
+void FiffRawWriter::run()
+{
+    QElapsedTimer timerWrite;
+    QElapsedTimer timerSync;
+    timerSync.start();
+
+    m_mutex.lock();
+
+    while(true) {
+        while(m_queueWrite.isEmpty() && !m_bStop) {
+            m_condQueued.wait(&m_mutex);
+        }
+
+        if(m_queueWrite.isEmpty()) {
+            break;
+        }
+
+        QByteArray tag = m_queueWrite.dequeue();
+        QSharedPointer<FiffStream> pStream = m_pStream;
+        const bool bSync = m_syncPolicy == SyncEveryBuffer
+                           || (m_syncPolicy == SyncInterval && timerSync.elapsed() >= m_iSyncIntervalMSecs);
+        m_bWriting = true;
+        m_mutex.unlock();
+
+        // The device is only accessed by this thread while m_bWriting is set, see flush()
+        timerWrite.start();
+        qint64 iWritten = 0;
+        if(pStream) {
+            iWritten = pStream->device()->write(tag);
+            if(iWritten != tag.size()) {
+                qWarning() << "[FiffRawWriter::run] Could only write" << iWritten << "of" << tag.size() << "bytes.";
+            }
+
+            if(bSync) {
+                syncDevice(pStream->device());
+                timerSync.restart();
+            }
+        }
+        const qint64 iNsecs = timerWrite.nsecsElapsed();
+
+        m_mutex.lock();
+        m_bWriting = false;
+        m_statistics.iBytes += std::max(iWritten, qint64(0));
+        ++m_statistics.iBuffers;
+        m_statistics.iMaxWriteNsecs = std::max(m_statistics.iMaxWriteNsecs, iNsecs);
+        m_queueFree.enqueue(tag);
+        m_condWritten.wakeAll();
+    }
+
+    m_mutex.unlock();
+}
+
+//=============================================================================================================
+
+void FiffRawWriter::syncDevice(QIODevice* pDevice)
+{
+    QFileDevice* pFile = qobject_cast<QFileDevice*>(pDevice);
+    if(!pFile || !pFile->flush()) {
+        return;
+    }
+
+#if defined(Q_OS_WIN)
+    _commit(pFile->handle());
+#else
+    ::fsync(pFile->handle());
+#endif
+}
@@ -0,0 +1,238 @@
+//=============================================================================================================
+/**
+ * @file     fiffrawwriter.h
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    FiffRawWriter class declaration.
+ *
+ */
+
+#ifndef FIFFRAWWRITER_H
+#define FIFFRAWWRITER_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff_types.h>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QByteArray>
+#include <QIODevice>
+#include <QElapsedTimer>
+#include <QSharedPointer>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+namespace FIFFLIB{
+    class FiffStream;
+}
+
+//=============================================================================================================
+// DEFINE NAMESPACE WRITETOFILEPLUGIN
+//=============================================================================================================
+
+namespace WRITETOFILEPLUGIN
+{
+
+//=============================================================================================================
+/**
+ * The data buffers are packed into complete FIFF_DATA_BUFFER tags in the calling thread and written to the device
+ * of the raw data stream by the writer thread. The packed tags rotate through a fixed pool, so the caller only
+ * blocks if the disk falls behind by more than the whole pool.
+ *
+ * @brief Asynchronous writer for the data buffers of a raw FIFF file.
+ */
+class FiffRawWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    typedef QSharedPointer<FiffRawWriter> SPtr;            /**< Shared pointer type for FiffRawWriter. */
+
+    enum SyncPolicy {
+        NoSync,             /**< Leave it to the operating system when to write the data to disk. */
+        SyncInterval,       /**< Sync the file to disk in a fixed interval. */
+        SyncEveryBuffer     /**< Sync the file to disk after each buffer. */
+    };
+
+    struct Statistics {
+        qint64  iBytes = 0;             /**< Written bytes. */
+        qint64  iBuffers = 0;           /**< Written buffers. */
+        qint64  iClippedSamples = 0;    /**< Samples which were out of the range of the storage type. */
+        qint64  iStalls = 0;            /**< Number of times the caller had to wait for a free buffer. */
+        qint64  iMaxWriteNsecs = 0;     /**< Longest time spent writing and syncing a single buffer. */
+        int     iQueueDepth = 0;        /**< Buffers currently waiting to be written. */
+        int     iMaxQueueDepth = 0;     /**< Maximal number of buffers which were waiting to be written. */
+        double  dMBytesPerSec = 0.0;    /**< Sustained write rate since the statistics were reset. */
+    };
+
+    //=========================================================================================================
+    /**
+     * Constructs a FiffRawWriter.
+     *
+     * @param[in] iNumBuffers    The number of buffers in the pool, at least two. Default is 8.
+     */
+    explicit FiffRawWriter(int iNumBuffers = 8);
+
+    //=========================================================================================================
+    /**
+     * Destroys the FiffRawWriter. Pending buffers are written before the thread ends.
+     */
+    ~FiffRawWriter();
+
+    //=========================================================================================================
+    /**
+     * Sets the storage type and the calibrations of the channels. Call flush() before changing the format
+     * of a running recording.
+     *
+     * @param[in] iDataType      The storage type: FIFFT_FLOAT, FIFFT_INT, FIFFT_SHORT or FIFFT_DAU_PACK16.
+     * @param[in] vecCals        The calibration (cal * range) of each channel. Empty to write the data as is.
+     */
+    void setFormat(FIFFLIB::fiff_int_t iDataType,
+                   const Eigen::RowVectorXd& vecCals = Eigen::RowVectorXd());
+
+    //=========================================================================================================
+    /**
+     * Returns the storage type.
+     *
+     * @return The storage type.
+     */
+    FIFFLIB::fiff_int_t dataType() const;
+
+    //=========================================================================================================
+    /**
+     * Sets when the file is synced to disk.
+     *
+     * @param[in] policy             The sync policy.
+     * @param[in] iIntervalMSecs     The interval used by SyncInterval. Default is 1000 ms.
+     */
+    void setSyncPolicy(SyncPolicy policy,
+                       int iIntervalMSecs = 1000);
+
+    //=========================================================================================================
+    /**
+     * Sets the stream the buffers are written to. Pending buffers are written to the previous stream first.
+     *
+     * @param[in] pStream        The stream of the raw file, positioned inside the FIFFB_RAW_DATA block.
+     */
+    void setStream(QSharedPointer<FIFFLIB::FiffStream> pStream);
+
+    //=========================================================================================================
+    /**
+     * Packs a data buffer and queues it for writing. Blocks if all buffers of the pool are waiting to be
+     * written.
+     *
+     * @param[in] matData        The data buffer, one channel per row.
+     *
+     * @return The number of bytes which will be written to the file, 0 if the buffer could not be packed.
+     */
+    qint64 write(const Eigen::MatrixXd& matData);
+
+    //=========================================================================================================
+    /**
+     * Blocks until all queued buffers are written and flushes the device. Call this before writing other tags
+     * to the stream.
+     */
+    void flush();
+
+    //=========================================================================================================
+    /**
+     * Writes the pending buffers and stops the writer thread.
+     */
+    void stop();
+
+    //=========================================================================================================
+    /**
+     * Returns the statistics since the last call of resetStatistics().
+     *
+     * @return The statistics.
+     */
+    Statistics statistics() const;
+
+    //=========================================================================================================
+    /**
+     * Resets the statistics.
+     */
+    void resetStatistics();
+
+protected:
+    //=========================================================================================================
+    /**
+     * Writes the queued buffers to the device of the stream until stop() is called.
+     */
+    virtual void run();
+
+private:
+    //=========================================================================================================
+    /**
+     * Writes the operating system buffers of the device to disk.
+     *
+     * @param[in] pDevice        The device of the stream.
+     */
+    void syncDevice(QIODevice* pDevice);
+
+    mutable QMutex                          m_mutex;                /**< Guards the queues, the stream and the statistics. */
+    QWaitCondition                          m_condQueued;           /**< Signaled when a buffer was queued or the writer should stop. */
+    QWaitCondition                          m_condWritten;          /**< Signaled when a buffer was written. */
+
+    QQueue<QByteArray>                      m_queueFree;            /**< Buffers which can be packed. */
+    QQueue<QByteArray>                      m_queueWrite;           /**< Packed buffers waiting to be written. */
+
+    QSharedPointer<FIFFLIB::FiffStream>     m_pStream;              /**< The stream to write to. */
+
+    FIFFLIB::fiff_int_t                     m_iDataType;            /**< The storage type. */
+    Eigen::RowVectorXd                      m_vecInvCals;           /**< The inverse calibration of each channel. */
+
+    SyncPolicy                              m_syncPolicy;           /**< When to sync the file to disk. */
+    int                                     m_iSyncIntervalMSecs;   /**< The interval used by SyncInterval. */
+
+    bool                                    m_bWriting;             /**< Whether the writer thread is currently writing a buffer. */
+    bool                                    m_bStop;                /**< Whether the writer thread should stop. */
+
+    Statistics                              m_statistics;           /**< The statistics. */
+    QElapsedTimer                           m_timerStatistics;      /**< Measures the time since the statistics were reset. */
+};
+} // NAMESPACE
+
+#endif // FIFFRAWWRITER_H
@@ -43,11 +43,15 @@
 #include <disp/viewers/projectsettingsview.h>
 #include <scMeas/realtimemultisamplearray.h>
 #include <fiff/fiff_stream.h>
+#include <fiff/fiff_file.h>
 
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
 
+#include <QSettings>
+#include <QDebug>
+
 //=============================================================================================================
 // EIGEN INCLUDES
 //=============================================================================================================
@@ -74,6 +78,8 @@ WriteToFile::WriteToFile()
 , m_iBlinkStatus(0)
 , m_iSplitCount(0)
 , m_iRecordingMSeconds(5*60*1000)
+, m_iDataType(FIFFT_FLOAT)
+, m_pRawWriter(FiffRawWriter::SPtr::create())
 , m_pCircularBuffer(CircularBuffer_Matrix_double::SPtr(new CircularBuffer_Matrix_double(40)))
 {
     m_pActionRecordFile = new QAction(QIcon(":/images/record.png"), tr("Start Recording"),this);
@@ -123,6 +129,9 @@ void WriteToFile::init()
     connect(m_pWriteToFileInput.data(), &PluginInputConnector::notify,
             this, &WriteToFile::update, Qt::DirectConnection);
     m_inputConnectors.append(m_pWriteToFileInput);
+
+    QSettings settings("MNECPP");
+    setDataType(settings.value(QString("MNESCAN/%1/dataType").arg(getName()), FIFFT_FLOAT).toInt());
 }
 
 //=============================================================================================================
@@ -135,6 +144,7 @@ void WriteToFile::unload()
 
 bool WriteToFile::start()
 {
+    m_pRawWriter->start(QThread::HighPriority);
     QThread::start();
 
     return true;
@@ -147,6 +157,8 @@ bool WriteToFile::stop()
     requestInterruption();
     wait();
 
+    m_pRawWriter->stop();
+
     m_bPluginControlWidgetsInit = false;
 
     return true;
@@ -272,7 +284,7 @@ void WriteToFile::initPluginControlWidgets()
 void WriteToFile::run()
 {
     MatrixXd matData;
-    qint32 size = 0;
+    qint64 size = 0;
 
     while(!isInterruptionRequested()) {
         if(m_pCircularBuffer) {
@@ -281,15 +293,13 @@ void WriteToFile::run()
                 //Write raw data to fif file
                 m_mutex.lock();
                 if(m_bWriteToFile) {
-                    size += matData.rows()*matData.cols() * 4;
-
                     if(size > MAX_DATA_LEN) {
                         size = 0;
                         this->splitRecordingFile();
                     }
 
                     if(m_pOutfid) {
-                        m_pOutfid->write_raw_buffer(matData);
+                        size += m_pRawWriter->write(matData);
                     }
                 } else {
                     size = 0;
@@ -307,6 +317,34 @@ void WriteToFile::run()
 
 //=============================================================================================================
 
+void WriteToFile::setDataType(int iDataType)
+{
+    switch(iDataType) {
+        case FIFFT_FLOAT:
+        case FIFFT_INT:
+        case FIFFT_SHORT:
+        case FIFFT_DAU_PACK16:
+            break;
+        default:
+            qWarning() << "[WriteToFile::setDataType] Data type" << iDataType << "is not supported. Writing floats.";
+            iDataType = FIFFT_FLOAT;
+    }
+
+    m_iDataType = iDataType;
+
+    QSettings settings("MNECPP");
+    settings.setValue(QString("MNESCAN/%1/dataType").arg(getName()), m_iDataType);
+}
+
+//=============================================================================================================
+
+int WriteToFile::getDataType() const
+{
+    return m_iDataType;
+}
+
+//=============================================================================================================
+
 void WriteToFile::setRecordingTimerChanged(int timeMSecs)
 {
     //If the recording time is changed during the recording, change the timer
@@ -338,9 +376,16 @@ void WriteToFile::toggleRecordingFile()
     //Setup writing to file
     if(m_bWriteToFile) {
         m_mutex.lock();
+        m_pRawWriter->flush();
         m_pOutfid->finish_writing_raw();
         m_mutex.unlock();
 
+        FiffRawWriter::Statistics statistics = m_pRawWriter->statistics();
+        qInfo() << "[WriteToFile::toggleRecordingFile] Wrote" << statistics.iBytes / (1024 * 1024) << "MB in"
+                << statistics.iBuffers << "buffers at" << statistics.dMBytesPerSec << "MB/s. Max queue depth"
+                << statistics.iMaxQueueDepth << "with" << statistics.iStalls << "stalls, longest write"
+                << statistics.iMaxWriteNsecs / 1000000 << "ms," << statistics.iClippedSamples << "clipped samples.";
+
         m_bWriteToFile = false;
         m_iSplitCount = 0;
 
@@ -392,12 +437,8 @@ void WriteToFile::toggleRecordingFile()
 
         //Start/Prepare writing process. Actual writing is done in run() method.
         m_mutex.lock();
-        RowVectorXd cals;
-        m_pOutfid = FiffStream::start_writing_raw(m_qFileOut,
-                                                  *m_pFiffInfo,
-                                                  cals);
-        fiff_int_t first = 0;
-        m_pOutfid->write_int(FIFF_FIRST_SAMPLE, &first);
+        m_pRawWriter->resetStatistics();
+        startRawFile();
         m_mutex.unlock();
 
         m_bWriteToFile = true;
@@ -422,7 +463,9 @@ void WriteToFile::splitRecordingFile()
     QString nextFileName = m_sRecordFileName.remove("_raw.fif");
     nextFileName += QString("-%1_raw.fif").arg(m_iSplitCount);
 
-    //Write the link to the next file
+    //Write the pending buffers before the link to the next file
+    m_pRawWriter->flush();
+
     qint32 data;
     m_pOutfid->start_block(FIFFB_REF);
     data = FIFFV_ROLE_NEXT_FILE;
@@ -438,15 +481,39 @@ void WriteToFile::splitRecordingFile()
 
     //start next file
     m_qFileOut.setFileName(nextFileName);
+    startRawFile();
+}
+
+//=============================================================================================================
+
+void WriteToFile::startRawFile()
+{
     RowVectorXd cals;
-    MatrixXi sel;
-    m_pOutfid = FiffStream::start_writing_raw(m_qFileOut,
-                                              *m_pFiffInfo,
-                                              cals,
-                                              sel,
-                                              false);
+
+    if(m_iDataType == FIFFT_FLOAT) {
+        // Floats are written as they are received
+        m_pOutfid = FiffStream::start_writing_raw(m_qFileOut,
+                                                  *m_pFiffInfo,
+                                                  cals);
+        m_pRawWriter->setFormat(FIFFT_FLOAT);
+    } else {
+        // Integers are scaled by the inverse of cal * range, which the reader applies again
+        m_pOutfid = FiffStream::start_writing_raw(m_qFileOut,
+                                                  *m_pFiffInfo,
+                                                  cals,
+                                                  defaultMatrixXi,
+                                                  false,
+                                                  m_iDataType);
+        for(int k = 0; k < cals.size(); ++k) {
+            cals[k] *= m_pFiffInfo->chs[k].range;
+        }
+        m_pRawWriter->setFormat(m_iDataType, cals);
+    }
+
     fiff_int_t first = 0;
     m_pOutfid->write_int(FIFF_FIRST_SAMPLE, &first);
+
+    m_pRawWriter->setStream(m_pOutfid);
 }
 
 //=============================================================================================================
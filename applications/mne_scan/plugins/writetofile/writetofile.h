@@ -40,6 +40,7 @@
 //=============================================================================================================
 
 #include "writetofile_global.h"
+#include "fiffrawwriter.h"
 
 #include <utils/generics/circularbuffer.h>
 #include <scShared/Interfaces/IAlgorithm.h>
@@ -138,6 +139,22 @@ public:
      */
     void initPluginControlWidgets();
 
+    //=========================================================================================================
+    /**
+     * Sets the storage type of the recorded data. Takes effect with the next file which is started.
+     *
+     * @param[in] iDataType      The storage type: FIFFT_FLOAT, FIFFT_INT, FIFFT_SHORT or FIFFT_DAU_PACK16.
+     */
+    void setDataType(int iDataType);
+
+    //=========================================================================================================
+    /**
+     * Returns the storage type of the recorded data.
+     *
+     * @return The storage type.
+     */
+    int getDataType() const;
+
 private:
     //=========================================================================================================
     /**
@@ -181,6 +198,12 @@ private:
      */
     void splitRecordingFile();
 
+    //=========================================================================================================
+    /**
+     * Starts writing a raw file to m_qFileOut and hands the stream to the raw writer.
+     */
+    void startRawFile();
+
     //=========================================================================================================
     /**
      * change recording button.
@@ -193,11 +216,13 @@ private:
     qint16                                  m_iBlinkStatus;                 /**< The blink status of the recording button.*/
     qint32                                  m_iSplitCount;                  /**< File split count */
     int                                     m_iRecordingMSeconds;           /**< Recording length in mseconds.*/
+    int                                     m_iDataType;                    /**< The storage type of the recorded data.*/
 
     QMutex                                  m_mutex;                        /**< The threads mutex.*/
 
     QSharedPointer<FIFFLIB::FiffInfo>       m_pFiffInfo;                    /**< Fiff measurement info.*/
     QSharedPointer<FIFFLIB::FiffStream>     m_pOutfid;                      /**< FiffStream to write to.*/
+    FiffRawWriter::SPtr                     m_pRawWriter;                   /**< Writes the data buffers to m_pOutfid in its own thread.*/
 
     QSharedPointer<QTimer>                  m_pUpdateTimeInfoTimer;         /**< timer to control remaining time. */
     QSharedPointer<QTimer>                  m_pBlinkingRecordButtonTimer;   /**< timer to control blinking recording button. */
@@ -98,11 +98,13 @@ CONFIG(debug, debug|release) {
 
 SOURCES += \
         writetofile.cpp \
+        fiffrawwriter.cpp \
         FormFiles/writetofilesetupwidget.cpp \
 
 HEADERS += \
         writetofile.h\
         writetofile_global.h \
+        fiffrawwriter.h \
         FormFiles/writetofilesetupwidget.h \
 
 FORMS += \
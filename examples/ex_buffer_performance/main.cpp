@@ -0,0 +1,176 @@
+//=============================================================================================================
+/**
+ * @file     main.cpp
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Example comparing the throughput of CircularBuffer and RingBuffer.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <utils/generics/circularbuffer.h>
+#include <utils/generics/ringbuffer.h>
+#include <utils/generics/applicationlogger.h>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtCore/QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QtConcurrent>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace IOBUFFER;
+using namespace UTILSLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+ * Pushes iNumBlocks matrices from a second thread through the buffer and pops them in the calling thread.
+ *
+ * @param[in] buffer        The buffer to measure.
+ * @param[in] iNumBlocks    The number of blocks to transfer.
+ * @param[in] iRows         The number of rows of each block.
+ * @param[in] iCols         The number of columns of each block.
+ *
+ * @return The elapsed time in milliseconds.
+ */
+template<typename T>
+qint64 measureThroughput(T& buffer,
+                         int iNumBlocks,
+                         int iRows,
+                         int iCols)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QFuture<void> producer = QtConcurrent::run([&buffer, iNumBlocks, iRows, iCols]() {
+        MatrixXd matBlock = MatrixXd::Random(iRows, iCols);
+        for(int i = 0; i < iNumBlocks; ++i) {
+            while(!buffer.push(matBlock)) {
+                //Do nothing until the buffer is ready to accept new data again
+            }
+        }
+    });
+
+    MatrixXd matData;
+    double dChecksum = 0.0;
+    for(int i = 0; i < iNumBlocks; ++i) {
+        while(!buffer.pop(matData)) {
+            //Do nothing until new data is available
+        }
+        dChecksum += matData(0,0);
+    }
+
+    producer.waitForFinished();
+    qint64 iElapsed = timer.elapsed();
+
+    qDebug() << "Checksum" << dChecksum;
+
+    return iElapsed;
+}
+
+//=============================================================================================================
+
+/**
+ * The function main marks the entry point of the program.
+ * By default, main has the storage class extern.
+ *
+ * @param [in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+ * @param [in] argv (argument vector) is an array of pointers to arrays of character objects. The array objects are null-terminated strings, representing the arguments that were entered on the command line when the program was started.
+ * @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+ */
+int main(int argc, char *argv[])
+{
+    qInstallMessageHandler(ApplicationLogger::customLogWriter);
+    QCoreApplication app(argc, argv);
+
+    // Command Line Parser
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Buffer Performance Example");
+    parser.addHelpOption();
+
+    QCommandLineOption blocksOption("blocks", "The number of blocks to transfer <blocks>.", "blocks", "20000");
+    QCommandLineOption rowsOption("rows", "The number of channels per block <rows>.", "rows", "306");
+    QCommandLineOption colsOption("cols", "The number of samples per block <cols>.", "cols", "100");
+    QCommandLineOption sizeOption("size", "The number of buffer elements <size>.", "size", "40");
+
+    parser.addOption(blocksOption);
+    parser.addOption(rowsOption);
+    parser.addOption(colsOption);
+    parser.addOption(sizeOption);
+
+    parser.process(app);
+
+    int iNumBlocks = parser.value(blocksOption).toInt();
+    int iRows = parser.value(rowsOption).toInt();
+    int iCols = parser.value(colsOption).toInt();
+    int iSize = parser.value(sizeOption).toInt();
+
+    CircularBuffer_Matrix_double circularBuffer(iSize);
+    qint64 iTimeCircular = measureThroughput(circularBuffer, iNumBlocks, iRows, iCols);
+
+    RingBuffer_Matrix_double ringBufferBlock(iSize, RingBuffer_Matrix_double::Block);
+    qint64 iTimeRingBlock = measureThroughput(ringBufferBlock, iNumBlocks, iRows, iCols);
+
+    RingBuffer_Matrix_double ringBufferYield(iSize, RingBuffer_Matrix_double::Yield);
+    qint64 iTimeRingYield = measureThroughput(ringBufferYield, iNumBlocks, iRows, iCols);
+
+    RingBuffer_Matrix_double ringBufferSpin(iSize, RingBuffer_Matrix_double::Spin);
+    qint64 iTimeRingSpin = measureThroughput(ringBufferSpin, iNumBlocks, iRows, iCols);
+
+    RingBuffer_Matrix_double ringBufferSleep(iSize, RingBuffer_Matrix_double::Sleep);
+    qint64 iTimeRingSleep = measureThroughput(ringBufferSleep, iNumBlocks, iRows, iCols);
+
+    qInfo() << "Transferred" << iNumBlocks << "blocks of" << iRows << "x" << iCols;
+    qInfo() << "CircularBuffer:        " << iTimeCircular << "ms";
+    qInfo() << "RingBuffer (Block):    " << iTimeRingBlock << "ms";
+    qInfo() << "RingBuffer (Yield):    " << iTimeRingYield << "ms";
+    qInfo() << "RingBuffer (Spin):     " << iTimeRingSpin << "ms";
+    qInfo() << "RingBuffer (Sleep):    " << iTimeRingSleep << "ms";
+
+    return 0;
+}
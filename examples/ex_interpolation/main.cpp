@@ -154,7 +154,7 @@ int main(int argc, char *argv[])
 
     //SCDC with cancel distance 0.03
     qint64 startTimeScdc = QDateTime::currentMSecsSinceEpoch();
-    QSharedPointer<MatrixXd> distanceMatrix = GeometryInfo::scdc(t_sensorSurfaceVV[0].rr, t_sensorSurfaceVV[0].neighbor_vert, mappedSubSet, 0.2);
+    QSharedPointer<SparseMatrix<float> > distanceMatrix = GeometryInfo::scdcSparse(t_sensorSurfaceVV[0].rr, t_sensorSurfaceVV[0].adjacency, mappedSubSet, 0.2);
     std::cout << "SCDC duration: " << QDateTime::currentMSecsSinceEpoch() - startTimeScdc<< " ms " << std::endl;
 
     //filter out bad MEG channels
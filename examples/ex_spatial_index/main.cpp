@@ -0,0 +1,189 @@
+//=============================================================================================================
+/**
+ * @file     main.cpp
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Example comparing the KdTree spatial index with a linear search over the surface vertices.
+ *
+ */
+
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <mne/mne_bem.h>
+#include <mne/mne_bem_surface.h>
+
+#include <utils/kdtree.h>
+#include <utils/generics/applicationlogger.h>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtCore/QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNELIB;
+using namespace UTILSLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+ * Finds the closest vertex by looking at all of them, as done before the spatial index was available.
+ *
+ * @param[in] matVertices   The vertices, one per row.
+ * @param[in] vecPoint      The query point.
+ *
+ * @return The index of the closest vertex.
+ */
+int linearNearest(const MatrixX3f& matVertices,
+                  const Vector3f& vecPoint)
+{
+    int iChampionId = -1;
+    float fChampDist = std::numeric_limits<float>::max();
+    for(int i = 0; i < matVertices.rows(); ++i) {
+        float fDist = (matVertices.row(i).transpose() - vecPoint).squaredNorm();
+        if(fDist < fChampDist) {
+            iChampionId = i;
+            fChampDist = fDist;
+        }
+    }
+    return iChampionId;
+}
+
+//=============================================================================================================
+
+/**
+ * The function main marks the entry point of the program.
+ * By default, main has the storage class extern.
+ *
+ * @param [in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+ * @param [in] argv (argument vector) is an array of pointers to arrays of character objects. The array objects are null-terminated strings, representing the arguments that were entered on the command line when the program was started.
+ * @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+ */
+int main(int argc, char *argv[])
+{
+    qInstallMessageHandler(ApplicationLogger::customLogWriter);
+    QCoreApplication app(argc, argv);
+
+    // Command Line Parser
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Spatial Index Example");
+    parser.addHelpOption();
+
+    QCommandLineOption bemFileOption("bem", "Path to BEM <file>.", "file", QCoreApplication::applicationDirPath() + "/MNE-sample-data/subjects/sample/bem/sample-head.fif");
+    QCommandLineOption queriesOption("queries", "The number of query points <queries>.", "queries", "10000");
+    QCommandLineOption radiusOption("radius", "The radius for the radius queries in meters <radius>.", "radius", "0.01");
+
+    parser.addOption(bemFileOption);
+    parser.addOption(queriesOption);
+    parser.addOption(radiusOption);
+
+    parser.process(app);
+
+    int iNumQueries = parser.value(queriesOption).toInt();
+    float fRadius = parser.value(radiusOption).toFloat();
+
+    QFile t_fileBem(parser.value(bemFileOption));
+    MNEBem t_Bem(t_fileBem);
+
+    if(t_Bem.size() == 0) {
+        qWarning() << "Could not read BEM surface from" << t_fileBem.fileName();
+        return 1;
+    }
+
+    const MatrixX3f& matVertices = t_Bem[0].rr;
+
+    // query points scattered around the surface, like sensor or digitizer positions
+    MatrixX3f matQueries(iNumQueries, 3);
+    for(int i = 0; i < iNumQueries; ++i) {
+        matQueries.row(i) = matVertices.row(rand() % matVertices.rows()) + 0.02f * RowVector3f::Random();
+    }
+
+    QElapsedTimer timer;
+
+    timer.start();
+    QVector<int> vecLinear(iNumQueries);
+    for(int i = 0; i < iNumQueries; ++i) {
+        vecLinear[i] = linearNearest(matVertices, matQueries.row(i).transpose());
+    }
+    qint64 iTimeLinear = timer.elapsed();
+
+    timer.restart();
+    KdTree tree(matVertices);
+    qint64 iTimeBuild = timer.elapsed();
+
+    timer.restart();
+    QVector<int> vecTree(iNumQueries);
+    float fDist;
+    for(int i = 0; i < iNumQueries; ++i) {
+        vecTree[i] = tree.findNearest(matQueries.row(i).transpose(), fDist);
+    }
+    qint64 iTimeTree = timer.elapsed();
+
+    timer.restart();
+    qint64 iNumInRadius = 0;
+    for(int i = 0; i < iNumQueries; ++i) {
+        iNumInRadius += tree.findInRadius(matQueries.row(i).transpose(), fRadius).size();
+    }
+    qint64 iTimeRadius = timer.elapsed();
+
+    int iNumMismatches = 0;
+    for(int i = 0; i < iNumQueries; ++i) {
+        if(vecLinear[i] != vecTree[i]) {
+            ++iNumMismatches;
+        }
+    }
+
+    qInfo() << "Searched" << iNumQueries << "points on a surface with" << matVertices.rows() << "vertices";
+    qInfo() << "Linear search:         " << iTimeLinear << "ms";
+    qInfo() << "KdTree build:          " << iTimeBuild << "ms";
+    qInfo() << "KdTree nearest:        " << iTimeTree << "ms";
+    qInfo() << "KdTree radius:         " << iTimeRadius << "ms," << iNumInRadius << "points found";
+    qInfo() << "Mismatches:            " << iNumMismatches;
+
+    return 0;
+}
@@ -48,6 +48,7 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
     ex_averaging \
+    ex_buffer_performance \
     ex_cancel_noise \
     ex_compute_forward \
     ex_evoked_grad_amp \
@@ -62,6 +63,7 @@ SUBDIRS += \
     ex_read_fwd \
     ex_read_raw \
     ex_read_write_raw \
+    ex_spatial_index \
 
     qtHaveModule(charts) {
         SUBDIRS += \
@@ -41,6 +41,12 @@
 #include "rtdataclient.h"
 #include <fiff/fiff_file.h>
 
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+
 //=============================================================================================================
 // USED NAMESPACES
 //=============================================================================================================
@@ -57,6 +63,11 @@ RtDataClient::RtDataClient(QObject *parent)
 : QTcpSocket(parent)
 , m_clientID(-1)
 {
+    // Bytes are handed to the tag reader as they arrive. When waiting in a thread without event loop,
+    // waitForReadyRead emits readyRead as well.
+    connect(this, &QTcpSocket::readyRead,
+            this, &RtDataClient::onReadyRead);
+
     getClientId();
 }
 
@@ -81,11 +92,9 @@ qint32 RtDataClient::getClientId()
         QString t_sCommand("");
         t_fiffStream.write_rt_command(1, t_sCommand);
 
-        this->waitForReadyRead(100);
         // ID is send as answer
         FiffTag::SPtr t_pTag;
-        t_fiffStream.read_tag(t_pTag);
-        if (t_pTag->kind == FIFF_MNE_RT_CLIENT_ID)
+        if (readTag(t_pTag, 100) && t_pTag->kind == FIFF_MNE_RT_CLIENT_ID)
             m_clientID = *t_pTag->toInt();
     }
     return m_clientID;
@@ -100,14 +109,16 @@ FiffInfo::SPtr RtDataClient::readInfo()
     bool t_bReadMeasBlockEnd = false;
     QString col_names, row_names;
 
-    FiffStream t_fiffStream(this);
     //
     // Find the start
     //
     FiffTag::SPtr t_pTag;
     while(!t_bReadMeasBlockStart)
     {
-        t_fiffStream.read_rt_tag(t_pTag);
+        if(!readTag(t_pTag)) {
+            qWarning() << "[RtDataClient::readInfo] Connection lost while reading the measurement info.";
+            return FiffInfo::SPtr(new FiffInfo());
+        }
         if(t_pTag->kind == FIFF_BLOCK_START && *(t_pTag->toInt()) == FIFFB_MEAS_INFO)
         {
             printf("FIFF_BLOCK_START FIFFB_MEAS_INFO\n");
@@ -124,7 +135,10 @@ FiffInfo::SPtr RtDataClient::readInfo()
 
     while(!t_bReadMeasBlockEnd)
     {
-        t_fiffStream.read_rt_tag(t_pTag);
+        if(!readTag(t_pTag)) {
+            qWarning() << "[RtDataClient::readInfo] Connection lost while reading the measurement info.";
+            return FiffInfo::SPtr(new FiffInfo());
+        }
         //
         //  megacq parameters
         //
@@ -132,7 +146,10 @@ FiffInfo::SPtr RtDataClient::readInfo()
         {
             while(t_pTag->kind != FIFF_BLOCK_END || *(t_pTag->toInt()) != FIFFB_DACQ_PARS)
             {
-                t_fiffStream.read_rt_tag(t_pTag);
+                if(!readTag(t_pTag)) {
+                    qWarning() << "[RtDataClient::readInfo] Connection lost while reading the measurement info.";
+                    return FiffInfo::SPtr(new FiffInfo());
+                }
                 if(t_pTag->kind == FIFF_DACQ_PARS)
                     p_pFiffInfo->acq_pars = t_pTag->toString();
                 else if(t_pTag->kind == FIFF_DACQ_STIM)
@@ -162,7 +179,10 @@ FiffInfo::SPtr RtDataClient::readInfo()
         {
             while(t_pTag->kind != FIFF_BLOCK_END || *(t_pTag->toInt()) != FIFFB_ISOTRAK)
             {
-                t_fiffStream.read_rt_tag(t_pTag);
+                if(!readTag(t_pTag)) {
+                    qWarning() << "[RtDataClient::readInfo] Connection lost while reading the measurement info.";
+                    return FiffInfo::SPtr(new FiffInfo());
+                }
 
                 if(t_pTag->kind == FIFF_DIG_POINT)
                     p_pFiffInfo->dig.append(t_pTag->toDigPoint());
@@ -175,14 +195,20 @@ FiffInfo::SPtr RtDataClient::readInfo()
         {
             while(t_pTag->kind != FIFF_BLOCK_END || *(t_pTag->toInt()) != FIFFB_PROJ)
             {
-                t_fiffStream.read_rt_tag(t_pTag);
+                if(!readTag(t_pTag)) {
+                    qWarning() << "[RtDataClient::readInfo] Connection lost while reading the measurement info.";
+                    return FiffInfo::SPtr(new FiffInfo());
+                }
                 if(t_pTag->kind == FIFF_BLOCK_START && *(t_pTag->toInt()) == FIFFB_PROJ_ITEM)
                 {
                     FiffProj proj;
                     qint32 countProj = p_pFiffInfo->projs.size();
                     while(t_pTag->kind != FIFF_BLOCK_END || *(t_pTag->toInt()) != FIFFB_PROJ_ITEM)
                     {
-                        t_fiffStream.read_rt_tag(t_pTag);
+                        if(!readTag(t_pTag)) {
+                            qWarning() << "[RtDataClient::readInfo] Connection lost while reading the measurement info.";
+                            return FiffInfo::SPtr(new FiffInfo());
+                        }
                         switch (t_pTag->kind)
                         {
                         case FIFF_NAME: // First proj -> Proj is created
@@ -228,14 +254,20 @@ FiffInfo::SPtr RtDataClient::readInfo()
         {
             while(t_pTag->kind != FIFF_BLOCK_END || *(t_pTag->toInt()) != FIFFB_MNE_CTF_COMP)
             {
-                t_fiffStream.read_rt_tag(t_pTag);
+                if(!readTag(t_pTag)) {
+                    qWarning() << "[RtDataClient::readInfo] Connection lost while reading the measurement info.";
+                    return FiffInfo::SPtr(new FiffInfo());
+                }
                 if(t_pTag->kind == FIFF_BLOCK_START && *(t_pTag->toInt()) == FIFFB_MNE_CTF_COMP_DATA)
                 {
                     FiffCtfComp comp;
                     qint32 countComp = p_pFiffInfo->comps.size();
                     while(t_pTag->kind != FIFF_BLOCK_END || *(t_pTag->toInt()) != FIFFB_MNE_CTF_COMP_DATA)
                     {
-                        t_fiffStream.read_rt_tag(t_pTag);
+                        if(!readTag(t_pTag)) {
+                            qWarning() << "[RtDataClient::readInfo] Connection lost while reading the measurement info.";
+                            return FiffInfo::SPtr(new FiffInfo());
+                        }
                         switch (t_pTag->kind)
                         {
                         case FIFF_MNE_CTF_COMP_KIND: //First comp -> create comp
@@ -291,7 +323,10 @@ FiffInfo::SPtr RtDataClient::readInfo()
         {
             while(t_pTag->kind != FIFF_BLOCK_END || *(t_pTag->toInt()) != FIFFB_MNE_BAD_CHANNELS)
             {
-                t_fiffStream.read_rt_tag(t_pTag);
+                if(!readTag(t_pTag)) {
+                    qWarning() << "[RtDataClient::readInfo] Connection lost while reading the measurement info.";
+                    return FiffInfo::SPtr(new FiffInfo());
+                }
                 if(t_pTag->kind == FIFF_MNE_CH_NAME_LIST)
                     p_pFiffInfo->bads = FiffStream::split_name_list(t_pTag->data());
             }
@@ -370,15 +405,22 @@ void RtDataClient::readRawBuffer(qint32 p_nChannels,
                                  MatrixXf& data,
                                  fiff_int_t& kind)
 {
-    FiffStream t_fiffStream(this);
-    //
-    // Find the start
-    //
-    FiffTag::SPtr t_pTag;
+    m_tagReader.setNumChannels(p_nChannels);
 
-    t_fiffStream.read_rt_tag(t_pTag);
+    if(!waitForTag(-1)) {
+        kind = -1;
+        return;
+    }
 
-    kind = t_pTag->kind;
+    kind = m_tagReader.nextKind();
+
+    // Data buffers are received directly into pooled matrices, which are swapped into data
+    if(m_tagReader.takeDataBuffer(data)) {
+        return;
+    }
+
+    FiffTag::SPtr t_pTag;
+    m_tagReader.takeTag(t_pTag);
 
     if(kind == FIFF_DATA_BUFFER)
     {
@@ -391,9 +433,58 @@ void RtDataClient::readRawBuffer(qint32 p_nChannels,
 
 //=============================================================================================================
 
+RtTagReader::Statistics RtDataClient::getReaderStatistics() const
+{
+    return m_tagReader.statistics();
+}
+
+//=============================================================================================================
+
 void RtDataClient::setClientAlias(const QString &p_sAlias)
 {
     FiffStream t_fiffStream(this);
     t_fiffStream.write_rt_command(2, p_sAlias);//MNE_RT.MNE_RT_SET_CLIENT_ALIAS, alias);
     this->flush();
 }
+
+//=============================================================================================================
+
+void RtDataClient::onReadyRead()
+{
+    if(m_tagReader.read(this) > 0) {
+        emit tagsAvailable();
+    }
+}
+
+//=============================================================================================================
+
+bool RtDataClient::readTag(FiffTag::SPtr& p_pTag,
+                           int msecs)
+{
+    if(!waitForTag(msecs)) {
+        return false;
+    }
+
+    return m_tagReader.takeTag(p_pTag);
+}
+
+//=============================================================================================================
+
+bool RtDataClient::waitForTag(int msecs)
+{
+    // Bytes might have arrived without readyRead being delivered yet
+    if(!m_tagReader.hasTag() && bytesAvailable() > 0) {
+        m_tagReader.read(this);
+    }
+
+    // waitForReadyRead returns as soon as new bytes arrive, which readyRead hands to the tag reader
+    while(!m_tagReader.hasTag()) {
+        if(!waitForReadyRead(msecs)) {
+            return false;
+        }
+
+        m_tagReader.read(this);
+    }
+
+    return true;
+}
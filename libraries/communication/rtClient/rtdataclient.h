@@ -42,6 +42,7 @@
 //=============================================================================================================
 
 #include "../communication_global.h"
+#include "rttagreader.h"
 
 #include <fiff/fiff_stream.h>
 #include <fiff/fiff_info.h>
@@ -104,7 +105,7 @@ public:
     /**
      * Reads fiff measurement information of a data the connection
      *
-     * @return the read fiff measurement information
+     * @return the read fiff measurement information, an empty one if the connection was closed or a read failed
      */
     FIFFLIB::FiffInfo::SPtr readInfo();
 
@@ -120,6 +121,14 @@ public:
                        Eigen::MatrixXf& data,
                        FIFFLIB::fiff_int_t& kind);
 
+    //=========================================================================================================
+    /**
+     * Returns the throughput and back-pressure statistics of the tag reader.
+     *
+     * @return The statistics of the tag reader
+     */
+    RtTagReader::Statistics getReaderStatistics() const;
+
     //=========================================================================================================
     /**
      * Sets the alias of the data client
@@ -128,9 +137,45 @@ public:
      */
     void setClientAlias(const QString &p_sAlias);
 
+signals:
+    //=========================================================================================================
+    /**
+     * Emitted when completed tags were received, e.g. a raw buffer which can be read with readRawBuffer without
+     * blocking.
+     */
+    void tagsAvailable();
+
 private:
-    qint32 m_clientID;  /**< Corresponding client id of the data client at mne_rt_server */
-    
+    //=========================================================================================================
+    /**
+     * Hands the bytes which arrived at the socket to the tag reader.
+     */
+    void onReadyRead();
+
+    //=========================================================================================================
+    /**
+     * Returns the next tag. Blocks until the tag is completely received, without polling.
+     *
+     * @param[out] p_pTag    The read tag
+     * @param[in] msecs      Maximal time to wait for new data in ms. Default is -1, which waits forever.
+     *
+     * @return true if a tag was read, false if the waiting timed out or the connection was closed
+     */
+    bool readTag(QSharedPointer<FIFFLIB::FiffTag>& p_pTag,
+                 int msecs = -1);
+
+    //=========================================================================================================
+    /**
+     * Blocks until a completed tag is available, without polling.
+     *
+     * @param[in] msecs      Maximal time to wait for new data in ms. -1 waits forever.
+     *
+     * @return true if a tag is available
+     */
+    bool waitForTag(int msecs);
+
+    qint32          m_clientID;     /**< Corresponding client id of the data client at mne_rt_server */
+    RtTagReader     m_tagReader;    /**< Reassembles the tags from the received bytes */
 };
 } // NAMESPACE
 
@@ -0,0 +1,294 @@
+//=============================================================================================================
+/**
+ * @file     rttagreader.cpp
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Definition of the RtTagReader Class.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rttagreader.h"
+
+#include <fiff/fiff_file.h>
+#include <fiff/fiff_constants.h>
+
+#include <algorithm>
+#include <cstring>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QIODevice>
+#include <QtEndian>
+#include <QDebug>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace COMMUNICATIONLIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+RtTagReader::RtTagReader(int iPoolSize)
+: m_iPoolSize(iPoolSize)
+, m_iNumChannels(0)
+, m_iHeaderBytes(0)
+, m_iDataBytes(0)
+, m_iDataSize(0)
+, m_bInHeader(true)
+{
+    m_current.bIsDataBuffer = false;
+    m_stats = Statistics{0, 0, 0, 0, 0, 0};
+}
+
+//=============================================================================================================
+
+void RtTagReader::setNumChannels(int iNumChannels)
+{
+    m_iNumChannels = iNumChannels;
+}
+
+//=============================================================================================================
+
+int RtTagReader::read(QIODevice* pDevice)
+{
+    int iCompleted = 0;
+
+    m_stats.iMaxPendingBytes = std::max(m_stats.iMaxPendingBytes, pDevice->bytesAvailable());
+
+    forever {
+        qint64 iRequested, iRead;
+
+        if(m_bInHeader) {
+            iRequested = 16 - m_iHeaderBytes;
+            iRead = pDevice->read(m_pHeader + m_iHeaderBytes, iRequested);
+
+            if(iRead <= 0) {
+                break;
+            }
+
+            m_iHeaderBytes += iRead;
+
+            if(m_iHeaderBytes == 16) {
+                startTag();
+            }
+        } else {
+            // read the data straight into its final storage
+            char* pData = m_current.bIsDataBuffer ? reinterpret_cast<char*>(m_current.matData.data()) : m_current.pTag->data();
+
+            iRequested = m_iDataSize - m_iDataBytes;
+            iRead = pDevice->read(pData + m_iDataBytes, iRequested);
+
+            if(iRead < 0) {
+                break;
+            }
+
+            m_iDataBytes += iRead;
+        }
+
+        m_stats.iBytes += iRead;
+
+        if(!m_bInHeader && m_iDataBytes == m_iDataSize) {
+            finishTag();
+            ++iCompleted;
+        } else if(iRead < iRequested) {
+            // the device is drained, continue with the next call
+            break;
+        }
+    }
+
+    return iCompleted;
+}
+
+//=============================================================================================================
+
+bool RtTagReader::hasTag() const
+{
+    return !m_dqTags.empty();
+}
+
+//=============================================================================================================
+
+fiff_int_t RtTagReader::nextKind() const
+{
+    return m_dqTags.empty() ? -1 : m_dqTags.front().pTag->kind;
+}
+
+//=============================================================================================================
+
+bool RtTagReader::takeTag(FiffTag::SPtr& pTag)
+{
+    if(m_dqTags.empty()) {
+        return false;
+    }
+
+    Entry& entry = m_dqTags.front();
+    pTag = entry.pTag;
+
+    if(entry.bIsDataBuffer) {
+        // the samples are already converted to native endianness
+        pTag->resize(entry.matData.size() * sizeof(float));
+        std::memcpy(pTag->data(), entry.matData.data(), entry.matData.size() * sizeof(float));
+
+        if(m_lPool.size() < m_iPoolSize) {
+            m_lPool.append(MatrixXf());
+            m_lPool.last().swap(entry.matData);
+        }
+    }
+
+    m_dqTags.pop_front();
+
+    return true;
+}
+
+//=============================================================================================================
+
+bool RtTagReader::takeDataBuffer(MatrixXf& matData)
+{
+    if(m_dqTags.empty() || !m_dqTags.front().bIsDataBuffer) {
+        return false;
+    }
+
+    matData.swap(m_dqTags.front().matData);
+
+    // keep the previous storage of the caller for the next data buffers
+    if(m_lPool.size() < m_iPoolSize && m_dqTags.front().matData.size() > 0) {
+        m_lPool.append(MatrixXf());
+        m_lPool.last().swap(m_dqTags.front().matData);
+    }
+
+    m_dqTags.pop_front();
+
+    return true;
+}
+
+//=============================================================================================================
+
+RtTagReader::Statistics RtTagReader::statistics() const
+{
+    return m_stats;
+}
+
+//=============================================================================================================
+
+void RtTagReader::startTag()
+{
+    // the tag header is sent in big endian byte order
+    const uchar* pHeader = reinterpret_cast<const uchar*>(m_pHeader);
+
+    m_current.pTag = FiffTag::SPtr(new FiffTag());
+    m_current.pTag->kind = qFromBigEndian<qint32>(pHeader);
+    m_current.pTag->type = qFromBigEndian<qint32>(pHeader + 4);
+    qint32 iSize = qFromBigEndian<qint32>(pHeader + 8);
+    m_current.pTag->next = qFromBigEndian<qint32>(pHeader + 12);
+
+    if(iSize < 0) {
+        qWarning() << "[RtTagReader::startTag] Received tag" << m_current.pTag->kind << "with negative size" << iSize;
+        iSize = 0;
+    }
+
+    m_iHeaderBytes = 0;
+    m_iDataBytes = 0;
+    m_iDataSize = iSize;
+    m_bInHeader = false;
+
+    m_current.bIsDataBuffer = m_current.pTag->kind == FIFF_DATA_BUFFER
+                              && m_current.pTag->type == FIFFT_FLOAT
+                              && m_iNumChannels > 0
+                              && iSize > 0
+                              && iSize % (m_iNumChannels * int(sizeof(float))) == 0;
+
+    if(m_current.bIsDataBuffer) {
+        const int iNumSamples = iSize / (m_iNumChannels * int(sizeof(float)));
+
+        // take a pooled matrix, prefer one which already has the right size
+        int iPooled = -1;
+        for(int i = 0; i < m_lPool.size(); ++i) {
+            if(m_lPool.at(i).rows() == m_iNumChannels && m_lPool.at(i).cols() == iNumSamples) {
+                iPooled = i;
+                break;
+            }
+        }
+
+        if(iPooled < 0) {
+            ++m_stats.iPoolMisses;
+            iPooled = m_lPool.isEmpty() ? -1 : 0;
+        }
+
+        if(iPooled >= 0) {
+            m_current.matData.swap(m_lPool[iPooled]);
+            m_lPool.removeAt(iPooled);
+        }
+
+        m_current.matData.resize(m_iNumChannels, iNumSamples);
+    } else {
+        m_current.pTag->resize(iSize);
+    }
+}
+
+//=============================================================================================================
+
+void RtTagReader::finishTag()
+{
+    if(m_current.bIsDataBuffer) {
+        // convert the samples in place from big endian to native byte order
+        #if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        quint32* pSamples = reinterpret_cast<quint32*>(m_current.matData.data());
+        for(Index i = 0; i < m_current.matData.size(); ++i) {
+            pSamples[i] = qbswap(pSamples[i]);
+        }
+        #endif
+
+        ++m_stats.iDataBuffers;
+    } else if(m_current.pTag->size() > 0) {
+        FiffTag::convert_tag_data(m_current.pTag, FIFFV_BIG_ENDIAN, FIFFV_NATIVE_ENDIAN);
+    }
+
+    ++m_stats.iTags;
+
+    m_dqTags.push_back(Entry());
+    m_dqTags.back().pTag = m_current.pTag;
+    m_dqTags.back().bIsDataBuffer = m_current.bIsDataBuffer;
+    m_dqTags.back().matData.swap(m_current.matData);
+
+    m_stats.iMaxQueuedTags = std::max(m_stats.iMaxQueuedTags, static_cast<int>(m_dqTags.size()));
+
+    m_current.pTag.clear();
+    m_current.bIsDataBuffer = false;
+    m_bInHeader = true;
+}
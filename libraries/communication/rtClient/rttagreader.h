@@ -0,0 +1,209 @@
+//=============================================================================================================
+/**
+ * @file     rttagreader.h
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Declaration of the RtTagReader Class.
+ *
+ */
+
+#ifndef RTTAGREADER_H
+#define RTTAGREADER_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../communication_global.h"
+
+#include <fiff/fiff_tag.h>
+
+#include <deque>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QList>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class QIODevice;
+
+//=============================================================================================================
+// DEFINE NAMESPACE COMMUNICATIONLIB
+//=============================================================================================================
+
+namespace COMMUNICATIONLIB
+{
+
+//=============================================================================================================
+/**
+ * Reassembles the FIFF tags sent by mne_rt_server from the bytes of the data connection. The reader takes whatever
+ * is available on the device and keeps partially received tags until the rest arrives, so it never has to wait
+ * for a complete tag. The float samples of data buffers are read directly into a matrix taken from a pool,
+ * which is handed out by swapping it with the caller's matrix.
+ *
+ * @brief Incremental FIFF tag reader for real-time data connections.
+ */
+class COMMUNICATIONSHARED_EXPORT RtTagReader
+{
+
+public:
+    typedef QSharedPointer<RtTagReader> SPtr;               /**< Shared pointer type for RtTagReader. */
+    typedef QSharedPointer<const RtTagReader> ConstSPtr;    /**< Const shared pointer type for RtTagReader. */
+
+    /**
+     * Throughput and back-pressure statistics of the reader.
+     */
+    struct Statistics {
+        qint64  iBytes;             /**< Number of bytes read from the device. */
+        qint64  iTags;              /**< Number of completed tags, including data buffers. */
+        qint64  iDataBuffers;       /**< Number of completed data buffers which were read into a pooled matrix. */
+        qint64  iPoolMisses;        /**< Number of data buffers for which no pooled matrix of the right size was available. */
+        qint64  iMaxPendingBytes;   /**< Largest number of bytes which were waiting on the device when it was read. */
+        int     iMaxQueuedTags;     /**< Largest number of completed tags which were waiting to be taken. */
+    };
+
+    //=========================================================================================================
+    /**
+     * Constructs a RtTagReader.
+     *
+     * @param[in] iPoolSize     Number of data buffer matrices which are kept for reuse. Default is 4.
+     */
+    explicit RtTagReader(int iPoolSize = 4);
+
+    //=========================================================================================================
+    /**
+     * Sets the number of channels used to reshape data buffers. Data buffers which do not match the number of
+     * channels are queued as ordinary tags.
+     *
+     * @param[in] iNumChannels      The number of channels, 0 to queue all data buffers as ordinary tags.
+     */
+    void setNumChannels(int iNumChannels);
+
+    //=========================================================================================================
+    /**
+     * Reads all bytes which are currently available on the device without waiting for more.
+     *
+     * @param[in] pDevice       The device to read from.
+     *
+     * @return The number of tags which were completed.
+     */
+    int read(QIODevice* pDevice);
+
+    //=========================================================================================================
+    /**
+     * Returns whether a completed tag is waiting to be taken.
+     *
+     * @return True if a tag is available.
+     */
+    bool hasTag() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the kind of the next completed tag.
+     *
+     * @return The kind of the next tag, -1 if no tag is available.
+     */
+    FIFFLIB::fiff_int_t nextKind() const;
+
+    //=========================================================================================================
+    /**
+     * Takes the next completed tag. The tag data is converted to native endianness.
+     *
+     * @param[out] pTag     The tag.
+     *
+     * @return True if a tag was available.
+     */
+    bool takeTag(QSharedPointer<FIFFLIB::FiffTag>& pTag);
+
+    //=========================================================================================================
+    /**
+     * Takes the next completed tag if it is a data buffer which was read into a pooled matrix. The matrix is
+     * swapped with matData, the previous storage of matData is kept for reuse.
+     *
+     * @param[in, out] matData      The data buffer (channels x samples).
+     *
+     * @return True if the next tag was a data buffer and was taken.
+     */
+    bool takeDataBuffer(Eigen::MatrixXf& matData);
+
+    //=========================================================================================================
+    /**
+     * Returns the throughput and back-pressure statistics.
+     *
+     * @return The statistics.
+     */
+    Statistics statistics() const;
+
+private:
+    struct Entry {
+        QSharedPointer<FIFFLIB::FiffTag>    pTag;           /**< The tag. Holds no data for data buffers in matData. */
+        Eigen::MatrixXf                     matData;        /**< The samples of a data buffer. */
+        bool                                bIsDataBuffer;  /**< Whether the samples are in matData. */
+    };
+
+    //=========================================================================================================
+    /**
+     * Parses the received tag header and prepares the storage for the tag data.
+     */
+    void startTag();
+
+    //=========================================================================================================
+    /**
+     * Converts the completed tag and queues it.
+     */
+    void finishTag();
+
+    std::deque<Entry>           m_dqTags;           /**< The completed tags, oldest first. */
+    QList<Eigen::MatrixXf>      m_lPool;            /**< Matrices kept for reuse. */
+    int                         m_iPoolSize;        /**< Maximal number of matrices kept for reuse. */
+    int                         m_iNumChannels;     /**< The number of channels of a data buffer. */
+
+    Entry                       m_current;          /**< The tag which is currently received. */
+    char                        m_pHeader[16];      /**< The received bytes of the current tag header. */
+    int                         m_iHeaderBytes;     /**< Number of received header bytes. */
+    qint64                      m_iDataBytes;       /**< Number of received data bytes of the current tag. */
+    qint64                      m_iDataSize;        /**< Size of the data of the current tag. */
+    bool                        m_bInHeader;        /**< Whether the header of the current tag is received. */
+
+    Statistics                  m_stats;            /**< The statistics. */
+};
+} // NAMESPACE
+
+#endif // RTTAGREADER_H
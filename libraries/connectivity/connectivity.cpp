@@ -51,6 +51,7 @@
 #include "metrics/weightedphaselagindex.h"
 #include "metrics/unbiasedsquaredphaselagindex.h"
 #include "metrics/debiasedsquaredweightedphaselagindex.h"
+#include "metrics/abstractmetric.h"
 
 //=============================================================================================================
 // QT INCLUDES
@@ -91,6 +92,40 @@ QList<Network> Connectivity::calculate(ConnectivitySettings& connectivitySetting
     QElapsedTimer timer;
     timer.start();
 
+    if(connectivitySettings.isEmpty()) {
+        qWarning() << "Connectivity::calculate - Input data is empty";
+        return results;
+    }
+
+    // All frequency domain metrics share the tapered spectra and the CSD of each trial. Keep the intermediate data
+    // alive while evaluating the requested metrics, so that the FFTs and CSDs are only computed once per trial.
+    // The window type and FFT size setters of the connectivity settings already invalidate the cached data.
+    bool bStorageModeIsActive = AbstractMetric::m_bStorageModeIsActive;
+    bool bShareSpectra = lMethods.size() > 1;
+
+    if(bShareSpectra) {
+        if(!bStorageModeIsActive) {
+            connectivitySettings.clearIntermediateData();
+        }
+
+        // Resolve the frequency bins the same way the metrics do, in order to key the cached CSD correctly
+        int iNFreqs = int(floor(connectivitySettings.getFFTSize() / 2.0)) + 1;
+
+        if(AbstractMetric::m_iNumberBinStart == -1 ||
+           AbstractMetric::m_iNumberBinAmount == -1 ||
+           AbstractMetric::m_iNumberBinStart > iNFreqs ||
+           AbstractMetric::m_iNumberBinAmount > iNFreqs ||
+           AbstractMetric::m_iNumberBinAmount + AbstractMetric::m_iNumberBinStart > iNFreqs) {
+            AbstractMetric::m_iNumberBinStart = 0;
+            AbstractMetric::m_iNumberBinAmount = iNFreqs;
+        }
+
+        connectivitySettings.setFrequencyBinRange(AbstractMetric::m_iNumberBinStart,
+                                                  AbstractMetric::m_iNumberBinAmount);
+
+        AbstractMetric::m_bStorageModeIsActive = true;
+    }
+
     if(lMethods.contains("WPLI")) {
         results.append(WeightedPhaseLagIndex::calculate(connectivitySettings));
     }
@@ -127,6 +162,15 @@ QList<Network> Connectivity::calculate(ConnectivitySettings& connectivitySetting
         results.append(DebiasedSquaredWeightedPhaseLagIndex::calculate(connectivitySettings));
     }
 
+    if(bShareSpectra) {
+        AbstractMetric::m_bStorageModeIsActive = bStorageModeIsActive;
+
+        //Do not store data to save memory
+        if(!bStorageModeIsActive) {
+            connectivitySettings.clearIntermediateData();
+        }
+    }
+
     qWarning() << "Total" << timer.elapsed();
     qDebug() << "Connectivity::calculateMultiMethods - Calculated"<< lMethods <<"for" << connectivitySettings.size() << "trials in"<< timer.elapsed() << "msecs.";
 
@@ -95,24 +95,28 @@ public:
     typedef QSharedPointer<ConnectivitySettings> SPtr;            /**< Shared pointer type for ConnectivitySettings. */
     typedef QSharedPointer<const ConnectivitySettings> ConstSPtr; /**< Const shared pointer type for ConnectivitySettings. */
 
+    /**
+     * The cross spectra are stored in packed upper triangular form. Row p of each CSD matrix holds the frequency
+     * resolved values of the channel pair (i,j), j >= i, in row-major order, see AbstractMetric::pairIndex().
+     */
     struct IntermediateTrialData {
         Eigen::MatrixXd     matData;
         Eigen::MatrixXd     matPsd;
-        QVector<Eigen::MatrixXcd>               vecTapSpectra;
-        QVector<QPair<int,Eigen::MatrixXcd> >   vecPairCsd;
-        QVector<QPair<int,Eigen::MatrixXcd> >   vecPairCsdNormalized;
-        QVector<QPair<int,Eigen::MatrixXd> >    vecPairCsdImagSign;
-        QVector<QPair<int,Eigen::MatrixXd> >    vecPairCsdImagAbs;
-        QVector<QPair<int,Eigen::MatrixXd> >    vecPairCsdImagSqrd;
+        QVector<Eigen::MatrixXcd>   vecTapSpectra;
+        Eigen::MatrixXcd    matCsd;
+        Eigen::MatrixXcd    matCsdNormalized;
+        Eigen::MatrixXd     matCsdImagSign;
+        Eigen::MatrixXd     matCsdImagAbs;
+        Eigen::MatrixXd     matCsdImagSqrd;
     };
 
     struct IntermediateSumData {
         Eigen::MatrixXd     matPsdSum;
-        QVector<QPair<int,Eigen::MatrixXcd> >   vecPairCsdSum;
-        QVector<QPair<int,Eigen::MatrixXcd> >   vecPairCsdNormalizedSum;
-        QVector<QPair<int,Eigen::MatrixXd> >    vecPairCsdImagSignSum;
-        QVector<QPair<int,Eigen::MatrixXd> >    vecPairCsdImagAbsSum;
-        QVector<QPair<int,Eigen::MatrixXd> >    vecPairCsdImagSqrdSum;
+        Eigen::MatrixXcd    matCsdSum;
+        Eigen::MatrixXcd    matCsdNormalizedSum;
+        Eigen::MatrixXd     matCsdImagSignSum;
+        Eigen::MatrixXd     matCsdImagAbsSum;
+        Eigen::MatrixXd     matCsdImagSqrdSum;
     };
 
     //=========================================================================================================
@@ -157,6 +161,18 @@ public:
 
     const QString& getWindowType() const;
 
+    //=========================================================================================================
+    /**
+     * Sets the frequency bin range the stored intermediate CSD data refers to. Together with the window type and
+     * the FFT size this forms the key of the cached spectral data. All intermediate data is cleared if the range
+     * changed.
+     *
+     * @param[in] iBinStart      The first frequency bin.
+     * @param[in] iBinAmount     The number of frequency bins.
+     */
+    void setFrequencyBinRange(int iBinStart,
+                              int iBinAmount);
+
     void setNodePositions(const FIFFLIB::FiffInfo& fiffInfo,
                           const Eigen::RowVectorXi& picks);
 
@@ -172,12 +188,22 @@ public:
     IntermediateSumData& getIntermediateSumData();
 
 protected:
+    //=========================================================================================================
+    /**
+     * Substracts the intermediate data of a trial from the overall summed up intermediate data.
+     *
+     * @param[in] trialData      The trial data to substract.
+     */
+    void subtractFromSum(const IntermediateTrialData& trialData);
+
     QStringList                     m_sConnectivityMethods;         /**< The connectivity methods. */
     QString                         m_sWindowType;                  /**< The window type used to compute tapered spectra. */
 
     float                           m_fSFreq;                       /**< The sampling frequency. */
     int                             m_iNfft;                        /**< The FFT length. Also includes the negativ frequencies. Gets recalculated if the sFreq or spectrum resolution change. */
     float                           m_fFreqResolution;              /**< The spectrum's resolution. */
+    int                             m_iBinStart;                    /**< The first frequency bin the intermediate CSD data was computed for. */
+    int                             m_iBinAmount;                   /**< The number of frequency bins the intermediate CSD data was computed for. */
 
     Eigen::MatrixX3f                m_matNodePositions;             /**< The node position in 3D space. */
 
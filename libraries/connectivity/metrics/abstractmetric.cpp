@@ -46,11 +46,14 @@
 // EIGEN INCLUDES
 //=============================================================================================================
 
+#include <unsupported/Eigen/FFT>
+
 //=============================================================================================================
 // USED NAMESPACES
 //=============================================================================================================
 
 using namespace CONNECTIVITYLIB;
+using namespace Eigen;
 
 //=============================================================================================================
 // DEFINE GLOBAL METHODS
@@ -68,3 +71,113 @@ AbstractMetric::AbstractMetric()
 {
 }
 
+//*******************************************************************************************************
+
+void AbstractMetric::computeTaperedSpectra(ConnectivitySettings::IntermediateTrialData& inputData,
+                                           int iNRows,
+                                           int iNFreqs,
+                                           int iNfft,
+                                           const QPair<MatrixXd, VectorXd>& tapers)
+{
+    if(inputData.vecTapSpectra.size() == iNRows) {
+        return;
+    }
+
+    inputData.vecTapSpectra.clear();
+    inputData.vecTapSpectra.reserve(iNRows);
+
+    // This code was copied and changed modified Utils/Spectra since we do not want to call the function due to time loss.
+    RowVectorXd vecInputFFT, rowData;
+    RowVectorXcd vecTmpFreq;
+
+    MatrixXcd matTapSpectrum(tapers.first.rows(), iNFreqs);
+
+    FFT<double> fft;
+    fft.SetFlag(fft.HalfSpectrum);
+
+    for (int i = 0; i < iNRows; ++i) {
+        // Substract mean
+        rowData.array() = inputData.matData.row(i).array() - inputData.matData.row(i).mean();
+
+        // Calculate tapered spectra
+        for(int j = 0; j < tapers.first.rows(); j++) {
+            // Zero padd if necessary. The zero padding in Eigen's FFT is only working for column vectors.
+            if (rowData.cols() < iNfft) {
+                vecInputFFT.setZero(iNfft);
+                vecInputFFT.block(0,0,1,rowData.cols()) = rowData.cwiseProduct(tapers.first.row(j));
+            } else {
+                vecInputFFT = rowData.cwiseProduct(tapers.first.row(j));
+            }
+
+            // FFT for freq domain returning the half spectrum and multiply taper weights
+            fft.fwd(vecTmpFreq, vecInputFFT, iNfft);
+            matTapSpectrum.row(j) = vecTmpFreq * tapers.second(j);
+        }
+
+        inputData.vecTapSpectra.append(matTapSpectrum);
+    }
+}
+
+//*******************************************************************************************************
+
+void AbstractMetric::computeCsd(ConnectivitySettings::IntermediateTrialData& inputData,
+                                MatrixXcd& matCsdSum,
+                                QMutex& mutex,
+                                int iNRows,
+                                int iNFreqs,
+                                int iNfft,
+                                const QPair<MatrixXd, VectorXd>& tapers)
+{
+    int iNPairs = numberOfPairs(iNRows);
+
+    if(inputData.matCsd.rows() == iNPairs) {
+        return;
+    }
+
+    computeTaperedSpectra(inputData,
+                          iNRows,
+                          iNFreqs,
+                          iNfft,
+                          tapers);
+
+    inputData.matCsd = MatrixXcd::Zero(iNPairs, m_iNumberBinAmount);
+
+    // Gather the spectra of all rows per taper, so that the pairs of a seed row are one contiguous block
+    MatrixXcd matSpectra(iNRows, m_iNumberBinAmount);
+    MatrixXcd matSpectraConj(iNRows, m_iNumberBinAmount);
+
+    for(int t = 0; t < tapers.first.rows(); ++t) {
+        for (int i = 0; i < iNRows; ++i) {
+            matSpectra.row(i) = inputData.vecTapSpectra.at(i).block(t,m_iNumberBinStart,1,m_iNumberBinAmount);
+        }
+
+        matSpectraConj = matSpectra.conjugate();
+
+        // Compute CSD (sum over tapers if necessary) for all pairs (i,j), j >= i
+        for (int i = 0; i < iNRows; ++i) {
+            inputData.matCsd.middleRows(pairIndex(i,i,iNRows), iNRows - i).array() += matSpectraConj.bottomRows(iNRows - i).array().rowwise() * matSpectra.row(i).array();
+        }
+    }
+
+    double denomCSD = sqrt(tapers.second.cwiseAbs2().sum()) * sqrt(tapers.second.cwiseAbs2().sum()) / 2.0;
+    inputData.matCsd /= denomCSD;
+
+    // Divide first and last element by 2 due to half spectrum
+    if(m_iNumberBinStart == 0) {
+        inputData.matCsd.col(0) /= 2.0;
+    }
+
+    if(iNfft % 2 == 0 && m_iNumberBinStart + m_iNumberBinAmount >= iNFreqs) {
+        inputData.matCsd.rightCols(1) /= 2.0;
+    }
+
+    mutex.lock();
+
+    if(matCsdSum.rows() != inputData.matCsd.rows() || matCsdSum.cols() != inputData.matCsd.cols()) {
+        matCsdSum = inputData.matCsd;
+    } else {
+        matCsdSum += inputData.matCsd;
+    }
+
+    mutex.unlock();
+}
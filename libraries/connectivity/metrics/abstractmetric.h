@@ -40,6 +40,7 @@
 //=============================================================================================================
 
 #include "../connectivity_global.h"
+#include "../connectivitysettings.h"
 
 //=============================================================================================================
 // QT INCLUDES
@@ -47,6 +48,8 @@
 
 #include <QSharedPointer>
 #include <QVector>
+#include <QPair>
+#include <QMutex>
 
 //=============================================================================================================
 // EIGEN INCLUDES
@@ -87,6 +90,69 @@ public:
      */
     explicit AbstractMetric();
 
+    //=========================================================================================================
+    /**
+     * Computes the demeaned and tapered half spectra for all rows of a trial. This is the spectral stage shared
+     * by all frequency domain metrics. The spectra are only computed if they are not available already.
+     *
+     * @param[in] inputData      The input data.
+     * @param[in] iNRows         The number of rows.
+     * @param[in] iNFreqs        The number of frequency bins.
+     * @param[in] iNfft          The FFT length.
+     * @param[in] tapers         The taper information.
+     */
+    static void computeTaperedSpectra(ConnectivitySettings::IntermediateTrialData& inputData,
+                                      int iNRows,
+                                      int iNFreqs,
+                                      int iNfft,
+                                      const QPair<Eigen::MatrixXd, Eigen::VectorXd>& tapers);
+
+    //=========================================================================================================
+    /**
+     * Computes the packed upper triangular CSD for the currently selected frequency bins and adds it to the CSD sum.
+     * All channel pairs of one seed row are computed at once as a vectorized complex multiply-accumulate over the
+     * tapers. The CSD is only computed if it is not available already, i.e. if another metric computed it before.
+     *
+     * @param[in] inputData      The input data.
+     * @param[out] matCsdSum     The sum of all packed CSD matrices for each trial.
+     * @param[in] mutex          The mutex used to safely access the sum data.
+     * @param[in] iNRows         The number of rows.
+     * @param[in] iNFreqs        The number of frequency bins.
+     * @param[in] iNfft          The FFT length.
+     * @param[in] tapers         The taper information.
+     */
+    static void computeCsd(ConnectivitySettings::IntermediateTrialData& inputData,
+                           Eigen::MatrixXcd& matCsdSum,
+                           QMutex& mutex,
+                           int iNRows,
+                           int iNFreqs,
+                           int iNfft,
+                           const QPair<Eigen::MatrixXd, Eigen::VectorXd>& tapers);
+
+    //=========================================================================================================
+    /**
+     * Returns the number of channel pairs (i,j), j >= i, stored in the packed upper triangular form.
+     *
+     * @param[in] iNRows         The number of rows.
+     *
+     * @return The number of channel pairs.
+     */
+    static inline int numberOfPairs(int iNRows);
+
+    //=========================================================================================================
+    /**
+     * Returns the row of the channel pair (i,j), j >= i, in the packed upper triangular form.
+     *
+     * @param[in] i              The seed row.
+     * @param[in] j              The target row.
+     * @param[in] iNRows         The number of rows.
+     *
+     * @return The packed row index.
+     */
+    static inline int pairIndex(int i,
+                                int j,
+                                int iNRows);
+
     static bool     m_bStorageModeIsActive;
     static int      m_iNumberBinStart;
     static int      m_iNumberBinAmount;
@@ -97,6 +163,21 @@ protected:
 //=============================================================================================================
 // INLINE DEFINITIONS
 //=============================================================================================================
+
+inline int AbstractMetric::numberOfPairs(int iNRows)
+{
+    return iNRows * (iNRows + 1) / 2;
+}
+
+//=============================================================================================================
+
+inline int AbstractMetric::pairIndex(int i,
+                                     int j,
+                                     int iNRows)
+{
+    return i * iNRows - i * (i - 1) / 2 + j - i;
+}
+
 } // namespace CONNECTIVITYLIB
 
 #endif // ABSTRACTMETRIC_H
@@ -114,7 +114,7 @@ void Coherency::calculateAbs(Network& finalNetwork,
     std::function<void(ConnectivitySettings::IntermediateTrialData&)> computeLambda = [&](ConnectivitySettings::IntermediateTrialData& inputData) {
         compute(inputData,
                 connectivitySettings.getIntermediateSumData().matPsdSum,
-                connectivitySettings.getIntermediateSumData().vecPairCsdSum,
+                connectivitySettings.getIntermediateSumData().matCsdSum,
                 mutex,
                 iNRows,
                 iNFreqs,
@@ -135,16 +135,8 @@ void Coherency::calculateAbs(Network& finalNetwork,
 //    timer.restart();
 
     // Compute CSD/sqrt(PSD_X * PSD_Y)
-    std::function<void(QPair<int,MatrixXcd>&)> computePSDCSDLambda = [&](QPair<int,MatrixXcd>& pairInput) {
-        computePSDCSDAbs(mutex,
-                         finalNetwork,
-                         pairInput,
-                         connectivitySettings.getIntermediateSumData().matPsdSum);
-    };
-
-    QFuture<void> resultCSDPSD = QtConcurrent::map(connectivitySettings.getIntermediateSumData().vecPairCsdSum,
-                                                   computePSDCSDLambda);
-    resultCSDPSD.waitForFinished();
+    finalNetwork.appendPackedEdges(computeCoherency(connectivitySettings.getIntermediateSumData().matCsdSum,
+                                                    connectivitySettings.getIntermediateSumData().matPsdSum).cwiseAbs());
 
 //    iTime = timer.elapsed();
 //    qWarning() << "Compute" << iTime;
@@ -185,7 +177,7 @@ void Coherency::calculateImag(Network& finalNetwork,
     std::function<void(ConnectivitySettings::IntermediateTrialData&)> computeLambda = [&](ConnectivitySettings::IntermediateTrialData& inputData) {
         compute(inputData,
                 connectivitySettings.getIntermediateSumData().matPsdSum,
-                connectivitySettings.getIntermediateSumData().vecPairCsdSum,
+                connectivitySettings.getIntermediateSumData().matCsdSum,
                 mutex,
                 iNRows,
                 iNFreqs,
@@ -206,16 +198,8 @@ void Coherency::calculateImag(Network& finalNetwork,
 //    timer.restart();
 
     // Compute CSD/sqrt(PSD_X * PSD_Y)
-    std::function<void(QPair<int,MatrixXcd>&)> computePSDCSDLambda = [&](QPair<int,MatrixXcd>& pairInput) {
-        computePSDCSDImag(mutex,
-                          finalNetwork,
-                          pairInput,
-                          connectivitySettings.getIntermediateSumData().matPsdSum);
-    };
-
-    QFuture<void> resultCSDPSD = QtConcurrent::map(connectivitySettings.getIntermediateSumData().vecPairCsdSum,
-                                                   computePSDCSDLambda);
-    resultCSDPSD.waitForFinished();
+    finalNetwork.appendPackedEdges(computeCoherency(connectivitySettings.getIntermediateSumData().matCsdSum,
+                                                    connectivitySettings.getIntermediateSumData().matPsdSum).imag());
 
 //    iTime = timer.elapsed();
 //    qWarning() << "Compute" << iTime;
@@ -226,7 +210,7 @@ void Coherency::calculateImag(Network& finalNetwork,
 
 void Coherency::compute(ConnectivitySettings::IntermediateTrialData& inputData,
                         MatrixXd& matPsdSum,
-                        QVector<QPair<int,MatrixXcd> >& vecPairCsdSum,
+                        MatrixXcd& matCsdSum,
                         QMutex& mutex,
                         int iNRows,
                         int iNFreqs,
@@ -237,123 +221,69 @@ void Coherency::compute(ConnectivitySettings::IntermediateTrialData& inputData,
 //    qint64 iTime = 0;
 //    timer.start();
 
-    if(inputData.vecPairCsd.size() == iNRows) {
-        //qDebug() << "Coherency::compute - vecPairCsd were already computed for this trial.";
+    if(inputData.matCsd.rows() == numberOfPairs(iNRows) &&
+       inputData.matPsd.rows() == iNRows) {
+        //qDebug() << "Coherency::compute - matCsd and matPsd were already computed for this trial.";
         return;
     }
 
-    //qDebug() << "Coherency::compute - vecPairCsdSum and matPsdSum are computed for this trial.";
-
-    // Substract mean, compute tapered spectra and PSD
-    // This code was copied and changed modified Utils/Spectra since we do not want to call the function due to time loss.
-    bool bNfftEven = false;
-    if (iNfft % 2 == 0){
-        bNfftEven = true;
-    }
-
-    FFT<double> fft;
-    fft.SetFlag(fft.HalfSpectrum);
+    //qDebug() << "Coherency::compute - matCsdSum and matPsdSum are computed for this trial.";
 
-    double denomPSD = tapers.second.cwiseAbs2().sum() / 2.0;
+    // Substract mean and compute tapered spectra via the shared spectral stage
+    computeTaperedSpectra(inputData,
+                          iNRows,
+                          iNFreqs,
+                          iNfft,
+                          tapers);
 
-    RowVectorXd vecInputFFT, rowData;
-    RowVectorXcd vecTmpFreq;
-
-    MatrixXcd matTapSpectrum(tapers.first.rows(), iNFreqs);
-
-    int i,j;
+    // Compute PSD. The CSD might have been computed by another metric already, the PSD is only needed for the coherency.
+    if(inputData.matPsd.rows() != iNRows) {
+        bool bNfftEven = false;
+        if (iNfft % 2 == 0){
+            bNfftEven = true;
+        }
 
-    inputData.matPsd = MatrixXd(iNRows, m_iNumberBinAmount);
+        double denomPSD = tapers.second.cwiseAbs2().sum() / 2.0;
 
-    for (i = 0; i < iNRows; ++i) {
-        // Substract mean
-        rowData.array() = inputData.matData.row(i).array() - inputData.matData.row(i).mean();
+        inputData.matPsd = MatrixXd(iNRows, m_iNumberBinAmount);
 
-        // Calculate tapered spectra if not available already
-        if(inputData.vecTapSpectra.size() != iNRows) {
-            for(j = 0; j < tapers.first.rows(); j++) {
-                // Zero padd if necessary. The zero padding in Eigen's FFT is only working for column vectors.
-                if (rowData.cols() < iNfft) {
-                    vecInputFFT.setZero(iNfft);
-                    vecInputFFT.block(0,0,1,rowData.cols()) = rowData.cwiseProduct(tapers.first.row(j));;
-                } else {
-                    vecInputFFT = rowData.cwiseProduct(tapers.first.row(j));
-                }
+        for (int i = 0; i < iNRows; ++i) {
+            // Compute PSD (average over tapers if necessary).
+            inputData.matPsd.row(i) = inputData.vecTapSpectra.at(i).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(i).rows(),m_iNumberBinAmount).cwiseAbs2().colwise().sum() / denomPSD;
 
-                // FFT for freq domain returning the half spectrum and multiply taper weights
-                fft.fwd(vecTmpFreq, vecInputFFT, iNfft);
-                matTapSpectrum.row(j) = vecTmpFreq * tapers.second(j);
+            // Divide first and last element by 2 due to half spectrum
+            if(m_iNumberBinStart == 0) {
+                inputData.matPsd.row(i)(0) /= 2.0;
             }
 
-            inputData.vecTapSpectra.append(matTapSpectrum);
+            if(bNfftEven && m_iNumberBinStart + m_iNumberBinAmount >= iNFreqs) {
+                inputData.matPsd.row(i).tail(1) /= 2.0;
+            }
         }
 
-        // Compute PSD (average over tapers if necessary).
-        inputData.matPsd.row(i) = inputData.vecTapSpectra.at(i).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(i).rows(),m_iNumberBinAmount).cwiseAbs2().colwise().sum() / denomPSD;
-
-        // Divide first and last element by 2 due to half spectrum
-        if(m_iNumberBinStart == 0) {
-            inputData.matPsd.row(i)(0) /= 2.0;
-        }
+        mutex.lock();
 
-        if(bNfftEven && m_iNumberBinStart + m_iNumberBinAmount >= iNFreqs) {
-            inputData.matPsd.row(i).tail(1) /= 2.0;
+        if(matPsdSum.rows() == 0 || matPsdSum.cols() == 0) {
+            matPsdSum = inputData.matPsd;
+        } else {
+            matPsdSum += inputData.matPsd;
         }
-    }
 
-    mutex.lock();
-
-    if(matPsdSum.rows() == 0 || matPsdSum.cols() == 0) {
-        matPsdSum = inputData.matPsd;
-    } else {
-        matPsdSum += inputData.matPsd;
+        mutex.unlock();
     }
 
-    mutex.unlock();
-
 //    iTime = timer.elapsed();
 //    qWarning() << QThread::currentThreadId() << "Coherency::compute timer - compute - Tapered spectra and PSD (summing):" << iTime;
 //    timer.restart();
 
     // Compute CSD
-    if(inputData.vecPairCsd.size() != iNRows) {
-        inputData.vecPairCsd.clear();
-
-        //MatrixXcd matCsd = MatrixXcd(iNRows, iNFreqs);
-        MatrixXcd matCsd = MatrixXcd(iNRows, m_iNumberBinAmount);
-
-        double denomCSD = sqrt(tapers.second.cwiseAbs2().sum()) * sqrt(tapers.second.cwiseAbs2().sum()) / 2.0;
-
-        for (i = 0; i < iNRows; ++i) {
-            for (j = i; j < iNRows; ++j) {
-                // Compute CSD (average over tapers if necessary)
-                matCsd.row(j) = inputData.vecTapSpectra.at(i).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(i).rows(),m_iNumberBinAmount).cwiseProduct(inputData.vecTapSpectra.at(j).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(j).rows(),m_iNumberBinAmount).conjugate()).colwise().sum() / denomCSD;
-
-                // Divide first and last element by 2 due to half spectrum
-                if(m_iNumberBinStart == 0) {
-                    matCsd.row(j)(0) /= 2.0;
-                }
-
-                if(bNfftEven && m_iNumberBinStart + m_iNumberBinAmount >= iNFreqs) {
-                    matCsd.row(j).tail(1) /= 2.0;
-                }
-            }
-
-            inputData.vecPairCsd.append(QPair<int,MatrixXcd>(i,matCsd));
-        }
-
-        mutex.lock();
-
-        if(vecPairCsdSum.isEmpty()) {
-            vecPairCsdSum = inputData.vecPairCsd;
-        } else {
-            for (j = 0; j < vecPairCsdSum.size(); ++j) {
-                vecPairCsdSum[j].second += inputData.vecPairCsd.at(j).second;
-            }
-        }
-
-        mutex.unlock();
-    }
+    computeCsd(inputData,
+               matCsdSum,
+               mutex,
+               iNRows,
+               iNFreqs,
+               iNfft,
+               tapers);
 
 //    iTime = timer.elapsed();
 //    qWarning() << QThread::currentThreadId() << "Coherency::compute timer - compute - CSD summing:" << iTime;
@@ -361,7 +291,7 @@ void Coherency::compute(ConnectivitySettings::IntermediateTrialData& inputData,
 
     //Do not store data to save memory
     if(!m_bStorageModeIsActive) {
-        inputData.vecPairCsd.clear();
+        inputData.matCsd.resize(0,0);
         inputData.vecTapSpectra.clear();
     }
 
@@ -372,67 +302,22 @@ void Coherency::compute(ConnectivitySettings::IntermediateTrialData& inputData,
 
 //=============================================================================================================
 
-void Coherency::computePSDCSDAbs(QMutex& mutex,
-                                 Network& finalNetwork,
-                                 const QPair<int,MatrixXcd>& pairInput,
-                                 const MatrixXd& matPsdSum)
+MatrixXcd Coherency::computeCoherency(const MatrixXcd& matCsdSum,
+                                     const MatrixXd& matPsdSum)
 {
-    MatrixXd matPSDtmp(matPsdSum.rows(), matPsdSum.cols());
-    RowVectorXd rowPsdSum = matPsdSum.row(pairInput.first);
-
-    for(int j = 0; j < matPSDtmp.rows(); ++j) {
-        matPSDtmp.row(j) = rowPsdSum.cwiseProduct(matPsdSum.row(j));
-    }
-
-    // Average. Note that the number of trials cancel each other out.
-    MatrixXcd matCohy = pairInput.second.cwiseQuotient(matPSDtmp.cwiseSqrt());
-
-    QSharedPointer<NetworkEdge> pEdge;
-    MatrixXd matWeight;
-    int j;
-    int i = pairInput.first;
-
-    for(j = i; j < matCohy.rows(); ++j) {
-        matWeight = matCohy.row(j).cwiseAbs().transpose();
-        pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
+    int iNRows = matPsdSum.rows();
+    MatrixXd matPsdProduct(matCsdSum.rows(), matCsdSum.cols());
 
-        mutex.lock();
-        finalNetwork.getNodeAt(i)->append(pEdge);
-        finalNetwork.getNodeAt(j)->append(pEdge);
-        finalNetwork.append(pEdge);
-        mutex.unlock();
+    if(matCsdSum.rows() != numberOfPairs(iNRows)) {
+        qDebug() << "Coherency::computeCoherency - Number of CSD pairs does not match the PSD. Returning.";
+        return MatrixXcd();
     }
-}
-
-//=============================================================================================================
-
-void Coherency::computePSDCSDImag(QMutex& mutex,
-                                  Network& finalNetwork,
-                                  const QPair<int,MatrixXcd>& pairInput,
-                                  const MatrixXd& matPsdSum)
-{
-    MatrixXd matPSDtmp(matPsdSum.rows(), matPsdSum.cols());
-    RowVectorXd rowPsdSum = matPsdSum.row(pairInput.first);
 
-    for(int j = 0; j < matPSDtmp.rows(); ++j) {
-        matPSDtmp.row(j) = rowPsdSum.cwiseProduct(matPsdSum.row(j));
+    // PSD_X * PSD_Y for all pairs (i,j), j >= i
+    for(int i = 0; i < iNRows; ++i) {
+        matPsdProduct.middleRows(pairIndex(i,i,iNRows), iNRows - i).array() = matPsdSum.bottomRows(iNRows - i).array().rowwise() * matPsdSum.row(i).array();
     }
 
-    MatrixXcd matCohy = pairInput.second.cwiseQuotient(matPSDtmp.cwiseSqrt());
-
-    QSharedPointer<NetworkEdge> pEdge;
-    MatrixXd matWeight;
-    int j;
-    int i = pairInput.first;
-
-    for(j = i; j < matCohy.rows(); ++j) {
-        matWeight = matCohy.row(j).imag().transpose();
-        pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
-
-        mutex.lock();
-        finalNetwork.getNodeAt(i)->append(pEdge);
-        finalNetwork.getNodeAt(j)->append(pEdge);
-        finalNetwork.append(pEdge);
-        mutex.unlock();
-    }
+    // Average. Note that the number of trials cancel each other out.
+    return matCsdSum.cwiseQuotient(matPsdProduct.cwiseSqrt());
 }
@@ -123,8 +123,8 @@ private:
      *
      * @param[in]    inputData           The input data.
      * @param[out]   matPsdSum           The sum of all PSD matrices for each trial.
-     * @param[out]   vecPairCsdSum       The sum of all CSD matrices for each trial.
-     * @param[in]    mutex               The mutex used to safely access matPsdSum and vecPairCsdSum.
+     * @param[out]   matCsdSum           The sum of all packed CSD matrices for each trial.
+     * @param[in]    mutex               The mutex used to safely access matPsdSum and matCsdSum.
      * @param[in]    iNRows              The number of rows.
      * @param[in]    iNFreqs             The number of frequenciy bins.
      * @param[in]    iNfft               The FFT length.
@@ -132,7 +132,7 @@ private:
      */
     static void compute(ConnectivitySettings::IntermediateTrialData& inputData,
                         Eigen::MatrixXd& matPsdSum,
-                        QVector<QPair<int,Eigen::MatrixXcd> >& vecPairCsdSum,
+                        Eigen::MatrixXcd& matCsdSum,
                         QMutex& mutex,
                         int iNRows,
                         int iNFreqs,
@@ -141,16 +141,15 @@ private:
 
     //=========================================================================================================
     /**
-     * Computes the PSD and CSD. This function gets called in parallel.
+     * Computes the packed coherency CSD/sqrt(PSD_X * PSD_Y) for all channel pairs.
+     *
+     * @param[in]    matCsdSum           The sum of all packed CSD matrices.
+     * @param[in]    matPsdSum           The sum of all PSD matrices.
+     *
+     * @return The packed coherency with one row per channel pair.
      */
-    static void computePSDCSDAbs(QMutex& mutex,
-                                 Network& finalNetwork,
-                                 const QPair<int,Eigen::MatrixXcd>& pairInput,
-                                 const Eigen::MatrixXd& matPsdSum);
-    static void computePSDCSDImag(QMutex& mutex,
-                                  Network& finalNetwork,
-                                  const QPair<int,Eigen::MatrixXcd>& pairInput,
-                                  const Eigen::MatrixXd& matPsdSum);
+    static Eigen::MatrixXcd computeCoherency(const Eigen::MatrixXcd& matCsdSum,
+                                             const Eigen::MatrixXd& matPsdSum);
 };
 
 //=============================================================================================================
@@ -186,8 +186,7 @@ void CrossCorrelation::compute(ConnectivitySettings::IntermediateTrialData& inpu
 //    qint64 iTime = 0;
 //    timer.start();
 
-    // Calculate tapered spectra if not available already
-    RowVectorXd vecInputFFT, rowData;
+    RowVectorXd vecInputFFT;
     RowVectorXcd vecResultFreq;
 
     FFT<double> fft;
@@ -196,34 +195,12 @@ void CrossCorrelation::compute(ConnectivitySettings::IntermediateTrialData& inpu
     int i, j;
     int iNRows = inputData.matData.rows();
 
-    // Calculate tapered spectra if not available already
-    // This code was copied and changed modified Utils/Spectra since we do not want to call the function due to time loss.
-    if(inputData.vecTapSpectra.isEmpty()) {
-        int iNFreqs = int(floor(iNfft / 2.0)) + 1;
-        MatrixXcd matTapSpectrum(tapers.first.rows(), iNFreqs);
-
-        for (i = 0; i < iNRows; ++i) {
-            // Substract mean
-            rowData.array() = inputData.matData.row(i).array() - inputData.matData.row(i).mean();
-
-            // Calculate tapered spectra
-            for(j = 0; j < tapers.first.rows(); j++) {
-                // Zero padd if necessary. The zero padding in Eigen's FFT is only working for column vectors.
-                if (rowData.cols() < iNfft) {
-                    vecInputFFT.setZero(iNfft);
-                    vecInputFFT.block(0,0,1,rowData.cols()) = rowData.cwiseProduct(tapers.first.row(j));;
-                } else {
-                    vecInputFFT = rowData.cwiseProduct(tapers.first.row(j));
-                }
-
-                // FFT for freq domain returning the half spectrum and multiply taper weights
-                fft.fwd(vecResultFreq, vecInputFFT, iNfft);
-                matTapSpectrum.row(j) = vecResultFreq * tapers.second(j);
-            }
-
-            inputData.vecTapSpectra.append(matTapSpectrum);
-        }
-    }
+    // Calculate tapered spectra via the shared spectral stage if not available already
+    computeTaperedSpectra(inputData,
+                          iNRows,
+                          int(floor(iNfft / 2.0)) + 1,
+                          iNfft,
+                          tapers);
 
 //    iTime = timer.elapsed();
 //    qDebug() << QThread::currentThreadId() << "CrossCorrelation::compute timer - Tapered spectra:" << iTime;
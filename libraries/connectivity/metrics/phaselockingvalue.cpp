@@ -150,8 +150,8 @@ Network PhaseLockingValue::calculate(ConnectivitySettings& connectivitySettings)
 
     std::function<void(ConnectivitySettings::IntermediateTrialData&)> computeLambda = [&](ConnectivitySettings::IntermediateTrialData& inputData) {
         compute(inputData,
-                connectivitySettings.getIntermediateSumData().vecPairCsdSum,
-                connectivitySettings.getIntermediateSumData().vecPairCsdNormalizedSum,
+                connectivitySettings.getIntermediateSumData().matCsdSum,
+                connectivitySettings.getIntermediateSumData().matCsdNormalizedSum,
                 mutex,
                 iNRows,
                 iNFreqs,
@@ -186,122 +186,50 @@ Network PhaseLockingValue::calculate(ConnectivitySettings& connectivitySettings)
 //=============================================================================================================
 
 void PhaseLockingValue::compute(ConnectivitySettings::IntermediateTrialData& inputData,
-                                QVector<QPair<int,Eigen::MatrixXcd> >& vecPairCsdSum,
-                                QVector<QPair<int,MatrixXcd> >& vecPairCsdNormalizedSum,
+                                MatrixXcd& matCsdSum,
+                                MatrixXcd& matCsdNormalizedSum,
                                 QMutex& mutex,
                                 int iNRows,
                                 int iNFreqs,
                                 int iNfft,
                                 const QPair<MatrixXd, VectorXd>& tapers)
 {
-    if(inputData.vecPairCsdNormalized.size() == iNRows) {
-        //qDebug() << "PhaseLockingValue::compute - vecPairCsdNormalized was already computed for this trial.";
-        return;
-    }
-
-    int i,j;
-
-    // Calculate tapered spectra if not available already
-    // This code was copied and changed modified Utils/Spectra since we do not want to call the function due to time loss.
-    if(inputData.vecTapSpectra.isEmpty()) {
-        RowVectorXd vecInputFFT, rowData;
-        RowVectorXcd vecTmpFreq;
-
-        MatrixXcd matTapSpectrum(tapers.first.rows(), iNFreqs);
-
-        FFT<double> fft;
-        fft.SetFlag(fft.HalfSpectrum);
-
-        for (i = 0; i < iNRows; ++i) {
-            // Substract mean
-            rowData.array() = inputData.matData.row(i).array() - inputData.matData.row(i).mean();
+    int iNPairs = numberOfPairs(iNRows);
 
-            // Calculate tapered spectra if not available already
-            for(j = 0; j < tapers.first.rows(); j++) {
-                // Zero padd if necessary. The zero padding in Eigen's FFT is only working for column vectors.
-                if (rowData.cols() < iNfft) {
-                    vecInputFFT.setZero(iNfft);
-                    vecInputFFT.block(0,0,1,rowData.cols()) = rowData.cwiseProduct(tapers.first.row(j));;
-                } else {
-                    vecInputFFT = rowData.cwiseProduct(tapers.first.row(j));
-                }
-
-                // FFT for freq domain returning the half spectrum and multiply taper weights
-                fft.fwd(vecTmpFreq, vecInputFFT, iNfft);
-                matTapSpectrum.row(j) = vecTmpFreq * tapers.second(j);
-            }
-
-            inputData.vecTapSpectra.append(matTapSpectrum);
-        }
+    if(inputData.matCsdNormalized.rows() == iNPairs) {
+        //qDebug() << "PhaseLockingValue::compute - matCsdNormalized was already computed for this trial.";
+        return;
     }
 
-    // Compute CSD
-    if(inputData.vecPairCsd.isEmpty()) {
-        MatrixXcd matCsd = MatrixXcd(iNRows, m_iNumberBinAmount);
-
-        bool bNfftEven = false;
-        if (iNfft % 2 == 0){
-            bNfftEven = true;
-        }
+    // Compute tapered spectra and CSD via the shared spectral stage. Both are only computed if they are not available
+    // already, e.g. because another metric was evaluated on the same trial data before.
+    computeCsd(inputData,
+               matCsdSum,
+               mutex,
+               iNRows,
+               iNFreqs,
+               iNfft,
+               tapers);
 
-        double denomCSD = sqrt(tapers.second.cwiseAbs2().sum()) * sqrt(tapers.second.cwiseAbs2().sum()) / 2.0;
-
-        for (i = 0; i < iNRows; ++i) {
-            for (j = i; j < iNRows; ++j) {
-                // Compute CSD (average over tapers if necessary)
-                matCsd.row(j) = inputData.vecTapSpectra.at(i).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(i).rows(),m_iNumberBinAmount).cwiseProduct(inputData.vecTapSpectra.at(j).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(j).rows(),m_iNumberBinAmount).conjugate()).colwise().sum() / denomCSD;
-
-                // Divide first and last element by 2 due to half spectrum
-                if(m_iNumberBinStart == 0) {
-                    matCsd.row(j)(0) /= 2.0;
-                }
-
-                if(bNfftEven && m_iNumberBinStart + m_iNumberBinAmount >= iNFreqs) {
-                    matCsd.row(j).tail(1) /= 2.0;
-                }
-            }
-
-            inputData.vecPairCsd.append(QPair<int,MatrixXcd>(i,matCsd));
-            inputData.vecPairCsdNormalized.append(QPair<int,MatrixXcd>(i,matCsd.cwiseQuotient(matCsd.cwiseAbs())));
-        }
+    if(inputData.matCsdNormalized.rows() != iNPairs) {
+        inputData.matCsdNormalized = inputData.matCsd.cwiseQuotient(inputData.matCsd.cwiseAbs());
 
         mutex.lock();
 
-        if(vecPairCsdSum.isEmpty()) {
-            vecPairCsdSum = inputData.vecPairCsd;
-            vecPairCsdNormalizedSum = inputData.vecPairCsdNormalized;
+        if(matCsdNormalizedSum.rows() != inputData.matCsdNormalized.rows() || matCsdNormalizedSum.cols() != inputData.matCsdNormalized.cols()) {
+            matCsdNormalizedSum = inputData.matCsdNormalized;
         } else {
-            for (int j = 0; j < vecPairCsdSum.size(); ++j) {
-                vecPairCsdSum[j].second += inputData.vecPairCsd.at(j).second;
-                vecPairCsdNormalizedSum[j].second += inputData.vecPairCsdNormalized.at(j).second;
-            }
+            matCsdNormalizedSum += inputData.matCsdNormalized;
         }
 
         mutex.unlock();
-    } else {
-        if(inputData.vecPairCsdNormalized.isEmpty()) {
-            for (i = 0; i < iNRows; ++i) {
-                inputData.vecPairCsdNormalized.append(QPair<int,MatrixXcd>(i,inputData.vecPairCsd.at(i).second.cwiseQuotient(inputData.vecPairCsd.at(i).second.cwiseAbs())));
-            }
-
-            mutex.lock();
-
-            if(vecPairCsdNormalizedSum.isEmpty()) {
-                vecPairCsdNormalizedSum = inputData.vecPairCsdNormalized;
-            } else {
-                for (int j = 0; j < vecPairCsdNormalizedSum.size(); ++j) {
-                    vecPairCsdNormalizedSum[j].second += inputData.vecPairCsdNormalized.at(j).second;
-                }
-            }
-
-            mutex.unlock();
-        }
     }
 
+    //Do not store data to save memory
     if(!m_bStorageModeIsActive) {
-        inputData.vecPairCsd.clear();
+        inputData.matCsd.resize(0,0);
         inputData.vecTapSpectra.clear();
-        inputData.vecPairCsdNormalized.clear();
+        inputData.matCsdNormalized.resize(0,0);
     }
 }
 
@@ -311,22 +239,5 @@ void PhaseLockingValue::computePLV(ConnectivitySettings &connectivitySettings,
                                    Network& finalNetwork)
 {
     // Compute final PLV and create Network
-    MatrixXd matNom;
-    MatrixXd matWeight;
-    QSharedPointer<NetworkEdge> pEdge;
-    int j;
-
-    for (int i = 0; i < connectivitySettings.at(0).matData.rows(); ++i) {
-        matNom = connectivitySettings.getIntermediateSumData().vecPairCsdNormalizedSum.at(i).second.cwiseAbs() / connectivitySettings.size();
-
-        for(j = i; j < connectivitySettings.at(0).matData.rows(); ++j) {
-            matWeight = matNom.row(j).transpose();
-
-            pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
-
-            finalNetwork.getNodeAt(i)->append(pEdge);
-            finalNetwork.getNodeAt(j)->append(pEdge);
-            finalNetwork.append(pEdge);
-        }
-    }
+    finalNetwork.appendPackedEdges(connectivitySettings.getIntermediateSumData().matCsdNormalizedSum.cwiseAbs() / connectivitySettings.size());
 }
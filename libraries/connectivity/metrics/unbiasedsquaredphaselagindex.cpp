@@ -151,8 +151,8 @@ Network UnbiasedSquaredPhaseLagIndex::calculate(ConnectivitySettings& connectivi
 
     std::function<void(ConnectivitySettings::IntermediateTrialData&)> computeLambda = [&](ConnectivitySettings::IntermediateTrialData& inputData) {
         compute(inputData,
-                connectivitySettings.getIntermediateSumData().vecPairCsdSum,
-                connectivitySettings.getIntermediateSumData().vecPairCsdImagSignSum,
+                connectivitySettings.getIntermediateSumData().matCsdSum,
+                connectivitySettings.getIntermediateSumData().matCsdImagSignSum,
                 mutex,
                 iNRows,
                 iNFreqs,
@@ -187,124 +187,50 @@ Network UnbiasedSquaredPhaseLagIndex::calculate(ConnectivitySettings& connectivi
 //=============================================================================================================
 
 void UnbiasedSquaredPhaseLagIndex::compute(ConnectivitySettings::IntermediateTrialData& inputData,
-                                           QVector<QPair<int,MatrixXcd> >& vecPairCsdSum,
-                                           QVector<QPair<int,MatrixXd> >& vecPairCsdImagSignSum,
+                                           MatrixXcd& matCsdSum,
+                                           MatrixXd& matCsdImagSignSum,
                                            QMutex& mutex,
                                            int iNRows,
                                            int iNFreqs,
                                            int iNfft,
                                            const QPair<MatrixXd, VectorXd>& tapers)
 {
-    if(inputData.vecPairCsdImagSign.size() == iNRows) {
-        //qDebug() << "UnbiasedSquaredPhaseLagIndex::compute - vecPairCsdImagSign was already computed for this trial.";
+    int iNPairs = numberOfPairs(iNRows);
+
+    if(inputData.matCsdImagSign.rows() == iNPairs) {
+        //qDebug() << "UnbiasedSquaredPhaseLagIndex::compute - matCsdImagSign was already computed for this trial.";
         return;
     }
 
-    int i,j;
-
-    // Calculate tapered spectra if not available already
-    // This code was copied and changed modified Utils/Spectra since we do not want to call the function due to time loss.
-    if(inputData.vecTapSpectra.size() != iNRows) {
-        inputData.vecTapSpectra.clear();
-
-        RowVectorXd vecInputFFT, rowData;
-        RowVectorXcd vecTmpFreq;
-
-        MatrixXcd matTapSpectrum(tapers.first.rows(), iNFreqs);
-
-        FFT<double> fft;
-        fft.SetFlag(fft.HalfSpectrum);
-
-        for (i = 0; i < iNRows; ++i) {
-            // Substract mean
-            rowData.array() = inputData.matData.row(i).array() - inputData.matData.row(i).mean();
+    // Compute tapered spectra and CSD via the shared spectral stage. Both are only computed if they are not available
+    // already, e.g. because another metric was evaluated on the same trial data before.
+    computeCsd(inputData,
+               matCsdSum,
+               mutex,
+               iNRows,
+               iNFreqs,
+               iNfft,
+               tapers);
 
-            // Calculate tapered spectra if not available already
-            for(j = 0; j < tapers.first.rows(); j++) {
-                // Zero padd if necessary. The zero padding in Eigen's FFT is only working for column vectors.
-                if (rowData.cols() < iNfft) {
-                    vecInputFFT.setZero(iNfft);
-                    vecInputFFT.block(0,0,1,rowData.cols()) = rowData.cwiseProduct(tapers.first.row(j));;
-                } else {
-                    vecInputFFT = rowData.cwiseProduct(tapers.first.row(j));
-                }
-
-                // FFT for freq domain returning the half spectrum and multiply taper weights
-                fft.fwd(vecTmpFreq, vecInputFFT, iNfft);
-                matTapSpectrum.row(j) = vecTmpFreq * tapers.second(j);
-            }
-
-            inputData.vecTapSpectra.append(matTapSpectrum);
-        }
-    }
-
-    // Compute CSD
-    if(inputData.vecPairCsd.isEmpty()) {
-        double denomCSD = sqrt(tapers.second.cwiseAbs2().sum()) * sqrt(tapers.second.cwiseAbs2().sum()) / 2.0;
-
-        bool bNfftEven = false;
-        if (iNfft % 2 == 0){
-            bNfftEven = true;
-        }
-
-        MatrixXcd matCsd = MatrixXcd(iNRows, m_iNumberBinAmount);
-
-        for (i = 0; i < iNRows; ++i) {
-            for (j = i; j < iNRows; ++j) {
-                // Compute CSD (average over tapers if necessary)
-                matCsd.row(j) = inputData.vecTapSpectra.at(i).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(i).rows(),m_iNumberBinAmount).cwiseProduct(inputData.vecTapSpectra.at(j).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(j).rows(),m_iNumberBinAmount).conjugate()).colwise().sum() / denomCSD;
-
-                // Divide first and last element by 2 due to half spectrum
-                if(m_iNumberBinStart == 0) {
-                    matCsd.row(j)(0) /= 2.0;
-                }
-
-                if(bNfftEven && m_iNumberBinStart + m_iNumberBinAmount >= iNFreqs) {
-                    matCsd.row(j).tail(1) /= 2.0;
-                }
-            }
-
-            inputData.vecPairCsd.append(QPair<int,MatrixXcd>(i,matCsd));
-            inputData.vecPairCsdImagSign.append(QPair<int,MatrixXd>(i,matCsd.imag().cwiseSign()));
-        }
+    if(inputData.matCsdImagSign.rows() != iNPairs) {
+        inputData.matCsdImagSign = inputData.matCsd.imag().cwiseSign();
 
         mutex.lock();
 
-        if(vecPairCsdSum.isEmpty()) {
-            vecPairCsdSum = inputData.vecPairCsd;
-            vecPairCsdImagSignSum = inputData.vecPairCsdImagSign;
+        if(matCsdImagSignSum.rows() != inputData.matCsdImagSign.rows() || matCsdImagSignSum.cols() != inputData.matCsdImagSign.cols()) {
+            matCsdImagSignSum = inputData.matCsdImagSign;
         } else {
-            for (int j = 0; j < vecPairCsdSum.size(); ++j) {
-                vecPairCsdSum[j].second += inputData.vecPairCsd.at(j).second;
-                vecPairCsdImagSignSum[j].second += inputData.vecPairCsdImagSign.at(j).second;
-            }
+            matCsdImagSignSum += inputData.matCsdImagSign;
         }
 
         mutex.unlock();
-    } else {
-        if(inputData.vecPairCsdImagSign.isEmpty()) {
-            for (i = 0; i < inputData.vecPairCsd.size(); ++i) {
-                inputData.vecPairCsdImagSign.append(QPair<int,MatrixXd>(i,inputData.vecPairCsd.at(i).second.imag().cwiseSign()));
-            }
-
-            mutex.lock();
-
-            if(vecPairCsdImagSignSum.isEmpty()) {
-                vecPairCsdImagSignSum = inputData.vecPairCsdImagSign;
-            } else {
-                for (int j = 0; j < vecPairCsdImagSignSum.size(); ++j) {
-                    vecPairCsdImagSignSum[j].second += inputData.vecPairCsdImagSign.at(j).second;
-                }
-            }
-
-            mutex.unlock();
-        }
     }
 
+    //Do not store data to save memory
     if(!m_bStorageModeIsActive) {
-        inputData.vecPairCsd.clear();
+        inputData.matCsd.resize(0,0);
         inputData.vecTapSpectra.clear();
-        inputData.vecPairCsdImagSign.clear();
+        inputData.matCsdImagSign.resize(0,0);
     }
 }
 
@@ -313,26 +239,12 @@ void UnbiasedSquaredPhaseLagIndex::compute(ConnectivitySettings::IntermediateTri
 void UnbiasedSquaredPhaseLagIndex::computeUSPLI(ConnectivitySettings &connectivitySettings,
                                Network& finalNetwork)
 {
-    // Compute final DSWPLV and create Network
-    MatrixXd matNom;
-    MatrixXd matWeight;
-    QSharedPointer<NetworkEdge> pEdge;
-    int j;
+    // Compute final USPLI and create Network
     double dNTrials = double(connectivitySettings.size() - 1.0);
 
-    for (int i = 0; i < connectivitySettings.getIntermediateSumData().vecPairCsdImagSignSum.size(); ++i) {
-        matNom = connectivitySettings.getIntermediateSumData().vecPairCsdImagSignSum.at(i).second.cwiseAbs() / connectivitySettings.size();
-        matNom = (connectivitySettings.size() * matNom.array().square() - 1.0) / dNTrials;
-
-        for(j = i; j < matNom.rows(); ++j) {
-            matWeight = matNom.row(j).transpose();
+    MatrixXd matNom = connectivitySettings.getIntermediateSumData().matCsdImagSignSum.cwiseAbs() / connectivitySettings.size();
+    matNom = (connectivitySettings.size() * matNom.array().square() - 1.0) / dNTrials;
 
-            pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
-
-            finalNetwork.getNodeAt(i)->append(pEdge);
-            finalNetwork.getNodeAt(j)->append(pEdge);
-            finalNetwork.append(pEdge);
-        }
-    }
+    finalNetwork.appendPackedEdges(matNom);
 }
 
@@ -152,8 +152,8 @@ Network WeightedPhaseLagIndex::calculate(ConnectivitySettings& connectivitySetti
 
     std::function<void(ConnectivitySettings::IntermediateTrialData&)> computeLambda = [&](ConnectivitySettings::IntermediateTrialData& inputData) {
         compute(inputData,
-                connectivitySettings.getIntermediateSumData().vecPairCsdSum,
-                connectivitySettings.getIntermediateSumData().vecPairCsdImagAbsSum,
+                connectivitySettings.getIntermediateSumData().matCsdSum,
+                connectivitySettings.getIntermediateSumData().matCsdImagAbsSum,
                 mutex,
                 iNRows,
                 iNFreqs,
@@ -188,142 +188,51 @@ Network WeightedPhaseLagIndex::calculate(ConnectivitySettings& connectivitySetti
 //=============================================================================================================
 
 void WeightedPhaseLagIndex::compute(ConnectivitySettings::IntermediateTrialData& inputData,
-                                    QVector<QPair<int,MatrixXcd> >& vecPairCsdSum,
-                                    QVector<QPair<int,MatrixXd> >& vecPairCsdImagAbsSum,
+                                    MatrixXcd& matCsdSum,
+                                    MatrixXd& matCsdImagAbsSum,
                                     QMutex& mutex,
                                     int iNRows,
                                     int iNFreqs,
                                     int iNfft,
                                     const QPair<MatrixXd, VectorXd>& tapers)
 {
-//    QElapsedTimer timer;
-//    qint64 iTime = 0;
-//    timer.start();
+    int iNPairs = numberOfPairs(iNRows);
 
-    if(inputData.vecPairCsd.size() == iNRows &&
-       inputData.vecPairCsdImagAbs.size() == iNRows ) {
-        //qDebug() << "WeightedPhaseLagIndex::compute - vecPairCsd and vecPairCsdImagAbs were already computed for this trial.";
+    if(inputData.matCsd.rows() == iNPairs &&
+       inputData.matCsdImagAbs.rows() == iNPairs) {
+        //qDebug() << "WeightedPhaseLagIndex::compute - matCsd and matCsdImagAbs were already computed for this trial.";
         return;
     }
 
-    int i,j;
-
-    // Calculate tapered spectra if not available already
-    // This code was copied and changed modified Utils/Spectra since we do not want to call the function due to time loss.
-    if(inputData.vecTapSpectra.size() != iNRows) {
-        inputData.vecTapSpectra.clear();
-
-        RowVectorXd vecInputFFT, rowData;
-        RowVectorXcd vecTmpFreq;
-
-        MatrixXcd matTapSpectrum(tapers.first.rows(), iNFreqs);
-
-        FFT<double> fft;
-        fft.SetFlag(fft.HalfSpectrum);
-
-        for (i = 0; i < iNRows; ++i) {
-            // Substract mean
-            rowData.array() = inputData.matData.row(i).array() - inputData.matData.row(i).mean();
-
-            // Calculate tapered spectra if not available already
-            for(j = 0; j < tapers.first.rows(); j++) {
-                // Zero padd if necessary. The zero padding in Eigen's FFT is only working for column vectors.
-                if (rowData.cols() < iNfft) {
-                    vecInputFFT.setZero(iNfft);
-                    vecInputFFT.block(0,0,1,rowData.cols()) = rowData.cwiseProduct(tapers.first.row(j));;
-                } else {
-                    vecInputFFT = rowData.cwiseProduct(tapers.first.row(j));
-                }
-
-                // FFT for freq domain returning the half spectrum and multiply taper weights
-                fft.fwd(vecTmpFreq, vecInputFFT, iNfft);
-                matTapSpectrum.row(j) = vecTmpFreq * tapers.second(j);
-            }
-
-            inputData.vecTapSpectra.append(matTapSpectrum);
-        }
-
-//        iTime = timer.elapsed();
-//        qWarning() << "WeightedPhaseLagIndex::compute timer - Compute spectra:" << iTime;
-//        timer.restart();
-    }
-
-    // Compute CSD
-    if(inputData.vecPairCsd.isEmpty()) {
-        double denomCSD = sqrt(tapers.second.cwiseAbs2().sum()) * sqrt(tapers.second.cwiseAbs2().sum()) / 2.0;
-        bool bNfftEven = false;
-        if (iNfft % 2 == 0){
-            bNfftEven = true;
-        }
-
-        MatrixXcd matCsd = MatrixXcd(iNRows, m_iNumberBinAmount);
-
-        for (i = 0; i < iNRows; ++i) {
-            for (j = i; j < iNRows; ++j) {
-                // Compute CSD (average over tapers if necessary)
-                matCsd.row(j) = inputData.vecTapSpectra.at(i).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(i).rows(),m_iNumberBinAmount).cwiseProduct(inputData.vecTapSpectra.at(j).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(j).rows(),m_iNumberBinAmount).conjugate()).colwise().sum() / denomCSD;
-
-                // Divide first and last element by 2 due to half spectrum
-                if(m_iNumberBinStart == 0) {
-                    matCsd.row(j)(0) /= 2.0;
-                }
-
-                if(bNfftEven && m_iNumberBinStart + m_iNumberBinAmount >= iNFreqs) {
-                    matCsd.row(j).tail(1) /= 2.0;
-                }
-            }
-
-            inputData.vecPairCsd.append(QPair<int,MatrixXcd>(i,matCsd));
-            inputData.vecPairCsdImagAbs.append(QPair<int,MatrixXd>(i,matCsd.imag().cwiseAbs()));
-        }
+    // Compute tapered spectra and CSD via the shared spectral stage. Both are only computed if they are not available
+    // already, e.g. because another metric was evaluated on the same trial data before.
+    computeCsd(inputData,
+               matCsdSum,
+               mutex,
+               iNRows,
+               iNFreqs,
+               iNfft,
+               tapers);
 
-//        iTime = timer.elapsed();
-//        qWarning() << "WeightedPhaseLagIndex::compute timer - Compute CSD and Imag CSD:" << iTime;
-//        timer.restart();
+    if(inputData.matCsdImagAbs.rows() != iNPairs) {
+        inputData.matCsdImagAbs = inputData.matCsd.imag().cwiseAbs();
 
         mutex.lock();
 
-        if(vecPairCsdSum.isEmpty()) {
-            vecPairCsdSum = inputData.vecPairCsd;
-            vecPairCsdImagAbsSum = inputData.vecPairCsdImagAbs;
+        if(matCsdImagAbsSum.rows() != inputData.matCsdImagAbs.rows() || matCsdImagAbsSum.cols() != inputData.matCsdImagAbs.cols()) {
+            matCsdImagAbsSum = inputData.matCsdImagAbs;
         } else {
-            for (int j = 0; j < vecPairCsdSum.size(); ++j) {
-                vecPairCsdSum[j].second += inputData.vecPairCsd.at(j).second;
-                vecPairCsdImagAbsSum[j].second += inputData.vecPairCsdImagAbs.at(j).second;
-            }
+            matCsdImagAbsSum += inputData.matCsdImagAbs;
         }
 
         mutex.unlock();
-
-//        iTime = timer.elapsed();
-//        qWarning() << "WeightedPhaseLagIndex::compute timer - Add CSD to sum:" << iTime;
-//        timer.restart();
-    } else {
-        if (inputData.vecPairCsdImagAbs.isEmpty()) {
-            inputData.vecPairCsdImagAbs.clear();
-            for (i = 0; i < inputData.vecPairCsd.size(); ++i) {
-                inputData.vecPairCsdImagAbs.append(QPair<int,MatrixXd>(i,inputData.vecPairCsd.at(i).second.imag().cwiseAbs()));
-            }
-
-            mutex.lock();
-
-            if(vecPairCsdImagAbsSum.isEmpty()) {
-                vecPairCsdImagAbsSum = inputData.vecPairCsdImagAbs;
-            } else {
-                for (int j = 0; j < vecPairCsdImagAbsSum.size(); ++j) {
-                    vecPairCsdImagAbsSum[j].second += inputData.vecPairCsdImagAbs.at(j).second;
-                }
-            }
-
-            mutex.unlock();
-        }
     }
 
     //Do not store data to save memory
     if(!m_bStorageModeIsActive) {
-        inputData.vecPairCsd.clear();
-        inputData.vecPairCsdImagAbs.clear();
+        inputData.matCsd.resize(0,0);
         inputData.vecTapSpectra.clear();
+        inputData.matCsdImagAbs.resize(0,0);
     }
 }
 
@@ -333,26 +242,10 @@ void WeightedPhaseLagIndex::computeWPLI(ConnectivitySettings &connectivitySettin
                                         Network& finalNetwork)
 {
     // Compute final WPLI and create Network
-    MatrixXd matDenom, matNom;
-    MatrixXd matWeight;
-    QSharedPointer<NetworkEdge> pEdge;
-    int j;
-
-    for (int i = 0; i < connectivitySettings.getIntermediateSumData().vecPairCsdSum.size(); ++i) {
-        matDenom = connectivitySettings.getIntermediateSumData().vecPairCsdImagAbsSum.at(i).second;
-        matDenom = (matDenom.array() == 0.).select(INFINITY, matDenom);
-
-        matNom = connectivitySettings.getIntermediateSumData().vecPairCsdSum.at(i).second.imag().cwiseAbs().cwiseQuotient(matDenom);
+    const ConnectivitySettings::IntermediateSumData& sumData = connectivitySettings.getIntermediateSumData();
 
-        for(j = i; j < matNom.rows(); ++j) {
-            matWeight = matNom.row(j).transpose();
+    MatrixXd matDenom = (sumData.matCsdImagAbsSum.array() == 0.).select(INFINITY, sumData.matCsdImagAbsSum);
 
-            pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
-
-            finalNetwork.getNodeAt(i)->append(pEdge);
-            finalNetwork.getNodeAt(j)->append(pEdge);
-            finalNetwork.append(pEdge);
-        }
-    }
+    finalNetwork.appendPackedEdges(sumData.matCsdSum.imag().cwiseAbs().cwiseQuotient(matDenom));
 }
 
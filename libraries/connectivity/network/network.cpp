@@ -74,7 +74,9 @@ using namespace UTILSLIB;
 
 Network::Network(const QString& sConnectivityMethod,
                  double dThreshold)
-: m_sConnectivityMethod(sConnectivityMethod)
+: m_iPackedFreqBins(QPair<int,int>(-1,-1))
+, m_iNumberPackedNodes(0)
+, m_sConnectivityMethod(sConnectivityMethod)
 , m_minMaxFullWeights(QPair<double,double>(std::numeric_limits<double>::max(),0.0))
 , m_minMaxThresholdedWeights(QPair<double,double>(std::numeric_limits<double>::max(),0.0))
 , m_dThreshold(dThreshold)
@@ -108,6 +110,21 @@ MatrixXd Network::getFullConnectivityMatrix(bool bGetMirroredVersion) const
         }
     }
 
+    // Packed edges, skipping the self pair at the start of each row
+    int iRow = 0;
+
+    for(int i = 0; i < m_iNumberPackedNodes; ++i) {
+        ++iRow;
+
+        for(int j = i + 1; j < m_iNumberPackedNodes; ++j, ++iRow) {
+            matDist(i,j) = m_vecPackedWeights(iRow);
+
+            if(bGetMirroredVersion) {
+                matDist(j,i) = m_vecPackedWeights(iRow);
+            }
+        }
+    }
+
     //IOUtils::write_eigen_matrix(matDist,"eigen.txt");
     return matDist;
 }
@@ -132,6 +149,23 @@ MatrixXd Network::getThresholdedConnectivityMatrix(bool bGetMirroredVersion) con
         }
     }
 
+    // Packed edges, skipping the self pair at the start of each row
+    int iRow = 0;
+
+    for(int i = 0; i < m_iNumberPackedNodes; ++i) {
+        ++iRow;
+
+        for(int j = i + 1; j < m_iNumberPackedNodes; ++j, ++iRow) {
+            if(fabs(m_vecPackedWeights(iRow)) >= m_dThreshold) {
+                matDist(i,j) = m_vecPackedWeights(iRow);
+
+                if(bGetMirroredVersion) {
+                    matDist(j,i) = m_vecPackedWeights(iRow);
+                }
+            }
+        }
+    }
+
     //IOUtils::write_eigen_matrix(matDist,"eigen.txt");
     return matDist;
 }
@@ -140,6 +174,8 @@ MatrixXd Network::getThresholdedConnectivityMatrix(bool bGetMirroredVersion) con
 
 const QList<NetworkEdge::SPtr>& Network::getFullEdges() const
 {
+    createPackedEdges();
+
     return m_lFullEdges;
 }
 
@@ -147,6 +183,8 @@ const QList<NetworkEdge::SPtr>& Network::getFullEdges() const
 
 const QList<NetworkEdge::SPtr>& Network::getThresholdedEdges() const
 {
+    createPackedEdges();
+
     return m_lThresholdedEdges;
 }
 
@@ -154,6 +192,8 @@ const QList<NetworkEdge::SPtr>& Network::getThresholdedEdges() const
 
 const QList<NetworkNode::SPtr>& Network::getNodes() const
 {
+    createPackedEdges();
+
     return m_lNodes;
 }
 
@@ -161,6 +201,8 @@ const QList<NetworkNode::SPtr>& Network::getNodes() const
 
 NetworkNode::SPtr Network::getNodeAt(int i)
 {
+    createPackedEdges();
+
     return m_lNodes.at(i);
 }
 
@@ -168,6 +210,8 @@ NetworkNode::SPtr Network::getNodeAt(int i)
 
 qint16 Network::getFullDistribution() const
 {
+    createPackedEdges();
+
     qint16 distribution = 0;
 
     for(int i = 0; i < m_lNodes.size(); ++i) {
@@ -181,6 +225,8 @@ qint16 Network::getFullDistribution() const
 
 qint16 Network::getThresholdedDistribution() const
 {
+    createPackedEdges();
+
     qint16 distribution = 0;
 
     for(int i = 0; i < m_lNodes.size(); ++i) {
@@ -222,6 +268,8 @@ QPair<double, double> Network::getMinMaxThresholdedWeights() const
 
 QPair<int,int> Network::getMinMaxFullDegrees() const
 {
+    createPackedEdges();
+
     int maxDegree = 0;
     int minDegree = 1000000;
 
@@ -240,6 +288,8 @@ QPair<int,int> Network::getMinMaxFullDegrees() const
 
 QPair<int,int> Network::getMinMaxThresholdedDegrees() const
 {
+    createPackedEdges();
+
     int maxDegree = 0;
     int minDegree = 1000000;
 
@@ -258,6 +308,8 @@ QPair<int,int> Network::getMinMaxThresholdedDegrees() const
 
 QPair<int,int> Network::getMinMaxFullIndegrees() const
 {
+    createPackedEdges();
+
     int maxDegree = 0;
     int minDegree = 1000000;
 
@@ -276,6 +328,8 @@ QPair<int,int> Network::getMinMaxFullIndegrees() const
 
 QPair<int,int> Network::getMinMaxThresholdedIndegrees() const
 {
+    createPackedEdges();
+
     int maxDegree = 0;
     int minDegree = 1000000;
 
@@ -294,6 +348,8 @@ QPair<int,int> Network::getMinMaxThresholdedIndegrees() const
 
 QPair<int,int> Network::getMinMaxFullOutdegrees() const
 {
+    createPackedEdges();
+
     int maxDegree = 0;
     int minDegree = 1000000;
 
@@ -312,6 +368,8 @@ QPair<int,int> Network::getMinMaxFullOutdegrees() const
 
 QPair<int,int> Network::getMinMaxThresholdedOutdegrees() const
 {
+    createPackedEdges();
+
     int maxDegree = 0;
     int minDegree = 1000000;
 
@@ -397,6 +455,27 @@ void Network::setFrequencyRange(float fLowerFreq, float fUpperFreq)
             m_minMaxFullWeights.second = fabs(m_lFullEdges.at(i)->getWeight());
         }
     }
+
+    if(m_iNumberPackedNodes == 0) {
+        return;
+    }
+
+    m_iPackedFreqBins = QPair<int,int>(iLowerBin,iUpperBin);
+    averagePackedWeights();
+
+    int iRow = 0;
+
+    for(int i = 0; i < m_iNumberPackedNodes; ++i) {
+        ++iRow;
+
+        for(int j = i + 1; j < m_iNumberPackedNodes; ++j, ++iRow) {
+            if(fabs(m_vecPackedWeights(iRow)) < m_minMaxFullWeights.first) {
+                m_minMaxFullWeights.first = fabs(m_vecPackedWeights(iRow));
+            } else if(fabs(m_vecPackedWeights(iRow)) > m_minMaxFullWeights.second) {
+                m_minMaxFullWeights.second = fabs(m_vecPackedWeights(iRow));
+            }
+        }
+    }
 }
 
 //=============================================================================================================
@@ -435,9 +514,43 @@ void Network::append(NetworkNode::SPtr newNode)
 
 //=============================================================================================================
 
+void Network::appendPackedEdges(const MatrixXd& matPackedWeights)
+{
+    int iNNodes = m_lNodes.size();
+
+    if(matPackedWeights.rows() != iNNodes * (iNNodes + 1) / 2) {
+        qDebug() << "Network::appendPackedEdges - Number of tensor rows does not match the number of node pairs. Returning.";
+        return;
+    }
+
+    // Only one packed tensor is kept, create the objects for a previously appended one
+    createPackedEdges();
+
+    m_pMatPackedWeights = QSharedPointer<const MatrixXd>(new MatrixXd(matPackedWeights));
+    m_iNumberPackedNodes = iNNodes;
+    m_iPackedFreqBins = QPair<int,int>(-1,-1);
+    averagePackedWeights();
+
+    int iRow = 0;
+
+    for(int i = 0; i < iNNodes; ++i) {
+        ++iRow;
+
+        for(int j = i + 1; j < iNNodes; ++j, ++iRow) {
+            if(m_vecPackedWeights(iRow) < m_minMaxFullWeights.first) {
+                m_minMaxFullWeights.first = m_vecPackedWeights(iRow);
+            } else if(m_vecPackedWeights(iRow) >= m_minMaxFullWeights.second) {
+                m_minMaxFullWeights.second = m_vecPackedWeights(iRow);
+            }
+        }
+    }
+}
+
+//=============================================================================================================
+
 bool Network::isEmpty() const
 {
-    if(m_lFullEdges.isEmpty() || m_lNodes.isEmpty()) {
+    if((m_lFullEdges.isEmpty() && m_iNumberPackedNodes < 2) || m_lNodes.isEmpty()) {
         return true;
     }
 
@@ -458,6 +571,10 @@ void Network::normalize()
         m_lFullEdges.at(i)->setWeight(m_lFullEdges.at(i)->getWeight()/m_minMaxFullWeights.second);
     }
 
+    if(m_iNumberPackedNodes > 0) {
+        m_vecPackedWeights /= m_minMaxFullWeights.second;
+    }
+
     m_minMaxFullWeights.first = m_minMaxFullWeights.first/m_minMaxFullWeights.second;
     m_minMaxFullWeights.second = 1.0;
 
@@ -521,3 +638,89 @@ int Network::getFFTSize()
     return m_iFFTSize;
 }
 
+//=============================================================================================================
+
+void Network::createPackedEdges() const
+{
+    if(m_iNumberPackedNodes == 0) {
+        return;
+    }
+
+    // The node objects can be shared with copies of this network, so attach the new edges to copies of them
+    QList<NetworkNode::SPtr> lNodes;
+    lNodes.reserve(m_lNodes.size());
+
+    for(int i = 0; i < m_lNodes.size(); ++i) {
+        NetworkNode::SPtr pNode = NetworkNode::SPtr(new NetworkNode(m_lNodes.at(i)->getId(), m_lNodes.at(i)->getVert()));
+        pNode->setHubStatus(m_lNodes.at(i)->getHubStatus());
+
+        for(int j = 0; j < m_lNodes.at(i)->getFullEdges().size(); ++j) {
+            pNode->append(m_lNodes.at(i)->getFullEdges().at(j));
+        }
+
+        lNodes << pNode;
+    }
+
+    NetworkEdge::SPtr pEdge;
+    bool bActive;
+    int iRow = 0;
+
+    m_lFullEdges.reserve(m_lFullEdges.size() + m_iNumberPackedNodes * (m_iNumberPackedNodes - 1) / 2);
+
+    for(int i = 0; i < m_iNumberPackedNodes; ++i) {
+        ++iRow;
+
+        for(int j = i + 1; j < m_iNumberPackedNodes; ++j, ++iRow) {
+            bActive = fabs(m_vecPackedWeights(iRow)) >= m_dThreshold;
+
+            pEdge = NetworkEdge::SPtr(new NetworkEdge(i,
+                                                      j,
+                                                      m_pMatPackedWeights,
+                                                      iRow,
+                                                      bActive,
+                                                      m_iPackedFreqBins.first,
+                                                      m_iPackedFreqBins.second));
+            pEdge->setWeight(m_vecPackedWeights(iRow));
+
+            lNodes.at(i)->append(pEdge);
+            lNodes.at(j)->append(pEdge);
+
+            m_lFullEdges << pEdge;
+
+            if(bActive) {
+                m_lThresholdedEdges << pEdge;
+            }
+        }
+    }
+
+    m_lNodes = lNodes;
+
+    m_pMatPackedWeights.clear();
+    m_vecPackedWeights.resize(0);
+    m_iNumberPackedNodes = 0;
+}
+
+//=============================================================================================================
+
+void Network::averagePackedWeights()
+{
+    if(!m_pMatPackedWeights) {
+        return;
+    }
+
+    int iStartWeightBin = m_iPackedFreqBins.first;
+    int iEndWeightBin = m_iPackedFreqBins.second;
+
+    if(iEndWeightBin < iStartWeightBin || iStartWeightBin < -1 || iEndWeightBin < -1 ) {
+        return;
+    }
+
+    int cols = m_pMatPackedWeights->cols();
+
+    if(iEndWeightBin == -1 && iStartWeightBin == -1) {
+        m_vecPackedWeights = m_pMatPackedWeights->rowwise().mean();
+    } else if(iStartWeightBin >= 0 && iStartWeightBin < cols) {
+        int iNumberBins = iEndWeightBin < cols ? iEndWeightBin - iStartWeightBin + 1 : cols - iStartWeightBin;
+        m_vecPackedWeights = m_pMatPackedWeights->middleCols(iStartWeightBin, iNumberBins).rowwise().mean();
+    }
+}
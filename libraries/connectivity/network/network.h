@@ -314,6 +314,18 @@ public:
      */
     void append(QSharedPointer<NetworkNode> newNode);
 
+    //=========================================================================================================
+    /**
+     * Appends the edges for all node pairs (i,j), j > i, from a packed upper triangular weight tensor. Row p of the
+     * tensor holds the frequency resolved weights of the pair p (including the self pairs i == j) in row-major order.
+     * The edges are kept in packed form: the connectivity matrices, thresholding, frequency averaging and
+     * normalization operate on the tensor directly. NetworkEdge objects referencing a tensor row are only created
+     * when the edge or node objects are requested. The nodes must have been appended before.
+     *
+     * @param[in] matPackedWeights    The packed weight tensor with one row per node pair and one column per frequency bin.
+     */
+    void appendPackedEdges(const Eigen::MatrixXd& matPackedWeights);
+
     //=========================================================================================================
     /**
      * Returns whether the Network is empty by checking the number of nodes and edges.
@@ -393,10 +405,28 @@ public:
     int getFFTSize();
 
 protected:
-    QList<QSharedPointer<NetworkEdge> >     m_lFullEdges;               /**< List with all edges of the network.*/
-    QList<QSharedPointer<NetworkEdge> >     m_lThresholdedEdges;        /**< List with all the active (thresholded) edges of the network.*/
+    //=========================================================================================================
+    /**
+     * Creates the NetworkEdge objects for the packed edges, appends them to the edge lists and to copies of the
+     * nodes, and releases the packed representation afterwards. Does nothing if there are no packed edges.
+     */
+    void createPackedEdges() const;
+
+    //=========================================================================================================
+    /**
+     * Recalculates the averaged weights of the packed edges for the current frequency bins.
+     */
+    void averagePackedWeights();
+
+    mutable QList<QSharedPointer<NetworkEdge> >     m_lFullEdges;               /**< List with all edges of the network.*/
+    mutable QList<QSharedPointer<NetworkEdge> >     m_lThresholdedEdges;        /**< List with all the active (thresholded) edges of the network.*/
+
+    mutable QList<QSharedPointer<NetworkNode> >     m_lNodes;                   /**< List with all nodes of the network.*/
 
-    QList<QSharedPointer<NetworkNode> >     m_lNodes;                   /**< List with all nodes of the network.*/
+    mutable QSharedPointer<const Eigen::MatrixXd>   m_pMatPackedWeights;        /**< The packed weight tensor of the edges which were not created as objects yet, one row per node pair.*/
+    mutable Eigen::VectorXd                         m_vecPackedWeights;         /**< The averaged weight of each packed node pair.*/
+    QPair<int,int>                                  m_iPackedFreqBins;          /**< The frequency bins the packed weights are averaged from/to.*/
+    mutable int                                     m_iNumberPackedNodes;       /**< The number of nodes spanned by the packed edges. Zero if there are no packed edges.*/
 
     Eigen::MatrixXd                         m_matDistMatrix;            /**< The distance matrix.*/
 
@@ -75,6 +75,7 @@ NetworkEdge::NetworkEdge(int iStartNodeID,
 , m_iEndNodeID(iEndNodeID)
 , m_bIsActive(bIsActive)
 , m_iMinMaxFreqBins(QPair<int,int>(iStartWeightBin,iEndWeightBin))
+, m_iTensorRow(-1)
 , m_dAveragedWeight(0.0)
 {
     if(matWeight.rows() == 0 || matWeight.cols() == 0) {
@@ -89,6 +90,33 @@ NetworkEdge::NetworkEdge(int iStartNodeID,
 
 //=============================================================================================================
 
+NetworkEdge::NetworkEdge(int iStartNodeID,
+                         int iEndNodeID,
+                         const QSharedPointer<const MatrixXd>& pMatWeightTensor,
+                         int iTensorRow,
+                         bool bIsActive,
+                         int iStartWeightBin,
+                         int iEndWeightBin)
+: m_iStartNodeID(iStartNodeID)
+, m_iEndNodeID(iEndNodeID)
+, m_bIsActive(bIsActive)
+, m_iMinMaxFreqBins(QPair<int,int>(iStartWeightBin,iEndWeightBin))
+, m_pMatWeightTensor(pMatWeightTensor)
+, m_iTensorRow(iTensorRow)
+, m_dAveragedWeight(0.0)
+{
+    if(!m_pMatWeightTensor || iTensorRow < 0 || iTensorRow >= m_pMatWeightTensor->rows() || m_pMatWeightTensor->cols() == 0) {
+        m_pMatWeightTensor.clear();
+        m_iTensorRow = -1;
+        m_matWeight = MatrixXd::Zero(1,1);
+        qDebug() << "NetworkEdge::NetworkEdge - Weight tensor is empty or does not contain the requested row. Setting to 1x1 zero matrix.";
+    }
+
+    calculateAveragedWeight();
+}
+
+//=============================================================================================================
+
 int NetworkEdge::getStartNodeID()
 {
     return m_iStartNodeID;
@@ -126,6 +154,10 @@ double NetworkEdge::getWeight() const
 
 MatrixXd NetworkEdge::getMatrixWeight() const
 {
+    if(m_pMatWeightTensor) {
+        return m_pMatWeightTensor->row(m_iTensorRow).transpose();
+    }
+
     return m_matWeight;
 }
 
@@ -147,6 +179,22 @@ void NetworkEdge::calculateAveragedWeight()
         return;
     }
 
+    if(m_pMatWeightTensor) {
+        int cols = m_pMatWeightTensor->cols();
+
+        if ((iEndWeightBin == -1 && iStartWeightBin == -1) ) {
+            m_dAveragedWeight = m_pMatWeightTensor->row(m_iTensorRow).mean();
+        } else if(iStartWeightBin < cols) {
+            if(iEndWeightBin < cols) {
+                m_dAveragedWeight = m_pMatWeightTensor->row(m_iTensorRow).segment(iStartWeightBin,iEndWeightBin-iStartWeightBin+1).mean();
+            } else {
+                m_dAveragedWeight = m_pMatWeightTensor->row(m_iTensorRow).segment(iStartWeightBin,cols-iStartWeightBin).mean();
+            }
+        }
+
+        return;
+    }
+
     int rows = m_matWeight.rows();
 
     if ((iEndWeightBin == -1 && iStartWeightBin == -1) ) {
@@ -101,6 +101,27 @@ public:
                          int iStartWeightBin = -1,
                          int iEndWeightBin = -1);
 
+    //=========================================================================================================
+    /**
+     * Constructs a NetworkEdge object whose weights are stored as row in a packed weight tensor, which is shared
+     * by all edges of a network. This avoids a separate weight matrix allocation per edge.
+     *
+     * @param[in]  iStartNodeID      The start node id of the edge.
+     * @param[in]  iEndNodeID        The end node id of the edge.
+     * @param[in]  pMatWeightTensor  The shared packed weight tensor. Each row holds the frequency resolved weights of one edge.
+     * @param[in]  iTensorRow        The row of this edge in the weight tensor.
+     * @param[in]  bIsActive         The active flag of this edge. Default is true.
+     * @param[in]  iStartWeightBin   The bin index to start avergaing from. Default is -1 which means an average over all weights.
+     * @param[in]  iEndWeightBin     The bin index to end avergaing to. Default is -1 which means an average over all weights.
+     */
+    explicit NetworkEdge(int iStartNodeID,
+                         int iEndNodeID,
+                         const QSharedPointer<const Eigen::MatrixXd>& pMatWeightTensor,
+                         int iTensorRow,
+                         bool bIsActive = true,
+                         int iStartWeightBin = -1,
+                         int iEndWeightBin = -1);
+
     //=========================================================================================================
     /**
      * Returns the start node of this edge.
@@ -188,6 +209,8 @@ protected:
     QPair<int,int>  m_iMinMaxFreqBins;      /**< The lower/upper bin indeces to start avergaing from/to. Default is -1 which means an average over all weights.*/
 
     Eigen::MatrixXd m_matWeight;            /**< The weight matrix of the edge. E.g. rows could be different frequency bins/bands and columns could be different instances in time.*/
+    QSharedPointer<const Eigen::MatrixXd> m_pMatWeightTensor;   /**< The shared packed weight tensor. Only set if the edge weights are stored in a tensor instead of m_matWeight.*/
+    int             m_iTensorRow;           /**< The row of this edge in the shared weight tensor.*/
 
     double          m_dAveragedWeight;      /**< The current averaged edge weight.*/
 };
@@ -45,6 +45,7 @@
 
 #include <QGridLayout>
 #include <QSpinBox>
+#include <QDoubleSpinBox>
 #include <QLabel>
 #include <QSettings>
 
@@ -82,6 +83,22 @@ CovarianceSettingsView::CovarianceSettingsView(const QString& sSettingsPath,
     connect(m_pSpinBoxNumSamples, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
             this, &CovarianceSettingsView::samplesChanged);
     t_pGridLayout->addWidget(m_pSpinBoxNumSamples,0,1,1,1);
+
+    QLabel* t_pLabelForgettingFactor = new QLabel;
+    t_pLabelForgettingFactor->setText("Forgetting Factor");
+    t_pGridLayout->addWidget(t_pLabelForgettingFactor,1,0,1,1);
+
+    m_pSpinBoxForgettingFactor = new QDoubleSpinBox;
+    m_pSpinBoxForgettingFactor->setDecimals(5);
+    m_pSpinBoxForgettingFactor->setMinimum(0.9);
+    m_pSpinBoxForgettingFactor->setMaximum(1.0);
+    m_pSpinBoxForgettingFactor->setSingleStep(0.0001);
+    m_pSpinBoxForgettingFactor->setValue(1.0);
+    m_pSpinBoxForgettingFactor->setToolTip("Per sample forgetting factor of the running covariance. 1 disables forgetting.");
+    connect(m_pSpinBoxForgettingFactor, static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
+            this, &CovarianceSettingsView::forgettingFactorChanged);
+    t_pGridLayout->addWidget(m_pSpinBoxForgettingFactor,1,1,1,1);
+
     this->setLayout(t_pGridLayout);
 
     loadSettings();
@@ -111,6 +128,13 @@ void CovarianceSettingsView::setMinSamples(int iSamples)
 
 //=============================================================================================================
 
+void CovarianceSettingsView::setCurrentForgettingFactor(double dForgettingFactor)
+{
+    m_pSpinBoxForgettingFactor->setValue(dForgettingFactor);
+}
+
+//=============================================================================================================
+
 void CovarianceSettingsView::saveSettings()
 {
     if(m_sSettingsPath.isEmpty()) {
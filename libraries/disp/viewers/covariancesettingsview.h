@@ -49,6 +49,7 @@
 
 #include <QWidget>
 #include <QSpinBox>
+#include <QDoubleSpinBox>
 #include <QPair>
 
 #include <QComboBox>
@@ -104,6 +105,14 @@ public:
      */
     void setMinSamples(int iSamples);
 
+    //=========================================================================================================
+    /**
+     * Set the current per sample forgetting factor of the running covariance.
+     *
+     * @param[in] dForgettingFactor     new forgetting factor. 1 disables forgetting.
+     */
+    void setCurrentForgettingFactor(double dForgettingFactor);
+
     //=========================================================================================================
     /**
      * Saves all important settings of this view via QSettings.
@@ -135,9 +144,11 @@ protected:
 
 signals:
     void samplesChanged(int iSamples);
+    void forgettingFactorChanged(double dForgettingFactor);
 
 private:
     QSpinBox*       m_pSpinBoxNumSamples;
+    QDoubleSpinBox* m_pSpinBoxForgettingFactor;     /**< The per sample forgetting factor of the running covariance. */
     QString         m_sSettingsPath;            /**< The settings path to store the GUI settings to. */
 
 };
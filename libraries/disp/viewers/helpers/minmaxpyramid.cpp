@@ -0,0 +1,221 @@
+//=============================================================================================================
+/**
+ * @file     minmaxpyramid.cpp
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Definition of the MinMaxPyramid Class.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "minmaxpyramid.h"
+
+#include <algorithm>
+#include <limits>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace DISPLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+MinMaxPyramid::MinMaxPyramid()
+: m_iRows(0)
+, m_iCols(0)
+{
+}
+
+//=============================================================================================================
+
+void MinMaxPyramid::update(const MatrixXdR& matData)
+{
+    if(!matches(matData)) {
+        m_iRows = matData.rows();
+        m_iCols = matData.cols();
+
+        m_lMin.clear();
+        m_lMax.clear();
+
+        int iNumBins = (m_iCols + 1) / 2;
+        while(m_iCols > 1 && iNumBins >= 1) {
+            m_lMin.append(MatrixXfR(m_iRows, iNumBins));
+            m_lMax.append(MatrixXfR(m_iRows, iNumBins));
+
+            if(iNumBins == 1) {
+                break;
+            }
+            iNumBins = (iNumBins + 1) / 2;
+        }
+    }
+
+    update(matData, 0, m_iCols);
+}
+
+//=============================================================================================================
+
+void MinMaxPyramid::update(const MatrixXdR& matData,
+                           int iFirstCol,
+                           int iNumCols)
+{
+    if(!matches(matData) || m_lMin.isEmpty()) {
+        return;
+    }
+
+    int iBegin = std::max(iFirstCol, 0);
+    int iEnd = std::min(iFirstCol + iNumCols, m_iCols);
+
+    if(iBegin >= iEnd) {
+        return;
+    }
+
+    // first level from the samples
+    int iBinBegin = iBegin / 2;
+    int iBinEnd = (iEnd - 1) / 2 + 1;
+
+    for(int r = 0; r < m_iRows; ++r) {
+        const double* pRow = matData.data() + r * m_iCols;
+        float* pMin = m_lMin[0].data() + r * m_lMin[0].cols();
+        float* pMax = m_lMax[0].data() + r * m_lMax[0].cols();
+
+        for(int i = iBinBegin; i < iBinEnd; ++i) {
+            double dMin = pRow[2*i];
+            double dMax = dMin;
+            if(2*i+1 < m_iCols) {
+                dMin = std::min(dMin, pRow[2*i+1]);
+                dMax = std::max(dMax, pRow[2*i+1]);
+            }
+            pMin[i] = static_cast<float>(dMin);
+            pMax[i] = static_cast<float>(dMax);
+        }
+    }
+
+    // higher levels from the level below
+    for(int l = 1; l < m_lMin.size(); ++l) {
+        const int iChildCols = m_lMin[l-1].cols();
+        iBinBegin /= 2;
+        iBinEnd = (iBinEnd - 1) / 2 + 1;
+
+        for(int r = 0; r < m_iRows; ++r) {
+            const float* pChildMin = m_lMin[l-1].data() + r * iChildCols;
+            const float* pChildMax = m_lMax[l-1].data() + r * iChildCols;
+            float* pMin = m_lMin[l].data() + r * m_lMin[l].cols();
+            float* pMax = m_lMax[l].data() + r * m_lMax[l].cols();
+
+            for(int i = iBinBegin; i < iBinEnd; ++i) {
+                float fMin = pChildMin[2*i];
+                float fMax = pChildMax[2*i];
+                if(2*i+1 < iChildCols) {
+                    fMin = std::min(fMin, pChildMin[2*i+1]);
+                    fMax = std::max(fMax, pChildMax[2*i+1]);
+                }
+                pMin[i] = fMin;
+                pMax[i] = fMax;
+            }
+        }
+    }
+}
+
+//=============================================================================================================
+
+bool MinMaxPyramid::getMinMax(const MatrixXdR& matData,
+                              int iRow,
+                              int iBegin,
+                              int iEnd,
+                              double& dMin,
+                              double& dMax) const
+{
+    iBegin = std::max(iBegin, 0);
+    iEnd = std::min(iEnd, static_cast<int>(matData.cols()));
+
+    if(iBegin >= iEnd || iRow < 0 || iRow >= matData.rows()) {
+        return false;
+    }
+
+    dMin = std::numeric_limits<double>::max();
+    dMax = std::numeric_limits<double>::lowest();
+
+    const double* pRow = matData.data() + iRow * matData.cols();
+
+    // without a matching pyramid fall back to the samples
+    if(!matches(matData)) {
+        for(int i = iBegin; i < iEnd; ++i) {
+            dMin = std::min(dMin, pRow[i]);
+            dMax = std::max(dMax, pRow[i]);
+        }
+        return true;
+    }
+
+    // take the unpaired bins at both ends of the range and continue one level up with the rest
+    if(iBegin & 1) {
+        dMin = std::min(dMin, pRow[iBegin]);
+        dMax = std::max(dMax, pRow[iBegin]);
+        ++iBegin;
+    }
+    if(iEnd & 1) {
+        --iEnd;
+        dMin = std::min(dMin, pRow[iEnd]);
+        dMax = std::max(dMax, pRow[iEnd]);
+    }
+    iBegin /= 2;
+    iEnd /= 2;
+
+    for(int l = 0; l < m_lMin.size() && iBegin < iEnd; ++l) {
+        const float* pMin = m_lMin[l].data() + iRow * m_lMin[l].cols();
+        const float* pMax = m_lMax[l].data() + iRow * m_lMax[l].cols();
+
+        if(iBegin & 1) {
+            dMin = std::min(dMin, static_cast<double>(pMin[iBegin]));
+            dMax = std::max(dMax, static_cast<double>(pMax[iBegin]));
+            ++iBegin;
+        }
+        if(iEnd & 1) {
+            --iEnd;
+            dMin = std::min(dMin, static_cast<double>(pMin[iEnd]));
+            dMax = std::max(dMax, static_cast<double>(pMax[iEnd]));
+        }
+        iBegin /= 2;
+        iEnd /= 2;
+    }
+
+    return true;
+}
+
+//=============================================================================================================
+
+bool MinMaxPyramid::matches(const MatrixXdR& matData) const
+{
+    return matData.rows() == m_iRows && matData.cols() == m_iCols;
+}
@@ -0,0 +1,145 @@
+//=============================================================================================================
+/**
+ * @file     minmaxpyramid.h
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Declaration of the MinMaxPyramid Class.
+ *
+ *           Level l of the pyramid holds the minimum and maximum of each aligned group of 2^l samples, level 0 are the
+ *           samples themselves. The minimum and maximum of any sample range are then combined from at most two bins
+ *           per level, so the cost of a query grows with the logarithm of the range length only.
+ */
+
+#ifndef MINMAXPYRAMID_H
+#define MINMAXPYRAMID_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../../disp_global.h"
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QVector>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// DEFINE NAMESPACE DISPLIB
+//=============================================================================================================
+
+namespace DISPLIB
+{
+
+//=============================================================================================================
+/**
+ * The pyramid does not keep a copy of the samples. Updates and queries get passed the row-major data matrix it was
+ * built for, which has to be the same as during the last update of the queried range.
+ *
+ * @brief The MinMaxPyramid class holds the min/max envelope of each row of a data matrix at all power of two resolutions.
+ */
+class DISPSHARED_EXPORT MinMaxPyramid
+{
+
+public:
+    typedef Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> MatrixXdR;
+    typedef Eigen::Matrix<float,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> MatrixXfR;
+
+    //=========================================================================================================
+    /**
+     * Constructs an empty MinMaxPyramid.
+     */
+    MinMaxPyramid();
+
+    //=========================================================================================================
+    /**
+     * Recalculates the whole pyramid. The levels are reallocated if the size of the data changed.
+     *
+     * @param[in] matData        The data, one row per channel.
+     */
+    void update(const MatrixXdR& matData);
+
+    //=========================================================================================================
+    /**
+     * Recalculates the bins which cover the given columns. Columns outside the data are ignored.
+     *
+     * @param[in] matData        The data, one row per channel. Needs to have the size of the last full update.
+     * @param[in] iFirstCol      The first changed column.
+     * @param[in] iNumCols       The number of changed columns.
+     */
+    void update(const MatrixXdR& matData,
+                int iFirstCol,
+                int iNumCols);
+
+    //=========================================================================================================
+    /**
+     * Returns the minimum and maximum of a row within a column range.
+     *
+     * @param[in] matData        The data the pyramid was built for.
+     * @param[in] iRow           The row.
+     * @param[in] iBegin         The first column of the range.
+     * @param[in] iEnd           One past the last column of the range.
+     * @param[out] dMin          The minimum.
+     * @param[out] dMax          The maximum.
+     *
+     * @return False if the range is empty, true otherwise.
+     */
+    bool getMinMax(const MatrixXdR& matData,
+                   int iRow,
+                   int iBegin,
+                   int iEnd,
+                   double& dMin,
+                   double& dMax) const;
+
+    //=========================================================================================================
+    /**
+     * Returns whether the pyramid was built for data of the given size.
+     *
+     * @param[in] matData        The data.
+     *
+     * @return True if the sizes match.
+     */
+    bool matches(const MatrixXdR& matData) const;
+
+private:
+    int                 m_iRows;        /**< Number of rows of the data. */
+    int                 m_iCols;        /**< Number of columns of the data. */
+
+    QVector<MatrixXfR>  m_lMin;         /**< Minimum per bin, level l+1 at index l. */
+    QVector<MatrixXfR>  m_lMax;         /**< Maximum per bin, level l+1 at index l. */
+};
+} // NAMESPACE DISPLIB
+
+#endif // MINMAXPYRAMID_H
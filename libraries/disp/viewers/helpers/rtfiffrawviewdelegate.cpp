@@ -43,6 +43,9 @@
 
 #include "../scalingview.h"
 
+#include <limits>
+#include <utility>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
@@ -525,6 +528,8 @@ void RtFiffRawViewDelegate::createPlotPath(const QModelIndex &index,
         path.moveTo(qSamplePosition);
     }
 
+    double dMin, dMax, dMinPart, dMaxPart;
+
     for(qint32 j = 0; j < data.second; j += iSkip) {
         if(j < currentSampleIndex) {
             dValue = *(data.first+j) - *(data.first); //remove first sample data[0] as offset
@@ -536,9 +541,49 @@ void RtFiffRawViewDelegate::createPlotPath(const QModelIndex &index,
 
         dValueScaled = y_base-dValueScaled;//Reverse direction -> plot the right way
 
-        qSamplePosition.setY(dValueScaled);
-        qSamplePosition.setX(path.currentPosition().x()+dDx);
-        path.lineTo(qSamplePosition);
+        if(iSkip > 1) {
+            //Several samples fall onto this pixel column. Draw a vertical line from their minimum to their maximum
+            //instead of only the first sample, so that short peaks between the drawn samples do not get lost.
+            qint32 iEnd = qMin(j + iSkip, data.second);
+            dMin = std::numeric_limits<double>::max();
+            dMax = -std::numeric_limits<double>::max();
+
+            if(j < currentSampleIndex
+               && t_pModel->getMinMax(index.row(), j, qMin(iEnd, currentSampleIndex), dMinPart, dMaxPart)) {
+                dMin = dMinPart - *(data.first);
+                dMax = dMaxPart - *(data.first);
+            }
+
+            if(iEnd > currentSampleIndex
+               && t_pModel->getMinMax(index.row(), qMax(j, currentSampleIndex), iEnd, dMinPart, dMaxPart)) {
+                dMin = qMin(dMin, dMinPart - lastFirstValue);
+                dMax = qMax(dMax, dMaxPart - lastFirstValue);
+            }
+
+            if(dMin <= dMax) {
+                double dMinScaled = y_base - dMin * dScaleY;
+                double dMaxScaled = y_base - dMax * dScaleY;
+
+                //Start with the end which is closer to the previous column to keep the connecting line short
+                if(qAbs(path.currentPosition().y() - dMinScaled) > qAbs(path.currentPosition().y() - dMaxScaled)) {
+                    std::swap(dMinScaled, dMaxScaled);
+                }
+
+                qSamplePosition.setX(path.currentPosition().x()+dDx);
+                qSamplePosition.setY(dMinScaled);
+                path.lineTo(qSamplePosition);
+                qSamplePosition.setY(dMaxScaled);
+                path.lineTo(qSamplePosition);
+            } else {
+                qSamplePosition.setY(dValueScaled);
+                qSamplePosition.setX(path.currentPosition().x()+dDx);
+                path.lineTo(qSamplePosition);
+            }
+        } else {
+            qSamplePosition.setY(dValueScaled);
+            qSamplePosition.setX(path.currentPosition().x()+dDx);
+            path.lineTo(qSamplePosition);
+        }
 
         //Create ellipse position
         if(j == (qint32)(m_markerPosition.x() / dDx)) {
@@ -46,7 +46,9 @@
 #include <utils/ioutils.h>
 
 #include <rtprocessing/sphara.h>
+#include <rtprocessing/filter.h>
 #include <rtprocessing/detecttrigger.h>
+#include <rtprocessing/preprocessingpipeline.h>
 
 //=============================================================================================================
 // QT INCLUDES
@@ -77,9 +79,6 @@ using namespace RTPROCESSINGLIB;
 
 RtFiffRawViewModel::RtFiffRawViewModel(QObject *parent)
 : QAbstractTableModel(parent)
-, m_bSpharaActivated(false)
-, m_bProjActivated(false)
-, m_bCompActivated(false)
 , m_bPerformFiltering(false)
 , m_fSps(1024.0f)
 , m_iT(10)
@@ -88,7 +87,7 @@ RtFiffRawViewModel::RtFiffRawViewModel(QObject *parent)
 , m_iCurrentSample(0)
 , m_bIsFreezed(false)
 , m_sFilterChannelType("MEG")
-, m_iMaxFilterLength(128)
+, m_iFilterLength(128)
 , m_iCurrentBlockSize(1024)
 , m_iResidual(0)
 , m_bDrawFilterFront(true)
@@ -99,6 +98,8 @@ RtFiffRawViewModel::RtFiffRawViewModel(QObject *parent)
 , m_iCurrentSampleFreeze(0)
 , m_iCurrentTriggerChIndex(0)
 , m_pFiffInfo(FiffInfo::SPtr::create())
+, m_pFilterContext(FilterFftContext::SPtr::create())
+, m_pPreprocessing(PreprocessingPipeline::SPtr::create())
 , m_colBackground(Qt::white)
 {
 }
@@ -309,23 +310,19 @@ void RtFiffRawViewModel::setFiffInfo(QSharedPointer<FIFFLIB::FiffInfo> &p_pFiffI
         m_matDataFiltered.conservativeResize(m_pFiffInfo->chs.size(), m_iMaxSamples);
         m_matDataFiltered.setZero();
 
+        m_pyramidRaw.update(m_matDataRaw);
+        m_pyramidFiltered.update(m_matDataFiltered);
+
         m_vecLastBlockFirstValuesFiltered.conservativeResize(m_pFiffInfo->chs.size());
         m_vecLastBlockFirstValuesFiltered.setZero();
 
         m_vecLastBlockFirstValuesRaw.conservativeResize(m_pFiffInfo->chs.size());
         m_vecLastBlockFirstValuesRaw.setZero();
 
-        m_matOverlap.conservativeResize(m_pFiffInfo->chs.size(), m_iMaxFilterLength);
-
-        m_matSparseProjMult = SparseMatrix<double>(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
-        m_matSparseCompMult = SparseMatrix<double>(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
-        m_matSparseSpharaMult = SparseMatrix<double>(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
-        m_matSparseProjCompMult = SparseMatrix<double>(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
+        m_matOverlap.conservativeResize(m_pFiffInfo->chs.size(), m_iFilterLength);
 
-        m_matSparseProjMult.setIdentity();
-        m_matSparseCompMult.setIdentity();
-        m_matSparseSpharaMult.setIdentity();
-        m_matSparseProjCompMult.setIdentity();
+        m_pPreprocessing = PreprocessingPipeline::SPtr::create();
+        m_pPreprocessing->setFilterActive(m_bPerformFiltering && !m_filterKernel.isEmpty());
 
         //Create the initial Compensator projector
         updateCompensator(0);
@@ -356,8 +353,7 @@ void RtFiffRawViewModel::setFiffInfo(QSharedPointer<FIFFLIB::FiffInfo> &p_pFiffI
         initSphara();
     } else {
         m_vecBadIdcs = RowVectorXi(0,0);
-        m_matProj = MatrixXd(0,0);
-        m_matComp = MatrixXd(0,0);
+        m_pPreprocessing = PreprocessingPipeline::SPtr::create();
     }
 }
 
@@ -384,6 +380,9 @@ void RtFiffRawViewModel::setSamplingInfo(float sps, int T, bool bSetZero)
         m_vecLastBlockFirstValuesFiltered.setZero();
     }
 
+    m_pyramidRaw.update(m_matDataRaw);
+    m_pyramidFiltered.update(m_matDataFiltered);
+
     if(m_iCurrentSample>m_iMaxSamples) {
         m_iCurrentSample = 0;
     }
@@ -406,14 +405,8 @@ MatrixXd RtFiffRawViewModel::getLastBlock()
 
 void RtFiffRawViewModel::addData(const QList<MatrixXd> &data)
 {
-    //SSP
-    bool doProj = m_bProjActivated && m_matDataRaw.cols() > 0 && m_matDataRaw.rows() == m_matProj.cols() ? true : false;
-
-    //Compensator
-    bool doComp = m_bCompActivated && m_matDataRaw.cols() > 0 && m_matDataRaw.rows() == m_matComp.cols() ? true : false;
-
-    //SPHARA
-    bool doSphara = m_bSpharaActivated && m_matSparseSpharaMult.cols() > 0 && m_matDataRaw.rows() == m_matSparseSpharaMult.cols() ? true : false;
+    //SPHARA on the filtered data. Without filtering it is part of the operator which is applied to the raw data.
+    bool doSphara = m_pPreprocessing->hasPostFilterStage();
 
     //Copy new data into the global data matrix
     for(qint32 b = 0; b < data.size(); ++b) {
@@ -425,8 +418,11 @@ void RtFiffRawViewModel::addData(const QList<MatrixXd> &data)
             return;
         }
 
+        bool bWrapped = false;
+
         //Reset m_iCurrentSample and start filling the data matrix from the beginning again. Also add residual amount of data to the end of the matrix.
         if(m_iCurrentSample+nCol > m_matDataRaw.cols()) {
+            bWrapped = true;
             m_iResidual = nCol - ((m_iCurrentSample+nCol) % m_matDataRaw.cols());
 
             if(m_iResidual == nCol) {
@@ -438,24 +434,9 @@ void RtFiffRawViewModel::addData(const QList<MatrixXd> &data)
 //            std::cout<<"m_matDataRaw.cols(): "<<m_matDataRaw.cols()<<std::endl;
 //            std::cout<<"nCol-m_iResidual: "<<nCol-m_iResidual<<std::endl<<std::endl;
 
-            if(doComp) {
-                if(doProj) {
-                    //Comp + Proj
-                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseProjCompMult * data.at(b).block(0,0,nRow,m_iResidual);
-                } else {
-                    //Comp
-                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseCompMult * data.at(b).block(0,0,nRow,m_iResidual);
-                }
-            } else {
-                if(doProj)
-                {
-                    //Proj
-                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseProjMult * data.at(b).block(0,0,nRow,m_iResidual);
-                } else {
-                    //None - Raw
-                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = data.at(b).block(0,0,nRow,m_iResidual);
-                }
-            }
+            //Comp, Proj and, if not filtering, SPHARA
+            m_pPreprocessing->applyPreFilter(data.at(b).block(0,0,nRow,m_iResidual),
+                                             m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual));
 
             m_iCurrentSample = 0;
 
@@ -481,23 +462,9 @@ void RtFiffRawViewModel::addData(const QList<MatrixXd> &data)
 
         //std::cout<<"incoming data is ok"<<std::endl;
 
-        if(doComp) {
-            if(doProj) {
-                //Comp + Proj
-                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseProjCompMult * data.at(b);
-            } else {
-                //Comp
-                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseCompMult * data.at(b);
-            }
-        } else {
-            if(doProj) {
-                //Proj
-                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseProjMult * data.at(b);
-            } else {
-                //None - Raw
-                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = data.at(b);
-            }
-        }
+        //Comp, Proj and, if not filtering, SPHARA
+        m_pPreprocessing->applyPreFilter(data.at(b),
+                                         m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol));
 
         //Filter if neccessary else set filtered data matrix to zero
         if(!m_filterKernel.isEmpty() && m_bPerformFiltering) {
@@ -505,23 +472,33 @@ void RtFiffRawViewModel::addData(const QList<MatrixXd> &data)
 
             //Perform SPHARA on filtered data after actual filtering - SPHARA should be applied on the best possible data
             if(doSphara) {
-                if(m_iCurrentSample-m_iMaxFilterLength/2 >= 0) {
-                    m_matDataFiltered.block(0, m_iCurrentSample-m_iMaxFilterLength/2, nRow, nCol) = m_matSparseSpharaMult * m_matDataFiltered.block(0, m_iCurrentSample-m_iMaxFilterLength/2, nRow, nCol);
+                if(m_iCurrentSample-m_iFilterLength/2 >= 0) {
+                    m_pPreprocessing->applyPostFilter(m_matDataFiltered.block(0, m_iCurrentSample-m_iFilterLength/2, nRow, nCol));
                 }
                 else {
-                    if(m_iCurrentSample-m_iMaxFilterLength/2 < 0) {
-                        m_matDataFiltered.block(0, 0, nRow, nCol) = m_matSparseSpharaMult * m_matDataFiltered.block(0, 0, nRow, nCol);
-                        int iResidual = m_iResidual+m_iMaxFilterLength/2;
-                        m_matDataFiltered.block(0, m_matDataFiltered.cols()-iResidual, nRow, iResidual) = m_matSparseSpharaMult * m_matDataFiltered.block(0, m_matDataFiltered.cols()-iResidual, nRow, iResidual);
+                    if(m_iCurrentSample-m_iFilterLength/2 < 0) {
+                        m_pPreprocessing->applyPostFilter(m_matDataFiltered.block(0, 0, nRow, nCol));
+                        int iResidual = m_iResidual+m_iFilterLength/2;
+                        m_pPreprocessing->applyPostFilter(m_matDataFiltered.block(0, m_matDataFiltered.cols()-iResidual, nRow, iResidual));
                     }
                 }
             }
         } else {
             m_matDataFiltered.block(0, m_iCurrentSample, nRow, nCol).setZero();// = m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol);
+        }
 
-            //Perform SPHARA on raw data data
-            if(doSphara) {
-                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseSpharaMult * m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol);
+        //Update the min/max pyramids. The filter and SPHARA also write up to one filter length around the block.
+        //When the block wraps around they also write to the end of the matrix, in this case update everything.
+        if(bWrapped) {
+            m_pyramidRaw.update(m_matDataRaw);
+            m_pyramidFiltered.update(m_matDataFiltered);
+        } else {
+            m_pyramidRaw.update(m_matDataRaw, m_iCurrentSample, nCol);
+
+            if(m_iCurrentSample < m_iFilterLength) {
+                m_pyramidFiltered.update(m_matDataFiltered);
+            } else {
+                m_pyramidFiltered.update(m_matDataFiltered, m_iCurrentSample-m_iFilterLength, nCol+2*m_iFilterLength);
             }
         }
 
@@ -594,6 +571,29 @@ fiff_int_t RtFiffRawViewModel::getCoil(qint32 row) const
 
 //=============================================================================================================
 
+bool RtFiffRawViewModel::getMinMax(int row,
+                                   int iBegin,
+                                   int iEnd,
+                                   double& dMin,
+                                   double& dMax) const
+{
+    qint32 chRow = m_qMapIdxRowSelection.value(row,0);
+
+    if(m_bIsFreezed) {
+        if(!m_filterKernel.isEmpty() && m_bPerformFiltering) {
+            return m_pyramidFilteredFreeze.getMinMax(m_matDataFilteredFreeze, chRow, iBegin, iEnd, dMin, dMax);
+        }
+        return m_pyramidRawFreeze.getMinMax(m_matDataRawFreeze, chRow, iBegin, iEnd, dMin, dMax);
+    }
+
+    if(!m_filterKernel.isEmpty() && m_bPerformFiltering) {
+        return m_pyramidFiltered.getMinMax(m_matDataFiltered, chRow, iBegin, iEnd, dMin, dMax);
+    }
+    return m_pyramidRaw.getMinMax(m_matDataRaw, chRow, iBegin, iEnd, dMin, dMax);
+}
+
+//=============================================================================================================
+
 void RtFiffRawViewModel::selectRows(const QList<qint32> &selection)
 {
     beginResetModel();
@@ -654,6 +654,8 @@ void RtFiffRawViewModel::toggleFreeze(const QModelIndex &)
     if(m_bIsFreezed) {
         m_matDataRawFreeze = m_matDataRaw;
         m_matDataFilteredFreeze = m_matDataFiltered;
+        m_pyramidRawFreeze = m_pyramidRaw;
+        m_pyramidFilteredFreeze = m_pyramidFiltered;
         m_qMapDetectedTriggerFreeze = m_qMapDetectedTrigger;
         m_qMapDetectedTriggerOldFreeze = m_qMapDetectedTriggerOld;
 
@@ -683,57 +685,28 @@ void RtFiffRawViewModel::updateProjection(const QList<FIFFLIB::FiffProj>& projs)
 {
     //  Update the SSP projector
     if(m_pFiffInfo) {
-        //If a minimum of one projector is active set m_bProjActivated to true so that this model applies the ssp to the incoming data
-        m_bProjActivated = false;
+        //If a minimum of one projector is active set bProjActivated to true so that this model applies the ssp to the incoming data
+        bool bProjActivated = false;
         m_pFiffInfo->projs = projs;
 
         for(qint32 i = 0; i < this->m_pFiffInfo->projs.size(); ++i) {
             if(this->m_pFiffInfo->projs[i].active) {
-                m_bProjActivated = true;
+                bProjActivated = true;
                 break;
             }
         }
 
-        this->m_pFiffInfo->make_projector(m_matProj);
+        MatrixXd matProj;
+        this->m_pFiffInfo->make_projector(matProj);
 
         qDebug() << "RtFiffRawViewModel::updateProjection - New projection calculated.";
 
         //set columns of matrix to zero depending on bad channels indexes
         for(qint32 j = 0; j < m_vecBadIdcs.cols(); ++j) {
-            m_matProj.col(m_vecBadIdcs[j]).setZero();
+            matProj.col(m_vecBadIdcs[j]).setZero();
         }
 
-//        std::cout << "Bads\n" << m_vecBadIdcs << std::endl;
-//        std::cout << "Proj\n";
-//        std::cout << m_matProj.block(0,0,10,10) << std::endl;
-
-        //
-        // Make proj sparse
-        //
-        qint32 nchan = this->m_pFiffInfo->nchan;
-        qint32 i, k;
-
-        typedef Eigen::Triplet<double> T;
-        std::vector<T> tripletList;
-        tripletList.reserve(nchan);
-
-        tripletList.clear();
-        tripletList.reserve(m_matProj.rows()*m_matProj.cols());
-        for(i = 0; i < m_matProj.rows(); ++i) {
-            for(k = 0; k < m_matProj.cols(); ++k) {
-                if(m_matProj(i,k) != 0) {
-                    tripletList.push_back(T(i, k, m_matProj(i,k)));
-                }
-            }
-        }
-
-        m_matSparseProjMult = SparseMatrix<double>(m_matProj.rows(),m_matProj.cols());
-        if(tripletList.size() > 0) {
-            m_matSparseProjMult.setFromTriplets(tripletList.begin(), tripletList.end());
-        }
-
-        //Create full multiplication matrix
-        m_matSparseProjCompMult = m_matSparseProjMult * m_matSparseCompMult;
+        m_pPreprocessing->setProjector(matProj, bProjActivated);
     }
 }
 
@@ -743,51 +716,13 @@ void RtFiffRawViewModel::updateCompensator(int to)
 {
     //  Update the compensator
     if(m_pFiffInfo) {
-        if(to == 0) {
-            m_bCompActivated = false;
-        } else {
-            m_bCompActivated = true;
-        }
-
-//        qDebug()<<"to"<<to;
-//        qDebug()<<"from"<<from;
-//        qDebug()<<"m_bCompActivated"<<m_bCompActivated;
-
         FiffCtfComp newComp;
         this->m_pFiffInfo->make_compensator(0, to, newComp);//Do this always from 0 since we always read new raw data, we never actually perform a multiplication on already existing data
 
         //We do not need to call this->m_pFiffInfo->set_current_comp(to);
         //Because we will set the compensators to the coil in the same FiffInfo which is already used to write to file.
         //Note that the data is written in raw form not in compensated form.
-        m_matComp = newComp.data->data;
-
-        //
-        // Make proj sparse
-        //
-        qint32 nchan = this->m_pFiffInfo->nchan;
-        qint32 i, k;
-
-        typedef Eigen::Triplet<double> T;
-        std::vector<T> tripletList;
-        tripletList.reserve(nchan);
-
-        tripletList.clear();
-        tripletList.reserve(m_matComp.rows()*m_matComp.cols());
-        for(i = 0; i < m_matComp.rows(); ++i) {
-            for(k = 0; k < m_matComp.cols(); ++k) {
-                if(m_matComp(i,k) != 0) {
-                    tripletList.push_back(T(i, k, m_matComp(i,k)));
-                }
-            }
-        }
-
-        m_matSparseCompMult = SparseMatrix<double>(m_matComp.rows(),m_matComp.cols());
-        if(tripletList.size() > 0) {
-            m_matSparseCompMult.setFromTriplets(tripletList.begin(), tripletList.end());
-        }
-
-        //Create full multiplication matrix
-        m_matSparseProjCompMult = m_matSparseProjMult * m_matSparseCompMult;
+        m_pPreprocessing->setCompensator(newComp.data->data, to != 0);
     }
 }
 
@@ -795,7 +730,7 @@ void RtFiffRawViewModel::updateCompensator(int to)
 
 void RtFiffRawViewModel::updateSpharaActivation(bool state)
 {
-    m_bSpharaActivated = state;
+    m_pPreprocessing->setSpharaActive(state);
 }
 
 //=============================================================================================================
@@ -873,7 +808,7 @@ void RtFiffRawViewModel::updateSpharaOptions(const QString& sSytemType, int nBas
         }
 
         //Create full multiplication matrix
-        m_matSparseSpharaMult = matSparseSpharaMultFirst * matSparseSpharaMultSecond;
+        m_pPreprocessing->setSpharaOperator(matSparseSpharaMultFirst * matSparseSpharaMultSecond);
     }
 }
 
@@ -882,15 +817,13 @@ void RtFiffRawViewModel::updateSpharaOptions(const QString& sSytemType, int nBas
 void RtFiffRawViewModel::setFilter(QList<FilterKernel> filterData)
 {
     m_filterKernel = filterData;
+    m_pFilterContext->setFilterKernels(m_filterKernel);
+    m_pPreprocessing->setFilterActive(m_bPerformFiltering && !m_filterKernel.isEmpty());
 
-    m_iMaxFilterLength = 1;
-    for(int i=0; i<filterData.size(); ++i) {
-        if(m_iMaxFilterLength<filterData.at(i).getFilterOrder()) {
-            m_iMaxFilterLength = filterData.at(i).getFilterOrder();
-        }
-    }
+    //The context filters with all kernels at once, its output is padded by the sum of their orders
+    m_iFilterLength = qMax(m_pFilterContext->getFilterOrder(), 1);
 
-    m_matOverlap.conservativeResize(m_pFiffInfo->chs.size(), m_iMaxFilterLength);
+    m_matOverlap.conservativeResize(m_pFiffInfo->chs.size(), m_iFilterLength);
     m_matOverlap.setZero();
 
     m_bDrawFilterFront = false;
@@ -904,6 +837,7 @@ void RtFiffRawViewModel::setFilter(QList<FilterKernel> filterData)
 void RtFiffRawViewModel::setFilterActive(bool state)
 {
     m_bPerformFiltering = state;
+    m_pPreprocessing->setFilterActive(m_bPerformFiltering && !m_filterKernel.isEmpty());
 }
 
 //=============================================================================================================
@@ -1113,7 +1047,7 @@ void RtFiffRawViewModel::filterDataBlock()
     //Create temporary filters with higher fft length because we are going to filter all available data at once for one time
     QList<FilterKernel> tempFilterList;
 
-    int fftLength = m_matDataRaw.row(0).cols() + 4 * m_iMaxFilterLength;
+    int fftLength = m_matDataRaw.row(0).cols() + 4 * m_iFilterLength;
     int exp = ceil(MNEMath::log2(fftLength));
     fftLength = pow(2, exp) < 512 ? 512 : pow(2, exp);
 
@@ -1137,8 +1071,8 @@ void RtFiffRawViewModel::filterDataBlock()
     //Also append mirrored data in front and back to get rid of edge effects
     for(qint32 i=0; i<m_matDataRaw.rows(); ++i) {
         if(m_filterChannelList.contains(m_pFiffInfo->chs.at(i).ch_name)) {
-            RowVectorXd datTemp(m_matDataRaw.row(i).cols() + 2 * m_iMaxFilterLength);
-            datTemp << m_matDataRaw.row(i).head(m_iMaxFilterLength).reverse(), m_matDataRaw.row(i), m_matDataRaw.row(i).tail(m_iMaxFilterLength).reverse();
+            RowVectorXd datTemp(m_matDataRaw.row(i).cols() + 2 * m_iFilterLength);
+            datTemp << m_matDataRaw.row(i).head(m_iFilterLength).reverse(), m_matDataRaw.row(i), m_matDataRaw.row(i).tail(m_iFilterLength).reverse();
             timeData.append(QPair<QList<FilterKernel>,QPair<int,RowVectorXd> >(tempFilterList,QPair<int,RowVectorXd>(i,datTemp)));
         } else {
             notFilterChannelIndex.append(i);
@@ -1153,8 +1087,8 @@ void RtFiffRawViewModel::filterDataBlock()
         future.waitForFinished();
 
         for(int r = 0; r < timeData.size(); ++r) {
-            m_matDataFiltered.row(timeData.at(r).second.first) = timeData.at(r).second.second.segment(m_iMaxFilterLength+m_iMaxFilterLength/2, m_matDataRaw.cols());
-            m_matOverlap.row(timeData.at(r).second.first) = timeData.at(r).second.second.tail(m_iMaxFilterLength);
+            m_matDataFiltered.row(timeData.at(r).second.first) = timeData.at(r).second.second.segment(m_iFilterLength+m_iFilterLength/2, m_matDataRaw.cols());
+            m_matOverlap.row(timeData.at(r).second.first) = timeData.at(r).second.second.tail(m_iFilterLength);
         }
     }
 
@@ -1163,6 +1097,8 @@ void RtFiffRawViewModel::filterDataBlock()
         m_matDataFiltered.row(notFilterChannelIndex.at(i)) = m_matDataRaw.row(notFilterChannelIndex.at(i));
     }
 
+    m_pyramidFiltered.update(m_matDataFiltered);
+
     if(!m_bIsFreezed) {
         m_vecLastBlockFirstValuesFiltered = m_matDataFiltered.col(0);
     }
@@ -1176,102 +1112,106 @@ void RtFiffRawViewModel::filterDataBlock(const MatrixXd &data, int iDataIndex)
 {
     //std::cout<<"START RtFiffRawViewModel::filterDataBlock"<<std::endl;
 
-    if(iDataIndex >= m_matDataFiltered.cols() || data.cols() < m_iMaxFilterLength) {
+    if(iDataIndex >= m_matDataFiltered.cols() || data.cols() < m_iFilterLength) {
         return;
     }
 
-    //Generate QList structure which can be handled by the QConcurrent framework
-    QList<QPair<QList<FilterKernel>,QPair<int,RowVectorXd> > > timeData;
+    //Collect the channels which are to be filtered
+    QList<int> filterChannelIndex;
     QList<int> notFilterChannelIndex;
 
     for(qint32 i = 0; i < data.rows(); ++i) {
         if(m_filterChannelList.contains(m_pFiffInfo->chs.at(i).ch_name)) {
-            timeData.append(QPair<QList<FilterKernel>,QPair<int,RowVectorXd> >(m_filterKernel,QPair<int,RowVectorXd>(i,data.row(i))));
+            filterChannelIndex.append(i);
         } else {
             notFilterChannelIndex.append(i);
-            }
+        }
     }
 
-    //Do the concurrent filtering
-    if(!timeData.isEmpty()) {
-        QFuture<void> future = QtConcurrent::map(timeData,
-                                             doFilterPerChannelRTMSA);
+    //Filter all picked channels at once. The context keeps the transformed coefficients between blocks.
+    if(!filterChannelIndex.isEmpty()) {
+        RowVectorXi vecPicks(filterChannelIndex.size());
+        for(int i = 0; i < filterChannelIndex.size(); ++i) {
+            vecPicks[i] = filterChannelIndex.at(i);
+        }
 
-        future.waitForFinished();
+        MatrixXd matFiltered = m_pFilterContext->calculate(data, vecPicks);
 
         //Do the overlap add method and store in m_matDataFiltered
-        int iFilterDelay = m_iMaxFilterLength/2;
-        int iFilteredNumberCols = timeData.at(0).second.second.cols();
+        int iFilterDelay = m_iFilterLength/2;
+        int iFilteredNumberCols = matFiltered.cols();
+
+        for(int r = 0; r < filterChannelIndex.size(); ++r) {
+            int iRow = filterChannelIndex.at(r);
 
-        for(int r = 0; r<timeData.size(); ++r) {
             if(iDataIndex+2*data.cols() > m_matDataRaw.cols()) {
                 //Handle last data block
                 //std::cout<<"Handle last data block"<<std::endl;
 
                 if(m_bDrawFilterFront) {
                     //Get the currently filtered data. This data has a delay of filterLength/2 in front and back.
-                    RowVectorXd tempData = timeData.at(r).second.second;
+                    RowVectorXd tempData = matFiltered.row(iRow);
 
                     //Perform the actual overlap add by adding the last filterlength data to the newly filtered one
-                    tempData.head(m_iMaxFilterLength) += m_matOverlap.row(timeData.at(r).second.first);
+                    tempData.head(m_iFilterLength) += m_matOverlap.row(iRow);
 
                     //Write the newly calulated filtered data to the filter data matrix. Keep in mind that the current block also effect last part of the last block (begin at dataIndex-iFilterDelay).
                     int start = iDataIndex-iFilterDelay < 0 ? 0 : iDataIndex-iFilterDelay;
-                    m_matDataFiltered.row(timeData.at(r).second.first).segment(start,iFilteredNumberCols-m_iMaxFilterLength) = tempData.head(iFilteredNumberCols-m_iMaxFilterLength);
+                    m_matDataFiltered.row(iRow).segment(start,iFilteredNumberCols-m_iFilterLength) = tempData.head(iFilteredNumberCols-m_iFilterLength);
                 } else {
                     //Perform this else case everytime the filter was changed. Do not begin to plot from dataIndex-iFilterDelay because the impsulse response and m_matOverlap do not match with the new filter anymore.
-                    m_matDataFiltered.row(timeData.at(r).second.first).segment(iDataIndex-iFilterDelay,m_iMaxFilterLength) = timeData.at(r).second.second.segment(m_iMaxFilterLength,m_iMaxFilterLength);
-                    m_matDataFiltered.row(timeData.at(r).second.first).segment(iDataIndex+iFilterDelay,iFilteredNumberCols-2*m_iMaxFilterLength) = timeData.at(r).second.second.segment(m_iMaxFilterLength,iFilteredNumberCols-2*m_iMaxFilterLength);
+                    m_matDataFiltered.row(iRow).segment(iDataIndex-iFilterDelay,m_iFilterLength) = matFiltered.row(iRow).segment(m_iFilterLength,m_iFilterLength);
+                    m_matDataFiltered.row(iRow).segment(iDataIndex+iFilterDelay,iFilteredNumberCols-2*m_iFilterLength) = matFiltered.row(iRow).segment(m_iFilterLength,iFilteredNumberCols-2*m_iFilterLength);
                 }
 
                 //Refresh the m_matOverlap with the new calculated filtered data.
-                m_matOverlap.row(timeData.at(r).second.first) = timeData.at(r).second.second.tail(m_iMaxFilterLength);
+                m_matOverlap.row(iRow) = matFiltered.row(iRow).tail(m_iFilterLength);
             } else if(iDataIndex == 0) {
                 //Handle first data block
                 //std::cout<<"Handle first data block"<<std::endl;
 
                 if(m_bDrawFilterFront) {
                     //Get the currently filtered data. This data has a delay of filterLength/2 in front and back.
-                    RowVectorXd tempData = timeData.at(r).second.second;
+                    RowVectorXd tempData = matFiltered.row(iRow);
 
                     //Add newly calculate data to the tail of the current filter data matrix
-                    m_matDataFiltered.row(timeData.at(r).second.first).segment(m_matDataFiltered.cols()-iFilterDelay-m_iResidual, iFilterDelay) = tempData.head(iFilterDelay) + m_matOverlap.row(timeData.at(r).second.first).head(iFilterDelay);
+                    m_matDataFiltered.row(iRow).segment(m_matDataFiltered.cols()-iFilterDelay-m_iResidual, iFilterDelay) = tempData.head(iFilterDelay) + m_matOverlap.row(iRow).head(iFilterDelay);
 
                     //Perform the actual overlap add by adding the last filterlength data to the newly filtered one
-                    tempData.head(m_iMaxFilterLength) += m_matOverlap.row(timeData.at(r).second.first);
-                    m_matDataFiltered.row(timeData.at(r).second.first).head(iFilteredNumberCols-m_iMaxFilterLength-iFilterDelay) = tempData.segment(iFilterDelay,iFilteredNumberCols-m_iMaxFilterLength-iFilterDelay);
+                    tempData.head(m_iFilterLength) += m_matOverlap.row(iRow);
+                    m_matDataFiltered.row(iRow).head(iFilteredNumberCols-m_iFilterLength-iFilterDelay) = tempData.segment(iFilterDelay,iFilteredNumberCols-m_iFilterLength-iFilterDelay);
 
                     //Copy residual data from the front to the back. The residual is != 0 if the chosen block size cannot be evenly fit into the matrix size
-                    m_matDataFiltered.row(timeData.at(r).second.first).tail(m_iResidual) = m_matDataFiltered.row(timeData.at(r).second.first).head(m_iResidual);
+                    m_matDataFiltered.row(iRow).tail(m_iResidual) = m_matDataFiltered.row(iRow).head(m_iResidual);
                 } else {
                     //Perform this else case everytime the filter was changed. Do not begin to plot from dataIndex-iFilterDelay because the impsulse response and m_matOverlap do not match with the new filter anymore.
-                    m_matDataFiltered.row(timeData.at(r).second.first).head(m_iMaxFilterLength) = timeData.at(r).second.second.segment(m_iMaxFilterLength,m_iMaxFilterLength);
-                    m_matDataFiltered.row(timeData.at(r).second.first).segment(iFilterDelay,iFilteredNumberCols-2*m_iMaxFilterLength) = timeData.at(r).second.second.segment(m_iMaxFilterLength,iFilteredNumberCols-2*m_iMaxFilterLength);
+                    m_matDataFiltered.row(iRow).head(m_iFilterLength) = matFiltered.row(iRow).segment(m_iFilterLength,m_iFilterLength);
+                    m_matDataFiltered.row(iRow).segment(iFilterDelay,iFilteredNumberCols-2*m_iFilterLength) = matFiltered.row(iRow).segment(m_iFilterLength,iFilteredNumberCols-2*m_iFilterLength);
                 }
 
                 //Refresh the m_matOverlap with the new calculated filtered data.
-                m_matOverlap.row(timeData.at(r).second.first) = timeData.at(r).second.second.tail(m_iMaxFilterLength);
+                m_matOverlap.row(iRow) = matFiltered.row(iRow).tail(m_iFilterLength);
             } else {
                 //Handle middle data blocks
                 //std::cout<<"Handle middle data block"<<std::endl;
 
                 if(m_bDrawFilterFront) {
                     //Get the currently filtered data. This data has a delay of filterLength/2 in front and back.
-                    RowVectorXd tempData = timeData.at(r).second.second;
+                    RowVectorXd tempData = matFiltered.row(iRow);
 
                     //Perform the actual overlap add by adding the last filterlength data to the newly filtered one
-                    tempData.head(m_iMaxFilterLength) += m_matOverlap.row(timeData.at(r).second.first);
+                    tempData.head(m_iFilterLength) += m_matOverlap.row(iRow);
 
                     //Write the newly calulated filtered data to the filter data matrix. Keep in mind that the current block also effect last part of the last block (begin at dataIndex-iFilterDelay).
-                    m_matDataFiltered.row(timeData.at(r).second.first).segment(iDataIndex-iFilterDelay,iFilteredNumberCols-m_iMaxFilterLength) = tempData.head(iFilteredNumberCols-m_iMaxFilterLength);
+                    m_matDataFiltered.row(iRow).segment(iDataIndex-iFilterDelay,iFilteredNumberCols-m_iFilterLength) = tempData.head(iFilteredNumberCols-m_iFilterLength);
                 } else {
                     //Perform this else case everytime the filter was changed. Do not begin to plot from dataIndex-iFilterDelay because the impsulse response and m_matOverlap do not match with the new filter anymore.
-                    m_matDataFiltered.row(timeData.at(r).second.first).segment(iDataIndex-iFilterDelay,m_iMaxFilterLength).setZero();// = timeData.at(r).second.second.segment(m_iMaxFilterLength,m_iMaxFilterLength);
-                    m_matDataFiltered.row(timeData.at(r).second.first).segment(iDataIndex+iFilterDelay,iFilteredNumberCols-2*m_iMaxFilterLength) = timeData.at(r).second.second.segment(m_iMaxFilterLength,iFilteredNumberCols-2*m_iMaxFilterLength);
+                    m_matDataFiltered.row(iRow).segment(iDataIndex-iFilterDelay,m_iFilterLength).setZero();// = matFiltered.row(iRow).segment(m_iFilterLength,m_iFilterLength);
+                    m_matDataFiltered.row(iRow).segment(iDataIndex+iFilterDelay,iFilteredNumberCols-2*m_iFilterLength) = matFiltered.row(iRow).segment(m_iFilterLength,iFilteredNumberCols-2*m_iFilterLength);
                 }
 
                 //Refresh the m_matOverlap with the new calculated filtered data.
-                m_matOverlap.row(timeData.at(r).second.first) = timeData.at(r).second.second.tail(m_iMaxFilterLength);
+                m_matOverlap.row(iRow) = matFiltered.row(iRow).tail(m_iFilterLength);
             }
         }
     }
@@ -1300,5 +1240,10 @@ void RtFiffRawViewModel::clearModel()
     m_vecLastBlockFirstValuesRaw.setZero();
     m_matOverlap.setZero();
 
+    m_pyramidRaw.update(m_matDataRaw);
+    m_pyramidFiltered.update(m_matDataFiltered);
+    m_pyramidRawFreeze.update(m_matDataRawFreeze);
+    m_pyramidFilteredFreeze.update(m_matDataFilteredFreeze);
+
     endResetModel();
 }
@@ -41,6 +41,7 @@
 //=============================================================================================================
 
 #include "../../disp_global.h"
+#include "minmaxpyramid.h"
 
 #include <fiff/fiff_types.h>
 #include <fiff/fiff_proj.h>
@@ -70,6 +71,11 @@ namespace FIFFLIB {
     class FiffInfo;
 }
 
+namespace RTPROCESSINGLIB {
+    class FilterFftContext;
+    class PreprocessingPipeline;
+}
+
 //=============================================================================================================
 // DEFINE NAMESPACE DISPLIB
 //=============================================================================================================
@@ -243,6 +249,25 @@ public:
      */
     inline double getLastBlockFirstValue(int row) const;
 
+    //=========================================================================================================
+    /**
+     * Returns the minimum and maximum of the currently displayed data of a row within a sample range. The values
+     * are looked up in the min/max pyramid, so the cost does not grow with the number of samples in the range.
+     *
+     * @param[in] row        row for which the values are to be returned
+     * @param[in] iBegin     first sample of the range
+     * @param[in] iEnd       one past the last sample of the range
+     * @param[out] dMin      the minimum within the range
+     * @param[out] dMax      the maximum within the range
+     *
+     * @return false if the range is empty, true otherwise
+     */
+    bool getMinMax(int row,
+                   int iBegin,
+                   int iEnd,
+                   double& dMin,
+                   double& dMax) const;
+
     //=========================================================================================================
     /**
      * Returns a map which conatins the channel idx and its corresponding selection status
@@ -532,9 +557,6 @@ private:
      */
     void clearModel();
 
-    bool                                m_bProjActivated;                           /**< Projections activated */
-    bool                                m_bCompActivated;                           /**< Compensator activated */
-    bool                                m_bSpharaActivated;                         /**< Sphara activated */
     bool                                m_bIsFreezed;                               /**< Display is freezed */
     bool                                m_bDrawFilterFront;                         /**< Flag whether to plot/write the delayed frontal part of the filtered signal. This flag is necessary to get rid of nasty signal jumps when changing the filter parameters. */
     bool                                m_bPerformFiltering;                        /**< Flag whether to activate/deactivate filtering. */
@@ -546,7 +568,7 @@ private:
     qint32                              m_iMaxSamples;                              /**< Max samples per window */
     qint32                              m_iCurrentSample;                           /**< Current sample which holds the current position in the data matrix */
     qint32                              m_iCurrentSampleFreeze;                     /**< Current sample which holds the current position in the data matrix when freezing tool is active */
-    qint32                              m_iMaxFilterLength;                         /**< Max order of the current filters */
+    qint32                              m_iFilterLength;                            /**< Total order of the current filters, i.e. the length of the overlap */
     qint32                              m_iCurrentBlockSize;                        /**< Current block size */
     qint32                              m_iResidual;                                /**< Current amount of samples which were to size */
     int                                 m_iCurrentTriggerChIndex;                   /**< The index of the current trigger channel */
@@ -566,6 +588,10 @@ private:
     MatrixXdR                           m_matDataFiltered;                          /**< The filtered data */
     MatrixXdR                           m_matDataRawFreeze;                         /**< The raw data in freeze mode */
     MatrixXdR                           m_matDataFilteredFreeze;                    /**< The raw filtered data in freeze mode */
+    MinMaxPyramid                       m_pyramidRaw;                               /**< The min/max pyramid of the raw data */
+    MinMaxPyramid                       m_pyramidFiltered;                          /**< The min/max pyramid of the filtered data */
+    MinMaxPyramid                       m_pyramidRawFreeze;                         /**< The min/max pyramid of the raw data in freeze mode */
+    MinMaxPyramid                       m_pyramidFilteredFreeze;                    /**< The min/max pyramid of the filtered data in freeze mode */
     Eigen::MatrixXd                     m_matOverlap;                               /**< Last overlap block for the back */
 
     Eigen::VectorXi                     m_vecIndicesFirstVV;                        /**< The indices of the channels to pick for the first SPHARA operator in case of a VectorView system.*/
@@ -574,14 +600,6 @@ private:
     Eigen::VectorXi                     m_vecIndicesSecondBabyMEG;                  /**< The indices of the channels to pick for the second SPHARA operator in case of a BabyMEG system.*/
     Eigen::VectorXi                     m_vecIndicesFirstEEG;                       /**< The indices of the channels to pick for the second SPHARA operator in case of an EEG system.*/
 
-    Eigen::SparseMatrix<double>         m_matSparseSpharaMult;                      /**< The final sparse SPHARA operator .*/
-    Eigen::SparseMatrix<double>         m_matSparseProjCompMult;                    /**< The final sparse projection + compensator operator.*/
-    Eigen::SparseMatrix<double>         m_matSparseProjMult;                        /**< The final sparse SSP projector */
-    Eigen::SparseMatrix<double>         m_matSparseCompMult;                        /**< The final sparse compensator matrix */
-
-    Eigen::MatrixXd                     m_matProj;                                  /**< SSP projector */
-    Eigen::MatrixXd                     m_matComp;                                  /**< Compensator */
-
     Eigen::MatrixXd                     m_matSpharaVVGradLoaded;                    /**< The loaded VectorView gradiometer basis functions.*/
     Eigen::MatrixXd                     m_matSpharaVVMagLoaded;                     /**< The loaded VectorView magnetometer basis functions.*/
     Eigen::MatrixXd                     m_matSpharaBabyMEGInnerLoaded;              /**< The loaded babyMEG inner layer basis functions.*/
@@ -596,6 +614,8 @@ private:
     QMap<int,QList<QPair<int,double> > >m_qMapDetectedTriggerOldFreeze;             /**< Old detected trigger for each trigger channel while display is freezed. */
     QMap<qint32,float>                  m_qMapChScaling;                            /**< Channel scaling map. */
     QList<RTPROCESSINGLIB::FilterKernel>m_filterKernel;                             /**< List of currently active filters. */
+    QSharedPointer<RTPROCESSINGLIB::FilterFftContext> m_pFilterContext;            /**< FFT context of the active filters, kept between incoming blocks. */
+    QSharedPointer<RTPROCESSINGLIB::PreprocessingPipeline> m_pPreprocessing;       /**< Precomposed compensator, projector and SPHARA operators. */
     QStringList                         m_filterChannelList;                        /**< List of channels which are to be filtered.*/
     QStringList                         m_visibleChannelList;                       /**< List of currently visible channels in the view.*/
     QMap<qint32,qint32>                 m_qMapIdxRowSelection;                      /**< Selection mapping.*/
@@ -644,7 +664,7 @@ inline qint32 RtFiffRawViewModel::getCurrentSampleIndex() const
     }
 
     if(!m_filterKernel.isEmpty() && m_bPerformFiltering) {
-        return m_iCurrentSample-m_iMaxFilterLength/2;
+        return m_iCurrentSample-m_iFilterLength/2;
     }
 
     return m_iCurrentSample;
@@ -776,7 +796,7 @@ inline bool RtFiffRawViewModel::triggerDetectionActive() const
 inline int RtFiffRawViewModel::getCurrentOverlapAddDelay() const
 {
     if(!m_filterKernel.isEmpty())
-        return m_iMaxFilterLength/2;
+        return m_iFilterLength/2;
     else
         return 0;
 }
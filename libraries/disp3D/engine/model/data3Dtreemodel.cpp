@@ -569,6 +569,8 @@ void Data3DTreeModel::initMetatypes()
     qRegisterMetaType<FIFFLIB::FiffInfo>();
     qRegisterMetaType<FiffInfo>();
 
+    qRegisterMetaType<UTILSLIB::MeshAdjacency>();
+
     qRegisterMetaType<Eigen::MatrixX3i>();
     qRegisterMetaType<MatrixX3i>();
 
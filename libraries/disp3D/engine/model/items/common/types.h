@@ -44,6 +44,7 @@
 #include <fs/label.h>
 #include <inverse/dipoleFit/ecd_set.h>
 #include <fiff/fiff_info.h>
+#include <utils/meshadjacency.h>
 
 //=============================================================================================================
 // QT INCLUDES
@@ -258,4 +259,9 @@ Q_DECLARE_METATYPE(QSharedPointer<Eigen::SparseMatrix<float> >);
 Q_DECLARE_METATYPE(QList<FSLIB::Label>);
 #endif
 
+#ifndef DISP3DLIB_metatype_meshadjacency
+#define DISP3DLIB_metatype_meshadjacency
+Q_DECLARE_METATYPE(UTILSLIB::MeshAdjacency);
+#endif
+
 #endif // DISP3DLIB_TYPES_H
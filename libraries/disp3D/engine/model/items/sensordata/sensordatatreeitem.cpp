@@ -196,7 +196,7 @@ void SensorDataTreeItem::initData(const MNEBemSurface &bemSurface,
 
     //Setup worker
     m_pSensorRtDataWorkController->setInterpolationInfo(bemSurface.rr,
-                                                        bemSurface.neighbor_vert,
+                                                        bemSurface.adjacency,
                                                         vecSensorPos,
                                                         fiffInfo,
                                                         sensorTypeFiffConstant);
@@ -388,8 +388,8 @@ void MneDataTreeItem::initData(const MNEForwardSolution& tForwardSolution,
 
     m_pRtSourceDataController->setInterpolationInfo(tForwardSolution.src[0].rr,
                                                     tForwardSolution.src[1].rr,
-                                                    tForwardSolution.src[0].neighbor_vert,
-                                                    tForwardSolution.src[1].neighbor_vert,
+                                                    tForwardSolution.src[0].adjacency,
+                                                    tForwardSolution.src[1].adjacency,
                                                     clustVertNoLeft,
                                                     clustVertNoRight);
 
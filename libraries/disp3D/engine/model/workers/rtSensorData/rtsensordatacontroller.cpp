@@ -57,6 +57,7 @@
 using namespace DISP3DLIB;
 using namespace Eigen;
 using namespace FIFFLIB;
+using namespace UTILSLIB;
 
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -193,7 +194,7 @@ void RtSensorDataController::setTimeInterval(int iMSec)
 //=============================================================================================================
 
 void RtSensorDataController::setInterpolationInfo(const Eigen::MatrixX3f &matVertices,
-                                                  const QVector<QVector<int> > &vecNeighborVertices,
+                                                  const MeshAdjacency &adjacency,
                                                   const QVector<Vector3f> &vecSensorPos,
                                                   const FiffInfo &fiffInfo,
                                                   int iSensorType)
@@ -201,7 +202,7 @@ void RtSensorDataController::setInterpolationInfo(const Eigen::MatrixX3f &matVer
     emit numberVerticesChanged(matVertices.rows());
 
     emit interpolationInfoChanged(matVertices,
-                                  vecNeighborVertices,
+                                  adjacency,
                                   vecSensorPos,
                                   fiffInfo,
                                   iSensorType);
@@ -63,6 +63,10 @@ namespace FIFFLIB {
     class FiffInfo;
 }
 
+namespace UTILSLIB {
+    class MeshAdjacency;
+}
+
 //=============================================================================================================
 // DEFINE NAMESPACE DISP3DLIB
 //=============================================================================================================
@@ -152,7 +156,7 @@ public:
      * Warning: Using this function can take some seconds because recalculation are required.
      *
      * @param[in] matVertices               The vertex information.
-     * @param[in] vecNeighborVertices       The neighbor vertex information.
+     * @param[in] adjacency                 The vertex adjacency of the mesh.
      * @param[in] vecSensorPos              The QVector that holds the sensor positons in x, y and z coordinates.
      * @param[in] fiffEvoked                Holds all information about the sensors.
      * @param[in] iSensorType               Type of the sensor: FIFFV_EEG_CH or FIFFV_MEG_CH.
@@ -160,7 +164,7 @@ public:
      * @return Returns the created interpolation matrix.
      */
     void setInterpolationInfo(const Eigen::MatrixX3f &matVertices,
-                              const QVector<QVector<int> > &vecNeighborVertices,
+                              const UTILSLIB::MeshAdjacency &adjacency,
                               const QVector<Eigen::Vector3f> &vecSensorPos,
                               const FIFFLIB::FiffInfo &fiffInfo,
                               int iSensorType);
@@ -261,13 +265,13 @@ signals:
      * Emit this signal whenever the interpolation info changed.
      *
      * @param[in] matVertices               The vertex information.
-     * @param[in] vecNeighborVertices       The neighbor vertex information.
+     * @param[in] adjacency                 The vertex adjacency of the mesh.
      * @param[in] vecSensorPos              The QVector that holds the sensor positons in x, y and z coordinates.
      * @param[in] fiffEvoked                Holds all information about the sensors.
      * @param[in] iSensorType               Type of the sensor: FIFFV_EEG_CH or FIFFV_MEG_CH.
      */
     void interpolationInfoChanged(const Eigen::MatrixX3f &matVertices,
-                                  const QVector<QVector<int> > &vecNeighborVertices,
+                                  const UTILSLIB::MeshAdjacency &adjacency,
                                   const QVector<Eigen::Vector3f> &vecSensorPos,
                                   const FIFFLIB::FiffInfo &fiffInfo,
                                   int iSensorType);
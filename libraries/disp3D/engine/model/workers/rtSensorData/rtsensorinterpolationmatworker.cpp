@@ -55,6 +55,7 @@
 using namespace DISP3DLIB;
 using namespace MNELIB;
 using namespace FIFFLIB;
+using namespace UTILSLIB;
 using namespace Eigen;
 
 //=============================================================================================================
@@ -66,7 +67,7 @@ RtSensorInterpolationMatWorker::RtSensorInterpolationMatWorker()
 {
     m_lInterpolationData.dCancelDistance = 0.05;
     m_lInterpolationData.interpolationFunction = DISP3DLIB::Interpolation::cubic;
-    m_lInterpolationData.matDistanceMatrix = QSharedPointer<MatrixXd>(new MatrixXd());
+    m_lInterpolationData.matDistanceMatrix = QSharedPointer<SparseMatrix<float> >::create();
 }
 
 //=============================================================================================================
@@ -105,7 +106,7 @@ void RtSensorInterpolationMatWorker::setCancelDistance(double dCancelDist)
 //=============================================================================================================
 
 void RtSensorInterpolationMatWorker::setInterpolationInfo(const Eigen::MatrixX3f &matVertices,
-                                                          const QVector<QVector<int> > &vecNeighborVertices,
+                                                          const MeshAdjacency &adjacency,
                                                           const QVector<Vector3f> &vecSensorPos,
                                                           const FiffInfo &fiffInfo,
                                                           int iSensorType)
@@ -119,7 +120,7 @@ void RtSensorInterpolationMatWorker::setInterpolationInfo(const Eigen::MatrixX3f
     m_lInterpolationData.matVertices = matVertices;
     m_lInterpolationData.fiffInfo = fiffInfo;
     m_lInterpolationData.iSensorType = iSensorType;
-    m_lInterpolationData.vecNeighborVertices = vecNeighborVertices;
+    m_lInterpolationData.adjacency = adjacency;
 
     //set vecExcludeIndex
     m_lInterpolationData.vecExcludeIndex.clear();
@@ -185,8 +186,8 @@ void RtSensorInterpolationMatWorker::calculateInterpolationOperator()
     }
 
     //SCDC with cancel distance
-    m_lInterpolationData.matDistanceMatrix = GeometryInfo::scdc(m_lInterpolationData.matVertices,
-                                                                m_lInterpolationData.vecNeighborVertices,
+    m_lInterpolationData.matDistanceMatrix = GeometryInfo::scdcSparse(m_lInterpolationData.matVertices,
+                                                                m_lInterpolationData.adjacency,
                                                                 m_lInterpolationData.vecMappedSubset,
                                                                 m_lInterpolationData.dCancelDistance);
 
@@ -41,6 +41,7 @@
 
 #include "../../../../disp3D_global.h"
 #include <fiff/fiff_info.h>
+#include <utils/meshadjacency.h>
 
 //=============================================================================================================
 // QT INCLUDES
@@ -112,7 +113,7 @@ public:
      * Warning: Using this function can take some seconds because recalculation are required.
      *
      * @param[in] matVertices               The mesh information in form of vertices.
-     * @param[in] vecNeighborVertices       The neighbor vertex information.
+     * @param[in] adjacency                 The vertex adjacency of the mesh.
      * @param[in] vecSensorPos              The QVector that holds the sensor positons in x, y and z coordinates.
      * @param[in] fiffEvoked                Holds all information about the sensors.
      * @param[in] iSensorType               Type of the sensor: FIFFV_EEG_CH or FIFFV_MEG_CH.
@@ -120,7 +121,7 @@ public:
      * @return Returns the created interpolation matrix.
      */
     void setInterpolationInfo(const Eigen::MatrixX3f &matVertices,
-                              const QVector<QVector<int> > &vecNeighborVertices,
+                              const UTILSLIB::MeshAdjacency &adjacency,
                               const QVector<Eigen::Vector3f> &vecSensorPos,
                               const FIFFLIB::FiffInfo &fiffInfo,
                               int iSensorType);
@@ -154,12 +155,12 @@ protected:
         int                                             iSensorType;                    /**< Type of the sensor: FIFFV_EEG_CH or FIFFV_MEG_CH. */
         double                                          dCancelDistance;                /**< Cancel distance for the interpolaion in meters. */
 
-        QSharedPointer<Eigen::MatrixXd>                 matDistanceMatrix;              /**< Distance matrix that holds distances from sensors positions to the near vertices in meters. */
+        QSharedPointer<Eigen::SparseMatrix<float> >     matDistanceMatrix;              /**< Distance matrix that holds distances from sensors positions to the near vertices in meters. */
         Eigen::MatrixX3f                                matVertices;                    /**< Holds all vertex information. */
 
         QVector<int>                                 vecMappedSubset;                /**< Vector index position represents the id of the sensor and the qint in each cell is the vertex it is mapped to. */
         QVector<int>                                 vecExcludeIndex;                /**< The indices to be excluded from vecProjectedSensors, e.g., bad channels. */
-        QVector<QVector<int> >                          vecNeighborVertices;            /**< The neighbor vertex information. */
+        UTILSLIB::MeshAdjacency                         adjacency;                      /**< The vertex adjacency of the mesh. */
 
         FIFFLIB::FiffInfo                               fiffInfo;                       /**< Contains all information about the sensors. */
 
@@ -61,6 +61,7 @@
 using namespace DISP3DLIB;
 using namespace Eigen;
 using namespace FSLIB;
+using namespace UTILSLIB;
 
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -233,8 +234,8 @@ void RtSourceDataController::setTimeInterval(int iMSec)
 
 void RtSourceDataController::setInterpolationInfo(const MatrixX3f &matVerticesLeft,
                                                   const MatrixX3f &matVerticesRight,
-                                                  const QVector<QVector<int> > &vecNeighborVerticesLeft,
-                                                  const QVector<QVector<int> > &vecNeighborVerticesRight,
+                                                  const MeshAdjacency &adjacencyLeft,
+                                                  const MeshAdjacency &adjacencyRight,
                                                   const VectorXi &vecVertNoLeftHemi,
                                                   const VectorXi &vecVertNoRightHemi)
 {
@@ -249,11 +250,11 @@ void RtSourceDataController::setInterpolationInfo(const MatrixX3f &matVerticesLe
     }
 
     emit interpolationInfoLeftChanged(matVerticesLeft,
-                                      vecNeighborVerticesLeft,
+                                      adjacencyLeft,
                                       vecMappedSubsetLeft);
 
     emit interpolationInfoRightChanged(matVerticesRight,
-                                       vecNeighborVerticesRight,
+                                       adjacencyRight,
                                        vecMappedSubsetRight);
 }
 
@@ -63,6 +63,10 @@ namespace FSLIB {
     class Label;
 }
 
+namespace UTILSLIB {
+    class MeshAdjacency;
+}
+
 //=============================================================================================================
 // DEFINE NAMESPACE DISP3DLIB
 //=============================================================================================================
@@ -153,15 +157,15 @@ public:
      *
      * @param[in] matVerticesLeft                 The surface vertices in 3D space for the left hemisphere.
      * @param[in] matVerticesRight                The surface vertices in 3D space for the right hemisphere.
-     * @param[in] vecNeighborVerticesLeft         The neighbor vertices for the left hemisphere.
-     * @param[in] vecNeighborVerticesRight        The neighbor vertices for the right hemisphere.
+     * @param[in] adjacencyLeft                   The vertex adjacency of the left hemisphere.
+     * @param[in] adjacencyRight                  The vertex adjacency of the right hemisphere.
      * @param[in] vecVertNoLeftHemi               The vertex indexes for the left hemipshere.
      * @param[in] vecVertNoRightHemi              The vertex indexes for the right hemipshere.
      */
     void setInterpolationInfo(const Eigen::MatrixX3f &matVerticesLeft,
                               const Eigen::MatrixX3f &matVerticesRight,
-                              const QVector<QVector<int> > &vecNeighborVerticesLeft,
-                              const QVector<QVector<int> > &vecNeighborVerticesRight,
+                              const UTILSLIB::MeshAdjacency &adjacencyLeft,
+                              const UTILSLIB::MeshAdjacency &adjacencyRight,
                               const Eigen::VectorXi& vecVertNoLeftHemi,
                               const Eigen::VectorXi& vecVertNoRightHemi);
 
@@ -305,11 +309,11 @@ signals:
      * Emit this signal whenever the interpolation info for the left hemisphere changed.
      *
      * @param[in] matVerticesLeft               The mesh information in form of vertices.
-     * @param[in] vecNeighborVerticesLeft       The neighbor vertex information.
+     * @param[in] adjacencyLeft                 The vertex adjacency of the mesh.
      * @param[in] vecMappedSubsetLeft           Vector index position represents the id of the sensor and the qint in each cell is the vertex it is mapped to.
      */
     void interpolationInfoLeftChanged(const Eigen::MatrixX3f &matVerticesLeft,
-                                      const QVector<QVector<int> > &vecNeighborVerticesLeft,
+                                      const UTILSLIB::MeshAdjacency &adjacencyLeft,
                                       const QVector<int> &vecMappedSubsetLeft);
 
     //=========================================================================================================
@@ -317,11 +321,11 @@ signals:
      * Emit this signal whenever the interpolation info for the right hemisphere changed.
      *
      * @param[in] matVerticesRight               The mesh information in form of vertices.
-     * @param[in] vecNeighborVerticesRight       The neighbor vertex information.
+     * @param[in] adjacencyRight                 The vertex adjacency of the mesh.
      * @param[in] vecMappedSubsetRight           Vector index position represents the id of the sensor and the qint in each cell is the vertex it is mapped to.
      */
     void interpolationInfoRightChanged(const Eigen::MatrixX3f &matVerticesRight,
-                                       const QVector<QVector<int> > &vecNeighborVerticesRight,
+                                       const UTILSLIB::MeshAdjacency &adjacencyRight,
                                        const QVector<int> &vecMappedSubsetRight);
 
     //=========================================================================================================
@@ -59,6 +59,7 @@ using namespace DISP3DLIB;
 using namespace MNELIB;
 using namespace Eigen;
 using namespace FSLIB;
+using namespace UTILSLIB;
 
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -73,7 +74,7 @@ RtSourceInterpolationMatWorker::RtSourceInterpolationMatWorker()
 {
     m_lInterpolationData.dCancelDistance = 0.05;
     m_lInterpolationData.interpolationFunction = DISP3DLIB::Interpolation::cubic;
-    m_lInterpolationData.matDistanceMatrix = QSharedPointer<MatrixXd>(new MatrixXd());
+    m_lInterpolationData.matDistanceMatrix = QSharedPointer<SparseMatrix<float> >::create();
 }
 
 //=============================================================================================================
@@ -140,7 +141,7 @@ void RtSourceInterpolationMatWorker::setCancelDistance(double dCancelDist)
 //=============================================================================================================
 
 void RtSourceInterpolationMatWorker::setInterpolationInfo(const Eigen::MatrixX3f &matVertices,
-                                                          const QVector<QVector<int> > &vecNeighborVertices,
+                                                          const MeshAdjacency &adjacency,
                                                           const QVector<int> &vecMappedSubset)
 {
     if(matVertices.rows() == 0) {
@@ -150,7 +151,7 @@ void RtSourceInterpolationMatWorker::setInterpolationInfo(const Eigen::MatrixX3f
 
     //set members
     m_lInterpolationData.matVertices = matVertices;
-    m_lInterpolationData.vecNeighborVertices = vecNeighborVertices;
+    m_lInterpolationData.adjacency = adjacency;
     m_lInterpolationData.vecMappedSubset = vecMappedSubset;
 
     m_bInterpolationInfoIsInit = true;
@@ -201,8 +202,8 @@ void RtSourceInterpolationMatWorker::calculateInterpolationOperator()
     }
 
     //SCDC with cancel distance
-    m_lInterpolationData.matDistanceMatrix = GeometryInfo::scdc(m_lInterpolationData.matVertices,
-                                                                m_lInterpolationData.vecNeighborVertices,
+    m_lInterpolationData.matDistanceMatrix = GeometryInfo::scdcSparse(m_lInterpolationData.matVertices,
+                                                                m_lInterpolationData.adjacency,
                                                                 m_lInterpolationData.vecMappedSubset,
                                                                 m_lInterpolationData.dCancelDistance);
 
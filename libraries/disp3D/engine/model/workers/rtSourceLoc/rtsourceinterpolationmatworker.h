@@ -43,6 +43,8 @@
 
 #include <fs/label.h>
 
+#include <utils/meshadjacency.h>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
@@ -129,13 +131,13 @@ public:
      * Warning: Using this function can take some seconds because recalculation are required.
      *
      * @param[in] matVertices               The mesh information in form of vertices.
-     * @param[in] vecNeighborVertices       The neighbor vertex information.
+     * @param[in] adjacency                 The vertex adjacency of the mesh.
      * @param[in] vecMappedSubset           Vector index position represents the id of the sensor and the qint in each cell is the vertex it is mapped to.
      *
      * @return Returns the created interpolation matrix.
      */
     void setInterpolationInfo(const Eigen::MatrixX3f &matVertices,
-                              const QVector<QVector<int> > &vecNeighborVertices,
+                              const UTILSLIB::MeshAdjacency &adjacency,
                               const QVector<int> &vecMappedSubset);
 
     //=========================================================================================================
@@ -176,7 +178,7 @@ protected:
     struct InterpolationData {
         double                          dCancelDistance;                /**< Cancel distance for the interpolaion in meters. */
 
-        QSharedPointer<Eigen::MatrixXd> matDistanceMatrix;              /**< Distance matrix that holds distances from sensors positions to the near vertices in meters. */
+        QSharedPointer<Eigen::SparseMatrix<float> > matDistanceMatrix;  /**< Distance matrix that holds distances from sensors positions to the near vertices in meters. */
         Eigen::MatrixX3f                matVertices;                    /**< Holds all vertex information. */
 
         QList<FSLIB::Label>             lLabels;                        /**< The annotation labels. */
@@ -184,7 +186,7 @@ protected:
         QMap<qint32, qint32>            mapLabelIdSources;              /**< The mapped label ID to sources. */
 
         QVector<int>                 vecMappedSubset;                /**< Vector index position represents the id of the sensor and the qint in each cell is the vertex it is mapped to. */
-        QVector<QVector<int> >          vecNeighborVertices;            /**< The neighbor vertex information. */
+        UTILSLIB::MeshAdjacency         adjacency;                      /**< The vertex adjacency of the mesh. */
 
         double (*interpolationFunction) (double);                   /**< Function that computes interpolation coefficients using the distance values. */
     }                           m_lInterpolationData;               /**< Container for the interpolation data. */
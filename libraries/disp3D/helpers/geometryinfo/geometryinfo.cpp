@@ -41,13 +41,17 @@
 
 #include <fiff/fiff_info.h>
 
+#include <utils/kdtree.h>
+#include <utils/meshadjacency.h>
+
 //=============================================================================================================
 // INCLUDES
 //=============================================================================================================
 
 #include <cmath>
 #include <fstream>
-#include <set>
+#include <functional>
+#include <queue>
 
 //=============================================================================================================
 // QT INCLUDES
@@ -66,6 +70,7 @@
 using namespace DISP3DLIB;
 using namespace Eigen;
 using namespace FIFFLIB;
+using namespace UTILSLIB;
 
 //=============================================================================================================
 // DEFINE GLOBAL METHODS
@@ -76,7 +81,7 @@ using namespace FIFFLIB;
 //=============================================================================================================
 
 QSharedPointer<MatrixXd> GeometryInfo::scdc(const MatrixX3f &matVertices,
-                                            const QVector<QVector<int> > &vecNeighborVertices,
+                                            const MeshAdjacency &adjacency,
                                             QVector<int> &vecVertSubset,
                                             double dCancelDist)
 {
@@ -115,7 +120,7 @@ QSharedPointer<MatrixXd> GeometryInfo::scdc(const MatrixX3f &matVertices,
             vecThreads[i] = QtConcurrent::run(std::bind(iterativeDijkstra,
                                                         returnMat,
                                                         std::cref(matVertices),
-                                                        std::cref(vecNeighborVertices),
+                                                        std::cref(adjacency),
                                                         std::cref(vecVertSubset),
                                                         iBegin,
                                                         vecVertSubset.size(),
@@ -127,7 +132,7 @@ QSharedPointer<MatrixXd> GeometryInfo::scdc(const MatrixX3f &matVertices,
             vecThreads[i] = QtConcurrent::run(std::bind(iterativeDijkstra,
                                                         returnMat,
                                                         std::cref(matVertices),
-                                                        std::cref(vecNeighborVertices),
+                                                        std::cref(adjacency),
                                                         std::cref(vecVertSubset),
                                                         iBegin,
                                                         iEnd,
@@ -147,97 +152,100 @@ QSharedPointer<MatrixXd> GeometryInfo::scdc(const MatrixX3f &matVertices,
 
 //=============================================================================================================
 
-QVector<int> GeometryInfo::projectSensors(const MatrixX3f &matVertices,
-                                          const QVector<Vector3f> &vecSensorPositions)
+QSharedPointer<SparseMatrix<float> > GeometryInfo::scdcSparse(const MatrixX3f &matVertices,
+                                                              const MeshAdjacency &adjacency,
+                                                              QVector<int> &vecVertSubset,
+                                                              double dCancelDist)
 {
-    QVector<int> vecOutputArray;
+    // check for empty subset:
+    if(vecVertSubset.empty()) {
+        // caller passed an empty subset, need to fill in all vertex IDs
+        vecVertSubset.reserve(matVertices.rows());
+        for(qint32 id = 0; id < matVertices.rows(); ++id) {
+            vecVertSubset.push_back(id);
+        }
+    }
 
-    qint32 iCores = QThread::idealThreadCount();
-    if (iCores <= 0)
-    {
+    // distribute calculation on cores
+    int iCores = QThread::idealThreadCount();
+    if (iCores <= 0) {
         // assume that we have at least two available cores
         iCores = 2;
     }
 
-    const qint32 iSubArraySize = int(double(vecSensorPositions.size()) / double(iCores));
+    // start threads with their respective parts of the final subset, each one collects its own entries
+    qint32 iSubArraySize = int(double(vecVertSubset.size()) / double(iCores));
+    QVector<QFuture<void> > vecThreads(iCores);
+    std::vector<std::vector<Triplet<float> > > vecThreadDistances(iCores);
+    qint32 iBegin = 0;
 
-    //small input size no threads needed
-    if(iSubArraySize <= 1)
-    {
-        vecOutputArray.append(nearestNeighbor(matVertices,
-                                              vecSensorPositions.constBegin(),
-                                              vecSensorPositions.constEnd()));
-        return vecOutputArray;
+    for (int i = 0; i < vecThreads.size(); ++i) {
+        qint32 iEnd = (i == vecThreads.size()-1) ? vecVertSubset.size() : iBegin + iSubArraySize;
+        vecThreads[i] = QtConcurrent::run(std::bind(iterativeDijkstraSparse,
+                                                    std::ref(vecThreadDistances[i]),
+                                                    std::cref(matVertices),
+                                                    std::cref(adjacency),
+                                                    std::cref(vecVertSubset),
+                                                    iBegin,
+                                                    iEnd,
+                                                    dCancelDist));
+        iBegin = iEnd;
     }
 
-    // split input array + thread start
-    QVector<QFuture<QVector<int> > > vecThreads(iCores);
-    qint32 iBeginOffset = 0;
-    qint32 iEndOffset = iBeginOffset + iSubArraySize;
-    for(qint32 i = 0; i < vecThreads.size(); ++i)
-    {
-        //last round
-        if(i == vecThreads.size()-1)
-        {
-            vecThreads[i] = QtConcurrent::run(nearestNeighbor,
-                                              matVertices,
-                                              vecSensorPositions.constBegin() + iBeginOffset,
-                                              vecSensorPositions.constEnd());
-            break;
-        }
-        else
-        {
-            vecThreads[i] = QtConcurrent::run(nearestNeighbor,
-                                              matVertices,
-                                              vecSensorPositions.constBegin() + iBeginOffset,
-                                              vecSensorPositions.constBegin() + iEndOffset);
-            iBeginOffset = iEndOffset;
-            iEndOffset += iSubArraySize;
-        }
+    // wait for all other threads to finish
+    for (QFuture<void>& f : vecThreads) {
+        f.waitForFinished();
     }
 
-    //wait for threads to finish
-    for (QFuture<QVector<int> >& f : vecThreads) {
-        f.waitForFinished();
+    // collect the entries of all threads
+    std::vector<Triplet<float> > vecDistances;
+    size_t iNumEntries = 0;
+    for(const std::vector<Triplet<float> >& vecPart : vecThreadDistances) {
+        iNumEntries += vecPart.size();
+    }
+    vecDistances.reserve(iNumEntries);
+    for(std::vector<Triplet<float> >& vecPart : vecThreadDistances) {
+        vecDistances.insert(vecDistances.end(), vecPart.begin(), vecPart.end());
+        std::vector<Triplet<float> >().swap(vecPart);
     }
 
-    //move sub arrays back into output
-    for(qint32 i = 0; i < vecThreads.size(); ++i)
-    {
-        vecOutputArray.append(std::move(vecThreads[i].result()));
+    // convention: first dimension in distance table is "from", second dimension "to"
+    QSharedPointer<SparseMatrix<float> > returnMat = QSharedPointer<SparseMatrix<float> >::create(matVertices.rows(), vecVertSubset.size());
+    returnMat->setFromTriplets(vecDistances.begin(), vecDistances.end());
+
+    return returnMat;
+}
+
+//=============================================================================================================
+
+QVector<int> GeometryInfo::projectSensors(const MatrixX3f &matVertices,
+                                          const QVector<Vector3f> &vecSensorPositions)
+{
+    if(vecSensorPositions.isEmpty()) {
+        return QVector<int>();
     }
 
-    return vecOutputArray;
+    // the tree is built once per surface, each sensor lookup is then logarithmic in the number of vertices
+    const KdTree vertexTree(matVertices);
+
+    return nearestNeighbor(vertexTree,
+                           vecSensorPositions.constBegin(),
+                           vecSensorPositions.constEnd());
 }
 
 //=============================================================================================================
 
-QVector<int> GeometryInfo::nearestNeighbor(const MatrixX3f &matVertices,
+QVector<int> GeometryInfo::nearestNeighbor(const KdTree &vertexTree,
                                            QVector<Vector3f>::const_iterator itSensorBegin,
                                            QVector<Vector3f>::const_iterator itSensorEnd)
 {
-    //lin search sensor positions
     QVector<int> vecMappedSensors;
     vecMappedSensors.reserve(std::distance(itSensorBegin, itSensorEnd));
-int u =0;
+
+    float fDist;
     for(auto sensor = itSensorBegin; sensor != itSensorEnd; ++sensor)
     {
-        qint32 iChampionId;
-        double iChampDist = std::numeric_limits<double>::max();
-        for(qint32 i = 0; i < matVertices.rows(); ++i)
-        {
-            //calculate 3d euclidian distance
-            double dDist = sqrt(squared(matVertices(i, 0) - (*sensor)[0])  // x-cord
-                                + squared(matVertices(i, 1) - (*sensor)[1])    // y-cord
-                                + squared(matVertices(i, 2) - (*sensor)[2]));  // z-cord
-            if(dDist < iChampDist)
-            {
-                iChampionId = i;
-                iChampDist = dDist;
-            }
-        }
-       // qDebug() << "[GeometryInfo::nearestNeighbor] u" << u++;
-        vecMappedSensors.push_back(iChampionId);
+        vecMappedSensors.push_back(vertexTree.findNearest(*sensor, fDist));
     }
 
     return vecMappedSensors;
@@ -247,73 +255,145 @@ int u =0;
 
 void GeometryInfo::iterativeDijkstra(QSharedPointer<MatrixXd> matOutputDistMatrix,
                                      const MatrixX3f &matVertices,
-                                     const QVector<QVector<int> > &vecNeighborVertices,
+                                     const MeshAdjacency &adjacency,
                                      const QVector<int> &vecVertSubset,
                                      qint32 iBegin,
                                      qint32 iEnd,
                                      double dCancelDistance) {
     // initialization
-    const QVector<QVector<int> > &vecAdjacency = vecNeighborVertices;
-    qint32 n = vecAdjacency.size();
-    QVector<double> vecMinDists(n);
-    std::set< std::pair< double, qint32> > vertexQ;
-    const double INF = FLOAT_INFINITY;
+    QVector<double> vecMinDists(adjacency.numVertices(), FLOAT_INFINITY);
+    QVector<qint32> vecReached;
+
+    // outer loop, iterated for each vertex of 'vertSubset' between 'begin' and 'end'
+    for (qint32 i = iBegin; i < iEnd; ++i) {
+        dijkstra(vecVertSubset.at(i), matVertices, adjacency, dCancelDistance, vecMinDists, vecReached);
+
+        // save results for current root in matrix and reset the reached vertices for the next root
+        matOutputDistMatrix->col(i).fill(FLOAT_INFINITY);
+        for (qint32 v : vecReached) {
+            matOutputDistMatrix->coeffRef(v, i) = vecMinDists[v];
+            vecMinDists[v] = FLOAT_INFINITY;
+        }
+    }
+}
+
+//=============================================================================================================
+
+void GeometryInfo::iterativeDijkstraSparse(std::vector<Triplet<float> > &vecOutputDistances,
+                                           const MatrixX3f &matVertices,
+                                           const MeshAdjacency &adjacency,
+                                           const QVector<int> &vecVertSubset,
+                                           qint32 iBegin,
+                                           qint32 iEnd,
+                                           double dCancelDistance) {
+    // initialization
+    QVector<double> vecMinDists(adjacency.numVertices(), FLOAT_INFINITY);
+    QVector<qint32> vecReached;
 
     // outer loop, iterated for each vertex of 'vertSubset' between 'begin' and 'end'
     for (qint32 i = iBegin; i < iEnd; ++i) {
-        // init phase of dijkstra: set source node for current iteration and reset data fields
-        if(i ==123)
-            qDebug() << "blabla";
-        qint32 iRoot = vecVertSubset.at(i);
-        vertexQ.clear();
-        vecMinDists.fill(INF);
-        vecMinDists[iRoot] = 0.0;
-        vertexQ.insert(std::make_pair(vecMinDists[iRoot], iRoot));
-
-        // dijkstra main loop
-        while (vertexQ.empty() == false) {
-            // remove next vertex from queue
-            const double dDist = vertexQ.begin()->first;
-            const qint32 u = vertexQ.begin()->second;
-            vertexQ.erase(vertexQ.begin());
-
-            // check if we are still below cancel distance
-            if (dDist <= dCancelDistance) {
-                // visit each neighbour of u
-                const QVector<int>& vecNeighbours = vecAdjacency[u];
-
-                for (qint32 ne = 0; ne < vecNeighbours.length(); ++ne) {
-                    qint32 v = vecNeighbours[ne];
-
-                    // distance from source (i.e. root) to v, using u as its predecessor
-                    // calculate inline since designated function was magnitudes slower (even when declared as inline)
-                    const double dDistX = matVertices(u, 0) - matVertices(v, 0);
-                    const double dDistY = matVertices(u, 1) - matVertices(v, 1);
-                    const double dDistZ = matVertices(u, 2) - matVertices(v, 2);
-                    const double dDistWithU = dDist + sqrt(dDistX * dDistX + dDistY * dDistY + dDistZ * dDistZ);
-
-                    if (dDistWithU < vecMinDists[v]) {
-                        // this is a combination of insert and decreaseKey
-                        vertexQ.erase(std::make_pair(vecMinDists[v], v));
-                        vecMinDists[v] = dDistWithU;
-                        vertexQ.insert(std::make_pair(vecMinDists[v], v));
-                    }
+        dijkstra(vecVertSubset.at(i), matVertices, adjacency, dCancelDistance, vecMinDists, vecReached);
+
+        // save results for current root and reset the reached vertices for the next root
+        for (qint32 v : vecReached) {
+            vecOutputDistances.push_back(Triplet<float>(v, i, vecMinDists[v]));
+            vecMinDists[v] = FLOAT_INFINITY;
+        }
+    }
+}
+
+//=============================================================================================================
+
+void GeometryInfo::dijkstra(qint32 iRoot,
+                            const MatrixX3f &matVertices,
+                            const MeshAdjacency &adjacency,
+                            double dCancelDistance,
+                            QVector<double> &vecMinDists,
+                            QVector<qint32> &vecReached) {
+    // binary heap on a contiguous array. Instead of a decreaseKey the vertex is pushed again,
+    // outdated entries are recognized by their distance and skipped when they come up.
+    typedef std::pair<double, qint32> QueueEntry;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > vertexQ;
+
+    vecReached.clear();
+    vecMinDists[iRoot] = 0.0;
+    vecReached.push_back(iRoot);
+    vertexQ.push(std::make_pair(0.0, iRoot));
+
+    // dijkstra main loop
+    while (vertexQ.empty() == false) {
+        // remove next vertex from queue
+        const double dDist = vertexQ.top().first;
+        const qint32 u = vertexQ.top().second;
+        vertexQ.pop();
+
+        if (dDist > vecMinDists[u]) {
+            continue;
+        }
+
+        // visit each neighbour of u, they are stored contiguously
+        const int* const itEnd = adjacency.neighborsEnd(u);
+
+        for (const int* it = adjacency.neighborsBegin(u); it != itEnd; ++it) {
+            qint32 v = *it;
+
+            // distance from source (i.e. root) to v, using u as its predecessor
+            // calculate inline since designated function was magnitudes slower (even when declared as inline)
+            const double dDistX = matVertices(u, 0) - matVertices(v, 0);
+            const double dDistY = matVertices(u, 1) - matVertices(v, 1);
+            const double dDistZ = matVertices(u, 2) - matVertices(v, 2);
+            const double dDistWithU = dDist + sqrt(dDistX * dDistX + dDistY * dDistY + dDistZ * dDistZ);
+
+            // vertices beyond the cancel distance are never queued, so the search stops there
+            if (dDistWithU <= dCancelDistance && dDistWithU < vecMinDists[v]) {
+                if (vecMinDists[v] == FLOAT_INFINITY) {
+                    vecReached.push_back(v);
                 }
+                vecMinDists[v] = dDistWithU;
+                vertexQ.push(std::make_pair(dDistWithU, v));
             }
         }
+    }
+}
+
+//=============================================================================================================
+
+QVector<int> GeometryInfo::filterBadChannels(QSharedPointer<Eigen::MatrixXd> matDistanceTable,
+                                             const FIFFLIB::FiffInfo& fiffInfo,
+                                             qint32 iSensorType) {
+    QVector<int> vecBadColumns = badChannelColumns(fiffInfo, iSensorType);
+
+    // set whole column to infinity
+    for(int col : vecBadColumns){
+        matDistanceTable->col(col).fill(FLOAT_INFINITY);
+    }
+    return vecBadColumns;
+}
 
-        // save results for current root in matrix
-        for (qint32 m = 0; m < vecMinDists.size(); ++m) {
-            matOutputDistMatrix->coeffRef(m , i) = vecMinDists[m];
+//=============================================================================================================
+
+QVector<int> GeometryInfo::filterBadChannels(QSharedPointer<SparseMatrix<float> > matDistanceTable,
+                                             const FIFFLIB::FiffInfo& fiffInfo,
+                                             qint32 iSensorType) {
+    QVector<int> vecBadColumns = badChannelColumns(fiffInfo, iSensorType);
+
+    // remove all entries of the bad columns
+    if(!vecBadColumns.isEmpty()) {
+        QVector<bool> vecIsBad(matDistanceTable->cols(), false);
+        for(int col : vecBadColumns){
+            vecIsBad[col] = true;
         }
+        matDistanceTable->prune([&vecIsBad](const Index&, const Index& col, const float&) {
+            return !vecIsBad[col];
+        });
     }
+    return vecBadColumns;
 }
 
 //=============================================================================================================
 
-QVector<int> GeometryInfo::filterBadChannels(QSharedPointer<Eigen::MatrixXd> matDistanceTable,
-                                                const FIFFLIB::FiffInfo& fiffInfo,
-                                                qint32 iSensorType) {
+QVector<int> GeometryInfo::badChannelColumns(const FIFFLIB::FiffInfo& fiffInfo,
+                                             qint32 iSensorType) {
     // use pointer to avoid copying of FiffChInfo objects
     QVector<int> vecBadColumns;
     QVector<const FiffChInfo*> vecSensors;
@@ -328,11 +408,7 @@ QVector<int> GeometryInfo::filterBadChannels(QSharedPointer<Eigen::MatrixXd> mat
     for(const QString& b : fiffInfo.bads){
         for(int col = 0; col < vecSensors.size(); ++col){
             if(vecSensors[col]->ch_name == b){
-                // found index of our bad channel, set whole column to infinity
                 vecBadColumns.push_back(col);
-                for(int row = 0; row < matDistanceTable->rows(); ++row){
-                    matDistanceTable->coeffRef(row, col) = FLOAT_INFINITY;
-                }
                 break;
             }
         }
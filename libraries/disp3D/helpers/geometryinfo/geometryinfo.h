@@ -47,6 +47,7 @@
 //=============================================================================================================
 
 #include <limits>
+#include <vector>
 
 //=============================================================================================================
 // QT INCLUDES
@@ -60,6 +61,7 @@
 //=============================================================================================================
 
 #include <Eigen/Core>
+#include <Eigen/Sparse>
 
 //=============================================================================================================
 // FORWARD DECLARATIONS
@@ -69,6 +71,11 @@ namespace MNELIB {
     class MNEmatVertices;
 }
 
+namespace UTILSLIB {
+    class KdTree;
+    class MeshAdjacency;
+}
+
 //=============================================================================================================
 // DEFINE NAMESPACE DISP3DLIB
 //=============================================================================================================
@@ -110,17 +117,35 @@ public:
      * @brief scdc                           Calculates surface constrained distances on a mesh.
      *
      * @param[in] matVertices                The surface on which distances should be calculated.
-     * @param[in] vecNeighborVertices        The neighbor vertex information.
+     * @param[in] adjacency                  The vertex adjacency of the surface.
      * @param[in/out] pVecVertSubset         The subset of IDs for which the distances should be calculated.
      * @param[in] dCancelDist                Distances higher than this are ignored, i.e. set to infinity.
      *
      * @return                               A double matrix. One column represents the distances for one vertex inside of the passed subset
      */
     static QSharedPointer<Eigen::MatrixXd> scdc(const Eigen::MatrixX3f &matVertices,
-                                                const QVector<QVector<int> > &vecNeighborVertices,
+                                                const UTILSLIB::MeshAdjacency &adjacency,
                                                 QVector<int> &pVecVertSubset,
                                                 double dCancelDist = FLOAT_INFINITY);
 
+    //=========================================================================================================
+    /**
+     * @brief scdcSparse                     Calculates surface constrained distances on a mesh and only stores the ones up to the cancel distance.
+     *                                       Memory and run time scale with the number of vertices within the cancel distance instead of the mesh size.
+     *
+     * @param[in] matVertices                The surface on which distances should be calculated.
+     * @param[in] adjacency                  The vertex adjacency of the surface.
+     * @param[in/out] pVecVertSubset         The subset of IDs for which the distances should be calculated.
+     * @param[in] dCancelDist                Distances higher than this are not stored.
+     *
+     * @return                               A sparse matrix with the same layout as the one returned by scdc. Entries which are not
+     *                                       stored are out of reach. The distance of a subset vertex to itself is stored as explicit zero.
+     */
+    static QSharedPointer<Eigen::SparseMatrix<float> > scdcSparse(const Eigen::MatrixX3f &matVertices,
+                                                                  const UTILSLIB::MeshAdjacency &adjacency,
+                                                                  QVector<int> &pVecVertSubset,
+                                                                  double dCancelDist);
+
     //=========================================================================================================
     /**
      * @brief                            Calculates the nearest neighbor (euclidian distance) vertex to each sensor
@@ -148,6 +173,20 @@ public:
                                           const FIFFLIB::FiffInfo& fiffInfo,
                                           qint32 iSensorType);
 
+    //=========================================================================================================
+    /**
+     * @brief filterBadChannels          Filters bad channels from a sparse distance table by removing their columns' entries
+     *
+     * @param[out] matDistanceTable      Result of scdcSparse.
+     * @param[in] fiffInfo               Container for sensors.
+     * @param[in] iSensorType            Sensor type to be filtered out, use fiff constants.
+     *
+     * @return Vector of bad channel indices.
+     */
+    static QVector<int> filterBadChannels(QSharedPointer<Eigen::SparseMatrix<float> > matDistanceTable,
+                                          const FIFFLIB::FiffInfo& fiffInfo,
+                                          qint32 iSensorType);
+
 protected:
     //=========================================================================================================
     /**
@@ -163,13 +202,13 @@ protected:
     /**
      * @brief nearestNeighbor        Calculates the nearest vertex of an MNEmatVertices for each position between the two iterators
      *
-     * @param[in] matVertices        The MNEmatVertices that holds the vertex information
+     * @param[in] vertexTree         The spatial index over the vertices
      * @param[in] itSensorBegin      The iterator that indicates the start of the wanted section of positions
      * @param[in] itSensorEnd        The iterator that indicates the end of the wanted section of positions
      *
      * @return                       A vector of nearest vertex IDs that corresponds to the subvector between the two iterators
      */
-    static QVector<int> nearestNeighbor(const Eigen::MatrixX3f &matVertices,
+    static QVector<int> nearestNeighbor(const UTILSLIB::KdTree &vertexTree,
                                         QVector<Eigen::Vector3f>::const_iterator itSensorBegin,
                                         QVector<Eigen::Vector3f>::const_iterator itSensorEnd);
 
@@ -179,7 +218,7 @@ protected:
      *
      * @param[out] matOutputDistMatrix  The matrix in which the distances will be stored
      * @param[in] matVertices           The surface on which distances should be calculated
-     * @param[in] vecNeighborVertices   The neighbor vertex information.
+     * @param[in] adjacency             The vertex adjacency of the surface.
      * @param[in] vecVertSubset         The subset of vertices
      * @param[in] iBegin                Start index of distance calculation
      * @param[in] iEnd                  End index of distance calculation, exclusive
@@ -187,11 +226,61 @@ protected:
      */
     static void iterativeDijkstra(QSharedPointer<Eigen::MatrixXd> matOutputDistMatrix,
                                   const Eigen::MatrixX3f &matVertices,
-                                  const QVector<QVector<int> > &vecNeighborVertices,
+                                  const UTILSLIB::MeshAdjacency &adjacency,
                                   const QVector<int> &vecVertSubset,
                                   qint32 iBegin,
                                   qint32 iEnd,
                                   double dCancelDistance);
+
+    //=========================================================================================================
+    /**
+     * @brief iterativeDijkstraSparse   Same as iterativeDijkstra, but only stores the distances up to the cancel distance
+     *
+     * @param[out] vecOutputDistances   The distances as (vertex, subset index, distance) triplets
+     * @param[in] matVertices           The surface on which distances should be calculated
+     * @param[in] adjacency             The vertex adjacency of the surface.
+     * @param[in] vecVertSubset         The subset of vertices
+     * @param[in] iBegin                Start index of distance calculation
+     * @param[in] iEnd                  End index of distance calculation, exclusive
+     * @param[in] dCancelDistance       Distance threshold: vertices that are further away from the respective root vertex are not stored
+     */
+    static void iterativeDijkstraSparse(std::vector<Eigen::Triplet<float> > &vecOutputDistances,
+                                        const Eigen::MatrixX3f &matVertices,
+                                        const UTILSLIB::MeshAdjacency &adjacency,
+                                        const QVector<int> &vecVertSubset,
+                                        qint32 iBegin,
+                                        qint32 iEnd,
+                                        double dCancelDistance);
+
+    //=========================================================================================================
+    /**
+     * @brief dijkstra                  Calculates shortest distances on the mesh from one root vertex up to the cancel distance
+     *
+     * @param[in] iRoot                 The root vertex
+     * @param[in] matVertices           The surface on which distances should be calculated
+     * @param[in] adjacency             The vertex adjacency of the surface.
+     * @param[in] dCancelDistance       Distance threshold: vertices that are further away are not visited
+     * @param[in/out] vecMinDists       The distance of each vertex. Has to be infinity everywhere when passed in.
+     * @param[out] vecReached           The vertices within the cancel distance, i.e. the ones whose entry in vecMinDists was set
+     */
+    static void dijkstra(qint32 iRoot,
+                         const Eigen::MatrixX3f &matVertices,
+                         const UTILSLIB::MeshAdjacency &adjacency,
+                         double dCancelDistance,
+                         QVector<double> &vecMinDists,
+                         QVector<qint32> &vecReached);
+
+    //=========================================================================================================
+    /**
+     * @brief badChannelColumns          Finds the distance table columns of the bad channels
+     *
+     * @param[in] fiffInfo               Container for sensors.
+     * @param[in] iSensorType            Sensor type to be filtered out, use fiff constants.
+     *
+     * @return Vector of bad channel indices.
+     */
+    static QVector<int> badChannelColumns(const FIFFLIB::FiffInfo& fiffInfo,
+                                          qint32 iSensorType);
 };
 
 //=============================================================================================================
@@ -137,6 +137,72 @@ QSharedPointer<SparseMatrix<float> > Interpolation::createInterpolationMat(const
 
 //=============================================================================================================
 
+QSharedPointer<SparseMatrix<float> > Interpolation::createInterpolationMat(const QVector<int> &vecProjectedSensors,
+                                                                           const QSharedPointer<SparseMatrix<float> > matDistanceTable,
+                                                                           double (*interpolationFunction) (double),
+                                                                           const double dCancelDist,
+                                                                           const QVector<int> &vecExcludeIndex)
+{
+    if(matDistanceTable->rows() == 0 && matDistanceTable->cols() == 0) {
+        qDebug() << "[WARNING] Interpolation::createInterpolationMat - received an empty distance table.";
+        return QSharedPointer<SparseMatrix<float> >::create();
+    }
+
+    // initialization
+    QSharedPointer<Eigen::SparseMatrix<float> > matInterpolationMatrix = QSharedPointer<SparseMatrix<float> >::create(matDistanceTable->rows(), vecProjectedSensors.size());
+
+    // temporary helper structure for filling sparse matrix
+    QVector<Triplet<float> > vecNonZeroEntries;
+    const qint32 iRows = matInterpolationMatrix->rows();
+    const qint32 iCols = std::min<qint32>(matInterpolationMatrix->cols(), matDistanceTable->cols());
+
+    // mark all sensor nodes for faster lookup during later computation. Also consider bad channels here.
+    QVector<bool> vecIsSensor(iRows, false);
+    int idx = 0;
+
+    for(const qint32& s : vecProjectedSensors){
+        if(!vecExcludeIndex.contains(idx) && s >= 0 && s < iRows){
+            vecIsSensor[s] = true;
+        }
+        idx++;
+    }
+
+    // weights of all stored distances below the threshold, summed up per row for the normalization
+    QVector<float> vecWeightsSum(iRows, 0.0f);
+    vecNonZeroEntries.reserve(matDistanceTable->nonZeros());
+
+    for (qint32 c = 0; c < iCols; ++c) {
+        for (SparseMatrix<float>::InnerIterator it(*matDistanceTable, c); it; ++it) {
+            const qint32 r = it.row();
+            const float dDist = it.value();
+
+            if (!vecIsSensor[r] && dDist < dCancelDist) {
+                const float dValueWeight = std::fabs(1.0 / interpolationFunction(dDist));
+                vecWeightsSum[r] += dValueWeight;
+                vecNonZeroEntries.push_back(Eigen::Triplet<float> (r, c, dValueWeight));
+            }
+        }
+    }
+
+    for (Triplet<float> &entry : vecNonZeroEntries) {
+        entry = Triplet<float> (entry.row(), entry.col(), entry.value() / vecWeightsSum[entry.row()]);
+    }
+
+    // a sensor has been assigned to these nodes, we do not need to interpolate anything
+    //(final vertex signal is equal to sensor input signal, thus factor 1)
+    for (qint32 r = 0; r < iRows; ++r) {
+        if (vecIsSensor[r]) {
+            vecNonZeroEntries.push_back(Eigen::Triplet<float> (r, vecProjectedSensors.indexOf(r), 1));
+        }
+    }
+
+    matInterpolationMatrix->setFromTriplets(vecNonZeroEntries.begin(), vecNonZeroEntries.end());
+
+    return matInterpolationMatrix;
+}
+
+//=============================================================================================================
+
 VectorXf Interpolation::interpolateSignal(const QSharedPointer<SparseMatrix<float> > matInterpolationMatrix,
                                           const QSharedPointer<VectorXf> &vecMeasurementData)
 {
@@ -43,13 +43,103 @@
 #include "fiff_stream.h"
 #include "cstdlib"
 
+#include <utils/ioutils.h>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QFileDevice>
+#include <QPointer>
+
 //=============================================================================================================
 // USED NAMESPACES
 //=============================================================================================================
 
 using namespace FIFFLIB;
+using namespace UTILSLIB;
 using namespace Eigen;
 
+//=============================================================================================================
+// DEFINE STATIC METHODS
+//=============================================================================================================
+
+static inline double readMappedSample(const qint16* pSrc, bool bSwap)
+{
+    qint16 value;
+    memcpy(&value, pSrc, sizeof(qint16));
+    return bSwap ? IOUtils::swap_short(value) : value;
+}
+
+//=============================================================================================================
+
+static inline double readMappedSample(const qint32* pSrc, bool bSwap)
+{
+    qint32 value;
+    memcpy(&value, pSrc, sizeof(qint32));
+    return bSwap ? IOUtils::swap_int(value) : value;
+}
+
+//=============================================================================================================
+
+static inline double readMappedSample(const float* pSrc, bool bSwap)
+{
+    float value;
+    memcpy(&value, pSrc, sizeof(float));
+    return bSwap ? IOUtils::swap_float(value) : value;
+}
+
+//=============================================================================================================
+
+template<typename T>
+static void decodeMappedBuffer(const uchar* pBuffer,
+                               bool bSwap,
+                               qint32 nchan,
+                               const RowVectorXi& sel,
+                               const VectorXd& vecScale,
+                               fiff_int_t firstPick,
+                               fiff_int_t pickSamp,
+                               MatrixXd& dest,
+                               qint32 destCol)
+{
+    // The buffer is stored sample by sample, i.e. column major with nchan rows. The mapping is not
+    // necessarily aligned to sizeof(T), which is why readMappedSample copies each value.
+    const T* pData = reinterpret_cast<const T*>(pBuffer);
+    const qint32 nrows = sel.size() > 0 ? sel.size() : nchan;
+
+    for(fiff_int_t c = 0; c < pickSamp; ++c) {
+        const T* pSample = pData + static_cast<qint64>(firstPick + c) * nchan;
+        double* pDest = dest.data() + static_cast<qint64>(destCol + c) * dest.rows();
+
+        if(sel.size() > 0) {
+            for(qint32 r = 0; r < nrows; ++r) {
+                pDest[r] = vecScale[r] * readMappedSample(pSample + sel[r], bSwap);
+            }
+        } else {
+            for(qint32 r = 0; r < nrows; ++r) {
+                pDest[r] = vecScale[r] * readMappedSample(pSample + r, bSwap);
+            }
+        }
+    }
+}
+
+//=============================================================================================================
+
+static qint32 sampleSize(fiff_int_t type)
+{
+    switch(type) {
+        case FIFFT_DAU_PACK16:
+        case FIFFT_SHORT:
+            return sizeof(qint16);
+        case FIFFT_INT:
+            return sizeof(qint32);
+        case FIFFT_FLOAT:
+            return sizeof(float);
+        default:
+            return 0;
+    }
+}
+
 //=============================================================================================================
 // DEFINE MEMBER METHODS
 //=============================================================================================================
@@ -57,6 +147,8 @@ using namespace Eigen;
 FiffRawData::FiffRawData()
 : first_samp(-1)
 , last_samp(-1)
+, m_iMappedSize(0)
+, m_bMappedSwap(false)
 {
 }
 
@@ -65,6 +157,8 @@ FiffRawData::FiffRawData()
 FiffRawData::FiffRawData(QIODevice &p_IODevice)
 : first_samp(-1)
 , last_samp(-1)
+, m_iMappedSize(0)
+, m_bMappedSwap(false)
 {
     //setup FiffRawData object
     if(!FiffStream::setup_read_raw(p_IODevice, *this))
@@ -80,6 +174,8 @@ FiffRawData::FiffRawData(QIODevice &p_IODevice)
 FiffRawData::FiffRawData(QIODevice &p_IODevice, bool b_littleEndian)
 : first_samp(-1)
 , last_samp(-1)
+, m_iMappedSize(0)
+, m_bMappedSwap(false)
 {
     //setup FiffRawData object
     if(!FiffStream::setup_read_raw(p_IODevice, *this, false, b_littleEndian))
@@ -101,6 +197,9 @@ FiffRawData::FiffRawData(const FiffRawData &p_FiffRawData)
 , rawdir(p_FiffRawData.rawdir)
 , proj(p_FiffRawData.proj)
 , comp(p_FiffRawData.comp)
+, m_pMappedData(p_FiffRawData.m_pMappedData)
+, m_iMappedSize(p_FiffRawData.m_iMappedSize)
+, m_bMappedSwap(p_FiffRawData.m_bMappedSwap)
 {
 }
 
@@ -114,6 +213,7 @@ FiffRawData::~FiffRawData()
 
 void FiffRawData::clear()
 {
+    unmapRawData();
     info.clear();
     first_samp = -1;
     last_samp = -1;
@@ -251,8 +351,25 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
         mult.setFromTriplets(tripletList.begin(), tripletList.end());
 //    mult.makeCompressed();
 
+    VectorXd vecMappedCals, vecMappedOnes;
+    MatrixXd matMapped;
+    if (this->isRawDataMapped())
+    {
+        if (sel.size() == 0)
+        {
+            vecMappedCals = this->cals.transpose();
+        }
+        else
+        {
+            vecMappedCals.resize(sel.size());
+            for(i = 0; i < sel.size(); ++i)
+                vecMappedCals[i] = this->cals[sel[i]];
+        }
+        vecMappedOnes = VectorXd::Ones(nchan);
+    }
+
     FiffStream::SPtr fid;
-    if (!this->file->device()->isOpen())
+    if (!this->isRawDataMapped() && !this->file->device()->isOpen())
     {
         if (!this->file->device()->open(QIODevice::ReadOnly))
         {
@@ -277,7 +394,88 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
         //
         if (thisRawDir.last > from)
         {
-            if (thisRawDir.ent->kind == -1)
+            //
+            //  The picking logic is a bit complicated
+            //
+            if (to >= thisRawDir.last && from <= thisRawDir.first)
+            {
+                //
+                //  We need the whole buffer
+                //
+                first_pick = 0;//1;
+                last_pick  = thisRawDir.nsamp - 1;
+                if (do_debug)
+                    printf("W");
+            }
+            else if (from > thisRawDir.first)
+            {
+                first_pick = from - thisRawDir.first;// + 1;
+                if(to < thisRawDir.last)
+                {
+                    //
+                    //  Something from the middle
+                    //
+//                    qDebug() << "This needs to be debugged!";
+                    last_pick = thisRawDir.nsamp + to - thisRawDir.last - 1;//is this alright?
+                    if (do_debug)
+                        printf("M");
+                }
+                else
+                {
+                    //
+                    //  From the middle to the end
+                    //
+                    last_pick = thisRawDir.nsamp - 1;
+                    if (do_debug)
+                        printf("E");
+                }
+            }
+            else
+            {
+                //
+                //  From the beginning to the middle
+                //
+                first_pick = 0;//1;
+                last_pick  = to - thisRawDir.first;// + 1;
+                if (do_debug)
+                    printf("B");
+            }
+            //
+            //  Now we are ready to pick
+            //
+            picksamp = last_pick - first_pick + 1;
+
+            if(do_debug)
+            {
+                qDebug() << "first_pick: " << first_pick;
+                qDebug() << "last_pick: " << last_pick;
+                qDebug() << "picksamp: " << picksamp;
+            }
+
+            const bool bMappedBuffer = thisRawDir.ent->kind != -1 && this->isRawDataMapped();
+
+            if (bMappedBuffer)
+            {
+                //
+                //  Decode straight from the memory mapping, calibration is either fused or part of mult
+                //
+                if (picksamp > 0)
+                {
+                    if (mult.cols() == 0)
+                    {
+                        if (!read_mapped_buffer(thisRawDir, sel, vecMappedCals, first_pick, picksamp, data, dest))
+                            return false;
+                    }
+                    else
+                    {
+                        matMapped.resize(nchan, picksamp);
+                        if (!read_mapped_buffer(thisRawDir, defaultRowVectorXi, vecMappedOnes, first_pick, picksamp, matMapped, 0))
+                            return false;
+                        data.block(0,dest,data.rows(),picksamp) = mult*matMapped;
+                    }
+                }
+            }
+            else if (thisRawDir.ent->kind == -1)
             {
                 //
                 //  Take the easy route: skip is translated to zeros
@@ -366,70 +564,13 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
                         printf("Data Storage Format not known yet [3]!! Type: %d\n", t_pTag->type);
                 }
             }
-            //
-            //  The picking logic is a bit complicated
-            //
-            if (to >= thisRawDir.last && from <= thisRawDir.first)
-            {
-                //
-                //  We need the whole buffer
-                //
-                first_pick = 0;//1;
-                last_pick  = thisRawDir.nsamp - 1;
-                if (do_debug)
-                    printf("W");
-            }
-            else if (from > thisRawDir.first)
-            {
-                first_pick = from - thisRawDir.first;// + 1;
-                if(to < thisRawDir.last)
-                {
-                    //
-                    //  Something from the middle
-                    //
-//                    qDebug() << "This needs to be debugged!";
-                    last_pick = thisRawDir.nsamp + to - thisRawDir.last - 1;//is this alright?
-                    if (do_debug)
-                        printf("M");
-                }
-                else
-                {
-                    //
-                    //  From the middle to the end
-                    //
-                    last_pick = thisRawDir.nsamp - 1;
-                    if (do_debug)
-                        printf("E");
-                }
-            }
-            else
-            {
-                //
-                //  From the beginning to the middle
-                //
-                first_pick = 0;//1;
-                last_pick  = to - thisRawDir.first;// + 1;
-                if (do_debug)
-                    printf("B");
-            }
-            //
-            //  Now we are ready to pick
-            //
-            picksamp = last_pick - first_pick + 1;
-
-            if(do_debug)
-            {
-                qDebug() << "first_pick: " << first_pick;
-                qDebug() << "last_pick: " << last_pick;
-                qDebug() << "picksamp: " << picksamp;
-            }
-
             if (picksamp > 0)
             {
 //                    for(r = 0; r < data->rows(); ++r)
 //                        for(c = 0; c < picksamp; ++c)
 //                            (*data)(r,dest + c) = one(r,first_pick + c);
-                data.block(0,dest,data.rows(),picksamp) = one.block(0, first_pick, data.rows(), picksamp);
+                if (!bMappedBuffer)
+                    data.block(0,dest,data.rows(),picksamp) = one.block(0, first_pick, data.rows(), picksamp);
 
                 dest += picksamp;
             }
@@ -586,8 +727,25 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
 
     //
 
+    VectorXd vecMappedCals, vecMappedOnes;
+    MatrixXd matMapped;
+    if (this->isRawDataMapped())
+    {
+        if (sel.size() == 0)
+        {
+            vecMappedCals = this->cals.transpose();
+        }
+        else
+        {
+            vecMappedCals.resize(sel.size());
+            for(i = 0; i < sel.size(); ++i)
+                vecMappedCals[i] = this->cals[sel[i]];
+        }
+        vecMappedOnes = VectorXd::Ones(nchan);
+    }
+
     FiffStream::SPtr fid;
-    if (!this->file->device()->isOpen())
+    if (!this->isRawDataMapped() && !this->file->device()->isOpen())
     {
         if (!this->file->device()->open(QIODevice::ReadOnly))
         {
@@ -610,7 +768,88 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
         //
         if (thisRawDir.last > from)
         {
-            if (thisRawDir.ent->kind == -1)
+            //
+            //  The picking logic is a bit complicated
+            //
+            if (to >= thisRawDir.last && from <= thisRawDir.first)
+            {
+                //
+                //  We need the whole buffer
+                //
+                first_pick = 0;//1;
+                last_pick  = thisRawDir.nsamp - 1;
+                if (do_debug)
+                    printf("W");
+            }
+            else if (from > thisRawDir.first)
+            {
+                first_pick = from - thisRawDir.first;// + 1;
+                if(to < thisRawDir.last)
+                {
+                    //
+                    //  Something from the middle
+                    //
+//                    qDebug() << "This needs to be debugged!";
+                    last_pick = thisRawDir.nsamp + to - thisRawDir.last - 1;//is this alright?
+                    if (do_debug)
+                        printf("M");
+                }
+                else
+                {
+                    //
+                    //  From the middle to the end
+                    //
+                    last_pick = thisRawDir.nsamp - 1;
+                    if (do_debug)
+                        printf("E");
+                }
+            }
+            else
+            {
+                //
+                //  From the beginning to the middle
+                //
+                first_pick = 0;//1;
+                last_pick  = to - thisRawDir.first;// + 1;
+                if (do_debug)
+                    printf("B");
+            }
+            //
+            //  Now we are ready to pick
+            //
+            picksamp = last_pick - first_pick + 1;
+
+            if(do_debug)
+            {
+                qDebug() << "first_pick: " << first_pick;
+                qDebug() << "last_pick: " << last_pick;
+                qDebug() << "picksamp: " << picksamp;
+            }
+
+            const bool bMappedBuffer = thisRawDir.ent->kind != -1 && this->isRawDataMapped();
+
+            if (bMappedBuffer)
+            {
+                //
+                //  Decode straight from the memory mapping, calibration is either fused or part of mult
+                //
+                if (picksamp > 0)
+                {
+                    if (mult.cols() == 0)
+                    {
+                        if (!read_mapped_buffer(thisRawDir, sel, vecMappedCals, first_pick, picksamp, data, dest))
+                            return false;
+                    }
+                    else
+                    {
+                        matMapped.resize(nchan, picksamp);
+                        if (!read_mapped_buffer(thisRawDir, defaultRowVectorXi, vecMappedOnes, first_pick, picksamp, matMapped, 0))
+                            return false;
+                        data.block(0,dest,data.rows(),picksamp) = mult*matMapped;
+                    }
+                }
+            }
+            else if (thisRawDir.ent->kind == -1)
             {
                 //
                 //  Take the easy route: skip is translated to zeros
@@ -701,70 +940,13 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
                         printf("Data Storage Format not known yet [3]!! Type: %d\n", t_pTag->type);
                 }
             }
-            //
-            //  The picking logic is a bit complicated
-            //
-            if (to >= thisRawDir.last && from <= thisRawDir.first)
-            {
-                //
-                //  We need the whole buffer
-                //
-                first_pick = 0;//1;
-                last_pick  = thisRawDir.nsamp - 1;
-                if (do_debug)
-                    printf("W");
-            }
-            else if (from > thisRawDir.first)
-            {
-                first_pick = from - thisRawDir.first;// + 1;
-                if(to < thisRawDir.last)
-                {
-                    //
-                    //  Something from the middle
-                    //
-//                    qDebug() << "This needs to be debugged!";
-                    last_pick = thisRawDir.nsamp + to - thisRawDir.last - 1;//is this alright?
-                    if (do_debug)
-                        printf("M");
-                }
-                else
-                {
-                    //
-                    //  From the middle to the end
-                    //
-                    last_pick = thisRawDir.nsamp - 1;
-                    if (do_debug)
-                        printf("E");
-                }
-            }
-            else
-            {
-                //
-                //  From the beginning to the middle
-                //
-                first_pick = 0;//1;
-                last_pick  = to - thisRawDir.first;// + 1;
-                if (do_debug)
-                    printf("B");
-            }
-            //
-            //  Now we are ready to pick
-            //
-            picksamp = last_pick - first_pick + 1;
-
-            if(do_debug)
-            {
-                qDebug() << "first_pick: " << first_pick;
-                qDebug() << "last_pick: " << last_pick;
-                qDebug() << "picksamp: " << picksamp;
-            }
-
             if (picksamp > 0)
             {
 //                    for(r = 0; r < data->rows(); ++r)
 //                        for(c = 0; c < picksamp; ++c)
 //                            (*data)(r,dest + c) = one(r,first_pick + c);
-                data.block(0,dest,data.rows(),picksamp) = one.block(0, first_pick, data.rows(), picksamp);
+                if (!bMappedBuffer)
+                    data.block(0,dest,data.rows(),picksamp) = one.block(0, first_pick, data.rows(), picksamp);
 
                 dest += picksamp;
             }
@@ -814,3 +996,120 @@ bool FiffRawData::read_raw_segment_times(MatrixXd& data,
     //
     return this->read_raw_segment(data, times, (qint32)from, (qint32)to, sel);
 }
+
+//=============================================================================================================
+
+bool FiffRawData::mapRawData()
+{
+    if(this->isRawDataMapped()) {
+        return true;
+    }
+
+    if(!this->file) {
+        qWarning() << "[FiffRawData::mapRawData] No file stream available.";
+        return false;
+    }
+
+    QFileDevice* pFileDevice = qobject_cast<QFileDevice*>(this->file->device());
+
+    if(!pFileDevice) {
+        qWarning() << "[FiffRawData::mapRawData] The raw data device is not a file and can not be mapped.";
+        return false;
+    }
+
+    if(!pFileDevice->isOpen() && !pFileDevice->open(QIODevice::ReadOnly)) {
+        qWarning() << "[FiffRawData::mapRawData] Cannot open file" << this->info.filename;
+        return false;
+    }
+
+    qint64 iSize = pFileDevice->size();
+    uchar* pData = pFileDevice->map(0, iSize);
+
+    if(!pData) {
+        qWarning() << "[FiffRawData::mapRawData] Could not map file" << this->info.filename << ":" << pFileDevice->errorString();
+        return false;
+    }
+
+    //
+    //   Make sure every raw buffer lies completely within the mapping and has a supported type
+    //
+    for(int k = 0; k < this->rawdir.size(); ++k) {
+        const FiffRawDir& thisRawDir = this->rawdir[k];
+
+        if(thisRawDir.ent->kind == -1) {
+            continue;
+        }
+
+        qint32 iSampleSize = sampleSize(thisRawDir.ent->type);
+        qint64 iPayloadStart = static_cast<qint64>(thisRawDir.ent->pos) + FIFFC_DATA_OFFSET;
+        qint64 iPayloadSize = static_cast<qint64>(thisRawDir.nsamp) * this->info.nchan * iSampleSize;
+
+        if(iSampleSize == 0
+           || thisRawDir.ent->size < iPayloadSize
+           || iPayloadStart + iPayloadSize > iSize) {
+            qWarning() << "[FiffRawData::mapRawData] Raw buffer" << k << "can not be read from the mapping. Type:" << thisRawDir.ent->type;
+            pFileDevice->unmap(pData);
+            return false;
+        }
+    }
+
+    // the copies of this object share the mapping, the last one to release it unmaps the file. If the device is
+    // destroyed before, it has already removed its mappings.
+    QPointer<QFileDevice> pDevice(pFileDevice);
+    m_pMappedData = QSharedPointer<uchar>(pData, [pDevice](uchar* pMapped) {
+        if(pDevice) {
+            pDevice->unmap(pMapped);
+        }
+    });
+    m_iMappedSize = iSize;
+    m_bMappedSwap = (this->file->byteOrder() == QDataStream::LittleEndian) != (Q_BYTE_ORDER == Q_LITTLE_ENDIAN);
+
+    return true;
+}
+
+//=============================================================================================================
+
+void FiffRawData::unmapRawData()
+{
+    m_pMappedData.reset();
+    m_iMappedSize = 0;
+    m_bMappedSwap = false;
+}
+
+//=============================================================================================================
+
+bool FiffRawData::read_mapped_buffer(const FiffRawDir& rawDir,
+                                     const RowVectorXi& sel,
+                                     const VectorXd& vecScale,
+                                     fiff_int_t firstPick,
+                                     fiff_int_t pickSamp,
+                                     MatrixXd& dest,
+                                     qint32 destCol) const
+{
+    // rawdir is public and may have been changed after the mapping was validated
+    const qint64 iPayloadStart = static_cast<qint64>(rawDir.ent->pos) + FIFFC_DATA_OFFSET;
+    const qint64 iPayloadSize = static_cast<qint64>(rawDir.nsamp) * this->info.nchan * sampleSize(rawDir.ent->type);
+
+    if(iPayloadStart < 0 || iPayloadStart + iPayloadSize > m_iMappedSize) {
+        qWarning() << "[FiffRawData::read_mapped_buffer] Raw buffer lies outside of the mapped file.";
+        return false;
+    }
+
+    const uchar* pBuffer = m_pMappedData.data() + iPayloadStart;
+
+    switch(rawDir.ent->type) {
+        case FIFFT_DAU_PACK16:
+        case FIFFT_SHORT:
+            decodeMappedBuffer<qint16>(pBuffer, m_bMappedSwap, this->info.nchan, sel, vecScale, firstPick, pickSamp, dest, destCol);
+            return true;
+        case FIFFT_INT:
+            decodeMappedBuffer<qint32>(pBuffer, m_bMappedSwap, this->info.nchan, sel, vecScale, firstPick, pickSamp, dest, destCol);
+            return true;
+        case FIFFT_FLOAT:
+            decodeMappedBuffer<float>(pBuffer, m_bMappedSwap, this->info.nchan, sel, vecScale, firstPick, pickSamp, dest, destCol);
+            return true;
+        default:
+            printf("Data Storage Format not known yet [4]!! Type: %d\n", rawDir.ent->type);
+            return false;
+    }
+}
@@ -192,6 +192,60 @@ public:
                                 float to,
                                 const Eigen::RowVectorXi& sel = defaultRowVectorXi) const;
 
+    //=========================================================================================================
+    /**
+     * Maps the underlying fiff file into memory. Once mapped, read_raw_segment decodes the raw buffers listed in
+     * rawdir directly from the mapping into the output matrix, fusing the byte swap and the calibration into a
+     * single pass instead of reading each buffer into a temporary FiffTag. The device has to be a QFileDevice.
+     * The mapping is reference counted and shared by all copies made afterwards. It is unmapped when the last copy
+     * releases it.
+     *
+     * @return true if the file could be mapped and all raw buffers were validated, false otherwise.
+     */
+    bool mapRawData();
+
+    //=========================================================================================================
+    /**
+     * Releases this object's reference to the memory mapping created by mapRawData. The file is unmapped once no
+     * copy references the mapping anymore. read_raw_segment falls back to tag based reading.
+     */
+    void unmapRawData();
+
+    //=========================================================================================================
+    /**
+     * Returns whether the raw buffers are read from a memory mapping.
+     *
+     * @return true if mapRawData was called successfully, false otherwise.
+     */
+    inline bool isRawDataMapped() const
+    {
+        return !m_pMappedData.isNull();
+    }
+
+private:
+    //=========================================================================================================
+    /**
+     * Decodes samples [firstPick, firstPick + pickSamp) of a mapped raw buffer into the columns
+     * [destCol, destCol + pickSamp) of dest. Each output row r is multiplied by vecScale[r].
+     *
+     * @param[in] rawDir     The raw directory entry of the buffer.
+     * @param[in] sel        Channel selection vector. If empty all channels are decoded.
+     * @param[in] vecScale   Per output row scaling, i.e. the calibration factors or ones.
+     * @param[in] firstPick  First sample of the buffer to decode.
+     * @param[in] pickSamp   Number of samples to decode.
+     * @param[out] dest      The matrix to write to.
+     * @param[in] destCol    The first column of dest to write to.
+     *
+     * @return true if succeeded, false if the buffer type is not supported or the buffer is not inside the mapping.
+     */
+    bool read_mapped_buffer(const FiffRawDir& rawDir,
+                            const Eigen::RowVectorXi& sel,
+                            const Eigen::VectorXd& vecScale,
+                            fiff_int_t firstPick,
+                            fiff_int_t pickSamp,
+                            Eigen::MatrixXd& dest,
+                            qint32 destCol) const;
+
 public:
     FiffStream::SPtr file;      /**< replaces fid */
     FiffInfo info;              /**< Fiff measurement information */
@@ -202,7 +256,10 @@ public:
     Eigen::MatrixXd proj;       /**< SSP operator to apply to the data. */
     FiffCtfComp comp;           /**< Compensator. */
 
-
+private:
+    QSharedPointer<uchar>   m_pMappedData;      /**< Start of the memory mapped fiff file, unmapped by the last owner. Null if the file is not mapped. */
+    qint64                  m_iMappedSize;      /**< Size of the memory mapping in bytes. */
+    bool                    m_bMappedSwap;      /**< Whether the mapped samples need to be byte swapped to native endianness. */
 };
 } // NAMESPACE
 
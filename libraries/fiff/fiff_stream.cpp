@@ -70,6 +70,9 @@
 
 #include <iostream>
 #include <time.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
 
 //=============================================================================================================
 // EIGEN INCLUDES
@@ -84,6 +87,7 @@
 
 #include <QFile>
 #include <QTcpSocket>
+#include <QtEndian>
 
 //=============================================================================================================
 // USED NAMESPACES
@@ -93,6 +97,67 @@ using namespace FIFFLIB;
 using namespace UTILSLIB;
 using namespace Eigen;
 
+//=============================================================================================================
+// DEFINE STATIC FUNCTIONS
+//=============================================================================================================
+
+static const qint64 FIFF_TAG_HEADER_SIZE = 16;     /**< kind, type, size and next, each a 32 bit integer. */
+
+//=============================================================================================================
+
+template<typename T>
+static qint64 packIntegerSamples(const MatrixXd& buf,
+                                 const RowVectorXd& invCals,
+                                 uchar* pData)
+{
+    const double dMin = std::numeric_limits<T>::min();
+    const double dMax = std::numeric_limits<T>::max();
+    const bool bCalibrate = invCals.size() > 0;
+    qint64 iClipped = 0;
+
+    for(qint32 c = 0; c < buf.cols(); ++c) {
+        for(qint32 r = 0; r < buf.rows(); ++r) {
+            double dValue = std::round(bCalibrate ? buf(r,c) * invCals[r] : buf(r,c));
+
+            if(dValue < dMin) {
+                dValue = dMin;
+                ++iClipped;
+            } else if(dValue > dMax) {
+                dValue = dMax;
+                ++iClipped;
+            } else if(dValue != dValue) {
+                dValue = 0.0;
+                ++iClipped;
+            }
+
+            qToBigEndian<T>(static_cast<T>(dValue), pData);
+            pData += sizeof(T);
+        }
+    }
+
+    return iClipped;
+}
+
+//=============================================================================================================
+
+static void packFloatSamples(const MatrixXd& buf,
+                             const RowVectorXd& invCals,
+                             uchar* pData)
+{
+    const bool bCalibrate = invCals.size() > 0;
+    float fValue;
+    quint32 iValue;
+
+    for(qint32 c = 0; c < buf.cols(); ++c) {
+        for(qint32 r = 0; r < buf.rows(); ++r) {
+            fValue = static_cast<float>(bCalibrate ? buf(r,c) * invCals[r] : buf(r,c));
+            std::memcpy(&iValue, &fValue, sizeof(float));
+            qToBigEndian<quint32>(iValue, pData);
+            pData += sizeof(float);
+        }
+    }
+}
+
 //=============================================================================================================
 // DEFINE MEMBER METHODS
 //=============================================================================================================
@@ -2018,12 +2083,10 @@ FiffStream::SPtr FiffStream::start_writing_raw(QIODevice &p_IODevice,
                                                const FiffInfo& info,
                                                RowVectorXd& cals,
                                                MatrixXi sel,
-                                               bool bResetRange)
+                                               bool bResetRange,
+                                               fiff_int_t iDataType)
 {
-    //
-    //   We will always write floats
-    //
-    fiff_int_t data_type = 4;
+    fiff_int_t data_type = iDataType;
     qint32 k;
 
     if(sel.cols() == 0)
@@ -3140,6 +3203,60 @@ bool FiffStream::write_raw_buffer(const MatrixXd& buf)
 
 //=============================================================================================================
 
+qint64 FiffStream::pack_raw_buffer(const MatrixXd& buf,
+                                   const RowVectorXd& invCals,
+                                   fiff_int_t type,
+                                   QByteArray& tag)
+{
+    if(invCals.size() != 0 && invCals.size() != buf.rows()) {
+        qWarning("[FiffStream::pack_raw_buffer] buffer and calibration sizes do not match\n");
+        return -1;
+    }
+
+    qint64 iSampleSize;
+    switch(type) {
+        case FIFFT_FLOAT:
+        case FIFFT_INT:
+            iSampleSize = 4;
+            break;
+        case FIFFT_SHORT:
+        case FIFFT_DAU_PACK16:
+            iSampleSize = 2;
+            break;
+        default:
+            qWarning("[FiffStream::pack_raw_buffer] data type %d is not supported\n", type);
+            return -1;
+    }
+
+    const qint64 iDataSize = static_cast<qint64>(buf.size()) * iSampleSize;
+    if(iDataSize > std::numeric_limits<fiff_int_t>::max() - FIFF_TAG_HEADER_SIZE) {
+        qWarning("[FiffStream::pack_raw_buffer] buffer is too large for a single tag\n");
+        return -1;
+    }
+
+    tag.resize(static_cast<int>(FIFF_TAG_HEADER_SIZE + iDataSize));
+    uchar* pData = reinterpret_cast<uchar*>(tag.data());
+
+    // Tag header
+    qToBigEndian<qint32>(FIFF_DATA_BUFFER, pData);
+    qToBigEndian<qint32>(type, pData + 4);
+    qToBigEndian<qint32>(static_cast<qint32>(iDataSize), pData + 8);
+    qToBigEndian<qint32>(FIFFV_NEXT_SEQ, pData + 12);
+    pData += FIFF_TAG_HEADER_SIZE;
+
+    switch(type) {
+        case FIFFT_FLOAT:
+            packFloatSamples(buf, invCals, pData);
+            return 0;
+        case FIFFT_INT:
+            return packIntegerSamples<qint32>(buf, invCals, pData);
+        default:
+            return packIntegerSamples<qint16>(buf, invCals, pData);
+    }
+}
+
+//=============================================================================================================
+
 fiff_long_t FiffStream::write_string(fiff_int_t kind,
                                      const QString& data)
 {
@@ -508,6 +508,8 @@ public:
      * @param[out] cals          A copy of the calibration values
      * @param[in] sel            Which channels will be included in the output file (optional)
      * @param[in] bResetRange    Flag whether to reset the channel range to 1.0. Default is true.
+     * @param[in] iDataType      The storage type of the data buffers which will be written, stored as FIFF_DATA_PACK.
+     *                           Default is FIFFT_FLOAT.
      *
      * @return the started fiff file
      */
@@ -515,7 +517,8 @@ public:
                                               const FiffInfo& info,
                                               Eigen::RowVectorXd& cals,
                                               Eigen::MatrixXi sel = defaultMatrixXi,
-                                              bool bResetRange = true);
+                                              bool bResetRange = true,
+                                              fiff_int_t iDataType = FIFFT_FLOAT);
 
     //=========================================================================================================
     /**
@@ -836,6 +839,25 @@ public:
      */
     bool write_raw_buffer(const Eigen::MatrixXd& buf);
 
+    //=========================================================================================================
+    /**
+     * Packs a raw buffer into a complete FIFF_DATA_BUFFER tag in file byte order, so that it can be written to
+     * the device of a raw data stream as is, e.g. from another thread. The samples are multiplied with the
+     * inverse calibrations and, for the integer types, rounded. Samples outside of the range of the storage type
+     * are clipped.
+     *
+     * @param[in] buf        the buffer to pack, one channel per row
+     * @param[in] invCals    the inverse calibrations, one per channel. Empty for no calibration.
+     * @param[in] type       the storage type: FIFFT_FLOAT, FIFFT_INT, FIFFT_SHORT or FIFFT_DAU_PACK16
+     * @param[out] tag       the packed tag. Its memory is reused if it is large enough.
+     *
+     * @return the number of clipped samples, -1 if the buffer could not be packed
+     */
+    static qint64 pack_raw_buffer(const Eigen::MatrixXd& buf,
+                                  const Eigen::RowVectorXd& invCals,
+                                  fiff_int_t type,
+                                  QByteArray& tag);
+
     //=========================================================================================================
     /**
      * Writes a string tag
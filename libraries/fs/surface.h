@@ -43,6 +43,8 @@
 
 #include "fs_global.h"
 
+#include <utils/meshadjacency.h>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
@@ -217,6 +219,14 @@ public:
      */
     static Eigen::MatrixX3f compute_normals(const Eigen::MatrixX3f& rr, const Eigen::MatrixX3i& tris);
 
+    //=========================================================================================================
+    /**
+     * Vertex and triangle adjacency of the surface, built when the surface is read.
+     *
+     * @return The adjacency of the surface.
+     */
+    inline const UTILSLIB::MeshAdjacency& adjacency() const;
+
     //=========================================================================================================
     /**
      * Coordinates of vertices (rr)
@@ -290,6 +300,7 @@ private:
     Eigen::MatrixX3i m_matTris;    /**< alias faces. The triangle descriptions */
     Eigen::MatrixX3f m_matNN;      /**< Normalized surface normals for each vertex. -> not needed since qglbuilder is doing that for us */
     Eigen::VectorXf m_vecCurv;     /**< FreeSurfer curvature data */
+    UTILSLIB::MeshAdjacency m_adjacency;   /**< Neighboring vertices and triangles of each vertex */
 
     Eigen::Vector3f m_vecOffset; /**< Surface offset */
 };
@@ -340,6 +351,13 @@ inline const Eigen::MatrixX3f& Surface::nn() const
 
 //=============================================================================================================
 
+inline const UTILSLIB::MeshAdjacency& Surface::adjacency() const
+{
+    return m_adjacency;
+}
+
+//=============================================================================================================
+
 inline const Eigen::VectorXf& Surface::curv() const
 {
     return m_vecCurv;
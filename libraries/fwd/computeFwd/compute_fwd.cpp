@@ -73,6 +73,11 @@ using namespace MNELIB;
 #define FREE_CMATRIX_41(m) mne_free_cmatrix_41((m))
 #define FREE_ICMATRIX_41(m) mne_free_icmatrix_41((m))
 
+#define HEAD_POS_STEP_MOVE  0.001f                      /* Translation step for the head position derivatives (m) */
+#define HEAD_POS_STEP_ROT   (float)(EIGEN_PI/180.0)     /* Rotation step for the head position derivatives (rad) */
+#define HEAD_POS_MAX_MOVE   0.01f                       /* Never extrapolate the expansion further than this... */
+#define HEAD_POS_MAX_ROT    (float)(EIGEN_PI/18.0)      /* ...or this */
+
 static void matrix_error_41(int kind, int nr, int nc)
 
 {
@@ -1823,6 +1828,22 @@ bool mne_attach_env(const QString& name, const QString& command)
     return true;
 }
 
+static FiffCoordTransOld* move_meg_head_t(const FiffCoordTransOld* t,
+                                          const Matrix3f& rot,
+                                          const Vector3f& move,
+                                          const Vector3f& r0)
+/*
+ * Compose a rotation about r0 followed by a translation in head coordinates with a meg <-> head transformation
+ */
+{
+    FiffCoordTransOld* res = new FiffCoordTransOld(*t);
+
+    res->rot  = rot*t->rot;
+    res->move = rot*(t->move - r0) + r0 + move;
+    FiffCoordTransOld::add_inverse(res);
+    return res;
+}
+
 //=============================================================================================================
 // STATIC DEFINITIONS
 //=============================================================================================================
@@ -1855,6 +1876,8 @@ ComputeFwd::~ComputeFwd()
         delete m_mri_head_t;
     if(m_meg_head_t)
         delete m_meg_head_t;
+    if(m_ref_meg_head_t)
+        delete m_ref_meg_head_t;
     if(m_megcoils)
         delete m_megcoils;
     if(m_eegels)
@@ -1872,6 +1895,7 @@ void ComputeFwd::initFwd()
 
     m_mri_head_t            = Q_NULLPTR;
     m_meg_head_t            = Q_NULLPTR;
+    m_ref_meg_head_t        = Q_NULLPTR;
 
     m_listMegChs = QList<FiffChInfo>();
     m_listEegChs = QList<FiffChInfo>();
@@ -2348,100 +2372,40 @@ void ComputeFwd::calculateFwd()
 
 void ComputeFwd::updateHeadPos(FiffCoordTransOld* transDevHeadOld)
 {
-
-    int iNMeg = 0;
-    if(m_megcoils) {
-        iNMeg = m_megcoils->ncoil;
-    }
-
-    int iNComp = 0;
-    if(m_compcoils) {
-        iNMeg = m_megcoils->ncoil;
-    }
-//    // transformation in head space
-//    FiffCoordTransOld* transHeadHeadOld = new FiffCoordTransOld;
-//
-//    // get transformation matrix in Headspace between two meg -> head transformation
-//    // ToDo: the following part has to be tested
-//    if(transDevHeadOld->from != m_megcoils->coord_frame) {
-//        if(transDevHeadOld->to != m_megcoils->coord_frame) {
-//            qWarning() << "ComputeFwd::updateHeadPos: Target Space not in Head Space - Space: " << transDevHeadOld->to;
-//            return;
-//        }
-//        // calclulate rotation
-//        Matrix3f matRot = m_meg_head_t->rot;              // meg->head to origin
-//        Matrix3f matRotDest = transDevHeadOld->rot;       // meg->head after movement
-//        Matrix3f matRotNew = Matrix3f::Zero(3,3);         // rotation between origin and updated point
-//
-//        // get Quaternions
-//        Quaternionf quat(matRot);
-//        Quaternionf quatDest(matRotDest);
-//        Quaternionf quatNew;
-//        // Rotation between two rotation matrices is calculated by multiplying with the inverse
-//        // this is computitional easier with quaternions because for inverse we just have to flip signs
-//        quatNew = quat*quatDest.inverse();
-//        matRotNew = quatNew.toRotationMatrix();           // rotation between origin and updated point
-//
-//        // calculate translation
-//        // translation between to points = vector rsulting from substraction
-//        VectorXf vecTrans = m_meg_head_t->move;
-//        VectorXf vecTransDest = transDevHeadOld->move;
-//        VectorXf vecTransNew = vecTrans - vecTransDest;
-//
-//        // update new transformation matrix
-//        transHeadHeadOld->from = m_megcoils->coord_frame;
-//        transHeadHeadOld->to = m_megcoils->coord_frame;
-//        transHeadHeadOld->rot = matRotNew;
-//        transHeadHeadOld->move = vecTransNew;
-//        transHeadHeadOld->add_inverse(transHeadHeadOld);
-//    }
-//
-//    FwdCoilSet* megcoilsNew = m_megcoils->dup_coil_set(transHeadHeadOld);
-
-    // create new coilset with updated head position
-    if (m_pSettings->coord_frame == FIFFV_COORD_MRI) {
-        FiffCoordTransOld* head_mri_t = m_mri_head_t->fiff_invert_transform();
-        FiffCoordTransOld* meg_mri_t = FiffCoordTransOld::fiff_combine_transforms(FIFFV_COORD_DEVICE,FIFFV_COORD_MRI,transDevHeadOld,head_mri_t);
-        if (meg_mri_t == Q_NULLPTR) {
-            return;
-        }
-        if ((m_megcoils = m_templates->create_meg_coils(m_listMegChs,
-                                                        iNMeg,
-                                                        m_pSettings->accurate ? FWD_COIL_ACCURACY_ACCURATE : FWD_COIL_ACCURACY_NORMAL,
-                                                        meg_mri_t)) == Q_NULLPTR) {
+    // check if source spaces are still in head space
+    if(m_spaces[0]->coord_frame != FIFFV_COORD_HEAD) {
+        if (MneSurfaceOrVolume::mne_transform_source_spaces_to(m_pSettings->coord_frame,m_mri_head_t,m_spaces,m_iNSpace) != OK) {
             return;
         }
-        if (iNComp > 0) {
-            if ((m_compcoils = m_templates->create_meg_coils(m_listCompChs,
-                                                             iNComp,
-                                                             FWD_COIL_ACCURACY_NORMAL,
-                                                             meg_mri_t)) == Q_NULLPTR) {
-                return;
-            }
+    }
+
+    // try the expansion around the reference head position first, the gradient solution is not covered by it
+    if (m_pSettings->fast_head_pos_update && !m_pSettings->compute_grad) {
+        // (re)build the expansion around the last computed head position only if the new position is within its
+        // range, so a head which keeps moving further does not cost the twelve setup computations on every update
+        VectorXd vecParam;
+        if (!m_ref_meg_head_t && headPosChange(m_meg_head_t,transDevHeadOld,vecParam) && !setupHeadPosExpansion()) {
+            printf("Could not set up the head position expansion. The MEG forward solution will be recomputed.\n");
         }
-    } else {
-        if ((m_megcoils = m_templates->create_meg_coils(m_listMegChs,
-                                                        iNMeg,
-                                                        m_pSettings->accurate ? FWD_COIL_ACCURACY_ACCURATE : FWD_COIL_ACCURACY_NORMAL,
-                                                        transDevHeadOld)) == Q_NULLPTR) {
+        if (updateHeadPosFromExpansion(transDevHeadOld)) {
+            delete m_meg_head_t;
+            m_meg_head_t = new FiffCoordTransOld(*transDevHeadOld);
+            sol->data.block(0,0,m_meg_forward->nrow,m_meg_forward->ncol) = m_meg_forward->data;
             return;
         }
-
-        if (iNComp > 0) {
-            if ((m_compcoils = m_templates->create_meg_coils(m_listCompChs,
-                                                             iNComp,
-                                                             FWD_COIL_ACCURACY_NORMAL,transDevHeadOld)) == Q_NULLPTR) {
-                return;
-            }
-        }
     }
 
-    // check if source spaces are still in head space
-    if(m_spaces[0]->coord_frame != FIFFV_COORD_HEAD) {
-        if (MneSurfaceOrVolume::mne_transform_source_spaces_to(m_pSettings->coord_frame,m_mri_head_t,m_spaces,m_iNSpace) != OK) {
-            return;
-        }
+    // create new coilset with updated head position
+    FwdCoilSet* megcoils = Q_NULLPTR;
+    FwdCoilSet* compcoils = Q_NULLPTR;
+
+    if (!createMegCoils(transDevHeadOld,megcoils,compcoils)) {
+        return;
     }
+    delete m_megcoils;
+    delete m_compcoils;
+    m_megcoils = megcoils;
+    m_compcoils = compcoils;
 
     // recompute meg forward
     if ((FwdBemModel::compute_forward_meg(m_spaces,
@@ -2459,7 +2423,16 @@ void ComputeFwd::updateHeadPos(FiffCoordTransOld* transDevHeadOld)
         return;
     }
 
+    // the expansion is set up again around the new head position once the head stays close to it
+    if (m_ref_meg_head_t) {
+        delete m_ref_meg_head_t;
+        m_ref_meg_head_t = Q_NULLPTR;
+    }
+    m_lMegForwardDeriv.clear();
+    m_matRefMegForward.resize(0,0);
+
     // Update new Transformation Matrix
+    delete m_meg_head_t;
     m_meg_head_t = new FiffCoordTransOld(*transDevHeadOld);
     // update solution
     sol->data.block(0,0,m_meg_forward->nrow,m_meg_forward->ncol) = m_meg_forward->data;
@@ -2470,6 +2443,164 @@ void ComputeFwd::updateHeadPos(FiffCoordTransOld* transDevHeadOld)
 
 //=========================================================================================================
 
+bool ComputeFwd::createMegCoils(FiffCoordTransOld* transDevHeadOld,
+                                FwdCoilSet*& megcoils,
+                                FwdCoilSet*& compcoils) const
+{
+    FiffCoordTransOld* meg_t = transDevHeadOld;
+    FiffCoordTransOld* meg_mri_t = Q_NULLPTR;
+    bool bOk = true;
+
+    megcoils = Q_NULLPTR;
+    compcoils = Q_NULLPTR;
+
+    if (m_pSettings->coord_frame == FIFFV_COORD_MRI) {
+        FiffCoordTransOld* head_mri_t = m_mri_head_t->fiff_invert_transform();
+        meg_mri_t = FiffCoordTransOld::fiff_combine_transforms(FIFFV_COORD_DEVICE,FIFFV_COORD_MRI,transDevHeadOld,head_mri_t);
+        delete head_mri_t;
+        if (meg_mri_t == Q_NULLPTR) {
+            return false;
+        }
+        meg_t = meg_mri_t;
+    }
+    if ((megcoils = m_templates->create_meg_coils(m_listMegChs,
+                                                  m_listMegChs.size(),
+                                                  m_pSettings->accurate ? FWD_COIL_ACCURACY_ACCURATE : FWD_COIL_ACCURACY_NORMAL,
+                                                  meg_t)) == Q_NULLPTR) {
+        bOk = false;
+    }
+    else if (m_listCompChs.size() > 0) {
+        if ((compcoils = m_templates->create_meg_coils(m_listCompChs,
+                                                       m_listCompChs.size(),
+                                                       FWD_COIL_ACCURACY_NORMAL,
+                                                       meg_t)) == Q_NULLPTR) {
+            delete megcoils;
+            megcoils = Q_NULLPTR;
+            bOk = false;
+        }
+    }
+    delete meg_mri_t;
+    return bOk;
+}
+
+//=========================================================================================================
+
+bool ComputeFwd::setupHeadPosExpansion()
+{
+    FiffNamedMatrix megForward;
+    FiffNamedMatrix megForwardGrad;
+    MatrixXd matPlus;
+    Matrix3f rot;
+    Vector3f move;
+    double dNorm = m_meg_forward->data.norm();
+    float step;
+
+    if (dNorm == 0.0) {
+        return false;
+    }
+    printf("Setting up the head position expansion of the MEG forward solution...\n");
+
+    m_lMegForwardDeriv.clear();
+    m_vecMegForwardCurv.resize(6);
+    for (int k = 0; k < 6; ++k) {
+        step = k < 3 ? HEAD_POS_STEP_MOVE : HEAD_POS_STEP_ROT;
+        for (int sign = 1; sign >= -1; sign -= 2) {
+            rot.setIdentity();
+            move.setZero();
+            if (k < 3) {
+                move[k] = sign*step;
+            } else {
+                rot = AngleAxisf(sign*step,Vector3f::Unit(k-3)).toRotationMatrix();
+            }
+            FiffCoordTransOld* t = move_meg_head_t(m_meg_head_t,rot,move,m_pSettings->r0);
+            FwdCoilSet* megcoils = Q_NULLPTR;
+            FwdCoilSet* compcoils = Q_NULLPTR;
+            bool bOk = createMegCoils(t,megcoils,compcoils) &&
+                       FwdBemModel::compute_forward_meg(m_spaces,
+                                                        m_iNSpace,
+                                                        megcoils,
+                                                        compcoils,
+                                                        m_compData,
+                                                        m_pSettings->fixed_ori,
+                                                        m_bemModel,
+                                                        &m_pSettings->r0,
+                                                        m_pSettings->use_threads,
+                                                        megForward,
+                                                        megForwardGrad,
+                                                        false) != FAIL;
+            delete t;
+            delete megcoils;
+            delete compcoils;
+            if (!bOk) {
+                m_lMegForwardDeriv.clear();
+                return false;
+            }
+            if (sign > 0) {
+                matPlus = megForward.data;
+            }
+        }
+        m_lMegForwardDeriv.append(((matPlus - megForward.data)/(2.0*step)).cast<float>());
+        m_vecMegForwardCurv[k] = (matPlus - 2.0*m_meg_forward->data + megForward.data).norm()/(step*step*dNorm);
+    }
+    m_matRefMegForward = m_meg_forward->data;
+    m_ref_meg_head_t = new FiffCoordTransOld(*m_meg_head_t);
+    printf("Head position expansion set up.\n");
+
+    return true;
+}
+
+//=========================================================================================================
+
+bool ComputeFwd::headPosChange(const FiffCoordTransOld* transRef,
+                               const FiffCoordTransOld* trans,
+                               VectorXd& vecParam) const
+{
+    // the movement relative to the reference as rotation about the sphere model origin followed by a translation
+    Matrix3f rot = trans->rot*transRef->rot.transpose();
+    Vector3f move = trans->move - rot*(transRef->move - m_pSettings->r0) - m_pSettings->r0;
+    AngleAxisf rotVec(rot);
+
+    vecParam.resize(6);
+    vecParam << move.cast<double>(), (rotVec.angle()*rotVec.axis()).cast<double>();
+
+    return move.norm() <= HEAD_POS_MAX_MOVE && rotVec.angle() <= HEAD_POS_MAX_ROT;
+}
+
+//=========================================================================================================
+
+bool ComputeFwd::updateHeadPosFromExpansion(FiffCoordTransOld* transDevHeadOld)
+{
+    if (!m_ref_meg_head_t || m_lMegForwardDeriv.size() != 6) {
+        return false;
+    }
+
+    VectorXd vecParam;
+    if (!headPosChange(m_ref_meg_head_t,transDevHeadOld,vecParam)) {
+        printf("Head movement of %.1f mm and %.1f degrees is too large for the head position expansion.\n",
+               1000.0*vecParam.head(3).norm(),vecParam.tail(3).norm()*180.0/EIGEN_PI);
+        return false;
+    }
+
+    // estimate the error from the neglected second-order terms
+    double dErr = 0.5*vecParam.cwiseAbs2().dot(m_vecMegForwardCurv);
+    if (dErr > m_pSettings->fast_head_pos_tol) {
+        printf("Estimated relative error of the head position expansion %.2g %% is too large.\n",100.0*dErr);
+        return false;
+    }
+
+    m_meg_forward->data = m_matRefMegForward;
+    for (int k = 0; k < 6; ++k) {
+        if (vecParam[k] != 0.0) {
+            m_meg_forward->data += vecParam[k]*m_lMegForwardDeriv[k].cast<double>();
+        }
+    }
+    printf("MEG forward solution updated from the head position expansion (estimated relative error %.2g %%).\n",100.0*dErr);
+
+    return true;
+}
+
+//=========================================================================================================
+
 void ComputeFwd::storeFwd(const QString& sSolName)
 {
     // We are ready to spill it out
@@ -72,6 +72,7 @@
 
 #include <QSharedPointer>
 #include <QString>
+#include <QVector>
 
 #include <QCoreApplication>
 #include <QFile>
@@ -124,7 +125,10 @@ public:
 
     //=========================================================================================================
     /**
-     * Update the heaposition with meg_head_t and recalculate the forward solution for meg
+     * Update the heaposition with meg_head_t and recalculate the forward solution for meg.
+     * If ComputeFwdSettings::fast_head_pos_update is set, the MEG forward solution is updated from a first-order
+     * expansion around a reference head position as long as the estimated error stays below
+     * ComputeFwdSettings::fast_head_pos_tol. Otherwise, and for the gradient solution, it is fully recomputed.
      * @param [in] transDevHeadOld        The meg <-> head transformation to use for updating head position
      */
     void updateHeadPos(FIFFLIB::FiffCoordTransOld* transDevHeadOld);
@@ -159,6 +163,56 @@ private:
      */
     void initFwd();
 
+    //=========================================================================================================
+    /**
+     * Create the MEG and compensator coil sets for a meg <-> head transformation in the coordinate frame of the
+     * source spaces.
+     *
+     * @param [in] transDevHeadOld      The meg <-> head transformation
+     * @param [out] megcoils            The MEG coil set
+     * @param [out] compcoils           The compensator coil set, Q_NULLPTR if there are no compensator channels
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    bool createMegCoils(FIFFLIB::FiffCoordTransOld* transDevHeadOld,
+                        FwdCoilSet*& megcoils,
+                        FwdCoilSet*& compcoils) const;
+
+    //=========================================================================================================
+    /**
+     * Set up the first-order expansion of the MEG forward solution around the current head position. The
+     * derivatives with respect to a translation and a rotation about the sphere model origin are computed
+     * by central differences, which takes twelve forward computations.
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    bool setupHeadPosExpansion();
+
+    //=========================================================================================================
+    /**
+     * Express the change from one meg <-> head transformation to another as a translation and a rotation vector
+     * about the sphere model origin, the parameters of the head position expansion.
+     *
+     * @param [in] transRef             The reference meg <-> head transformation
+     * @param [in] trans                The new meg <-> head transformation
+     * @param [out] vecParam            The translation (m) followed by the rotation vector (rad)
+     *
+     * @return true if the change is within the range of the expansion, false otherwise.
+     */
+    bool headPosChange(const FIFFLIB::FiffCoordTransOld* transRef,
+                       const FIFFLIB::FiffCoordTransOld* trans,
+                       Eigen::VectorXd& vecParam) const;
+
+    //=========================================================================================================
+    /**
+     * Update the MEG forward solution from the first-order expansion if the estimated error is small enough.
+     *
+     * @param [in] transDevHeadOld      The new meg <-> head transformation
+     *
+     * @return true if the solution was updated, false if it has to be recomputed.
+     */
+    bool updateHeadPosFromExpansion(FIFFLIB::FiffCoordTransOld* transDevHeadOld);
+
     MNELIB::MneSourceSpaceOld **m_spaces;           /**< Source spaces */
     int m_iNSpace;                                  /**< The number of source spaces */
     int m_iNSource;                                 /**< Number of source space points */
@@ -182,6 +236,11 @@ private:
     FIFFLIB::FiffCoordTransOld* m_mri_head_t;       /**< The MRI->head coordinate transformation */
     FIFFLIB::FiffCoordTransOld* m_meg_head_t;       /**< The MEG->head coordinate transformation */
 
+    FIFFLIB::FiffCoordTransOld* m_ref_meg_head_t;   /**< The MEG->head coordinate transformation the expansion was set up at, Q_NULLPTR if there is none */
+    Eigen::MatrixXd m_matRefMegForward;             /**< The MEG forward solution at the reference head position */
+    QVector<Eigen::MatrixXf> m_lMegForwardDeriv;    /**< Derivatives of the MEG forward solution with respect to the three translation and three rotation parameters */
+    Eigen::VectorXd m_vecMegForwardCurv;            /**< Norms of the second derivatives relative to the norm of the reference solution */
+
     QSharedPointer<FIFFLIB::FiffInfoBase> m_pInfoBase;
 
     ComputeFwdSettings::SPtr m_pSettings;                /**< The settings for the forward calculation */
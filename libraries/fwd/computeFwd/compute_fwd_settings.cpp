@@ -100,6 +100,8 @@ void ComputeFwdSettings::initMembers()
     scale_eeg_pos = false;    
     use_equiv_eeg = true;     
     use_threads = true;
+    fast_head_pos_update = false;
+    fast_head_pos_tol = 0.02f;
 
     pFiffInfo = Q_NULLPTR;
     meg_head_t = Q_NULLPTR;
@@ -138,6 +138,8 @@ public:
     bool scale_eeg_pos;     	/**< Scale the electrode locations to scalp in the sphere model */
     bool use_equiv_eeg;      	/**< Use the equivalent source approach for the EEG sphere model */
     bool use_threads;        	/**< Parallelize? */
+    bool fast_head_pos_update;  /**< Update the MEG forward solution for new head positions from a first-order expansion? */
+    float fast_head_pos_tol;    /**< Largest estimated relative error of the expansion before the solution is recomputed */
 
     QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo;    /**< The FiffInfo file from the measurement.*/
     FIFFLIB::FiffCoordTransOld* meg_head_t;         /**< Pointer to meg <-> head transformation.*/
@@ -53,9 +53,12 @@
 #include <fiff/fiff_stream.h>
 #include <fiff/fiff_named_matrix.h>
 
+#include <QAtomicInt>
+#include <QCryptographicHash>
 #include <QFile>
 #include <QList>
 #include <QThread>
+#include <QVector>
 #include <QtConcurrent>
 
 #define _USE_MATH_DEFINES
@@ -185,13 +188,13 @@ void fromFloatEigenMatrix_40(const Eigen::MatrixXf& from_mat, float **& to_mat)
 
 float **mne_lu_invert_40(float **mat,int dim)
 /*
-      * Invert a matrix using the LU decomposition from
-      * LAPACK
+      * Invert a matrix in place using the blocked LU decomposition with partial pivoting
+      * The rows of mat have to be stored contiguously as done by mne_cmatrix_40
       */
 {
-    Eigen::MatrixXf eigen_mat = toFloatEigenMatrix_40(mat, dim, dim);
-    Eigen::MatrixXf eigen_mat_inv = eigen_mat.inverse();
-    fromFloatEigenMatrix_40(eigen_mat_inv, mat);
+    Eigen::Map<Eigen::Matrix<float,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > eigen_mat(mat[0],dim,dim);
+
+    eigen_mat = eigen_mat.partialPivLu().inverse();
     return mat;
 }
 
@@ -339,6 +342,68 @@ static struct {
 
 #define BEM_SUFFIX     "-bem.fif"
 #define BEM_SOL_SUFFIX "-bem-sol.fif"
+#define BEM_SOL_CACHE_SUFFIX "-bem-sol-cache.fif"
+
+/*
+ * A block of rows of a BEM coefficient matrix which is filled by one thread
+ */
+typedef struct {
+    MNELIB::MneSurfaceOld* surf1;   /* The surface holding the field points (rows) */
+    MNELIB::MneSurfaceOld* surf2;   /* The surface holding the source elements (columns) */
+    int     same;                   /* Are the two surfaces the same? */
+    int     first;                  /* First row of this block within surf1 */
+    int     last;                   /* One past the last row */
+    float   **mat;                  /* Row pointers into the coefficient matrix, already offset to surf2 */
+} bemCoeffRowsRec;
+
+static QList<bemCoeffRowsRec> make_bem_coeff_blocks(MNELIB::MneSurfaceOld* surf1,
+                                                    MNELIB::MneSurfaceOld* surf2,
+                                                    int   same,
+                                                    int   nrow,
+                                                    float **mat)
+/*
+ * Split the rows in a few more blocks than there are threads to even out the load
+ */
+{
+    QList<bemCoeffRowsRec> blocks;
+    bemCoeffRowsRec        block;
+    int nblock = qMin(nrow,4*qMax(1,QThread::idealThreadCount()));
+    int k;
+
+    block.surf1 = surf1;
+    block.surf2 = surf2;
+    block.same  = same;
+    block.mat   = mat;
+    for (k = 0; k < nblock; k++) {
+        block.first = (k*nrow)/nblock;
+        block.last  = ((k+1)*nrow)/nblock;
+        blocks.append(block);
+    }
+    return blocks;
+}
+
+#define FWD_MIN_CHUNK         16    /* Smallest number of source points handed to a thread at once */
+#define FWD_CHUNKS_PER_THREAD 16    /* Aim at this many chunks per thread to balance the load */
+
+/*
+ * A range of source space vertices processed in one go by one of the forward computation threads
+ */
+typedef struct {
+    MNELIB::MneSourceSpaceOld* s;   /* The source space */
+    int     first;                  /* First vertex of the range */
+    int     last;                   /* One past the last vertex */
+    int     off;                    /* Row of the first vertex in use within the result */
+} fwdChunkRec;
+
+/*
+ * One forward computation thread. All threads take chunks from the same list until it is exhausted,
+ * so threads which happen to be faster take over more of the work.
+ */
+typedef struct {
+    FWDLIB::FwdThreadArg*       arg;        /* Private copy of the arguments with own workspace */
+    const QVector<fwdChunkRec>* chunks;     /* All chunks */
+    QAtomicInt*                 next;       /* The next chunk to be processed */
+} fwdWorkerRec;
 
 //============================= misc_util.c =============================
 
@@ -1035,6 +1100,42 @@ void FwdBemModel::correct_auto_elements(MneSurfaceOld *surf, float **mat)
 
 //=============================================================================================================
 
+static void lin_pot_coeff_rows(bemCoeffRowsRec& rows)
+/*
+ * Linear collocation coefficients for a block of vertices
+ */
+{
+    MneSurfaceOld* surf2 = rows.surf2;
+    MneTriangle*   tri;
+    double omega[3];
+    double *row = MALLOC_40(surf2->np,double);
+    int    j,k,c;
+
+    for (j = rows.first; j < rows.last; j++) {
+        for (k = 0; k < surf2->np; k++)
+            row[k] = 0.0;
+        for (k = 0, tri = surf2->tris; k < surf2->ntri; k++,tri++) {
+            /*
+             * No contribution from a triangle that
+             * this vertex belongs to
+             */
+            if (rows.same && (tri->vert[0] == j || tri->vert[1] == j || tri->vert[2] == j))
+                continue;
+            /*
+             * Otherwise do the hard job
+             */
+            FwdBemModel::lin_pot_coeff (rows.surf1->rr[j],tri,omega);
+            for (c = 0; c < 3; c++)
+                row[tri->vert[c]] = row[tri->vert[c]] - omega[c];
+        }
+        for (k = 0; k < surf2->np; k++)
+            rows.mat[j][k] = row[k];
+    }
+    FREE_40(row);
+}
+
+//=============================================================================================================
+
 float **FwdBemModel::fwd_bem_lin_pot_coeff(const QList<MneSurfaceOld*>& surfs)
 /*
  * Calculate the coefficients for linear collocation approach
@@ -1042,12 +1143,8 @@ float **FwdBemModel::fwd_bem_lin_pot_coeff(const QList<MneSurfaceOld*>& surfs)
 {
     float **mat = NULL;
     float **sub_mat = NULL;
-    int   np1,np2,ntri,np_tot,np_max;
-    float **nodes;
-    MneTriangle*   tri;
-    double omega[3];
-    double *row = NULL;
-    int    j,k,p,q,c;
+    int   np1,np2,np_tot,np_max;
+    int    j,k,p,q;
     int    joff,koff;
     MneSurfaceOld* surf1;
     MneSurfaceOld* surf2;
@@ -1062,50 +1159,31 @@ float **FwdBemModel::fwd_bem_lin_pot_coeff(const QList<MneSurfaceOld*>& surfs)
     for (j = 0; j < np_tot; j++)
         for (k = 0; k < np_tot; k++)
             mat[j][k] = 0.0;
-    row        = MALLOC_40(np_max,double);
     sub_mat = MALLOC_40(np_max,float *);
     for (p = 0, joff = 0; p < surfs.size(); p++, joff = joff + np1) {
         surf1 = surfs[p];
         np1   = surf1->np;
-        nodes = surf1->rr;
         for (q = 0, koff = 0; q < surfs.size(); q++, koff = koff + np2) {
             surf2 = surfs[q];
             np2   = surf2->np;
-            ntri  = surf2->ntri;
 
             fprintf(stderr,"\t\t%s (%d) -> %s (%d) ... ",
                     fwd_bem_explain_surface(surf1->id).toUtf8().constData(),np1,
                     fwd_bem_explain_surface(surf2->id).toUtf8().constData(),np2);
 
-            for (j = 0; j < np1; j++) {
-                for (k = 0; k < np2; k++)
-                    row[k] = 0.0;
-                for (k = 0, tri = surf2->tris; k < ntri; k++,tri++) {
-                    /*
-               * No contribution from a triangle that
-               * this vertex belongs to
-               */
-                    if (p == q && (tri->vert[0] == j || tri->vert[1] == j || tri->vert[2] == j))
-                        continue;
-                    /*
-               * Otherwise do the hard job
-               */
-                    lin_pot_coeff (nodes[j],tri,omega);
-                    for (c = 0; c < 3; c++)
-                        row[tri->vert[c]] = row[tri->vert[c]] - omega[c];
-                }
-                for (k = 0; k < np2; k++)
-                    mat[j+joff][k+koff] = row[k];
-            }
-            if (p == q) {
-                for (j = 0; j < np1; j++)
-                    sub_mat[j] = mat[j+joff]+koff;
+            for (j = 0; j < np1; j++)
+                sub_mat[j] = mat[j+joff]+koff;
+            /*
+             * The rows are independent of each other
+             */
+            QList<bemCoeffRowsRec> blocks = make_bem_coeff_blocks(surf1,surf2,p == q,np1,sub_mat);
+            QtConcurrent::blockingMap(blocks, lin_pot_coeff_rows);
+
+            if (p == q)
                 correct_auto_elements (surf1,sub_mat);
-            }
             fprintf(stderr,"[done]\n");
         }
     }
-    FREE_40(row);
     FREE_40(sub_mat);
     return(mat);
 }
@@ -1234,71 +1312,35 @@ void FwdBemModel::fwd_bem_ip_modify_solution(float **solution, float **ip_soluti
           */
 {
     int s;
-    int j,k,joff,koff,ntot,nlast;
+    int koff,ntot,nlast;
     float mult;
-    float *row = NULL;
-    float **sub = NULL;
 
     for (s = 0, koff = 0; s < nsurf-1; s++)
         koff = koff + ntri[s];
     nlast = ntri[nsurf-1];
     ntot  = koff + nlast;
 
-    row = MALLOC_40(nlast,float);
-    sub = MALLOC_40(ntot,float *);
     mult = (1.0 + ip_mult)/ip_mult;
 
+    Map<Matrix<float,Dynamic,Dynamic,RowMajor> > sol(solution[0],ntot,ntot);
+    Map<Matrix<float,Dynamic,Dynamic,RowMajor> > ip(ip_solution[0],nlast,nlast);
+
     fprintf(stderr,"\t\tCombining...");
-#ifndef OLD
-    fprintf(stderr,"t ");
-    mne_transpose_square_40(ip_solution,nlast);
-#endif
-    for (s = 0, joff = 0; s < nsurf; s++) {
-        fprintf(stderr,"%d3 ",s+1);
-        /*
-        * Pick the correct submatrix
-        */
-        for (j = 0; j < ntri[s]; j++)
-            sub[j] = solution[j+joff]+koff;
-        /*
-        * Multiply
-        */
-#ifdef OLD
-        for (j = 0; j < ntri[s]; j++) {
-            for (k = 0; k < nlast; k++) {
-                res = mne_dot_vectors_skip_skip(sub[j],1,ip_solution[0]+k,nlast,nlast);
-                row[k] = sub[j][k] - 2.0*res;
-            }
-            for (k = 0; k < nlast; k++)
-                sub[j][k] = row[k];
-        }
-#else
-        for (j = 0; j < ntri[s]; j++) {
-            for (k = 0; k < nlast; k++)
-                row[k] = mne_dot_vectors_40(sub[j],ip_solution[k],nlast);
-            mne_add_scaled_vector_to_40(row,-2.0,sub[j],nlast);
-        }
-#endif
-        joff = joff+ntri[s];
-    }
-#ifndef OLD
-    fprintf(stderr,"t ");
-    mne_transpose_square_40(ip_solution,nlast);
-#endif
-    fprintf(stderr,"33 ");
+    /*
+     * The columns belonging to the innermost surface are multiplied by the
+     * isolated problem solution, all surfaces at once
+     */
+    sol.rightCols(nlast) -= 2.0f*(sol.rightCols(nlast)*ip);
     /*
      * The lower right corner is a special case
      */
-    for (j = 0; j < nlast; j++)
-        for (k = 0; k < nlast; k++)
-            sub[j][k] = sub[j][k] + mult*ip_solution[j][k];
+    sol.bottomRightCorner(nlast,nlast) += mult*ip;
     /*
      * Final scaling
      */
     fprintf(stderr,"done.\n\t\tScaling...");
-    mne_scale_vector_40(ip_mult,solution[0],ntot*ntot);
+    sol *= ip_mult;
     fprintf(stderr,"done.\n");
-    FREE_40(row); FREE_40(sub);
     return;
 }
 
@@ -1339,6 +1381,25 @@ int FwdBemModel::fwd_bem_check_solids(float **angles, int ntri1, int ntri2, floa
 
 //=============================================================================================================
 
+static void solid_angle_rows(bemCoeffRowsRec& rows)
+/*
+ * Solid angles for a block of triangles
+ */
+{
+    MneTriangle* tri;
+    int j,k;
+
+    for (j = rows.first; j < rows.last; j++)
+        for (k = 0, tri = rows.surf2->tris; k < rows.surf2->ntri; k++, tri++) {
+            if (rows.same && j == k)
+                rows.mat[j][k] = 0.0;
+            else
+                rows.mat[j][k] = MneSurfaceOrVolume::solid_angle (rows.surf1->tris[j].cent,tri);
+        }
+}
+
+//=============================================================================================================
+
 float **FwdBemModel::fwd_bem_solid_angles(const QList<MneSurfaceOld*>& surfs)
 /*
           * Compute the solid angle matrix
@@ -1346,12 +1407,10 @@ float **FwdBemModel::fwd_bem_solid_angles(const QList<MneSurfaceOld*>& surfs)
 {
     MneSurfaceOld* surf1;
     MneSurfaceOld* surf2;
-    MneTriangle* tri;
     int ntri1,ntri2,ntri_tot;
-    int j,k,p,q;
+    int j,p,q;
     int joff,koff;
     float **solids;
-    float result;
     float **sub_solids = NULL;
     float desired;
 
@@ -1367,16 +1426,13 @@ float **FwdBemModel::fwd_bem_solid_angles(const QList<MneSurfaceOld*>& surfs)
             surf2 = surfs[q];
             ntri2 = surf2->ntri;
             fprintf(stderr,"\t\t%s (%d) -> %s (%d) ... ",fwd_bem_explain_surface(surf1->id).toUtf8().constData(),ntri1,fwd_bem_explain_surface(surf2->id).toUtf8().constData(),ntri2);
-            for (j = 0; j < ntri1; j++)
-                for (k = 0, tri = surf2->tris; k < ntri2; k++, tri++) {
-                    if (p == q && j == k)
-                        result = 0.0;
-                    else
-                        result = MneSurfaceOrVolume::solid_angle (surf1->tris[j].cent,tri);
-                    solids[j+joff][k+koff] = result;
-                }
             for (j = 0; j < ntri1; j++)
                 sub_solids[j] = solids[j+joff]+koff;
+            /*
+             * The rows are independent of each other
+             */
+            QList<bemCoeffRowsRec> blocks = make_bem_coeff_blocks(surf1,surf2,p == q,ntri1,sub_solids);
+            QtConcurrent::blockingMap(blocks, solid_angle_rows);
             fprintf(stderr,"[done]\n");
             if (p == q)
                 desired = 1;
@@ -1485,6 +1541,7 @@ int FwdBemModel::fwd_bem_load_recompute_solution(const QString& name, int bem_me
  */
 {
     int solres;
+    QString cache_name;
 
     if (!m) {
         printf ("No model specified for fwd_bem_load_recompute_solution");
@@ -1508,7 +1565,83 @@ int FwdBemModel::fwd_bem_load_recompute_solution(const QString& name, int bem_me
     }
     if (bem_method == FWD_BEM_UNKNOWN)
         bem_method = FWD_BEM_LINEAR_COLL;
-    return fwd_bem_compute_solution(m,bem_method);
+    /*
+     * The same model may have been solved before
+     */
+    cache_name = fwd_bem_make_bem_sol_cache_name(name,bem_method,m);
+    if (!force_recompute) {
+        if (fwd_bem_load_solution(cache_name,bem_method,m) == TRUE) {
+            fprintf(stderr,"\nLoaded %s BEM solution from %s\n",fwd_bem_explain_method(m->bem_method).toUtf8().constData(),cache_name.toUtf8().constData());
+            return OK;
+        }
+    }
+    if (fwd_bem_compute_solution(m,bem_method) == FAIL)
+        return FAIL;
+    if (fwd_bem_write_solution(cache_name,m) == OK)
+        fprintf(stderr,"Solution cached in %s\n",cache_name.toUtf8().constData());
+    return OK;
+}
+
+//=============================================================================================================
+
+QString FwdBemModel::fwd_bem_make_bem_sol_cache_name(const QString& name, int bem_method, FwdBemModel *m)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    MneSurfaceOld* surf;
+    QString s1, s2;
+    int j,k;
+
+    hash.addData((const char*)&bem_method,sizeof(int));
+    hash.addData((const char*)&m->nsurf,sizeof(int));
+    for (k = 0; k < m->nsurf; k++) {
+        surf = m->surfs[k];
+        hash.addData((const char*)&surf->id,sizeof(int));
+        hash.addData((const char*)&m->sigma[k],sizeof(float));
+        hash.addData((const char*)&surf->np,sizeof(int));
+        for (j = 0; j < surf->np; j++)
+            hash.addData((const char*)surf->rr[j],3*sizeof(float));
+        hash.addData((const char*)&surf->ntri,sizeof(int));
+        for (j = 0; j < surf->ntri; j++)
+            hash.addData((const char*)surf->tris[j].vert,3*sizeof(int));
+    }
+    hash.addData((const char*)&m->ip_approach_limit,sizeof(float));
+
+    s1 = strip_from(name,".fif");
+    s2 = strip_from(s1,"-sol");
+    s1 = strip_from(s2,"-bem");
+    return QString("%1-%2%3").arg(s1).arg(QString(hash.result().toHex().left(16))).arg(BEM_SOL_CACHE_SUFFIX);
+}
+
+//=============================================================================================================
+
+int FwdBemModel::fwd_bem_write_solution(const QString& name, FwdBemModel *m)
+{
+    QFile file(name);
+    int   method;
+
+    if (!m || !m->solution || m->nsol <= 0)
+        return FAIL;
+
+    if (m->bem_method == FWD_BEM_LINEAR_COLL)
+        method = FIFFV_BEM_APPROX_LINEAR;
+    else if (m->bem_method == FWD_BEM_CONSTANT_COLL)
+        method = FIFFV_BEM_APPROX_CONST;
+    else
+        return FAIL;
+
+    FiffStream::SPtr stream = FiffStream::start_file(file);
+    if (!stream)
+        return FAIL;
+
+    stream->start_block(FIFFB_BEM);
+    stream->write_int(FIFF_BEM_APPROX,&method);
+    stream->write_float_matrix(FIFF_BEM_POT_SOLUTION,
+                               Map<Matrix<float,Dynamic,Dynamic,RowMajor> >(m->solution[0],m->nsol,m->nsol));
+    stream->end_block(FIFFB_BEM);
+    stream->end_file();
+    stream->close();
+
+    return OK;
 }
 
 //=============================================================================================================
@@ -2915,20 +3048,21 @@ int FwdBemModel::fwd_bem_field_grad(float *rd,
 
 void *FwdBemModel::meg_eeg_fwd_one_source_space(void *arg)
 /*
- * Compute the MEG or EEG forward solution for one source space
+ * Compute the MEG or EEG forward solution for one source space or a range of its vertices
  * and possibly for only one source component
  */
 {
     FwdThreadArg* a = (FwdThreadArg*)arg;
     MneSourceSpaceOld* s = a->s;
     int            j,p,q;
+    int            last = a->last < 0 ? s->np : a->last;
     float          *xyz[3];
 
     p = a->off;
     q = 3*a->off;
     if (a->fixed_ori) {					  /* The normal source component only */
         if (a->field_pot_grad && a->res_grad) {                   /* Gradient requested? */
-            for (j = 0; j < s->np; j++) {
+            for (j = a->first; j < last; j++) {
                 if (s->inuse[j]) {
                     if (a->field_pot_grad(s->rr[j],
                                           s->nn[j],
@@ -2945,7 +3079,7 @@ void *FwdBemModel::meg_eeg_fwd_one_source_space(void *arg)
                 }
             }
         } else {
-            for (j = 0; j < s->np; j++)
+            for (j = a->first; j < last; j++)
                 if (s->inuse[j])
                     if (a->field_pot(s->rr[j],
                                      s->nn[j],
@@ -2957,7 +3091,7 @@ void *FwdBemModel::meg_eeg_fwd_one_source_space(void *arg)
     }
     else {						  /* All source components */
         if (a->field_pot_grad && a->res_grad) {               /* Gradient requested? */
-            for (j = 0; j < s->np; j++) {
+            for (j = a->first; j < last; j++) {
                 if (s->inuse[j]) {
                     if (a->comp < 0) {				  /* Compute all components */
                         if (a->field_pot_grad(s->rr[j],
@@ -3037,7 +3171,7 @@ void *FwdBemModel::meg_eeg_fwd_one_source_space(void *arg)
             }
         }
         else {
-            for (j = 0; j < s->np; j++) {
+            for (j = a->first; j < last; j++) {
                 if (s->inuse[j]) {
                     if (a->vec_field_pot) {
                         xyz[0] = a->res[p++];
@@ -3087,6 +3221,71 @@ bad : {
 
 //=============================================================================================================
 
+static QVector<fwdChunkRec> make_fwd_chunks(MneSourceSpaceOld **spaces, int nspace, bool fixed_ori, int nthread)
+/*
+ * Split the source points of all source spaces into chunks with about the same number of points in use
+ */
+{
+    QVector<fwdChunkRec> chunks;
+    fwdChunkRec chunk;
+    int         nsource,chunk_size,nuse,off,j,k;
+
+    for (k = 0, nsource = 0; k < nspace; k++)
+        nsource += spaces[k]->nuse;
+    chunk_size = qMax(FWD_MIN_CHUNK,nsource/(FWD_CHUNKS_PER_THREAD*nthread));
+
+    for (k = 0, off = 0; k < nspace; k++) {
+        chunk.s     = spaces[k];
+        chunk.first = 0;
+        chunk.off   = off;
+        for (j = 0, nuse = 0; j < spaces[k]->np; j++) {
+            if (spaces[k]->inuse[j]) {
+                nuse++;
+                off = fixed_ori ? off + 1 : off + 3;
+            }
+            if (nuse == chunk_size) {
+                chunk.last = j+1;
+                chunks.append(chunk);
+                chunk.first = j+1;
+                chunk.off   = off;
+                nuse = 0;
+            }
+        }
+        if (nuse > 0) {
+            chunk.last = spaces[k]->np;
+            chunks.append(chunk);
+        }
+    }
+    return chunks;
+}
+
+//=============================================================================================================
+
+static void fwd_compute_chunks(fwdWorkerRec& worker)
+/*
+ * Keep taking the next unprocessed chunk until all are done
+ */
+{
+    int k;
+
+    worker.arg->stat = OK;
+    while ((k = worker.next->fetchAndAddOrdered(1)) < worker.chunks->size()) {
+        const fwdChunkRec& chunk = worker.chunks->at(k);
+
+        worker.arg->s     = chunk.s;
+        worker.arg->first = chunk.first;
+        worker.arg->last  = chunk.last;
+        worker.arg->off   = chunk.off;
+        FwdBemModel::meg_eeg_fwd_one_source_space(worker.arg);
+        if (worker.arg->stat != OK) {
+            worker.next->fetchAndStoreOrdered(worker.chunks->size());    /* Stop the others as well */
+            return;
+        }
+    }
+}
+
+//=============================================================================================================
+
 int FwdBemModel::compute_forward_meg(MneSourceSpaceOld **spaces,
                                      int nspace,
                                      FwdCoilSet *coils,
@@ -3116,7 +3315,7 @@ int FwdBemModel::compute_forward_meg(MneSourceSpaceOld **spaces,
                                              * for one dipole orientation */
     int                 nmeg = coils->ncoil;/* Number of channels */
     int                 nsource;            /* Total number of sources */
-    int                 k,p,q,off;
+    int                 k,off;
     QStringList         names;              /* Channel names */
     void                *client;
     FwdThreadArg*       one_arg = NULL;
@@ -3232,53 +3431,38 @@ int FwdBemModel::compute_forward_meg(MneSourceSpaceOld **spaces,
         use_threads = false;
 
     if (use_threads) {
-        int            nthread  = (fixed_ori || vec_field || nproc < 6) ? nspace : 3*nspace;
-        QList <FwdThreadArg*> args; //fwdThreadArg   *args    = MALLOC_40(nthread,fwdThreadArg);
-        int            stat;
+        QVector<fwdChunkRec> chunks = make_fwd_chunks(spaces,nspace,fixed_ori,nproc);
+        QList<fwdWorkerRec>  workers;
+        fwdWorkerRec         worker;
+        QAtomicInt           next(0);
+        int                  stat;
         /*
-        * We need copies to allocate separate workspace for each thread
+        * We need copies to allocate separate workspace for each thread, these are reused for all chunks
         */
-        if (fixed_ori || vec_field || nproc < 6) {
-            for (k = 0, off = 0; k < nthread; k++) {
-                FwdThreadArg* t_arg = FwdThreadArg::create_meg_multi_thread_duplicate(one_arg,bem_model != NULL);
-                t_arg->s   = spaces[k];
-                t_arg->off = off;
-                off = fixed_ori ? off + spaces[k]->nuse : off + 3*spaces[k]->nuse;
-                args.append(t_arg);
-            }
-            fprintf(stderr,"%d processors. I will use one thread for each of the %d source spaces.\n",
-                    nproc,nspace);
-        }
-        else {
-            for (k = 0, off = 0, q = 0; k < nspace; k++) {
-                for (p = 0; p < 3; p++,q++) {
-                    FwdThreadArg* t_arg = FwdThreadArg::create_meg_multi_thread_duplicate(one_arg,bem_model != NULL);
-                    t_arg->s    = spaces[k];
-                    t_arg->off  = off;
-                    t_arg->comp = p;
-                    args.append(t_arg);
-                }
-                off = fixed_ori ? off + spaces[k]->nuse : off + 3*spaces[k]->nuse;
-            }
-            fprintf(stderr,"%d processors. I will use %d threads : %d source spaces x 3 source components.\n",
-                    nproc,nthread,nspace);
+        for (k = 0; k < nproc; k++) {
+            worker.arg    = FwdThreadArg::create_meg_multi_thread_duplicate(one_arg,bem_model != NULL);
+            worker.chunks = &chunks;
+            worker.next   = &next;
+            workers.append(worker);
         }
+        fprintf(stderr,"%d processors. I will use %d threads sharing %d chunks of source points.\n",
+                nproc,nproc,chunks.size());
         fprintf(stderr,"Computing MEG at %d source locations (%s orientations)...",
                 nsource,fixed_ori ? "fixed" : "free");
         /*
         * Ready to start the threads & Wait for them to complete
         */
-        QtConcurrent::blockingMap(args, meg_eeg_fwd_one_source_space);
+        QtConcurrent::blockingMap(workers, fwd_compute_chunks);
         /*
         * Check the results
         */
-        for (k = 0, stat = OK; k < nthread; k++)
-            if (args[k]->stat != OK) {
+        for (k = 0, stat = OK; k < workers.size(); k++)
+            if (workers[k].arg->stat != OK) {
                 stat = FAIL;
                 break;
             }
-        for (k = 0; k < args.size(); k++)//nthread == args.size()
-            FwdThreadArg::free_meg_multi_thread_duplicate(args[k],bem_model != NULL);
+        for (k = 0; k < workers.size(); k++)
+            FwdThreadArg::free_meg_multi_thread_duplicate(workers[k].arg,bem_model != NULL);
         if (stat != OK)
             goto bad;
     }
@@ -3377,7 +3561,7 @@ int FwdBemModel::compute_forward_eeg(MneSourceSpaceOld **spaces,
                                              * for one dipole orientation */
     int             nsource;                /* Total number of sources */
     int             neeg = els->ncoil;      /* Number of channels */
-    int             k,p,q,off;
+    int             k,off;
     QStringList     names;                  /* Channel names */
     void            *client;
     FwdThreadArg*   one_arg = NULL;
@@ -3453,51 +3637,37 @@ int FwdBemModel::compute_forward_eeg(MneSourceSpaceOld **spaces,
         use_threads = false;
 
     if (use_threads) {
-        int            nthread  = (fixed_ori || vec_pot || nproc < 6) ? nspace : 3*nspace;
-        QList <FwdThreadArg*> args; //FwdThreadArg*   *args    = MALLOC_40(nthread,FwdThreadArg*);
-        int            stat;
+        QVector<fwdChunkRec> chunks = make_fwd_chunks(spaces,nspace,fixed_ori,nproc);
+        QList<fwdWorkerRec>  workers;
+        fwdWorkerRec         worker;
+        QAtomicInt           next(0);
+        int                  stat;
         /*
-        * We need copies to allocate separate workspace for each thread
+        * We need copies to allocate separate workspace for each thread, these are reused for all chunks
         */
-        if (fixed_ori || vec_pot || nproc < 6) {
-            for (k = 0, off = 0; k < nthread; k++) {
-                FwdThreadArg* t_arg = FwdThreadArg::create_eeg_multi_thread_duplicate(one_arg,bem_model != NULL);
-                t_arg->s   = spaces[k];
-                t_arg->off = off;
-                off = fixed_ori ? off + spaces[k]->nuse : off + 3*spaces[k]->nuse;
-                args.append(t_arg);
-            }
-            printf("%d processors. I will use one thread for each of the %d source spaces.\n",nproc,nspace);
-        }
-        else {
-            for (k = 0, off = 0, q = 0; k < nspace; k++) {
-                for (p = 0; p < 3; p++,q++) {
-                    FwdThreadArg* t_arg = FwdThreadArg::create_eeg_multi_thread_duplicate(one_arg,bem_model != NULL);
-                    t_arg->s    = spaces[k];
-                    t_arg->off  = off;
-                    t_arg->comp = p;
-                    args.append(t_arg);
-                }
-                off = fixed_ori ? off + spaces[k]->nuse : off + 3*spaces[k]->nuse;
-            }
-            printf("%d processors. I will use %d threads : %d source spaces x 3 source components.\n",nproc,nthread,nspace);
+        for (k = 0; k < nproc; k++) {
+            worker.arg    = FwdThreadArg::create_eeg_multi_thread_duplicate(one_arg,bem_model != NULL);
+            worker.chunks = &chunks;
+            worker.next   = &next;
+            workers.append(worker);
         }
+        printf("%d processors. I will use %d threads sharing %d chunks of source points.\n",nproc,nproc,chunks.size());
         printf("Computing EEG at %d source locations (%s orientations)...",
                 nsource,fixed_ori ? "fixed" : "free");
         /*
         * Ready to start the threads & Wait for them to complete
         */
-        QtConcurrent::blockingMap(args, meg_eeg_fwd_one_source_space);
+        QtConcurrent::blockingMap(workers, fwd_compute_chunks);
         /*
         * Check the results
         */
-        for (k = 0, stat = OK; k < nthread; k++)
-            if (args[k]->stat != OK) {
+        for (k = 0, stat = OK; k < workers.size(); k++)
+            if (workers[k].arg->stat != OK) {
                 stat = FAIL;
                 break;
             }
-        for (k = 0; k < args.size(); k++)//nthread == args.size()
-            FwdThreadArg::free_eeg_multi_thread_duplicate(args[k],bem_model != NULL);
+        for (k = 0; k < workers.size(); k++)
+            FwdThreadArg::free_eeg_multi_thread_duplicate(workers[k].arg,bem_model != NULL);
         if (stat != OK)
             goto bad;
     }
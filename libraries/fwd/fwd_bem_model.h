@@ -245,6 +245,34 @@ public:
                                         int         force_recompute,
                                         FwdBemModel* m);
 
+    //=========================================================================================================
+    /**
+     * Make the name of the file used to cache a computed solution. The name is placed next to the BEM
+     * file and contains a hash of the surface geometry, the conductivities and the approximation method,
+     * so that a cached solution is only picked up again for the very same model.
+     *
+     * @param[in] name          The BEM file name.
+     * @param[in] bem_method    The approximation method of the solution.
+     * @param[in] m             The BEM model with its surfaces loaded.
+     *
+     * @return The cache file name.
+     */
+    static QString fwd_bem_make_bem_sol_cache_name(const QString& name,
+                                                   int         bem_method,
+                                                   FwdBemModel* m);
+
+    //=========================================================================================================
+    /**
+     * Write the potential solution matrix of the model into a file which can be read by fwd_bem_load_solution.
+     *
+     * @param[in] name          The file to write.
+     * @param[in] m             The BEM model with a computed solution.
+     *
+     * @return OK or FAIL.
+     */
+    static int fwd_bem_write_solution(const QString& name,
+                                      FwdBemModel* m);
+
     //============================= fwd_bem_pot.c =============================
 
     static float fwd_bem_inf_field(float *rd,      /* Dipole position */
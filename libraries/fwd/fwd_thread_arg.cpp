@@ -44,6 +44,7 @@
 #include "fwd_coil_set.h"
 #include "fwd_bem_model.h"
 #include "fwd_comp_data.h"
+#include "fwd_eeg_sphere_model.h"
 
 #ifndef TRUE
 #define TRUE 1
@@ -98,6 +99,8 @@ FwdThreadArg::FwdThreadArg()
 ,fixed_ori     (FALSE)
 ,stat          (FAIL)
 ,comp          (-1)
+,first         (0)
+,last          (-1)
 {
 }
 
@@ -126,6 +129,8 @@ FwdThreadArg *FwdThreadArg::create_eeg_multi_thread_duplicate(FwdThreadArg *one,
         new_bem->v0 = NULL;
         res->client = new_bem;
     }
+    else
+        res->client = new FwdEegSphereModel(*(FwdEegSphereModel*)one->client);  /* The series coefficients are set up on first use */
     return res;
 }
 
@@ -142,6 +147,8 @@ void FwdThreadArg::free_eeg_multi_thread_duplicate(FwdThreadArg *one, bool bem_m
         FREE_80(bem->v0);
         FREE_80(bem);
     }
+    else
+        delete (FwdEegSphereModel*)one->client;
     one->client = NULL;
     if(one)
         delete one;
@@ -124,6 +124,8 @@ public:
     MNELIB::MneSourceSpaceOld   *s;                 /* The source space to process */
     int                 fixed_ori;         /* Compute fixed orientation solution? */
     int                 comp;              /* Which component to compute for free orientations */
+    int                 first;             /* First source space vertex to process */
+    int                 last;              /* One past the last vertex to process (-1 = up to the end) */
     int                 stat;
 
 // ### OLD STRUCT ###
@@ -5,7 +5,10 @@
 #include "guess_data.h"
 
 #include <string.h>
+#include <vector>
 #include <QScopedPointer>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
 
 using namespace INVERSELIB;
 using namespace MNELIB;
@@ -48,6 +51,8 @@ using namespace FWDLIB;
 
 #define EPS_VALUES 0.05
 
+#define FIT_BATCH 256       /* Time points collected per thread before the raw data fits are run */
+
 //=============================================================================================================
 // STATIC DEFINITIONS ToDo make members
 //=============================================================================================================
@@ -686,43 +691,137 @@ out : {
 
 //=============================================================================================================
 
+/*
+ * One time point to be fitted
+ */
+typedef struct {
+    float           time;       /* Which time is it? */
+    QVector<float>  B;          /* The field to fit, gets projected and whitened in place */
+    ECD             dip;        /* The fitted dipole */
+    bool            valid;      /* Was the fit successful? */
+} fitTimePointRec;
+
+/*
+ * A fitting thread works on every stride'th time point starting at first.
+ * The fit data and the guesses are shared, the workspace is private to the thread.
+ */
+typedef struct {
+    DipoleFitData*      fit;
+    GuessData*          guess;
+    dipoleFitWorkspace  workspace;
+    int                 verbose;
+    fitTimePointRec     *points;
+    int                 npoint;
+    int                 first;
+    int                 stride;
+} fitWorkerRec;
+
+static void fit_time_points(fitWorkerRec& worker)
+{
+    for (int k = worker.first; k < worker.npoint; k += worker.stride) {
+        fitTimePointRec& p = worker.points[k];
+        p.valid = DipoleFitData::fit_one(worker.fit,worker.guess,p.time,p.B.data(),worker.verbose,p.dip,worker.workspace);
+    }
+}
+
+static std::vector<fitWorkerRec> new_fit_workers(DipoleFitData* fit, GuessData* guess, int verbose)
+/*
+ * Verbose fitting reports every simplex step, keep these readable by fitting in one thread only
+ */
+{
+    int nthread = verbose ? 1 : qMax(1,QThread::idealThreadCount());
+    std::vector<fitWorkerRec> workers(nthread);
+
+    for (int k = 0; k < nthread; k++) {
+        workers[k].fit       = fit;
+        workers[k].guess     = guess;
+        workers[k].workspace = DipoleFitData::new_fit_workspace(fit);
+        workers[k].verbose   = verbose;
+        workers[k].points    = NULL;
+        workers[k].npoint    = 0;
+        workers[k].first     = k;
+        workers[k].stride    = nthread;
+    }
+    return workers;
+}
+
+static void free_fit_workers(std::vector<fitWorkerRec>& workers)
+{
+    for (size_t k = 0; k < workers.size(); k++)
+        DipoleFitData::free_fit_workspace(workers[k].workspace);
+    workers.clear();
+}
+
+static void fit_pending_time_points(std::vector<fitWorkerRec>& workers,
+                                    QVector<fitTimePointRec>& points,
+                                    int verbose,
+                                    int report_interval,
+                                    ECDSet& set)
+/*
+ * Fit the collected time points in parallel and add the results in temporal order
+ */
+{
+    if (points.isEmpty())
+        return;
+
+    for (size_t k = 0; k < workers.size(); k++) {
+        workers[k].points = points.data();
+        workers[k].npoint = points.size();
+    }
+    QtConcurrent::blockingMap(workers, fit_time_points);
+
+    for (int k = 0; k < points.size(); k++) {
+        if (!points[k].valid)
+            printf("t = %7.1f ms : %s\n",1000*points[k].time,"error (tbd: catch)");
+        else {
+            set.addEcd(points[k].dip);
+            if (verbose)
+                points[k].dip.print(stdout);
+            else {
+                if (set.size() % report_interval == 0)
+                    fprintf(stderr,"%d..",set.size());
+            }
+        }
+    }
+    points.clear();
+}
+
+//=============================================================================================================
+
 int DipoleFit::fit_dipoles( const QString& dataname, MneMeasData* data, DipoleFitData* fit, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set)
 {
-    float *one = MALLOC(data->nchan,float);
     float time;
     ECDSet set;
-    ECD   dip;
     int   s;
     int   report_interval = 10;
+    QVector<fitTimePointRec> points;
+    fitTimePointRec          point;
+    std::vector<fitWorkerRec> workers;
 
     set.dataname = dataname;
 
     fprintf(stderr,"Fitting...%c",verbose ? '\n' : '\0');
-    for (s = 0, time = tmin; time < tmax; s++, time = tmin  + s*tstep) {
-        /*
-     * Pick the data point
+    /*
+     * Pick all data points first, the fits are independent of each other
      */
+    for (s = 0, time = tmin; time < tmax; s++, time = tmin  + s*tstep) {
+        point.time = time;
+        point.B.resize(data->nchan);
         if (mne_get_values_from_data(time,integ,data->current->data,data->current->np,data->nchan,data->current->tmin,
-                                     1.0/data->current->tstep,FALSE,one) == FAIL) {
+                                     1.0/data->current->tstep,FALSE,point.B.data()) == FAIL) {
             fprintf(stderr,"Cannot pick time: %7.1f ms\n",1000*time);
             continue;
         }
-
-        if (!DipoleFitData::fit_one(fit,guess,time,one,verbose,dip))
-            printf("t = %7.1f ms : %s\n",1000*time,"error (tbd: catch)");
-        else {
-            set.addEcd(dip);
-            if (verbose)
-                dip.print(stdout);
-            else {
-                if (set.size() % report_interval == 0)
-                    fprintf(stderr,"%d..",set.size());
-            }
-        }
+        point.valid = false;
+        points.append(point);
     }
+
+    workers = new_fit_workers(fit,guess,verbose);
+    fit_pending_time_points(workers,points,verbose,report_interval,set);
+    free_fit_workers(workers);
+
     if (!verbose)
         fprintf(stderr,"[done]\n");
-    FREE(one);
     p_set = set;
     return OK;
 }
@@ -731,7 +830,6 @@ int DipoleFit::fit_dipoles( const QString& dataname, MneMeasData* data, DipoleFi
 
 int DipoleFit::fit_dipoles_raw(const QString& dataname, MneRawData* raw, mneChSelection sel, DipoleFitData* fit, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set)
 {
-    float *one    = MALLOC(sel->nchan,float);
     float sfreq   = raw->info->sfreq;
     float myinteg = integ > 0.0 ? 2*integ : 0.1;
     int   overlap = ceil(myinteg*sfreq);
@@ -742,9 +840,11 @@ int DipoleFit::fit_dipoles_raw(const QString& dataname, MneRawData* raw, mneChSe
     int   s,picks;
     float time,stime;
     float **data  = ALLOC_CMATRIX(sel->nchan,length);
-    ECD    dip;
     ECDSet set;
     int    report_interval = 10;
+    QVector<fitTimePointRec>  points;
+    fitTimePointRec           point;
+    std::vector<fitWorkerRec> workers = new_fit_workers(fit,guess,verbose);
 
     set.dataname = dataname;
 
@@ -767,35 +867,31 @@ int DipoleFit::fit_dipoles_raw(const QString& dataname, MneRawData* raw, mneChSe
         /*
      * Get the values
      */
-        if (mne_get_values_from_data_ch (time,integ,data,length,sel->nchan,stime,sfreq,FALSE,one) == FAIL) {
+        point.time = time;
+        point.B.resize(sel->nchan);
+        if (mne_get_values_from_data_ch (time,integ,data,length,sel->nchan,stime,sfreq,FALSE,point.B.data()) == FAIL) {
             fprintf(stderr,"Cannot pick time: %8.3f s\n",time);
             continue;
         }
         /*
-     * Fit
+     * Collect the time points and fit them in batches
      */
-        if (!DipoleFitData::fit_one(fit,guess,time,one,verbose,dip))
-            qWarning() << "Error";
-        else {
-            set.addEcd(dip);
-            if (verbose)
-                dip.print(stdout);
-            else {
-                if (set.size() % report_interval == 0)
-                    fprintf(stderr,"%d..",set.size());
-            }
-        }
+        point.valid = false;
+        points.append(point);
+        if (points.size() >= FIT_BATCH*(int)workers.size())
+            fit_pending_time_points(workers,points,verbose,report_interval,set);
     }
+    fit_pending_time_points(workers,points,verbose,report_interval,set);
     if (!verbose)
         fprintf(stderr,"[done]\n");
+    free_fit_workers(workers);
     FREE_CMATRIX(data);
-    FREE(one);
     p_set = set;
     return OK;
 
 bad : {
+        free_fit_workers(workers);
         FREE_CMATRIX(data);
-        FREE(one);
         return FAIL;
     }
 }
@@ -14,6 +14,7 @@
 #include <mne/c/mne_surface_old.h>
 
 #include <fwd/fwd_comp_data.h>
+#include <fwd/fwd_thread_arg.h>
 
 #include <Eigen/Dense>
 
@@ -457,6 +458,8 @@ FiffSparseMatrix* mne_convert_to_sparse_3(float **dense,        /* The dense mat
 }
 
 typedef struct {
+    DipoleFitData*  fit;
+    dipoleFitFuncs  funcs;
     float          limit;
     int            report_dim;
     float          *B;
@@ -1323,6 +1326,58 @@ static dipoleFitFuncs new_dipole_fit_funcs()
     return f;
 }
 
+static dipoleFitFuncs dup_dipole_fit_funcs(dipoleFitFuncs orig, bool bem_model)
+/*
+ * Duplicate the client data which carries workspace, the read-only parts are shared
+ */
+{
+    dipoleFitFuncs f = new_dipole_fit_funcs();
+    FwdThreadArg   one;
+    FwdThreadArg*  dup;
+
+    *f = *orig;
+    f->meg_client_free = NULL;
+    f->eeg_client_free = NULL;
+
+    if (orig->meg_client) {
+        one.client = orig->meg_client;
+        dup = FwdThreadArg::create_meg_multi_thread_duplicate(&one,bem_model);
+        f->meg_client = dup->client;
+        dup->client = NULL;
+        delete dup;
+    }
+    if (orig->eeg_client) {
+        one.client = orig->eeg_client;
+        dup = FwdThreadArg::create_eeg_multi_thread_duplicate(&one,bem_model);
+        f->eeg_client = dup->client;
+        dup->client = NULL;
+        delete dup;
+    }
+    return f;
+}
+
+static void free_dup_dipole_fit_funcs(dipoleFitFuncs f, bool bem_model)
+
+{
+    FwdThreadArg* one;
+
+    if (!f)
+        return;
+
+    if (f->meg_client) {
+        one = new FwdThreadArg;
+        one->client = f->meg_client;
+        FwdThreadArg::free_meg_multi_thread_duplicate(one,bem_model);
+    }
+    if (f->eeg_client) {
+        one = new FwdThreadArg;
+        one->client = f->eeg_client;
+        FwdThreadArg::free_eeg_multi_thread_duplicate(one,bem_model);
+    }
+    FREE_3(f);
+    return;
+}
+
 //============================= mne_simplex_fit.c =============================
 
 /*
@@ -4223,6 +4278,7 @@ out : {
 //=============================================================================================================
 
 DipoleForward* dipole_forward(DipoleFitData* d,
+                              dipoleFitFuncs funcs,
                               float         **rd,
                               int           ndip,
                               DipoleForward* old)
@@ -4259,7 +4315,7 @@ DipoleForward* dipole_forward(DipoleFitData* d,
         /*
      * Calculate the field of three orthogonal dipoles
      */
-        if ((DipoleFitData::compute_dipole_field(d,rd[k],TRUE,this_fwd)) == FAIL)
+        if ((DipoleFitData::compute_dipole_field(d,funcs,rd[k],TRUE,this_fwd)) == FAIL)
             goto bad;
         /*
      * Choice of column normalization
@@ -4317,10 +4373,23 @@ DipoleForward* DipoleFitData::dipole_forward_one(DipoleFitData* d,
 /*
  * Convenience function to compute the field of one dipole
  */
+{
+    return dipole_forward_one(d,d->funcs,rd,old);
+}
+
+//=============================================================================================================
+
+DipoleForward* DipoleFitData::dipole_forward_one(DipoleFitData* d,
+                                                 dipoleFitFuncs funcs,
+                                                 float         *rd,
+                                                 DipoleForward* old)
+/*
+ * Ditto with the given forward calculation functions
+ */
 {
     float *rds[1];
     rds[0] = rd;
-    return dipole_forward(d,rds,1,old);
+    return dipole_forward(d,funcs,rds,1,old);
 }
 
 //=============================================================================================================
@@ -4330,13 +4399,12 @@ static float fit_eval(float *rd,int npar,void *user)
  * Calculate the residual sum of squares
  */
 {
-    DipoleFitData* fit   = (DipoleFitData*)user;
+    fitDipUser       fuser = (fitDipUser)user;
     DipoleForward* fwd;
-    fitDipUser       fuser = (fitDipUser)fit->user;
     double        Bm2,one;
     int           ncomp,c;
 
-    fwd = fuser->fwd = DipoleFitData::dipole_forward_one(fit,rd,fuser->fwd);
+    fwd = fuser->fwd = DipoleFitData::dipole_forward_one(fuser->fit,fuser->funcs,rd,fuser->fwd);
     ncomp = fwd->sing[2]/fwd->sing[0] > fuser->limit ? 3 : 2;
     if (fuser->report_dim)
         fprintf(stderr,"ncomp = %d\n",ncomp);
@@ -4441,6 +4509,7 @@ static int report_func(int     loop,
 }
 
 static int fit_Q(DipoleFitData* fit,	     /* The fit data */
+                 dipoleFitFuncs funcs,	     /* The forward calculation functions */
                  float *B,		     /* Measurement */
                  float *rd,		     /* Dipole position */
                  float limit,		     /* Radial component omission limit */
@@ -4452,7 +4521,7 @@ static int fit_Q(DipoleFitData* fit,	     /* The fit data */
  */
 {
     int c;
-    DipoleForward* fwd = DipoleFitData::dipole_forward_one(fit,rd,NULL);
+    DipoleForward* fwd = DipoleFitData::dipole_forward_one(fit,funcs,rd,NULL);
     float Bm2,one;
 
     if (!fwd)
@@ -4648,7 +4717,8 @@ bool DipoleFitData::fit_one(DipoleFitData* fit,	            /* Precomputed fitti
                     float         time,              /* Which time is it? */
                     float         *B,	            /* The field to fit */
                     int           verbose,
-                    ECD&          res               /* The fitted dipole */
+                    ECD&          res,              /* The fitted dipole */
+                    dipoleFitWorkspace workspace    /* Thread-private forward functions (optional) */
                     )
 {
     float  **simplex       = NULL;	       /* The simplex */
@@ -4667,6 +4737,8 @@ bool DipoleFitData::fit_one(DipoleFitData* fit,	            /* Precomputed fitti
     fitDipUserRec user;
     int        k,p,neval,neval_tot,nchan,ncomp;
     int        fit_fail;
+    dipoleFitFuncs sphere_funcs = workspace ? workspace->sphere_funcs : fit->sphere_funcs;
+    dipoleFitFuncs bem_funcs    = workspace ? workspace->bem_funcs : fit->bem_funcs;
 
     nchan = fit->nmeg+fit->neeg;
     user.fwd = NULL;
@@ -4682,12 +4754,12 @@ bool DipoleFitData::fit_one(DipoleFitData* fit,	            /* Precomputed fitti
     if (find_best_guess(B,nchan,guess,limit,&best,&good) < 0)
         goto bad;
 
+    user.fit   = fit;
     user.limit = limit;
     user.B     = B;
     user.B2    = mne_dot_vectors_3(B,B,nchan);
     user.fwd   = NULL;
     user.report_dim = FALSE;
-    fit->user  = &user;
 
     VEC_COPY_3(rd_guess,guess->rr[best]);
     VEC_COPY_3(rd_final,guess->rr[best]);
@@ -4699,20 +4771,20 @@ bool DipoleFitData::fit_one(DipoleFitData* fit,	            /* Precomputed fitti
      * Do first pass with the sphere model
      */
         if (k == 0)
-            fit->funcs = fit->sphere_funcs;
+            user.funcs = sphere_funcs;
         else
-            fit->funcs = !fit->bemname.isEmpty() ? fit->bem_funcs : fit->sphere_funcs;
+            user.funcs = !fit->bemname.isEmpty() ? bem_funcs : sphere_funcs;
 
         simplex = make_initial_dipole_simplex(rd_guess,size);
         for (p = 0; p < 4; p++)
-            vals[p] = fit_eval(simplex[p],3,fit);
+            vals[p] = fit_eval(simplex[p],3,&user);
         if (simplex_minimize(simplex,           /* The initial simplex */
                              vals,              /* Function values at the vertices */
                              3,                 /* Number of variables */
                              ftol[k],           /* Relative convergence tolerance for the target function */
                              atol[k],           /* Absolute tolerance for the change in the parameters */
                              fit_eval,          /* The function to be evaluated */
-                             fit,               /* Data to be passed to the above function in each evaluation */
+                             &user,             /* Data to be passed to the above function in each evaluation */
                              max_eval,          /* Maximum number of function evaluations */
                              &neval,            /* Number of function evaluations */
                              report_interval,   /* How often to report (-1 = no_reporting) */
@@ -4738,7 +4810,7 @@ bool DipoleFitData::fit_one(DipoleFitData* fit,	            /* Precomputed fitti
     /*
    * Compute the dipole moment at the final point
    */
-    if (fit_Q(fit,user.B,rd_final,user.limit,Q,&ncomp,&final_val) == OK) {
+    if (fit_Q(fit,user.funcs,user.B,rd_final,user.limit,Q,&ncomp,&final_val) == OK) {
         res.time  = time;
         res.valid = true;
         for(int i = 0; i < 3; ++i)
@@ -4771,7 +4843,38 @@ bad : {
 
 //=============================================================================================================
 
+dipoleFitWorkspace DipoleFitData::new_fit_workspace(DipoleFitData* fit)
+{
+    dipoleFitWorkspace w = MALLOC_3(1,dipoleFitWorkspaceRec);
+
+    w->sphere_funcs = fit->sphere_funcs ? dup_dipole_fit_funcs(fit->sphere_funcs,false) : NULL;
+    w->bem_funcs    = fit->bem_funcs ? dup_dipole_fit_funcs(fit->bem_funcs,true) : NULL;
+
+    return w;
+}
+
+//=============================================================================================================
+
+void DipoleFitData::free_fit_workspace(dipoleFitWorkspace workspace)
+{
+    if (!workspace)
+        return;
+
+    free_dup_dipole_fit_funcs(workspace->sphere_funcs,false);
+    free_dup_dipole_fit_funcs(workspace->bem_funcs,true);
+    FREE_3(workspace);
+}
+
+//=============================================================================================================
+
 int DipoleFitData::compute_dipole_field(DipoleFitData* d, float *rd, int whiten, float **fwd)
+{
+    return compute_dipole_field(d,d->funcs,rd,whiten,fwd);
+}
+
+//=============================================================================================================
+
+int DipoleFitData::compute_dipole_field(DipoleFitData* d, dipoleFitFuncs funcs, float *rd, int whiten, float **fwd)
 /*
  * Compute the field and take whitening and projection into account
  */
@@ -4785,34 +4888,34 @@ int DipoleFitData::compute_dipole_field(DipoleFitData* d, float *rd, int whiten,
    * Compute the fields
    */
     if (d->nmeg > 0) {
-        if (d->funcs->meg_vec_field) {
-            if (d->funcs->meg_vec_field(rd,d->meg_coils,fwd,d->funcs->meg_client) != OK)
+        if (funcs->meg_vec_field) {
+            if (funcs->meg_vec_field(rd,d->meg_coils,fwd,funcs->meg_client) != OK)
                 goto bad;
         }
         else {
-            if (d->funcs->meg_field(rd,Qx,d->meg_coils,fwd[0],d->funcs->meg_client) != OK)
+            if (funcs->meg_field(rd,Qx,d->meg_coils,fwd[0],funcs->meg_client) != OK)
                 goto bad;
-            if (d->funcs->meg_field(rd,Qy,d->meg_coils,fwd[1],d->funcs->meg_client) != OK)
+            if (funcs->meg_field(rd,Qy,d->meg_coils,fwd[1],funcs->meg_client) != OK)
                 goto bad;
-            if (d->funcs->meg_field(rd,Qz,d->meg_coils,fwd[2],d->funcs->meg_client) != OK)
+            if (funcs->meg_field(rd,Qz,d->meg_coils,fwd[2],funcs->meg_client) != OK)
                 goto bad;
         }
     }
 
     if (d->neeg > 0) {
-        if (d->funcs->eeg_vec_pot) {
+        if (funcs->eeg_vec_pot) {
             eeg_fwd[0] = fwd[0]+d->nmeg;
             eeg_fwd[1] = fwd[1]+d->nmeg;
             eeg_fwd[2] = fwd[2]+d->nmeg;
-            if (d->funcs->eeg_vec_pot(rd,d->eeg_els,eeg_fwd,d->funcs->eeg_client) != OK)
+            if (funcs->eeg_vec_pot(rd,d->eeg_els,eeg_fwd,funcs->eeg_client) != OK)
                 goto bad;
         }
         else {
-            if (d->funcs->eeg_pot(rd,Qx,d->eeg_els,fwd[0]+d->nmeg,d->funcs->eeg_client) != OK)
+            if (funcs->eeg_pot(rd,Qx,d->eeg_els,fwd[0]+d->nmeg,funcs->eeg_client) != OK)
                 goto bad;
-            if (d->funcs->eeg_pot(rd,Qy,d->eeg_els,fwd[1]+d->nmeg,d->funcs->eeg_client) != OK)
+            if (funcs->eeg_pot(rd,Qy,d->eeg_els,fwd[1]+d->nmeg,funcs->eeg_client) != OK)
                 goto bad;
-            if (d->funcs->eeg_pot(rd,Qz,d->eeg_els,fwd[2]+d->nmeg,d->funcs->eeg_client) != OK)
+            if (funcs->eeg_pot(rd,Qz,d->eeg_els,fwd[2]+d->nmeg,funcs->eeg_client) != OK)
                 goto bad;
         }
     }
@@ -86,6 +86,15 @@ typedef struct {
   mneUserFreeFunc eeg_client_free;
 } *dipoleFitFuncs,dipoleFitFuncsRec;
 
+/*
+ * Private copies of the forward calculation functions for one fitting thread.
+ * Only the client data holding workspace is duplicated, the rest is shared with the fit data.
+ */
+typedef struct {
+  dipoleFitFuncs  sphere_funcs;	    /* Sphere model functions */
+  dipoleFitFuncs  bem_funcs;	    /* BEM functions (NULL if no BEM is used) */
+} *dipoleFitWorkspace,dipoleFitWorkspaceRec;
+
 //=============================================================================================================
 // DEFINE NAMESPACE INVERSELIB
 //=============================================================================================================
@@ -177,19 +186,46 @@ public:
      * @param[in] B          The field to fit
      * @param[in] verbose
      * @param[in] res        The fitted dipole
+     * @param[in] workspace  Thread-private forward functions, see new_fit_workspace. If NULL, the functions of fit are used.
+     */
+    static bool fit_one(DipoleFitData* fit, GuessData* guess, float time, float *B, int verbose, ECD& res, dipoleFitWorkspace workspace = NULL);
+
+    //=========================================================================================================
+    /**
+     * Create private copies of the forward calculation functions so that fit_one can be called
+     * from several threads at the same time. The fit data itself is only read while fitting.
+     *
+     * @param[in] fit        Precomputed fitting data
+     *
+     * @return The workspace, to be released with free_fit_workspace.
      */
-    static bool fit_one(DipoleFitData* fit, GuessData* guess, float time, float *B, int verbose, ECD& res);
+    static dipoleFitWorkspace new_fit_workspace(DipoleFitData* fit);
+
+    //=========================================================================================================
+    /**
+     * Release a workspace created with new_fit_workspace.
+     *
+     * @param[in] workspace  The workspace to release.
+     */
+    static void free_fit_workspace(dipoleFitWorkspace workspace);
 
 //============================= dipole_forward.c
 
     static int compute_dipole_field(DipoleFitData* d, float *rd, int whiten, float **fwd);
 
+    static int compute_dipole_field(DipoleFitData* d, dipoleFitFuncs funcs, float *rd, int whiten, float **fwd);
+
     //============================= dipole_forward.c
 
     static DipoleForward* dipole_forward_one(DipoleFitData* d,
                                      float         *rd,
                                      DipoleForward* old);
 
+    static DipoleForward* dipole_forward_one(DipoleFitData* d,
+                                     dipoleFitFuncs funcs,
+                                     float         *rd,
+                                     DipoleForward* old);
+
 public:
       FIFFLIB::FiffCoordTransOld*    mri_head_t; /**< MRI <-> head coordinate transformation */
       FIFFLIB::FiffCoordTransOld*    meg_head_t; /**< MEG <-> head coordinate transformation */
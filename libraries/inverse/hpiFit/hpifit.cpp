@@ -61,8 +61,11 @@
 // QT INCLUDES
 //=============================================================================================================
 
-#include <QFuture>
-#include <QtConcurrent/QtConcurrent>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
 
 //=============================================================================================================
 // USED NAMESPACES
@@ -97,6 +100,8 @@ HPIFit::HPIFit(FiffInfo::SPtr pFiffInfo,
     m_coilTemplate = NULL;
     m_coilMeg = NULL;
 
+    m_fFitDuration = 0.0f;
+
     updateChannels(pFiffInfo);
     updateSensor();
 }
@@ -114,6 +119,9 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
                     bool bDoDebug,
                     const QString& sHPIResourceDir)
 {
+    QElapsedTimer timer;
+    timer.start();
+
     //Check if data was passed
     if(t_mat.rows() == 0 || t_mat.cols() == 0 ) {
         std::cout<<std::endl<< "HPIFit::fitHPI - No data passed. Returning.";
@@ -304,6 +312,10 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
         vecError[i] = matDiffPos.col(i).norm();
     }
 
+    // store the fit report
+    m_vecNumIterations = coil.dpfitnumitr.cast<int>();
+    m_fFitDuration = timer.nsecsElapsed() / 1e6;
+
     // store Goodness of Fit
     vecGoF = coil.dpfiterror;
     for(int i = 0; i < vecGoF.size(); ++i) {
@@ -325,6 +337,7 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
     if(bDoDebug) {
         // DEBUG HPI fitting and write debug results
         std::cout << std::endl << std::endl << "HPIFit::fitHPI - dpfiterror" << coil.dpfiterror << std::endl << std::endl;
+        std::cout << std::endl << std::endl << "HPIFit::fitHPI - iterations " << m_vecNumIterations.transpose() << " in " << m_fFitDuration << " ms" << std::endl;
         std::cout << std::endl << std::endl << "HPIFit::fitHPI - Initial seed point for HPI coils" << std::endl << matCoilPos << std::endl;
         std::cout << std::endl << std::endl << "HPIFit::fitHPI - temp" << std::endl << matTemp << std::endl;
         std::cout << std::endl << std::endl << "HPIFit::fitHPI - testPos" << std::endl << matTestPos << std::endl;
@@ -364,6 +377,15 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
 
 //=============================================================================================================
 
+void HPIFit::getLastFitReport(VectorXi& vecNumIterations,
+                              float& fDuration) const
+{
+    vecNumIterations = m_vecNumIterations;
+    fDuration = m_fFitDuration;
+}
+
+//=============================================================================================================
+
 void HPIFit::findOrder(const MatrixXd& t_mat,
                        const MatrixXd& t_matProjectors,
                        FiffCoordTrans& transDevHead,
@@ -437,41 +459,18 @@ CoilParam HPIFit::dipfit(struct CoilParam coil,
                          int iNumCoils,
                          const MatrixXd& t_matProjectors)
 {
-    //Do this in conncurrent mode
-    //Generate QList structure which can be handled by the QConcurrent framework
-    QList<HPIFitData> lCoilData;
-
-    for(qint32 i = 0; i < iNumCoils; ++i) {
-        HPIFitData coilData;
-        coilData.coilPos = coil.pos.row(i);
-        coilData.sensorData = matData.col(i);
-        coilData.sensors = sensors;
-        coilData.matProjector = t_matProjectors;
-
-        lCoilData.append(coilData);
-    }
-    //Do the concurrent filtering
-    if(!lCoilData.isEmpty()) {
-//        //Do sequential
-//        for(int l = 0; l < lCoilData.size(); ++l) {
-//            doDipfitConcurrent(lCoilData[l]);
-//        }
-
-        //Do concurrent
-        QFuture<void> future = QtConcurrent::map(lCoilData,
-                                                 &HPIFitData::doDipfitConcurrent);
-        future.waitForFinished();
-
-        //Transform results to final coil information
-        for(qint32 i = 0; i < lCoilData.size(); ++i) {
-            coil.pos.row(i) = lCoilData.at(i).coilPos;
-            coil.mom = lCoilData.at(i).errorInfo.moment.transpose();
-            coil.dpfiterror(i) = lCoilData.at(i).errorInfo.error;
-            coil.dpfitnumitr(i) = lCoilData.at(i).errorInfo.numIterations;
-
-            //std::cout<<std::endl<< "HPIFit::dipfit - Itr steps for coil " << i << " =" <<coil.dpfitnumitr(i);
-        }
-    }
+    // Fit all coils together with the analytic leadfield derivatives
+    VectorXi vecNumIterations;
+
+    HPIFitData::fitCoilsLevenbergMarquardt(coil.pos,
+                                           coil.mom,
+                                           coil.dpfiterror,
+                                           vecNumIterations,
+                                           matData.leftCols(iNumCoils),
+                                           sensors,
+                                           t_matProjectors);
+
+    coil.dpfitnumitr = vecNumIterations.cast<double>();
 
     return coil;
 }
@@ -108,6 +108,8 @@ struct HpiFitResult {
     bool                        bIsLargeHeadMovement;
     float                       fHeadMovementDistance;
     float                       fHeadMovementAngle;
+    Eigen::VectorXi             vecNumIterations;       /**< Iterations of the coil fit per coil. */
+    float                       fFitDuration;           /**< Duration of the fit in ms. */
 };
 
 /**
@@ -176,6 +178,16 @@ public:
                 bool bDoDebug = false,
                 const QString& sHPIResourceDir = QString("./HPIFittingDebug"));
 
+    //=========================================================================================================
+    /**
+     * Returns the number of iterations per coil and the duration of the last call to fitHPI.
+     *
+     * @param[out]   vecNumIterations   The iterations of the coil fit per coil.
+     * @param[out]   fDuration          The duration of the fit in ms.
+     */
+    void getLastFitReport(Eigen::VectorXi& vecNumIterations,
+                          float& fDuration) const;
+
     //=========================================================================================================
     /**
      * assign frequencies to correct position
@@ -306,6 +318,9 @@ private:
 
     QVector<int>        m_vecFreqs;         /**< The frequencies for each coil in unknown order. */
 
+    Eigen::VectorXi     m_vecNumIterations; /**< The iterations per coil of the last fit. */
+    float               m_fFitDuration;     /**< The duration of the last fit in ms. */
+
 };
 
 //=============================================================================================================
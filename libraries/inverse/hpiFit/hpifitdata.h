@@ -73,29 +73,6 @@ namespace FIFFLIB{
 namespace INVERSELIB
 {
 
-//=============================================================================================================
-// Declare all structures to be used
-//=============================================================================================================
-/**
- * The strucut specifing the dipole error.
- */
-struct DipFitError {
-    double error;
-    Eigen::MatrixXd moment;
-    int numIterations;
-};
-
-
-
-//=========================================================================================================
-/**
- * The strucut specifing the sorting parameters.
- */
-struct HPISortStruct {
-    double base_arr;
-    int idx;
-};
-
 //=============================================================================================================
 // FORWARD DECLARATIONS
 //=============================================================================================================
@@ -121,70 +98,44 @@ public:
 
     //=========================================================================================================
     /**
-     * dipfit function is adapted from Fieldtrip Software.
-     */
-    void doDipfitConcurrent();
-
-    Eigen::MatrixXd         coilPos;
-    Eigen::RowVectorXd      sensorData;
-    DipFitError             errorInfo;
-    struct SensorSet        sensors;
-    Eigen::MatrixXd         matProjector;
-
-protected:
-    //=========================================================================================================
-    /**
-     * magnetic_dipole leadfield for a magnetic dipole in an infinite medium.
-     * The function has been compared with matlab magnetic_dipole and it gives same output.
-     */
-    Eigen::MatrixXd magnetic_dipole(Eigen::MatrixXd matPos,
-                                    Eigen::MatrixXd matPnt,
-                                    Eigen::MatrixXd matOri);
-
-    //=========================================================================================================
-    /**
-     * compute_leadfield computes a forward solution for a dipole in a a volume
-     * conductor model. The forward solution is expressed as the leadfield
-     * matrix (Nchan*3), where each column corresponds with the potential or field
-     * distributions on all sensors for one of the x,y,z-orientations of the dipole.
-     * The function has been compared with matlab ft_compute_leadfield and it gives
-     * same output.
-     */
-    Eigen::MatrixXd compute_leadfield(const Eigen::MatrixXd& matPos,
-                                      const struct SensorSet& sensors);
-
-    //=========================================================================================================
-    /**
-     * dipfitError computes the error between measured and model data
-     * and can be used for non-linear fitting of dipole position.
-     * The function has been compared with matlab dipfit_error and it gives
-     * same output
-     */
-    DipFitError dipfitError(const Eigen::MatrixXd& matPos,
-                            const Eigen::MatrixXd& matData,
-                            const struct SensorSet& sensors,
-                            const Eigen::MatrixXd& matProjectors);
-
-    //=========================================================================================================
-    /**
-     * Compare function for sorting
+     * Fits the positions and moments of all coils with a Levenberg-Marquardt iteration using the analytic
+     * derivatives of the magnetic dipole field. The moments are solved for linearly at every position, so only the
+     * positions are iterated. The coils are iterated in lockstep and the fields of all coils are evaluated together
+     * once per iteration.
+     *
+     * @param[in, out] matCoilPos       The coil positions (number of coils x 3), initialized with the starting points.
+     * @param[out] matCoilMom           The fitted coil moments (number of coils x 3).
+     * @param[out] vecError             The relative residual error per coil.
+     * @param[out] vecNumIterations     The number of iterations per coil.
+     * @param[in] matData               The coil amplitudes, one column per coil.
+     * @param[in] sensors               The sensor information.
+     * @param[in] matProjectors         The projectors to apply.
+     * @param[in] iMaxIterations        The maximum number of iterations.
      */
-    static bool compare(HPISortStruct a, HPISortStruct b);
+    static void fitCoilsLevenbergMarquardt(Eigen::MatrixXd& matCoilPos,
+                                           Eigen::MatrixXd& matCoilMom,
+                                           Eigen::VectorXd& vecError,
+                                           Eigen::VectorXi& vecNumIterations,
+                                           const Eigen::MatrixXd& matData,
+                                           const struct SensorSet& sensors,
+                                           const Eigen::MatrixXd& matProjectors,
+                                           int iMaxIterations = 50);
 
     //=========================================================================================================
     /**
-     * fminsearch Multidimensional unconstrained nonlinear minimization (Nelder-Mead).
-     * X = fminsearch(X0, iMaxiter, iMaxfun, iDisplay, matData, sensors) starts at X0 and
-     * attempts to find a local minimizer
+     * Computes the leadfields of magnetic dipoles at several positions and their derivatives with respect to
+     * the dipole positions.
+     *
+     * @param[in] matPos        The dipole positions (number of dipoles x 3).
+     * @param[in] sensors       The sensor information.
+     * @param[out] matLf        The leadfields, three columns per dipole.
+     * @param[out] matGrad      The derivatives of the leadfields, nine columns per dipole. Column 3*k+j of a dipole
+     *                          holds the derivative of its leadfield column j with respect to coordinate k.
      */
-    Eigen::MatrixXd fminsearch(const Eigen::MatrixXd& matPos,
-                               int iMaxiter,
-                               int iMaxfun,
-                               int iDisplay,
-                               const Eigen::MatrixXd& matData,
-                               const Eigen::MatrixXd& matProjectors,
-                               const struct SensorSet& sensors,
-                               int &iSimplexNumitr);
+    static void dipoleFieldAndGradient(const Eigen::MatrixXd& matPos,
+                                       const struct SensorSet& sensors,
+                                       Eigen::MatrixXd& matLf,
+                                       Eigen::MatrixXd& matGrad);
 };
 
 //=============================================================================================================
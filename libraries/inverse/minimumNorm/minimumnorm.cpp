@@ -68,6 +68,10 @@ using namespace FIFFLIB;
 MinimumNorm::MinimumNorm(const MNEInverseOperator &p_inverseOperator, float lambda, const QString method)
 : m_inverseOperator(p_inverseOperator)
 , inverseSetup(false)
+, m_bPickNormal(false)
+, m_bRealTimeSetup(false)
+, m_bRealTimeCombineXyz(false)
+, m_bRealTimeAllChannels(false)
 {
     this->setRegularization(lambda);
     this->setMethod(method);
@@ -78,6 +82,10 @@ MinimumNorm::MinimumNorm(const MNEInverseOperator &p_inverseOperator, float lamb
 MinimumNorm::MinimumNorm(const MNEInverseOperator &p_inverseOperator, float lambda, bool dSPM, bool sLORETA)
 : m_inverseOperator(p_inverseOperator)
 , inverseSetup(false)
+, m_bPickNormal(false)
+, m_bRealTimeSetup(false)
+, m_bRealTimeCombineXyz(false)
+, m_bRealTimeAllChannels(false)
 {
     this->setRegularization(lambda);
     this->setMethod(dSPM, sLORETA);
@@ -247,11 +255,126 @@ void MinimumNorm::doInverseSetup(qint32 nave, bool pick_normal)
 
     std::cout << "K " << K.rows() << " x " << K.cols() << std::endl;
 
+    m_bPickNormal = pick_normal;
+    m_bRealTimeSetup = false;
     inverseSetup = true;
 }
 
 //=============================================================================================================
 
+bool MinimumNorm::prepareRealTimeInverse(const QStringList &lChNames)
+{
+    m_bRealTimeSetup = false;
+
+    if(!inverseSetup) {
+        qWarning("MinimumNorm::prepareRealTimeInverse - Inverse not setup -> call doInverseSetup first!");
+        return false;
+    }
+
+    // Cache the data row of each kernel column
+    const QStringList& lChNamesInvOp = inv.noise_cov->names;
+
+    if(lChNamesInvOp.size() != K.cols()) {
+        qWarning() << "MinimumNorm::prepareRealTimeInverse - Dimension mismatch between K.cols() and the number of inverse operator channels -" << K.cols() << "and" << lChNamesInvOp.size();
+        return false;
+    }
+
+    m_vecChSelRealTime.resize(lChNamesInvOp.size());
+    m_bRealTimeAllChannels = lChNames.size() == lChNamesInvOp.size();
+
+    for(int j = 0; j < lChNamesInvOp.size(); ++j) {
+        m_vecChSelRealTime[j] = lChNames.indexOf(lChNamesInvOp.at(j));
+
+        if(m_vecChSelRealTime[j] < 0) {
+            qWarning() << "MinimumNorm::prepareRealTimeInverse - Channel" << lChNamesInvOp.at(j) << "not found in the data.";
+            return false;
+        }
+
+        m_bRealTimeAllChannels = m_bRealTimeAllChannels && m_vecChSelRealTime[j] == j;
+    }
+
+    m_bRealTimeCombineXyz = inv.source_ori == FIFFV_MNE_FREE_ORI && !m_bPickNormal;
+    m_matKernelRealTime = K;
+
+    // The noise normalization is a positive diagonal. For free orientations it scales the norm of the three
+    // components of a source, which is the same as scaling the three components before taking the norm.
+    if((m_bdSPM || m_bsLORETA) && inv.noisenorm.rows() > 0) {
+        VectorXd vecNoiseNorm = inv.noisenorm.diagonal();
+        int iNumComp = m_bRealTimeCombineXyz ? 3 : 1;
+
+        if(vecNoiseNorm.size() * iNumComp != m_matKernelRealTime.rows()) {
+            qWarning() << "MinimumNorm::prepareRealTimeInverse - Dimension mismatch between the noise normalization and K.rows() -" << vecNoiseNorm.size() << "and" << m_matKernelRealTime.rows();
+            return false;
+        }
+
+        for(int i = 0; i < m_matKernelRealTime.rows(); ++i) {
+            m_matKernelRealTime.row(i) *= vecNoiseNorm[i / iNumComp];
+        }
+    }
+
+    m_vecVerticesRealTime.resize(inv.src[0].vertno.size() + inv.src[1].vertno.size());
+    m_vecVerticesRealTime << inv.src[0].vertno, inv.src[1].vertno;
+
+    m_bRealTimeSetup = true;
+
+    return true;
+}
+
+//=============================================================================================================
+
+bool MinimumNorm::calculateInverseRealTime(const MatrixXd &matData,
+                                           MatrixXd &matSol)
+{
+    if(!m_bRealTimeSetup) {
+        qWarning("MinimumNorm::calculateInverseRealTime - Real-time inverse not prepared -> call prepareRealTimeInverse first!");
+        return false;
+    }
+
+    int iNumSamples = matData.cols();
+
+    // Pick the channels of the inverse operator
+    const MatrixXd* pMatData = &matData;
+
+    if(!m_bRealTimeAllChannels) {
+        if(m_vecChSelRealTime.maxCoeff() >= matData.rows()) {
+            qWarning() << "MinimumNorm::calculateInverseRealTime - Data has less rows than expected -" << matData.rows();
+            return false;
+        }
+
+        m_matDataRealTime.resize(m_vecChSelRealTime.size(), iNumSamples);
+        for(int j = 0; j < m_vecChSelRealTime.size(); ++j) {
+            m_matDataRealTime.row(j) = matData.row(m_vecChSelRealTime[j]);
+        }
+
+        pMatData = &m_matDataRealTime;
+    } else if(matData.rows() != m_matKernelRealTime.cols()) {
+        qWarning() << "MinimumNorm::calculateInverseRealTime - Dimension mismatch between K.cols() and data.rows() -" << m_matKernelRealTime.cols() << "and" << matData.rows();
+        return false;
+    }
+
+    if(!m_bRealTimeCombineXyz) {
+        matSol.resize(m_matKernelRealTime.rows(), iNumSamples);
+        matSol.noalias() = m_matKernelRealTime * (*pMatData);
+        return true;
+    }
+
+    // Free orientations: apply the kernel and take the norm of the xyz components of each source
+    m_matSolXyzRealTime.resize(m_matKernelRealTime.rows(), iNumSamples);
+    m_matSolXyzRealTime.noalias() = m_matKernelRealTime * (*pMatData);
+
+    int iNumSources = m_matKernelRealTime.rows() / 3;
+    matSol.resize(iNumSources, iNumSamples);
+
+    for(int t = 0; t < iNumSamples; ++t) {
+        Map<const Matrix<double,3,Dynamic> > matXyz(m_matSolXyzRealTime.col(t).data(), 3, iNumSources);
+        matSol.col(t) = matXyz.colwise().norm().transpose();
+    }
+
+    return true;
+}
+
+//=============================================================================================================
+
 const char* MinimumNorm::getName() const
 {
     return "Minimum Norm Estimate";
@@ -48,6 +48,7 @@
 #include <fs/label.h>
 
 #include <QSharedPointer>
+#include <QStringList>
 
 //=============================================================================================================
 // DEFINE NAMESPACE INVERSELIB
@@ -124,6 +125,39 @@ public:
      */
     virtual void doInverseSetup(qint32 nave, bool pick_normal = false);
 
+    //=========================================================================================================
+    /**
+     * Prepares the set up inverse for real-time use with data which has the given channels. The channel
+     * selection is cached as index vector and the dSPM/sLORETA noise normalization is folded into the kernel, so
+     * calculateInverseRealTime only needs a single matrix product and, for free orientations, the combination of
+     * the xyz components. Call doInverseSetup first and again after each inverse setup.
+     *
+     * @param[in] lChNames   The channel names of the data passed to calculateInverseRealTime.
+     *
+     * @return true if all channels of the inverse operator are present in the data, false otherwise.
+     */
+    bool prepareRealTimeInverse(const QStringList &lChNames);
+
+    //=========================================================================================================
+    /**
+     * Applies the prepared real-time inverse. The channels are picked via the cached index vector. The result
+     * is written to matSol, which is only reallocated if its size changes.
+     *
+     * @param[in] matData    The data with the channels given to prepareRealTimeInverse as rows.
+     * @param[out] matSol    The source estimate data [n_dipoles x n_times].
+     *
+     * @return true if successful, false if the real-time inverse is not prepared or the dimensions do not match.
+     */
+    bool calculateInverseRealTime(const Eigen::MatrixXd &matData, Eigen::MatrixXd &matSol);
+
+    //=========================================================================================================
+    /**
+     * Get the source vertices of the prepared real-time inverse.
+     *
+     * @return the vertices of both hemispheres
+     */
+    inline const Eigen::VectorXi& getRealTimeVertices() const;
+
     //=========================================================================================================
     /**
      * Get the name of the inverse operator.
@@ -194,12 +228,29 @@ private:
     QList<Eigen::VectorXi> vertno;                  /**< The vertices numbers */
     FSLIB::Label label;                             /**< The corresponding labels */
     Eigen::MatrixXd K;                              /**< Imaging kernel */
+    bool m_bPickNormal;                             /**< Whether the kernel was assembled for the normal components only */
+
+    bool m_bRealTimeSetup;                          /**< Real-time inverse prepared */
+    bool m_bRealTimeCombineXyz;                     /**< Whether the real-time solution combines the xyz components */
+    bool m_bRealTimeAllChannels;                    /**< Whether the data channels match the kernel columns, so no picking is needed */
+    Eigen::MatrixXd m_matKernelRealTime;            /**< Imaging kernel with the noise normalization folded in */
+    Eigen::VectorXi m_vecChSelRealTime;             /**< Data row of each kernel column */
+    Eigen::VectorXi m_vecVerticesRealTime;          /**< The vertices of both hemispheres */
+    Eigen::MatrixXd m_matDataRealTime;              /**< Buffer for the picked data */
+    Eigen::MatrixXd m_matSolXyzRealTime;            /**< Buffer for the xyz components before they are combined */
 };
 
 //=============================================================================================================
 // INLINE DEFINITIONS
 //=============================================================================================================
 
+inline const Eigen::VectorXi& MinimumNorm::getRealTimeVertices() const
+{
+    return m_vecVerticesRealTime;
+}
+
+//=============================================================================================================
+
 inline Eigen::MatrixXd& MinimumNorm::getKernel()
 {
     return K;
@@ -96,4 +96,5 @@ MneProjData::~MneProjData()
     FREE_46(a);
     FREE_46(b);
     FREE_46(c);
+    FREE_46(act);
 }
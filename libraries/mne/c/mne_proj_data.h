@@ -42,6 +42,8 @@
 
 #include "../mne_global.h"
 
+#include <utils/kdtree.h>
+
 //=============================================================================================================
 // EIGEN INCLUDES
 //=============================================================================================================
@@ -51,6 +53,7 @@
 //=============================================================================================================
 
 #include <QSharedPointer>
+#include <QVector>
 
 //=============================================================================================================
 // DEFINE NAMESPACE MNELIB
@@ -96,6 +99,9 @@ public:
     int   *act;
     int   nactive;
 
+    UTILSLIB::KdTree::SPtr  vert_tree;     /* Spatial index over the vertices with neighboring triangles, built on first use */
+    QVector<int>            vert_tree_ids; /* Vertex numbers of the points in vert_tree */
+
 // ### OLD STRUCT ###
 //    typedef struct {
 //        float *a;
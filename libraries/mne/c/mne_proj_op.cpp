@@ -432,8 +432,8 @@ int MneProjOp::mne_proj_op_proj_vector(MneProjOp *op, float *vec, int nvec, int
      * Assume that all dimension checking etc. has been done before
      */
 {
-    static float *res = NULL;
-    int    res_size   = 0;
+    static thread_local float *res = NULL;
+    static thread_local int   res_size = 0;
     float *pvec;
     float  w;
     int k,p;
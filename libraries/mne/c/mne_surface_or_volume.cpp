@@ -1565,16 +1565,18 @@ void MneSurfaceOrVolume::decide_search_restriction(MneSurfaceOld* s,
         /*
         * Search for the closest vertex
         */
-        mindist = 1000.0;
-        minvert = 0;
-        for (k = 0; k < s->np; k++) {
-            VEC_DIFF_17(r,s->rr[k],diff);
-            dist = VEC_LEN_17(diff);
-            if (dist < mindist && s->nneighbor_tri[k] > 0) {
-                mindist = dist;
-                minvert = k;
-            }
+        if (!p->vert_tree) {
+            p->vert_tree_ids.clear();
+            for (k = 0; k < s->np; k++)
+                if (s->nneighbor_tri[k] > 0)
+                    p->vert_tree_ids.append(k);
+            MatrixX3f verts(p->vert_tree_ids.size(),3);
+            for (k = 0; k < p->vert_tree_ids.size(); k++)
+                verts.row(k) = Map<RowVector3f>(s->rr[p->vert_tree_ids[k]]);
+            p->vert_tree = UTILSLIB::KdTree::SPtr(new UTILSLIB::KdTree(verts));
         }
+        k = p->vert_tree->findNearest(Map<Vector3f>(r),dist);
+        minvert = k < 0 ? 0 : p->vert_tree_ids[k];
     }
     else {
         /*
@@ -2603,6 +2605,17 @@ int MneSurfaceOrVolume::add_geometry_info(MneSourceSpaceOld* s, int do_normals,
     if (do_normals)
         printf("and vertex ");
     printf("normals and neighboring triangles...");
+    /*
+       * Count the neighboring triangles first so that each list is allocated only once
+       */
+    for (p = 0, tri = s->tris; p < s->ntri; p++, tri++)
+        for (k = 0; k < 3; k++)
+            s->nneighbor_tri[tri->vert[k]]++;
+    for (k = 0; k < s->np; k++) {
+        if (s->nneighbor_tri[k] > 0)
+            s->neighbor_tri[k] = MALLOC_17(s->nneighbor_tri[k],int);
+        s->nneighbor_tri[k] = 0;
+    }
     for (p = 0, tri = s->tris; p < s->ntri; p++, tri++) {
         ii = tri->vert;
         w = 1.0;			/* This should be related to the triangle size */
@@ -2616,8 +2629,6 @@ int MneSurfaceOrVolume::add_geometry_info(MneSourceSpaceOld* s, int do_normals,
             /*
            * Add to the list of neighbors
            */
-            s->neighbor_tri[ii[k]] = REALLOC_17(s->neighbor_tri[ii[k]],
-                    s->nneighbor_tri[ii[k]]+1,int);
             s->neighbor_tri[ii[k]][s->nneighbor_tri[ii[k]]] = p;
             s->nneighbor_tri[ii[k]]++;
         }
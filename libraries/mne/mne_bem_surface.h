@@ -46,6 +46,8 @@
 #include <fiff/fiff_types.h>
 #include <fiff/fiff.h>
 
+#include <utils/meshadjacency.h>
+
 //=============================================================================================================
 // EIGEN INCLUDES
 //=============================================================================================================
@@ -166,8 +168,7 @@ public:
     Eigen::MatrixX3d tri_cent;         /**< Triangle centers */
     Eigen::MatrixX3d tri_nn;           /**< Triangle normals */
     Eigen::VectorXd tri_area;          /**< Triangle areas */
-    QVector<QVector<int> > neighbor_tri;           /**< Vector of neighboring triangles for each vertex */
-    QVector<QVector<int> > neighbor_vert;          /**< Vector of neighboring vertices for each vertex */
+    UTILSLIB::MeshAdjacency adjacency;  /**< Neighboring vertices and triangles of each vertex */
 };
 
 //=============================================================================================================
@@ -43,10 +43,14 @@
 
 #include <utils/mnemath.h>
 
+#include <algorithm>
+#include <vector>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
 
+#include <QFileDevice>
 #include <QPointer>
 #include <QtConcurrent>
 #include <QDebug>
@@ -121,51 +125,136 @@ MNEEpochDataList MNEEpochDataList::readEpochs(const FiffRawData& raw,
         }
     }
 
-    fiff_int_t event_samp, from, to;
-    fiff_int_t dropCount = 0;
-    MatrixXd timesDummy;
-    MatrixXd times;
-
-    QScopedPointer<MNEEpochData> epoch(Q_NULLPTR);
+    // Epoch bounds, in order of the events
+    QVector<fiff_int_t> vecFrom(count), vecTo(count);
+    fiff_int_t event_samp;
 
     for (p = 0; p < count; ++p) {
-        // Read a data segment
         event_samp = events(selected(p),0);
-        from = event_samp + tmin*raw.info.sfreq;
-        to   = event_samp + floor(tmax*raw.info.sfreq + 0.5);
+        vecFrom[p] = event_samp + tmin*raw.info.sfreq;
+        vecTo[p]   = event_samp + floor(tmax*raw.info.sfreq + 0.5);
+    }
 
-        epoch.reset(new MNEEpochData());
+    // Visit the epochs sorted by their first sample, so that the raw data can be read in one pass
+    QVector<qint32> vecOrder(count);
+    for (p = 0; p < count; ++p) {
+        vecOrder[p] = p;
+    }
+    std::stable_sort(vecOrder.begin(), vecOrder.end(), [&vecFrom](qint32 a, qint32 b) {
+        return vecFrom[a] < vecFrom[b];
+    });
+
+    // Epochs closer than one raw buffer are read together, so that no buffer is decoded twice. Bound the length of
+    // a read segment to limit its memory.
+    const fiff_int_t iMaxGap = raw.rawdir.isEmpty() ? 0 : raw.rawdir.first().nsamp;
+    const fiff_int_t iMaxSegment = std::max(static_cast<fiff_int_t>(10 * raw.info.sfreq),
+                                            vecTo[vecOrder.first()] - vecFrom[vecOrder.first()] + 1);
+
+    // Decode the raw buffers straight from a memory mapping if the data comes from a file. The copy shares the
+    // file and releases the mapping when it goes out of scope.
+    FiffRawData rawMapped(raw);
+    if(raw.file && qobject_cast<QFileDevice*>(raw.file->device())) {
+        rawMapped.mapRawData();
+    }
+
+    QVector<MNEEpochData::SPtr> vecEpochs(count);
+    MatrixXd matSegment, timesDummy;
+    qint32 iFirst = 0;
+
+    while (iFirst < count) {
+        // Skip epochs which are not completely inside the recording
+        const qint32 e = vecOrder[iFirst];
+        if (vecFrom[e] < raw.first_samp || vecTo[e] > raw.last_samp) {
+            qWarning("[MNEEpochDataList::readEpochs] Can't read the event data segments.");
+            ++iFirst;
+            continue;
+        }
 
-        if(raw.read_raw_segment(epoch->epoch, timesDummy, from, to, picksNew)) {
-            if (p == 0) {
-                times.resize(1, to-from+1);
-                for (qint32 i = 0; i < times.cols(); ++i)
-                    times(0, i) = ((float)(from-event_samp+i)) / raw.info.sfreq;
+        // Collect the following epochs which can be read with the same segment
+        fiff_int_t segFrom = vecFrom[e];
+        fiff_int_t segTo = vecTo[e];
+        qint32 iLast = iFirst + 1;
+
+        while (iLast < count) {
+            const qint32 n = vecOrder[iLast];
+            if (vecTo[n] > raw.last_samp
+                || vecFrom[n] > segTo + iMaxGap
+                || std::max(segTo, vecTo[n]) - segFrom + 1 > iMaxSegment) {
+                break;
             }
+            segTo = std::max(segTo, vecTo[n]);
+            ++iLast;
+        }
 
-            epoch->event = event;
-            epoch->tmin = tmin;
-            epoch->tmax = tmax;
+        // Read and project the segment once, then copy the epochs out of it
+        if (rawMapped.read_raw_segment(matSegment, timesDummy, segFrom, segTo, picksNew)) {
+            for (qint32 i = iFirst; i < iLast; ++i) {
+                const qint32 n = vecOrder[i];
 
-            epoch->bReject = checkForArtifact(epoch->epoch,
-                                              raw.info,
-                                              mapReject,
-                                              lExcludeChs);
+                MNEEpochData::SPtr pEpoch = MNEEpochData::SPtr::create();
+                pEpoch->epoch = matSegment.middleCols(vecFrom[n] - segFrom, vecTo[n] - vecFrom[n] + 1);
+                pEpoch->event = event;
+                pEpoch->tmin = tmin;
+                pEpoch->tmax = tmax;
+                pEpoch->bReject = false;
 
-            if (epoch->bReject) {
-                dropCount++;
+                vecEpochs[n] = pEpoch;
             }
+        } else {
+            qWarning("[MNEEpochDataList::readEpochs] Can't read the event data segments.");
+        }
+
+        iFirst = iLast;
+    }
 
-            //Check if data block has the same size as the previous one
-            if(!data.isEmpty()) {
-                if(epoch->epoch.size() == data.last()->epoch.size()) {
-                    data.append(MNEEpochData::SPtr(epoch.take()));//List takes ownwership of the pointer - no delete need
+    // Keep the order of the events. Only accept epochs of the same size as the first one.
+    for (p = 0; p < count; ++p) {
+        if (!vecEpochs[p]) {
+            continue;
+        }
+
+        if (data.isEmpty() || vecEpochs[p]->epoch.size() == data.last()->epoch.size()) {
+            data.append(vecEpochs[p]);
+        }
+    }
+
+    // Artifact rejection, the epochs are scanned in parallel
+    fiff_int_t dropCount = 0;
+
+    if (!mapReject.isEmpty() && !data.isEmpty()) {
+        const QList<ArtifactRejectionData> vecChannels = rejectionChannels(raw.info,
+                                                                           mapReject,
+                                                                           lExcludeChs);
+
+        if (vecChannels.isEmpty()) {
+            qWarning() << "[MNEEpochDataList::readEpochs] No channels found to scan for artifacts. Do not reject.";
+        } else {
+            std::vector<qint32> vecRejectChannel(data.size(), -1);
+            QVector<qint32> vecIdx(data.size());
+            for (p = 0; p < data.size(); ++p) {
+                vecIdx[p] = p;
+            }
+
+            QtConcurrent::blockingMap(vecIdx, [&](qint32 idx) {
+                const MatrixXd& matEpoch = data.at(idx)->epoch;
+
+                for (int c = 0; c < vecChannels.size(); ++c) {
+                    const int iRow = vecChannels.at(c).iChIdx;
+                    if (iRow < matEpoch.rows()
+                        && matEpoch.row(iRow).maxCoeff() - matEpoch.row(iRow).minCoeff() > vecChannels.at(c).dThreshold) {
+                        vecRejectChannel[idx] = c;
+                        break;
+                    }
+                }
+            });
+
+            for (p = 0; p < data.size(); ++p) {
+                if (vecRejectChannel[p] >= 0) {
+                    data[p]->bReject = true;
+                    dropCount++;
+                    qInfo().noquote() << "[MNEEpochDataList::readEpochs] Reject trial because of channel"<<vecChannels.at(vecRejectChannel[p]).sChName;
                 }
-            } else {
-                data.append(MNEEpochData::SPtr(epoch.take()));//List takes ownwership of the pointer - no delete need
             }
-        } else {
-            qWarning("[MNEEpochDataList::readEpochs] Can't read the event data segments.");
         }
     }
 
@@ -280,6 +369,43 @@ bool MNEEpochDataList::checkForArtifact(const MatrixXd& data,
     bool bReject = false;
 
     //Prepare concurrent data handling
+    QList<ArtifactRejectionData> lchData = rejectionChannels(pFiffInfo,
+                                                             mapReject,
+                                                             lExcludeChs);
+
+    for(int i = 0; i < lchData.size(); ++i) {
+        lchData[i].data = data.row(lchData.at(i).iChIdx);
+    }
+
+    if(lchData.isEmpty()) {
+        qWarning() << "[MNEEpochDataList::checkForArtifact] No channels found to scan for artifacts. Do not reject. Returning.";
+
+        return bReject;
+    }
+
+    //qDebug() << "MNEEpochDataList::checkForArtifact - lchData.size()" << lchData.size();
+
+    //Start the concurrent processing
+    QFuture<void> future = QtConcurrent::map(lchData, checkChThreshold);
+    future.waitForFinished();
+
+    for(int i = 0; i < lchData.size(); ++i) {
+        if(lchData.at(i).bRejected) {
+            bReject = true;
+            qInfo().noquote() << "[MNEEpochDataList::checkForArtifact] Reject trial because of channel"<<lchData.at(i).sChName;
+            break;
+        }
+    }
+
+    return bReject;
+}
+
+//=============================================================================================================
+
+QList<ArtifactRejectionData> MNEEpochDataList::rejectionChannels(const FiffInfo& pFiffInfo,
+                                                                 const QMap<QString,double>& mapReject,
+                                                                 const QStringList& lExcludeChs)
+{
     QList<ArtifactRejectionData> lchData;
     QList<int> lChTypes;
 
@@ -297,7 +423,7 @@ bool MNEEpochDataList::checkForArtifact(const MatrixXd& data,
     }
 
     if(lChTypes.isEmpty()) {
-        return bReject;
+        return lchData;
     }
 
     for(int i = 0; i < pFiffInfo.chs.size(); ++i) {
@@ -307,7 +433,7 @@ bool MNEEpochDataList::checkForArtifact(const MatrixXd& data,
            && pFiffInfo.chs.at(i).chpos.coil_type != FIFFV_COIL_BABY_REF_MAG
            && pFiffInfo.chs.at(i).chpos.coil_type != FIFFV_COIL_BABY_REF_MAG2) {
             ArtifactRejectionData tempData;
-            tempData.data = data.row(i);
+            tempData.iChIdx = i;
 
             switch (pFiffInfo.chs.at(i).kind) {
             case FIFFV_MEG_CH:
@@ -332,27 +458,7 @@ bool MNEEpochDataList::checkForArtifact(const MatrixXd& data,
         }
     }
 
-    if(lchData.isEmpty()) {
-        qWarning() << "[MNEEpochDataList::checkForArtifact] No channels found to scan for artifacts. Do not reject. Returning.";
-
-        return bReject;
-    }
-
-    //qDebug() << "MNEEpochDataList::checkForArtifact - lchData.size()" << lchData.size();
-
-    //Start the concurrent processing
-    QFuture<void> future = QtConcurrent::map(lchData, checkChThreshold);
-    future.waitForFinished();
-
-    for(int i = 0; i < lchData.size(); ++i) {
-        if(lchData.at(i).bRejected) {
-            bReject = true;
-            qInfo().noquote() << "[MNEEpochDataList::checkForArtifact] Reject trial because of channel"<<lchData.at(i).sChName;
-            break;
-        }
-    }
-
-    return bReject;
+    return lchData;
 }
 
 //=============================================================================================================
@@ -67,6 +67,7 @@ struct ArtifactRejectionData {
     Eigen::RowVectorXd data;
     double dThreshold;
     QString sChName;
+    int iChIdx = -1;
 };
 
 //=============================================================================================================
@@ -170,6 +171,22 @@ public:
                                  const QStringList &lExcludeChs = QStringList());
 
     static void checkChThreshold(ArtifactRejectionData& inputData);
+
+private:
+    //=========================================================================================================
+    /**
+     * Selects the channels which are scanned for artifacts, together with their thresholds. The data rows are
+     * left empty.
+     *
+     * @param[in] pFiffInfo      The fiff info.
+     * @param[in] mapReject      The channel data types to scan for. EEG, MEG or EOG.
+     * @param[in] lExcludeChs    List of channel names to exclude.
+     *
+     * @return   The channels to scan.
+     */
+    static QList<ArtifactRejectionData> rejectionChannels(const FIFFLIB::FiffInfo& pFiffInfo,
+                                                          const QMap<QString,double>& mapReject,
+                                                          const QStringList& lExcludeChs);
 };
 } // NAMESPACE
 
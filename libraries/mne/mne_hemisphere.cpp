@@ -45,6 +45,7 @@
 //=============================================================================================================
 
 using namespace MNELIB;
+using namespace UTILSLIB;
 using namespace Eigen;
 using namespace FIFFLIB;
 
@@ -110,8 +111,7 @@ MNEHemisphere::MNEHemisphere(const MNEHemisphere& p_MNEHemisphere)
 , use_tri_cent(p_MNEHemisphere.use_tri_cent)
 , use_tri_nn(p_MNEHemisphere.use_tri_nn)
 , use_tri_area(p_MNEHemisphere.use_tri_area)
-, neighbor_tri(p_MNEHemisphere.neighbor_tri)
-, neighbor_vert(p_MNEHemisphere.neighbor_vert)
+, adjacency(p_MNEHemisphere.adjacency)
 , cluster_info(p_MNEHemisphere.cluster_info)
 , m_TriCoords(p_MNEHemisphere.m_TriCoords)
 {
@@ -128,45 +128,8 @@ MNEHemisphere::~MNEHemisphere()
 
 bool MNEHemisphere::add_geometry_info()
 {
-    int k,c,p,q;
-    bool found;
-
-    //Create neighboring triangle vector
-    neighbor_tri = QVector<QVector<int> >(this->tris.rows());
-
-    //Create neighbor_tri information
-    for (p = 0; p < this->tris.rows(); p++) {
-        for (k = 0; k < 3; k++) {
-            this->neighbor_tri[this->tris(p,k)].append(p);
-        }
-    }
-
-    //Create the neighboring vertices vector
-    neighbor_vert = QVector<QVector<int> >(this->np);
-
-    for (k = 0; k < this->np; k++) {
-        for (p = 0; p < this->neighbor_tri[k].size(); p++) {
-            //Fit in the other vertices of the neighboring triangle
-            for (c = 0; c < 3; c++) {
-                int vert = this->tris(this->neighbor_tri[k][p], c);
-
-                if (vert != k) {
-                    found = false;
-
-                    for (q = 0; q < this->neighbor_vert[k].size(); q++) {
-                        if (this->neighbor_vert[k][q] == vert) {
-                            found = true;
-                            break;
-                        }
-                    }
-
-                    if(!found) {
-                        this->neighbor_vert[k].append(vert);
-                    }
-                }
-            }
-        }
-    }
+    //Create the neighboring triangles and vertices in one linear pass, in the order of the former per vertex search
+    adjacency = MeshAdjacency(this->tris, this->np);
 
     return true;
 }
@@ -201,8 +164,7 @@ void MNEHemisphere::clear()
     use_tri_nn = MatrixX3d::Zero(0,3);
     use_tri_area = VectorXd::Zero(0);
 
-    neighbor_tri.clear();
-    neighbor_vert.clear();
+    adjacency = MeshAdjacency();
 
     cluster_info.clear();
 
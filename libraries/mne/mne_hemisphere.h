@@ -47,6 +47,8 @@
 #include <fiff/fiff_types.h>
 #include <fiff/fiff.h>
 
+#include <utils/meshadjacency.h>
+
 //=============================================================================================================
 // EIGEN INCLUDES
 //=============================================================================================================
@@ -203,8 +205,7 @@ public:
     Eigen::MatrixX3d use_tri_nn;        /**< Triangle normals of used triangles */
     Eigen::VectorXd use_tri_area;       /**< Triangle areas of used triangles */
 
-    QVector<QVector<int> > neighbor_tri;           /**< Vector of neighboring triangles for each vertex */
-    QVector<QVector<int> > neighbor_vert;          /**< Vector of neighboring vertices for each vertex */
+    UTILSLIB::MeshAdjacency adjacency;  /**< Neighboring vertices and triangles of each vertex */
 
     MNEClusterInfo cluster_info; /**< Holds the cluster information. */
 private:
@@ -259,8 +260,7 @@ inline bool operator== (const MNEHemisphere &a, const MNEHemisphere &b)
             a.use_tri_cent.isApprox(b.use_tri_cent, 0.0001) &&
             a.use_tri_nn.isApprox(b.use_tri_nn, 0.0001) &&
             a.use_tri_area.isApprox(b.use_tri_area, 0.0001) &&
-            a.neighbor_tri == b.neighbor_tri &&
-            a.neighbor_vert == b.neighbor_vert &&
+            a.adjacency == b.adjacency &&
             a.cluster_info == b.cluster_info &&
             a.m_TriCoords.isApprox(b.m_TriCoords, 0.0001f));
 }
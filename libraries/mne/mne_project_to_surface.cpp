@@ -46,6 +46,8 @@
 #include <mne/mne_bem_surface.h>
 #include <mne/mne_surface.h>
 
+#include <algorithm>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
@@ -80,6 +82,7 @@ MNEProjectToSurface::MNEProjectToSurface()
 , b(VectorXf::Zero(1))
 , c(VectorXf::Zero(1))
 , det(VectorXf::Zero(1))
+, maxTriRadius(0.0f)
 {
 }
 
@@ -94,6 +97,7 @@ MNEProjectToSurface::MNEProjectToSurface(const MNEBemSurface &p_MNEBemSurf)
 , b(VectorXf::Zero(p_MNEBemSurf.ntri))
 , c(VectorXf::Zero(p_MNEBemSurf.ntri))
 , det(VectorXf::Zero(p_MNEBemSurf.ntri))
+, maxTriRadius(0.0f)
 {
     for (int i = 0; i < p_MNEBemSurf.ntri; ++i)
     {
@@ -113,10 +117,12 @@ MNEProjectToSurface::MNEProjectToSurface(const MNEBemSurface &p_MNEBemSurf)
     {
         for (int i = 0; i < p_MNEBemSurf.ntri; ++i)
         {
-            nn.row(i) = r12.row(i).transpose().cross(r13.row(i).transpose()).transpose();
+            nn.row(i) = r12.row(i).transpose().cross(r13.row(i).transpose()).normalized().transpose();
         }
     }
     det = (a.array()*b.array() - c.array()*c.array()).matrix();
+
+    init_search_tree();
 }
 
 //=============================================================================================================
@@ -130,19 +136,22 @@ MNEProjectToSurface::MNEProjectToSurface(const MNESurface &p_MNESurf)
 , b(VectorXf::Zero(p_MNESurf.ntri))
 , c(VectorXf::Zero(p_MNESurf.ntri))
 , det(VectorXf::Zero(p_MNESurf.ntri))
+, maxTriRadius(0.0f)
 {
     for (int i = 0; i < p_MNESurf.ntri; ++i)
     {
         r1.row(i) = p_MNESurf.rr.row(p_MNESurf.tris(i,0));
         r12.row(i) = p_MNESurf.rr.row(p_MNESurf.tris(i,1)) - r1.row(i);
         r13.row(i) = p_MNESurf.rr.row(p_MNESurf.tris(i,2)) - r1.row(i);
-        nn.row(i) = r12.row(i).transpose().cross(r13.row(i).transpose()).transpose();
+        nn.row(i) = r12.row(i).transpose().cross(r13.row(i).transpose()).normalized().transpose();
         a(i) = r12.row(i) * r12.row(i).transpose();
         b(i) = r13.row(i) * r13.row(i).transpose();
         c(i) = r12.row(i) * r13.row(i).transpose();
     }
 
     det = (a.array()*b.array() - c.array()*c.array()).matrix();
+
+    init_search_tree();
 }
 
 //=============================================================================================================
@@ -162,10 +171,6 @@ bool MNEProjectToSurface::mne_find_closest_on_surface(const MatrixXf &r, const i
     Vector3f rTriK;
     for (int k = 0; k < np; ++k)
     {
-        /*
-         * To do: decide_search_restriction for the use in an iterative closest point to plane algorithm
-         * For now it's OK to go through all triangles.
-         */
         if (!this->mne_project_to_surface(r.row(k).transpose(), rTriK, bestTri, bestDist))
         {
             qDebug() << "The projection of point number " << k << " didn't work./n";
@@ -185,7 +190,23 @@ bool MNEProjectToSurface::mne_project_to_surface(const Vector3f &r, Vector3f &rT
     float p = 0, q = 0, p0 = 0, q0 = 0, dist0 = 0;
     bestDist = 0.0f;
     bestTri = -1;
-    for (int tri = 0; tri < a .size(); ++tri)
+
+    /*
+     * The triangle with the closest centroid gives an upper bound for the distance to the surface.
+     * Every triangle which can be closer has its centroid within this bound plus the triangle radius.
+     */
+    float centroidDist;
+    int startTri = this->centroidTree.findNearest(r, centroidDist);
+    if (startTri < 0 || !this->nearest_triangle_point(r, startTri, p0, q0, dist0))
+    {
+        qDebug() << "No best Triangle found./n";
+        return false;
+    }
+    // small margin for the rounding in the triangle distances
+    const float searchRadius = 1.001f * (std::fabs(dist0) + this->maxTriRadius);
+
+    const QVector<int> candidates = this->centroidTree.findInRadius(r, searchRadius);
+    for (int tri : candidates)
     {
         if (!this->nearest_triangle_point(r, tri, p0, q0, dist0))
         {
@@ -331,3 +352,21 @@ bool MNEProjectToSurface::project_to_triangle(Vector3f &rTri, const float p, con
     rTri = this->r1.row(tri) + p*this->r12.row(tri) + q*this->r13.row(tri);
     return true;
 }
+
+//=============================================================================================================
+
+void MNEProjectToSurface::init_search_tree()
+{
+    MatrixX3f centroids = r1 + (r12 + r13) / 3.0f;
+
+    maxTriRadius = 0.0f;
+    for (int i = 0; i < centroids.rows(); ++i)
+    {
+        const RowVector3f rc = r1.row(i) - centroids.row(i);
+        maxTriRadius = std::max(maxTriRadius, rc.norm());
+        maxTriRadius = std::max(maxTriRadius, (rc + r12.row(i)).norm());
+        maxTriRadius = std::max(maxTriRadius, (rc + r13.row(i)).norm());
+    }
+
+    centroidTree = UTILSLIB::KdTree(centroids);
+}
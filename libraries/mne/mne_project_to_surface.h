@@ -42,6 +42,8 @@
 
 #include "mne_global.h"
 
+#include <utils/kdtree.h>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
@@ -175,6 +177,12 @@ private:
      */
     bool project_to_triangle(Eigen::Vector3f &rTri, const float p, const float q, const int tri);
 
+    //=========================================================================================================
+    /**
+     * Builds the spatial index over the triangle centroids. Needs r1, r12 and r13.
+     */
+    void init_search_tree();
+
     Eigen::MatrixX3f r1;         /**< Cartesian Vector to the first triangel corner */
     Eigen::MatrixX3f r12;        /**< Cartesian Vector from the first to the second triangel corner */
     Eigen::MatrixX3f r13;        /**< Cartesian Vector from the first to the third triangel corner */
@@ -183,6 +191,8 @@ private:
     Eigen::VectorXf b;           /**< r13*r13 */
     Eigen::VectorXf c;           /**< r12*r13 */
     Eigen::VectorXf det;         /**< Determinant of the Matrix [a c, c b] */
+    UTILSLIB::KdTree centroidTree;   /**< Spatial index over the triangle centroids */
+    float maxTriRadius;              /**< Largest distance between a triangle centroid and its corners */
 };
 
 //=============================================================================================================
@@ -42,11 +42,17 @@
 #include <utils/mnemath.h>
 #include <fiff/fiff_raw_data.h>
 
+#include <utils/generics/ringbuffer.h>
+
+#include <atomic>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
 
 #include <QDebug>
+#include <QThread>
+#include <QThreadPool>
 
 //=============================================================================================================
 // EIGEN INCLUDES
@@ -63,6 +69,120 @@ using namespace RTPROCESSINGLIB;
 using namespace Eigen;
 using namespace FIFFLIB;
 using namespace UTILSLIB;
+using namespace IOBUFFER;
+
+//=============================================================================================================
+// DEFINE STATIC METHODS
+//=============================================================================================================
+
+/**
+ * Slice of raw data which is passed between the read, filter and write stage of filterFile.
+ */
+typedef struct {
+    MatrixXd matData;
+    fiff_int_t first;
+    fiff_int_t last;
+    bool bFinished;
+    bool bError;
+} FilterFileBlock;
+
+//=============================================================================================================
+
+/**
+ * Reads the samples block.first to block.last into block.matData.
+ */
+static bool readFilterFileBlock(FiffRawData* pFiffRawData,
+                                FilterFileBlock& block)
+{
+    SparseMatrix<double> mult;
+    RowVectorXi sel;
+    MatrixXd times;
+
+    return pFiffRawData->read_raw_segment(block.matData, times, mult, block.first, block.last, sel);
+}
+
+//=============================================================================================================
+
+/**
+ * Pushes the block to the queue. Blocks while the queue is full, unless pStop was set by the consumer.
+ */
+static bool pushFilterFileBlock(FilterFileBlock& block,
+                                RingBuffer<FilterFileBlock>* pQueue,
+                                const std::atomic<bool>* pStop)
+{
+    while(!pQueue->push(std::move(block))) {
+        if(pStop->load()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//=============================================================================================================
+
+/**
+ * Reads the data slice by slice and pushes it to the queue. The last element is marked as finished. Returns early
+ * if pStop is set while the queue is full.
+ */
+static void readFilterFileBlocks(FiffRawData* pFiffRawData,
+                                 fiff_int_t from,
+                                 fiff_int_t to,
+                                 fiff_int_t quantum,
+                                 RingBuffer<FilterFileBlock>* pQueue,
+                                 const std::atomic<bool>* pStop)
+{
+    FilterFileBlock block;
+
+    for(fiff_int_t first = from; first <= to; first += quantum) {
+        block.first = first;
+        block.last = std::min(first + quantum - 1, to);
+        block.bFinished = false;
+        block.bError = !readFilterFileBlock(pFiffRawData, block);
+
+        bool bError = block.bError;
+        if(!pushFilterFileBlock(block, pQueue, pStop) || bError) {
+            return;
+        }
+    }
+
+    block.bFinished = true;
+    block.bError = false;
+    block.matData.resize(0,0);
+    pushFilterFileBlock(block, pQueue, pStop);
+}
+
+//=============================================================================================================
+
+/**
+ * Writes the blocks from the queue until a finished element arrives. The queue blocks while it is empty. Returns
+ * false if pStop is set while the queue is empty, i.e. the producer is gone without a finished element.
+ */
+static bool writeFilterFileBlocks(FiffStream* pOutfid,
+                                  const RowVectorXd* pCals,
+                                  RingBuffer<FilterFileBlock>* pQueue,
+                                  const std::atomic<bool>* pStop)
+{
+    FilterFileBlock block;
+    bool bSuccess = true;
+    bool bPopped;
+
+    while(true) {
+        while(!(bPopped = pQueue->pop(block)) && !pStop->load()) {}
+        if(!bPopped && !pQueue->tryPop(block)) {
+            return false;
+        }
+
+        if(block.bFinished) {
+            return bSuccess;
+        }
+
+        // Keep consuming after an error, so the filter stage does not block on a full queue
+        if(bSuccess) {
+            bSuccess = pOutfid->write_raw_buffer(block.matData, *pCals);
+        }
+    }
+}
 
 //=============================================================================================================
 // DEFINE GLOBAL RTPROCESSINGLIB METHODS
@@ -110,51 +230,187 @@ bool RTPROCESSINGLIB::filterFile(QIODevice &pIODevice,
                                  const RowVectorXi& vecPicks,
                                  bool bUseThreads)
 {
-    int iOrder = filterKernel.getFilterOrder();
+    // Keep one context for all slices, so the coefficients are only transformed once
+    FilterFftContext filterContext;
+    filterContext.setFilterKernel(filterKernel);
+    int iOrder = filterContext.getFilterOrder();
 
     RowVectorXd cals;
-    SparseMatrix<double> mult;
-    RowVectorXi sel;
     FiffStream::SPtr outfid = FiffStream::start_writing_raw(pIODevice, pFiffRawData->info, cals);
 
     //Setup reading parameters
     fiff_int_t from = pFiffRawData->first_samp;
     fiff_int_t to = pFiffRawData->last_samp;
 
-    // slice input data into data junks with proper length so that the slices are always >= the filter order
-    float fFactor = 2.0f;
-    int iSize = fFactor * iOrder;
-    int residual = (to - from) % iSize;
-    while(residual < iOrder) {
-        fFactor = fFactor - 0.1f;
-        iSize = fFactor * iOrder;
-        residual = (to - from) % iSize;
-
-        if((iSize < iOrder)) {
-            qInfo() << "[Filter::filterData] Sliced data block size is too small. Filtering whole block at once.";
-            iSize = to - from;
+    // Slice the data into blocks of 10 seconds, but at least the filter order
+    float quantum_sec = 10.0f;
+    fiff_int_t quantum = std::max(fiff_int_t(ceil(quantum_sec*pFiffRawData->info.sfreq)), fiff_int_t(iOrder));
+
+    if (from > 0) {
+        outfid->write_int(FIFF_FIRST_SAMPLE,&from);
+    }
+
+    // With threads the slices are read and written in their own threads while the current slice is filtered.
+    // The stages are connected by bounded queues, so only a few slices are held in memory. Waiting stages sleep
+    // on the queues. Every stage marks its last element as finished, so no stage waits for a stage that is done.
+    // The stages wait for each other, so they run in a private pool which guarantees each of them a thread,
+    // independent of the size and load of the global pool.
+    RingBuffer<FilterFileBlock> readQueue(3);
+    RingBuffer<FilterFileBlock> writeQueue(3);
+    std::atomic<bool> bStopReading(false);
+    std::atomic<bool> bStopWriting(false);
+    QThreadPool stagePool;
+    QFuture<void> readFuture;
+    QFuture<bool> writeFuture;
+
+    if(bUseThreads) {
+        stagePool.setMaxThreadCount(2);
+
+        readFuture = QtConcurrent::run(&stagePool,
+                                       readFilterFileBlocks,
+                                       pFiffRawData.data(),
+                                       from,
+                                       to,
+                                       quantum,
+                                       &readQueue,
+                                       &bStopReading);
+        writeFuture = QtConcurrent::run(&stagePool,
+                                        writeFilterFileBlocks,
+                                        outfid.data(),
+                                        &cals,
+                                        &writeQueue,
+                                        &bStopWriting);
+    }
+
+    // Filter the slices and do the overlap add. The output of a slice is complete up to the start of the next
+    // slice, the filter tail is kept and added to the next slice. Half the filter length at the very beginning
+    // belongs to the filter delay and is skipped.
+    FilterFileBlock block;
+    MatrixXd matOverlap;
+    int iSkip = iOrder/2;
+    bool bSuccess = true;
+
+    for(fiff_int_t first = from; first <= to; first += quantum) {
+        if(bUseThreads) {
+            // the reader always ends with a finished or error element, if it is gone without one give up
+            bool bPopped = false;
+            while(!(bPopped = readQueue.pop(block)) && !readFuture.isFinished()) {}
+            if(!bPopped && !readQueue.tryPop(block)) {
+                bSuccess = false;
+                break;
+            }
+        } else {
+            block.first = first;
+            block.last = std::min(first + quantum - 1, to);
+            block.bError = !readFilterFileBlock(pFiffRawData.data(), block);
+            block.bFinished = false;
+        }
+
+        if(block.bError || block.bFinished) {
+            bSuccess = !block.bError;
             break;
         }
+
+        qInfo() << "Filtering and writing block" << block.first << "to" << block.last;
+
+        int iNumSamples = block.matData.cols();
+        MatrixXd matFiltered = filterContext.calculate(block.matData,
+                                                       vecPicks,
+                                                       bUseThreads);
+
+        if(matOverlap.rows() == matFiltered.rows()) {
+            matFiltered.leftCols(iOrder) += matOverlap;
+        }
+        matOverlap = matFiltered.rightCols(iOrder);
+
+        int iSkipNow = std::min(iSkip, iNumSamples);
+        iSkip -= iSkipNow;
+
+        block.matData = matFiltered.block(0, iSkipNow, matFiltered.rows(), iNumSamples - iSkipNow);
+
+        // The last slice also completes the filter delay at the end of the data
+        if(block.last >= to) {
+            block.matData.conservativeResize(NoChange, block.matData.cols() + iOrder/2);
+            block.matData.rightCols(iOrder/2) = matOverlap.leftCols(iOrder/2);
+        }
+
+        if(bUseThreads) {
+            bool bPushed = false;
+            while(!(bPushed = writeQueue.push(std::move(block))) && !writeFuture.isFinished()) {}
+            if(!bPushed) {
+                bSuccess = false;
+                break;
+            }
+        } else if(!outfid->write_raw_buffer(block.matData, cals)) {
+            bSuccess = false;
+            break;
+        }
+    }
+
+    if(bUseThreads) {
+        // Stop the reader, it leaves a full queue within one wait timeout
+        bStopReading.store(true);
+
+        // Stop the writer and wait for both stages
+        block.bFinished = true;
+        block.bError = false;
+        block.matData.resize(0,0);
+        while(!writeQueue.push(std::move(block)) && !writeFuture.isFinished()) {}
+        bStopWriting.store(true);
+
+        readFuture.waitForFinished();
+        bSuccess = writeFuture.result() && bSuccess;
     }
 
-    float quantum_sec = iSize/pFiffRawData->info.sfreq;
+    if(!bSuccess) {
+        qWarning("[Filter::filterFile] Error during reading or writing the data\n");
+        return false;
+    }
+
+    outfid->finish_writing_raw();
+
+    return true;
+}
+
+//=============================================================================================================
+
+bool RTPROCESSINGLIB::filterFile(QIODevice &pIODevice,
+                                 QSharedPointer<FiffRawData> pFiffRawData,
+                                 const IirFilter& iirFilter,
+                                 const RowVectorXi& vecPicks)
+{
+    RowVectorXd cals;
+    SparseMatrix<double> mult;
+    RowVectorXi sel;
+    FiffStream::SPtr outfid = FiffStream::start_writing_raw(pIODevice, pFiffRawData->info, cals);
+
+    //Setup reading parameters
+    fiff_int_t from = pFiffRawData->first_samp;
+    fiff_int_t to = pFiffRawData->last_samp;
+
+    // Read each slice with the settling length of the filter in front and back, so the forward and backward
+    // pass have settled when they reach the part which is written
+    float quantum_sec = 10.0f;
     fiff_int_t quantum = ceil(quantum_sec*pFiffRawData->info.sfreq);
+    fiff_int_t margin = std::min(iirFilter.getSettlingLength(), quantum);
 
-    // Read, filter and write the data
     bool first_buffer = true;
 
-    fiff_int_t first, last;
-    MatrixXd matData, matDataOverlap;
+    fiff_int_t first, last, readFirst, readLast;
+    MatrixXd matData;
     MatrixXd times;
 
-    for(first = from; first < to; first+=quantum) {
+    for(first = from; first <= to; first+=quantum) {
         last = first+quantum-1;
         if (last > to) {
             last = to;
         }
 
-        if (!pFiffRawData->read_raw_segment(matData, times, mult, first, last, sel)) {
-            qWarning("[Filter::filterData] Error during read_raw_segment\n");
+        readFirst = std::max(first - margin, from);
+        readLast = std::min(last + margin, to);
+
+        if (!pFiffRawData->read_raw_segment(matData, times, mult, readFirst, readLast, sel)) {
+            qWarning("[Filter::filterFile] Error during read_raw_segment\n");
             return false;
         }
 
@@ -167,22 +423,14 @@ bool RTPROCESSINGLIB::filterFile(QIODevice &pIODevice,
            first_buffer = false;
         }
 
-        matData = filterDataBlock(matData,
-                                  vecPicks,
-                                  filterKernel,
-                                  bUseThreads);
+        matData = filterData(matData,
+                             iirFilter,
+                             vecPicks);
 
-        if(first == from) {
-            outfid->write_raw_buffer(matData.block(0,iOrder/2,matData.rows(),matData.cols()-iOrder), cals);
-        } else if(first + quantum >= to) {
-            matData.block(0,0,matData.rows(),iOrder) += matDataOverlap;
-            outfid->write_raw_buffer(matData.block(0,0,matData.rows(),matData.cols()-iOrder), cals);
-        } else {
-            matData.block(0,0,matData.rows(),iOrder) += matDataOverlap;
-            outfid->write_raw_buffer(matData.block(0,0,matData.rows(),matData.cols()-iOrder), cals);
+        if (!outfid->write_raw_buffer(matData.block(0,first-readFirst,matData.rows(),last-first+1), cals)) {
+            qWarning("[Filter::filterFile] Error during write_raw_buffer\n");
+            return false;
         }
-
-        matDataOverlap = matData.block(0,matData.cols()-iOrder,matData.rows(),iOrder);
     }
 
     outfid->finish_writing_raw();
@@ -248,63 +496,44 @@ MatrixXd RTPROCESSINGLIB::filterData(const MatrixXd& mataData,
         return mataData;
     }
 
-    // Create output matrix with size of input matrix
-    MatrixXd matDataOut(mataData.rows(), mataData.cols()+iOrder);
-    matDataOut.setZero();
-    MatrixXd sliceFiltered;
+    FilterFftContext filterContext;
+    filterContext.setFilterKernel(filterKernel);
 
-    // slice input data into data junks with proper length so that the slices are always >= the filter order
-    float fFactor = 2.0f;
-    int iSize = fFactor * iOrder;
-    int residual = mataData.cols() % iSize;
-    while(residual < iOrder) {
-        fFactor = fFactor - 0.1f;
-        iSize = fFactor * iOrder;
-        residual = mataData.cols() % iSize;
+    MatrixXd matDataOut = filterContext.calculate(mataData,
+                                                  vecPicks,
+                                                  bUseThreads);
 
-        if(iSize < iOrder) {
-            iSize = mataData.cols();
-            break;
-        }
+    if(bKeepOverhead) {
+        return matDataOut;
+    } else {
+        return matDataOut.block(0,iOrder/2,matDataOut.rows(),mataData.cols());
     }
+}
 
-    if(mataData.cols() > iSize) {
-        int from = 0;
-        int numSlices = ceil(float(mataData.cols())/float(iSize)); //calculate number of data slices
-
-        for (int i = 0; i < numSlices; i++) {
-            if(i == numSlices-1) {
-                //catch the last one that might be shorter than the other blocks
-                iSize = mataData.cols() - (iSize * (numSlices -1));
-            }
+//=============================================================================================================
 
-            // Filter the data block. This will return data with a fitler delay of iOrder/2 in front and back
-            sliceFiltered = filterDataBlock(mataData.block(0,from,mataData.rows(),iSize),
-                                            vecPicks,
-                                            filterKernel,
-                                            bUseThreads);
-
-            // Perform overlap add
-            if(i == 0) {
-                matDataOut.block(0,0,mataData.rows(),sliceFiltered.cols()) += sliceFiltered;
-            } else {
-                matDataOut.block(0,from,mataData.rows(),sliceFiltered.cols()) += sliceFiltered;
-            }
+MatrixXd RTPROCESSINGLIB::filterData(const MatrixXd& matData,
+                                     const IirFilter& iirFilter,
+                                     const RowVectorXi& vecPicks)
+{
+    if(vecPicks.cols() == 0) {
+        return iirFilter.filterZeroPhase(matData);
+    }
 
-            from += iSize;
-        }
-    } else {
-        matDataOut = filterDataBlock(mataData,
-                                     vecPicks,
-                                     filterKernel,
-                                     bUseThreads);
+    // Only filter the picked channels. All of them are passed through the filter at once.
+    MatrixXd matPicked(vecPicks.cols(), matData.cols());
+    for(int i = 0; i < vecPicks.cols(); ++i) {
+        matPicked.row(i) = matData.row(vecPicks[i]);
     }
 
-    if(bKeepOverhead) {
-        return matDataOut;
-    } else {
-        return matDataOut.block(0,iOrder/2,matDataOut.rows(),mataData.cols());
+    matPicked = iirFilter.filterZeroPhase(matPicked);
+
+    MatrixXd matDataOut = matData;
+    for(int i = 0; i < vecPicks.cols(); ++i) {
+        matDataOut.row(vecPicks[i]) = matPicked.row(i);
     }
+
+    return matDataOut;
 }
 
 //=============================================================================================================
@@ -322,49 +551,139 @@ MatrixXd RTPROCESSINGLIB::filterDataBlock(const MatrixXd& mataData,
         return mataData;
     }
 
-    // Setup filters to the correct length, so we do not have to do this everytime we call the FFT filter function
-    FilterKernel filterKernelSetup = filterKernel;
-    filterKernelSetup.prepareFilter(mataData.cols());
+    FilterFftContext filterContext;
+    filterContext.setFilterKernel(filterKernel);
+
+    return filterContext.calculate(mataData,
+                                   vecPicks,
+                                   bUseThreads);
+}
+
+//=============================================================================================================
+
+void RTPROCESSINGLIB::filterChannel(RTPROCESSINGLIB::FilterObject& channelDataTime)
+{
+    //channelDataTime.vecData = channelDataTime.first.at(i).applyConvFilter(channelDataTime.vecData, true);
+    channelDataTime.filterKernel.applyFftFilter(channelDataTime.vecData, true); //FFT Convolution for rt is not suitable. FFT make the signal filtering non causal.
+}
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
 
-    // Do the concurrent filtering
-    RowVectorXi vecPicksNew = vecPicks;
-    if(vecPicksNew.cols() == 0) {
-        vecPicksNew = RowVectorXi::LinSpaced(mataData.rows(), 0, mataData.rows());
+FilterFftContext::FilterFftContext()
+: m_vecWorkers(std::max(QThread::idealThreadCount(), 1))
+, m_iFilterOrder(0)
+, m_iFftLength(0)
+{
+    #ifdef EIGEN_FFTW_DEFAULT
+    fftw_make_planner_thread_safe();
+    #endif
+
+    m_fftCoeff.SetFlag(m_fftCoeff.HalfSpectrum);
+
+    for(FilterFftWorker& worker : m_vecWorkers) {
+        worker.fft.SetFlag(worker.fft.HalfSpectrum);
+        worker.pMatData = Q_NULLPTR;
+        worker.pMatDataOut = Q_NULLPTR;
+        worker.pVecFftCoeff = Q_NULLPTR;
+        worker.iFftLength = 0;
+        worker.iFilterOrder = 0;
     }
+}
+
+//=============================================================================================================
+
+void FilterFftContext::setFilterKernel(const FilterKernel& filterKernel)
+{
+    setFilterKernels(QList<FilterKernel>() << filterKernel);
+}
 
-    // Generate QList structure which can be handled by the QConcurrent framework
-    QList<FilterObject> timeData;
+//=============================================================================================================
 
-    // Only select channels specified in vecPicksNew
-    FilterObject data;
-    for(qint32 i = 0; i < vecPicksNew.cols(); ++i) {
-        data.filterKernel = filterKernelSetup;
-        data.iRow = vecPicksNew[i];
-        data.vecData = mataData.row(vecPicksNew[i]);
-        timeData.append(data);
+void FilterFftContext::setFilterKernels(const QList<FilterKernel>& lFilterKernels)
+{
+    // Only start over if the coefficients changed
+    bool bChanged = lFilterKernels.size() != m_lCoefficients.size();
+
+    for(int i = 0; i < lFilterKernels.size() && !bChanged; ++i) {
+        const RowVectorXd vecCoeff = lFilterKernels.at(i).getCoefficients();
+        bChanged = vecCoeff.cols() != m_lCoefficients.at(i).cols() || vecCoeff != m_lCoefficients.at(i);
+    }
+
+    if(!bChanged) {
+        return;
     }
 
-    // Copy in data from last data block. This is necessary in order to also delay channels which are not filtered
-    MatrixXd matDataOut(mataData.rows(), mataData.cols()+iOrder);
-    matDataOut.setZero();
-    matDataOut.block(0, iOrder/2, mataData.rows(), mataData.cols()) = mataData;
+    m_lCoefficients.clear();
+    m_iFilterOrder = 0;
 
-    if(bUseThreads) {
-        QFuture<void> future = QtConcurrent::map(timeData,
-                                                 filterChannel);
-        future.waitForFinished();
+    for(int i = 0; i < lFilterKernels.size(); ++i) {
+        m_lCoefficients.append(lFilterKernels.at(i).getCoefficients());
+        m_iFilterOrder += m_lCoefficients.last().cols();
+    }
+
+    m_vecFftCoeff.resize(0);
+    m_iFftLength = 0;
+}
+
+//=============================================================================================================
+
+MatrixXd FilterFftContext::calculate(const MatrixXd& matData,
+                                     const RowVectorXi& vecPicks,
+                                     bool bUseThreads)
+{
+    int iOrder = m_iFilterOrder;
+
+    // Not picked channels are only delayed by half the filter length
+    MatrixXd matDataOut = MatrixXd::Zero(matData.rows(), matData.cols() + iOrder);
+    matDataOut.block(0, iOrder/2, matData.rows(), matData.cols()) = matData;
+
+    if(m_lCoefficients.isEmpty() || matData.cols() == 0) {
+        return matDataOut;
+    }
+
+    // Grow the FFT length with the data up to four times the filter order. Longer data is split into blocks of
+    // FFT length minus filter order.
+    int iMinLength = std::min(int(matData.cols()), 3 * iOrder) + iOrder;
+    if(m_iFftLength < iMinLength && m_iFftLength < getFastFftLength(4 * iOrder)) {
+        prepareFftLength(getFastFftLength(iMinLength));
+    }
+
+    QVector<int> vecRows;
+    if(vecPicks.cols() == 0) {
+        for(int i = 0; i < matData.rows(); ++i) {
+            vecRows.append(i);
+        }
     } else {
-        for(int i = 0; i < timeData.size(); ++i) {
-            filterChannel(timeData[i]);
+        for(int i = 0; i < vecPicks.cols(); ++i) {
+            if(vecPicks[i] >= 0 && vecPicks[i] < matData.rows()) {
+                vecRows.append(vecPicks[i]);
+            }
         }
     }
 
-    // Do the overlap add method and store in matDataOut
-    RowVectorXd tempData;
+    int iNumWorkers = bUseThreads ? std::min(int(m_vecWorkers.size()), vecRows.size()) : 1;
+    iNumWorkers = std::max(iNumWorkers, 1);
+
+    for(int i = 0; i < int(m_vecWorkers.size()); ++i) {
+        FilterFftWorker& worker = m_vecWorkers[i];
+        worker.vecRows.clear();
+        worker.pMatData = &matData;
+        worker.pMatDataOut = &matDataOut;
+        worker.pVecFftCoeff = &m_vecFftCoeff;
+        worker.iFftLength = m_iFftLength;
+        worker.iFilterOrder = iOrder;
+    }
 
-    for(int r = 0; r < timeData.size(); r++) {
-        // Write the newly calculated filtered data to the filter data matrix. This data has a delay of iOrder/2 in front and back
-        matDataOut.row(timeData.at(r).iRow) = timeData.at(r).vecData;
+    for(int i = 0; i < vecRows.size(); ++i) {
+        m_vecWorkers[i % iNumWorkers].vecRows.append(vecRows.at(i));
+    }
+
+    if(iNumWorkers > 1) {
+        QtConcurrent::blockingMap(m_vecWorkers, filterRows);
+    } else {
+        filterRows(m_vecWorkers[0]);
     }
 
     return matDataOut;
@@ -372,14 +691,111 @@ MatrixXd RTPROCESSINGLIB::filterDataBlock(const MatrixXd& mataData,
 
 //=============================================================================================================
 
-void RTPROCESSINGLIB::filterChannel(RTPROCESSINGLIB::FilterObject& channelDataTime)
+int FilterFftContext::getFilterOrder() const
 {
-    //channelDataTime.vecData = channelDataTime.first.at(i).applyConvFilter(channelDataTime.vecData, true);
-    channelDataTime.filterKernel.applyFftFilter(channelDataTime.vecData, true); //FFT Convolution for rt is not suitable. FFT make the signal filtering non causal.
+    return m_iFilterOrder;
 }
 
 //=============================================================================================================
-// DEFINE MEMBER METHODS
+
+int FilterFftContext::getFftLength() const
+{
+    return m_iFftLength;
+}
+
+//=============================================================================================================
+
+int FilterFftContext::getFastFftLength(int iMinLength)
+{
+    int iLength = std::max(iMinLength, 2);
+
+    while(true) {
+        int iResidual = iLength;
+
+        if(iResidual % 2 == 0) {
+            while(iResidual % 2 == 0) {
+                iResidual /= 2;
+            }
+            while(iResidual % 3 == 0) {
+                iResidual /= 3;
+            }
+            while(iResidual % 5 == 0) {
+                iResidual /= 5;
+            }
+
+            if(iResidual == 1) {
+                return iLength;
+            }
+        }
+
+        ++iLength;
+    }
+}
+
+//=============================================================================================================
+
+void FilterFftContext::prepareFftLength(int iFftLength)
+{
+    m_iFftLength = iFftLength;
+    m_vecFftCoeff = RowVectorXcd::Ones(iFftLength/2+1);
+
+    RowVectorXd vecInputFft(iFftLength);
+    RowVectorXcd vecFreqData;
+
+    // The cascade of kernels is the product of their transforms
+    for(int i = 0; i < m_lCoefficients.size(); ++i) {
+        vecInputFft.setZero();
+        vecInputFft.head(m_lCoefficients.at(i).cols()) = m_lCoefficients.at(i);
+
+        m_fftCoeff.fwd(vecFreqData, vecInputFft, iFftLength);
+        m_vecFftCoeff.array() *= vecFreqData.array();
+    }
+}
+
+//=============================================================================================================
+
+void FilterFftContext::filterRows(FilterFftWorker& worker)
+{
+    if(worker.vecRows.isEmpty()) {
+        return;
+    }
+
+    const MatrixXd& matData = *worker.pMatData;
+    MatrixXd& matDataOut = *worker.pMatDataOut;
+    int iFftLength = worker.iFftLength;
+    int iOrder = worker.iFilterOrder;
+    int iBlockSize = iFftLength - iOrder;
+    int iNumSamples = matData.cols();
+
+    worker.vecTime.resize(iFftLength);
+
+    for(int r : worker.vecRows) {
+        // The picked rows start without the delayed raw data
+        matDataOut.row(r).setZero();
+
+        for(int from = 0; from < iNumSamples; from += iBlockSize) {
+            int iSize = std::min(iBlockSize, iNumSamples - from);
+
+            worker.vecTime.head(iSize) = matData.row(r).segment(from, iSize);
+            worker.vecTime.tail(iFftLength - iSize).setZero();
+
+            worker.fft.fwd(worker.vecFreq, worker.vecTime, iFftLength);
+            worker.vecFreq.array() *= worker.pVecFftCoeff->array();
+            worker.fft.inv(worker.vecTime, worker.vecFreq, iFftLength);
+
+            // Overlap add the block including its filter tail
+            matDataOut.row(r).segment(from, iSize + iOrder) += worker.vecTime.head(iSize + iOrder);
+        }
+    }
+}
+
+//=============================================================================================================
+
+FilterOverlapAdd::FilterOverlapAdd()
+: m_pFilterContext(FilterFftContext::SPtr::create())
+{
+}
+
 //=============================================================================================================
 
 MatrixXd FilterOverlapAdd::calculate(const MatrixXd& mataData,
@@ -452,67 +868,17 @@ MatrixXd FilterOverlapAdd::calculate(const MatrixXd& mataData,
         m_matOverlapFront.setZero();
     }
 
-    // Create output matrix with size of input matrix
-    MatrixXd matDataOut(mataData.rows(), mataData.cols()+iOrder);
-    matDataOut.setZero();
-    MatrixXd sliceFiltered;
+    // Filter the data. This will return data with a filter delay of iOrder/2 in front and back
+    m_pFilterContext->setFilterKernel(filterKernel);
 
-    // slice input data into data junks with proper length so that the slices are always >= the filter order
-    float fFactor = 2.0f;
-    int iSize = fFactor * iOrder;
-    int residual = mataData.cols() % iSize;
-    while(residual < iOrder) {
-        fFactor = fFactor - 0.1f;
-        iSize = fFactor * iOrder;
-        residual = mataData.cols() % iSize;
+    MatrixXd matDataOut = m_pFilterContext->calculate(mataData,
+                                                      vecPicks,
+                                                      bUseThreads);
 
-        if(iSize < iOrder) {
-            iSize = mataData.cols();
-            break;
-        }
-    }
-
-    if(mataData.cols() > iSize) {
-        int from = 0;
-        int numSlices = ceil(float(mataData.cols())/float(iSize)); //calculate number of data slices
-
-        for (int i = 0; i < numSlices; i++) {
-            if(i == numSlices-1) {
-                //catch the last one that might be shorter than the other blocks
-                iSize = mataData.cols() - (iSize * (numSlices -1));
-            }
-
-            // Filter the data block. This will return data with a fitler delay of iOrder/2 in front and back
-            sliceFiltered = filterDataBlock(mataData.block(0,from,mataData.rows(),iSize),
-                                            vecPicks,
-                                            filterKernel,
-                                            bUseThreads);
-
-            if(i == 0) {
-                matDataOut.block(0,0,mataData.rows(),sliceFiltered.cols()) += sliceFiltered;
-            } else {
-                matDataOut.block(0,from,mataData.rows(),sliceFiltered.cols()) += sliceFiltered;
-            }
-
-            if(bFilterEnd && (i == 0)) {
-                matDataOut.block(0,0,matDataOut.rows(),iOrder) += m_matOverlapBack;
-            } else if (!bFilterEnd && (i == numSlices-1)) {
-                matDataOut.block(0,matDataOut.cols()-iOrder,matDataOut.rows(),iOrder) += m_matOverlapFront;
-            }
-
-            from += iSize;
-        }
+    if(bFilterEnd) {
+        matDataOut.block(0,0,matDataOut.rows(),iOrder) += m_matOverlapBack.topRows(matDataOut.rows());
     } else {
-        matDataOut = filterDataBlock(mataData,
-                                     vecPicks,
-                                     filterKernel,
-                                     bUseThreads);
-
-        if(bFilterEnd) {
-            matDataOut.block(0,0,matDataOut.rows(),iOrder) += m_matOverlapBack;
-        } else {
-            matDataOut.block(0,matDataOut.cols()-iOrder,matDataOut.rows(),iOrder) += m_matOverlapFront;
-        }
+        matDataOut.block(0,matDataOut.cols()-iOrder,matDataOut.rows(),iOrder) += m_matOverlapFront.topRows(matDataOut.rows());
     }
 
     // Refresh the overlap matrix with the new calculated filtered data
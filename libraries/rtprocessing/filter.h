@@ -43,14 +43,19 @@
 #include "rtprocessing_global.h"
 
 #include "helpers/filterkernel.h"
+#include "helpers/iirfilter.h"
 
 #include <fiff/fiff_info.h>
 
+#include <vector>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
 
 #include <QSharedPointer>
+#include <QList>
+#include <QVector>
 #include <QtConcurrent/QtConcurrent>
 
 //=============================================================================================================
@@ -81,6 +86,22 @@ typedef struct {
     Eigen::RowVectorXd vecData;
 } FilterObject;
 
+/**
+ * Per thread work package of the FilterFftContext. Holds its own FFT object, so the FFT plans and scratch
+ * buffers are kept between calls.
+ */
+typedef struct {
+    Eigen::FFT<double> fft;
+    Eigen::RowVectorXd vecTime;
+    Eigen::RowVectorXcd vecFreq;
+    QVector<int> vecRows;
+    const Eigen::MatrixXd* pMatData;
+    Eigen::MatrixXd* pMatDataOut;
+    const Eigen::RowVectorXcd* pVecFftCoeff;
+    int iFftLength;
+    int iFilterOrder;
+} FilterFftWorker;
+
 //=========================================================================================================
 /**
  * Creates a user designed filter kernel, filters data from an input file and writes the filtered data to a pIODevice.
@@ -114,13 +135,14 @@ RTPROCESINGSHARED_EXPORT bool filterFile(QIODevice& pIODevice,
 //=========================================================================================================
 /**
  * Filters data from an input file based on an exisiting filter kernel and writes the filtered data to a
- * pIODevice.
+ * pIODevice. With threads, reading, filtering and writing run concurrently and are connected by bounded queues,
+ * and the channels of each slice are filtered in parallel.
  *
  * @param [in] pIODevice            The IO device to write to.
  * @param [in] pFiffRawData         The fiff raw data object to read from.
  * @param [in] filterKernel         The list of filter kernels to use.
  * @param [in] vecPicks             Channel indexes to filter. Default is filter all channels.
- * @param [in] bUseThreads          hether to use multiple threads. Default is set to true.
+ * @param [in] bUseThreads          Whether to use multiple threads. Default is set to true.
  *
  * @return Returns true if successfull, false otherwise.
  */
@@ -128,7 +150,25 @@ RTPROCESINGSHARED_EXPORT bool filterFile(QIODevice& pIODevice,
                                          QSharedPointer<FIFFLIB::FiffRawData> pFiffRawData,
                                          const RTPROCESSINGLIB::FilterKernel& filterKernel,
                                          const Eigen::RowVectorXi &vecPicks = Eigen::RowVectorXi(),
-                                         bool bUseThreads = false);
+                                         bool bUseThreads = true);
+
+//=========================================================================================================
+/**
+ * Filters data from an input file zero-phase with an IIR filter and writes the filtered data to a pIODevice.
+ * The file is read in slices which are extended by the settling length of the filter on both sides, so that
+ * the written data does not contain slice edge transients.
+ *
+ * @param [in] pIODevice            The IO device to write to.
+ * @param [in] pFiffRawData         The fiff raw data object to read from.
+ * @param [in] iirFilter            The IIR filter to use.
+ * @param [in] vecPicks             Channel indexes to filter. Default is filter all channels.
+ *
+ * @return Returns true if successfull, false otherwise.
+ */
+RTPROCESINGSHARED_EXPORT bool filterFile(QIODevice& pIODevice,
+                                         QSharedPointer<FIFFLIB::FiffRawData> pFiffRawData,
+                                         const RTPROCESSINGLIB::IirFilter& iirFilter,
+                                         const Eigen::RowVectorXi &vecPicks = Eigen::RowVectorXi());
 
 //=========================================================================================================
 /**
@@ -180,6 +220,21 @@ RTPROCESINGSHARED_EXPORT Eigen::MatrixXd filterData(const Eigen::MatrixXd& mataD
                                                     bool bUseThreads = true,
                                                     bool bKeepOverhead = false);
 
+//=========================================================================================================
+/**
+ * Filters the raw input data zero-phase (forward-backward) with an IIR filter.
+ * For continous causal filtering use IirFilter::filter.
+ *
+ * @param [in] matData          The data which is to be filtered.
+ * @param [in] iirFilter        The IIR filter to use.
+ * @param [in] vecPicks         Channel indexes to filter. Default is filter all channels.
+ *
+ * @return The filtered data in form of a matrix.
+ */
+RTPROCESINGSHARED_EXPORT Eigen::MatrixXd filterData(const Eigen::MatrixXd& matData,
+                                                    const RTPROCESSINGLIB::IirFilter& iirFilter,
+                                                    const Eigen::RowVectorXi& vecPicks = Eigen::RowVectorXi());
+
 //=========================================================================================================
 /**
  * Calculates the filtered version of the raw input data block.
@@ -205,6 +260,112 @@ RTPROCESINGSHARED_EXPORT Eigen::MatrixXd filterDataBlock(const Eigen::MatrixXd&
  */
 RTPROCESINGSHARED_EXPORT void filterChannel(FilterObject &channelDataTime);
 
+//=============================================================================================================
+/**
+ * Persistent FFT convolution context. The FFT length is fixed to a length with small prime factors, the
+ * transformed filter coefficients, FFT plans and scratch buffers are kept between calls and all picked channels
+ * are filtered in one pass. Longer data is split into blocks internally. The context is meant to be kept alive
+ * by callers which filter one incoming buffer after another with the same filter.
+ *
+ * @brief Persistent FFT convolution context for one or more cascaded filter kernels.
+ */
+class RTPROCESINGSHARED_EXPORT FilterFftContext
+{
+public:
+    typedef QSharedPointer<FilterFftContext> SPtr;             /**< Shared pointer type for FilterFftContext. */
+    typedef QSharedPointer<const FilterFftContext> ConstSPtr;  /**< Const shared pointer type for FilterFftContext. */
+
+    //=========================================================================================================
+    /**
+     * Constructs a FilterFftContext object with one worker per ideal thread.
+     */
+    FilterFftContext();
+
+    //=========================================================================================================
+    /**
+     * Sets the filter kernel. The coefficients are only transformed anew if they changed.
+     *
+     * @param [in] filterKernel     The filter kernel to use.
+     */
+    void setFilterKernel(const RTPROCESSINGLIB::FilterKernel& filterKernel);
+
+    //=========================================================================================================
+    /**
+     * Sets a cascade of filter kernels which are applied one after another. The coefficients are only
+     * transformed anew if they changed.
+     *
+     * @param [in] lFilterKernels   The filter kernels to use.
+     */
+    void setFilterKernels(const QList<RTPROCESSINGLIB::FilterKernel>& lFilterKernels);
+
+    //=========================================================================================================
+    /**
+     * Filters the data. Returns the full convolution, i.e. the data with half the filter length delay in the
+     * front and back. Channels which are not picked are delayed accordingly but not filtered.
+     *
+     * @param [in] matData          The data which is to be filtered.
+     * @param [in] vecPicks         Channel indexes to filter. Default is filter all channels.
+     * @param [in] bUseThreads      Whether to use multiple threads. Default is set to true.
+     *
+     * @return The filtered data with getFilterOrder() more columns than the input data.
+     */
+    Eigen::MatrixXd calculate(const Eigen::MatrixXd& matData,
+                              const Eigen::RowVectorXi& vecPicks = Eigen::RowVectorXi(),
+                              bool bUseThreads = true);
+
+    //=========================================================================================================
+    /**
+     * Returns the total filter order, i.e. the sum of the lengths of all set filter kernels.
+     *
+     * @return The filter order.
+     */
+    int getFilterOrder() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the currently used FFT length, or 0 if no data was filtered yet.
+     *
+     * @return The FFT length.
+     */
+    int getFftLength() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the smallest even length >= iMinLength whose only prime factors are 2, 3 and 5.
+     *
+     * @param [in] iMinLength       The minimal length.
+     *
+     * @return The FFT length.
+     */
+    static int getFastFftLength(int iMinLength);
+
+private:
+    //=========================================================================================================
+    /**
+     * Transforms the filter coefficients for the given FFT length.
+     *
+     * @param [in] iFftLength       The FFT length.
+     */
+    void prepareFftLength(int iFftLength);
+
+    //=========================================================================================================
+    /**
+     * Filters the rows assigned to the worker block by block and adds them to the output.
+     *
+     * @param [in, out] worker      The work package.
+     */
+    static void filterRows(FilterFftWorker& worker);
+
+    Q_DISABLE_COPY(FilterFftContext)
+
+    std::vector<FilterFftWorker>        m_vecWorkers;           /**< One work package per thread. */
+    QList<Eigen::RowVectorXd>           m_lCoefficients;        /**< The time domain coefficients of the filter kernels. */
+    Eigen::RowVectorXcd                 m_vecFftCoeff;          /**< The product of the transformed coefficients for m_iFftLength. */
+    Eigen::FFT<double>                  m_fftCoeff;             /**< The FFT object used to transform the coefficients. */
+    int                                 m_iFilterOrder;         /**< The total filter order. */
+    int                                 m_iFftLength;           /**< The current FFT length. */
+};
+
 //=============================================================================================================
 /**
  * Filtering with FFT convolution and the overlap add method for continous data streams. This class will hold
@@ -218,6 +379,12 @@ public:
     typedef QSharedPointer<FilterOverlapAdd> SPtr;             /**< Shared pointer type for FilterOverlapAdd. */
     typedef QSharedPointer<const FilterOverlapAdd> ConstSPtr;  /**< Const shared pointer type for FilterOverlapAdd. */
 
+    //=========================================================================================================
+    /**
+     * Constructs a FilterOverlapAdd object.
+     */
+    FilterOverlapAdd();
+
     //=========================================================================================================
     /**
      * Creates a user designed filter kernel and filters the raw input data
@@ -279,6 +446,8 @@ public:
 private:
     Eigen::MatrixXd                 m_matOverlapBack;                   /**< Overlap block for the end of the data block */
     Eigen::MatrixXd                 m_matOverlapFront;                  /**< Overlap block for the beginning of the data block */
+
+    FilterFftContext::SPtr          m_pFilterContext;                   /**< The FFT context which is kept between blocks */
 };
 
 //=============================================================================================================
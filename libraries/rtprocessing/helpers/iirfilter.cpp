@@ -0,0 +1,551 @@
+//=============================================================================================================
+/**
+ * @file     iirfilter.cpp
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Definition of the IirFilter class
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "iirfilter.h"
+
+#include <complex>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE STATIC METHODS
+//=============================================================================================================
+
+typedef std::complex<double> Complex;
+
+/**
+ * Splits the roots into real-coefficient groups: conjugate pairs and pairs of real roots. An odd real root is
+ * returned as a group of its own. Roots with an imaginary part below dTol are treated as real.
+ */
+static std::vector<std::vector<Complex> > groupRoots(const std::vector<Complex>& vecRoots,
+                                                      double dTol = 1e-10)
+{
+    std::vector<std::vector<Complex> > vecGroups;
+    std::vector<double> vecReal;
+
+    for(const Complex& root : vecRoots) {
+        if(std::abs(root.imag()) <= dTol) {
+            vecReal.push_back(root.real());
+        } else if(root.imag() > 0.0) {
+            vecGroups.push_back({root, std::conj(root)});
+        }
+    }
+
+    std::sort(vecReal.begin(), vecReal.end());
+    for(size_t i = 0; i + 1 < vecReal.size(); i += 2) {
+        vecGroups.push_back({Complex(vecReal[i]), Complex(vecReal[i+1])});
+    }
+    if(vecReal.size() % 2 == 1) {
+        vecGroups.push_back({Complex(vecReal.back())});
+    }
+
+    return vecGroups;
+}
+
+//=============================================================================================================
+
+/**
+ * Returns the real polynomial 1, c1, c2 of a group of one or two roots.
+ */
+static Vector3d groupPolynomial(const std::vector<Complex>& vecGroup)
+{
+    if(vecGroup.size() == 1) {
+        return Vector3d(1.0, -vecGroup[0].real(), 0.0);
+    }
+
+    return Vector3d(1.0,
+                    -(vecGroup[0] + vecGroup[1]).real(),
+                    (vecGroup[0] * vecGroup[1]).real());
+}
+
+//=============================================================================================================
+
+/**
+ * Returns the smallest distance between any two roots of the groups.
+ */
+static double groupDistance(const std::vector<Complex>& vecGroupA,
+                            const std::vector<Complex>& vecGroupB)
+{
+    double dDist = std::numeric_limits<double>::max();
+
+    for(const Complex& a : vecGroupA) {
+        for(const Complex& b : vecGroupB) {
+            dDist = std::min(dDist, std::abs(a - b));
+        }
+    }
+
+    return dDist;
+}
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+IirFilter::IirFilter()
+: m_type(FilterKernel::UNKNOWN)
+, m_designMethod(Butterworth)
+, m_sFreq(1000.0)
+, m_dCenterFreq(0.5)
+, m_dBandwidth(0.1)
+, m_dRipple(0.5)
+, m_iFilterOrder(0)
+, m_iSettlingLength(0)
+, m_sFilterName("Unknown")
+{
+}
+
+//=============================================================================================================
+
+IirFilter::IirFilter(const QString &sFilterName,
+                     FilterKernel::FilterType type,
+                     int iOrder,
+                     double dCenterfreq,
+                     double dBandwidth,
+                     double dSFreq,
+                     DesignMethod designMethod,
+                     double dRipple)
+: m_type(type)
+, m_designMethod(designMethod)
+, m_sFreq(dSFreq)
+, m_dCenterFreq(dCenterfreq)
+, m_dBandwidth(dBandwidth)
+, m_dRipple(dRipple)
+, m_iFilterOrder(iOrder)
+, m_iSettlingLength(0)
+, m_sFilterName(sFilterName)
+{
+    designFilter();
+}
+
+//=============================================================================================================
+
+void IirFilter::filter(MatrixXd& matData)
+{
+    if(m_matSos.rows() == 0) {
+        return;
+    }
+
+    if(m_matState.rows() != matData.rows()) {
+        m_matState = MatrixXd::Zero(matData.rows(), 2 * m_matSos.rows());
+    }
+
+    applySos(matData, m_matState, false);
+}
+
+//=============================================================================================================
+
+MatrixXd IirFilter::filterZeroPhase(const MatrixXd& matData) const
+{
+    if(m_matSos.rows() == 0 || matData.cols() < 2) {
+        return matData;
+    }
+
+    int iNCols = matData.cols();
+    int iPad = std::min(std::max(m_iSettlingLength, 1), iNCols - 1);
+
+    // Extend the data by a point reflection at both ends
+    MatrixXd matExt(matData.rows(), iNCols + 2 * iPad);
+    matExt.middleCols(iPad, iNCols) = matData;
+    matExt.leftCols(iPad) = (2.0 * matData.col(0)).replicate(1, iPad) - matData.middleCols(1, iPad).rowwise().reverse();
+    matExt.rightCols(iPad) = (2.0 * matData.col(iNCols-1)).replicate(1, iPad) - matData.middleCols(iNCols-1-iPad, iPad).rowwise().reverse();
+
+    // Start both passes from the steady state of a step with the height of the first sample
+    RowVectorXd vecSteadyState = stepSteadyState();
+
+    MatrixXd matState = matExt.col(0) * vecSteadyState;
+    applySos(matExt, matState, false);
+
+    matState = matExt.col(matExt.cols()-1) * vecSteadyState;
+    applySos(matExt, matState, true);
+
+    return matExt.middleCols(iPad, iNCols);
+}
+
+//=============================================================================================================
+
+void IirFilter::reset()
+{
+    m_matState.resize(0,0);
+}
+
+//=============================================================================================================
+
+int IirFilter::getSettlingLength() const
+{
+    return m_iSettlingLength;
+}
+
+//=============================================================================================================
+
+QString IirFilter::getName() const
+{
+    return m_sFilterName;
+}
+
+//=============================================================================================================
+
+void IirFilter::setName(const QString& sFilterName)
+{
+    m_sFilterName = sFilterName;
+}
+
+//=============================================================================================================
+
+FilterKernel::FilterType IirFilter::getFilterType() const
+{
+    return m_type;
+}
+
+//=============================================================================================================
+
+IirFilter::DesignMethod IirFilter::getDesignMethod() const
+{
+    return m_designMethod;
+}
+
+//=============================================================================================================
+
+double IirFilter::getSamplingFrequency() const
+{
+    return m_sFreq;
+}
+
+//=============================================================================================================
+
+int IirFilter::getFilterOrder() const
+{
+    return m_iFilterOrder;
+}
+
+//=============================================================================================================
+
+double IirFilter::getCenterFrequency() const
+{
+    return m_dCenterFreq;
+}
+
+//=============================================================================================================
+
+double IirFilter::getBandwidth() const
+{
+    return m_dBandwidth;
+}
+
+//=============================================================================================================
+
+double IirFilter::getRipple() const
+{
+    return m_dRipple;
+}
+
+//=============================================================================================================
+
+MatrixXd IirFilter::getSos() const
+{
+    return m_matSos;
+}
+
+//=============================================================================================================
+
+void IirFilter::designFilter()
+{
+    m_matSos.resize(0,6);
+    m_matState.resize(0,0);
+    m_iSettlingLength = 0;
+
+    // Band edges normed to nyquist
+    double dLow = m_dCenterFreq;
+    double dHigh = m_dCenterFreq;
+
+    switch(m_type) {
+        case FilterKernel::LPF:
+        case FilterKernel::HPF:
+            break;
+
+        case FilterKernel::BPF:
+        case FilterKernel::NOTCH:
+            dLow = m_dCenterFreq - m_dBandwidth/2.0;
+            dHigh = m_dCenterFreq + m_dBandwidth/2.0;
+            break;
+
+        default:
+            qWarning() << "[IirFilter::designFilter] Unknown filter type. Filter will pass the data unchanged.";
+            return;
+    }
+
+    if(m_iFilterOrder < 1 || dLow <= 0.0 || dHigh >= 1.0 || dLow > dHigh) {
+        qWarning() << "[IirFilter::designFilter] Order must be positive and the band edges must lie between 0 and nyquist. Filter will pass the data unchanged.";
+        return;
+    }
+
+    int N = m_iFilterOrder;
+    const double dPi = M_PI;
+
+    // Analog lowpass prototype with a cutoff of 1 rad/s
+    std::vector<Complex> vecPoles;
+    double dGain = 1.0;
+
+    if(m_designMethod == Chebyshev) {
+        double dEps = std::sqrt(std::pow(10.0, m_dRipple/10.0) - 1.0);
+        double dMu = std::asinh(1.0/dEps) / N;
+        Complex prod(1.0);
+
+        for(int m = -N+1; m < N; m += 2) {
+            Complex p = -std::sinh(Complex(dMu, dPi * m / (2.0 * N)));
+            vecPoles.push_back(p);
+            prod *= -p;
+        }
+
+        dGain = prod.real();
+        if(N % 2 == 0) {
+            dGain /= std::sqrt(1.0 + dEps * dEps);
+        }
+    } else {
+        for(int k = 0; k < N; ++k) {
+            vecPoles.push_back(std::exp(Complex(0.0, dPi * (2.0 * k + N + 1) / (2.0 * N))));
+        }
+    }
+
+    // Prewarp the band edges for the bilinear transform z = (2+s)/(2-s)
+    const double dC = 2.0;
+    double dWarpedLow = dC * std::tan(dPi * dLow / 2.0);
+    double dWarpedHigh = dC * std::tan(dPi * dHigh / 2.0);
+    double dW0 = std::sqrt(dWarpedLow * dWarpedHigh);
+    double dBw = dWarpedHigh - dWarpedLow;
+
+    // Transform the prototype to the requested type. Zeros at infinity are not stored, their number is the
+    // difference between the number of poles and zeros.
+    std::vector<Complex> vecAnalogPoles;
+    std::vector<Complex> vecAnalogZeros;
+    Complex prodNegPoles(1.0);
+
+    for(const Complex& p : vecPoles) {
+        prodNegPoles *= -p;
+    }
+
+    switch(m_type) {
+        case FilterKernel::LPF:
+            for(const Complex& p : vecPoles) {
+                vecAnalogPoles.push_back(p * dWarpedLow);
+            }
+            dGain *= std::pow(dWarpedLow, N);
+            break;
+
+        case FilterKernel::HPF:
+            for(const Complex& p : vecPoles) {
+                vecAnalogPoles.push_back(dWarpedLow / p);
+                vecAnalogZeros.push_back(Complex(0.0));
+            }
+            dGain *= (1.0 / prodNegPoles).real();
+            break;
+
+        case FilterKernel::BPF:
+            for(const Complex& p : vecPoles) {
+                Complex pLp = p * dBw / 2.0;
+                Complex root = std::sqrt(pLp * pLp - dW0 * dW0);
+                vecAnalogPoles.push_back(pLp + root);
+                vecAnalogPoles.push_back(pLp - root);
+                vecAnalogZeros.push_back(Complex(0.0));
+            }
+            dGain *= std::pow(dBw, N);
+            break;
+
+        case FilterKernel::NOTCH:
+            for(const Complex& p : vecPoles) {
+                Complex pHp = (dBw / 2.0) / p;
+                Complex root = std::sqrt(pHp * pHp - dW0 * dW0);
+                vecAnalogPoles.push_back(pHp + root);
+                vecAnalogPoles.push_back(pHp - root);
+                vecAnalogZeros.push_back(Complex(0.0, dW0));
+                vecAnalogZeros.push_back(Complex(0.0, -dW0));
+            }
+            dGain *= (1.0 / prodNegPoles).real();
+            break;
+
+        default:
+            return;
+    }
+
+    // Bilinear transform. Zeros at infinity are mapped to nyquist.
+    std::vector<Complex> vecDigitalPoles;
+    std::vector<Complex> vecDigitalZeros;
+    Complex gainRatio(1.0);
+
+    for(const Complex& p : vecAnalogPoles) {
+        vecDigitalPoles.push_back((dC + p) / (dC - p));
+        gainRatio /= (dC - p);
+    }
+    for(const Complex& z : vecAnalogZeros) {
+        vecDigitalZeros.push_back((dC + z) / (dC - z));
+        gainRatio *= (dC - z);
+    }
+    while(vecDigitalZeros.size() < vecDigitalPoles.size()) {
+        vecDigitalZeros.push_back(Complex(-1.0));
+    }
+    dGain *= gainRatio.real();
+
+    // Group the roots into sections. The sections are ordered by increasing pole radius, so that the most
+    // resonant section is applied last, and each pole group is matched with the closest remaining zero group.
+    std::vector<std::vector<Complex> > vecPoleGroups = groupRoots(vecDigitalPoles);
+    std::vector<std::vector<Complex> > vecZeroGroups = groupRoots(vecDigitalZeros);
+
+    std::sort(vecPoleGroups.begin(), vecPoleGroups.end(),
+              [](const std::vector<Complex>& a, const std::vector<Complex>& b) {
+                  return std::abs(a[0]) < std::abs(b[0]);
+              });
+
+    m_matSos.resize(vecPoleGroups.size(), 6);
+    double dMaxRadius = 0.0;
+
+    for(size_t i = 0; i < vecPoleGroups.size(); ++i) {
+        const std::vector<Complex>& vecPoleGroup = vecPoleGroups[i];
+        int iBest = -1;
+        double dBestDist = std::numeric_limits<double>::max();
+
+        for(size_t j = 0; j < vecZeroGroups.size(); ++j) {
+            if(vecZeroGroups[j].size() != vecPoleGroup.size()) {
+                continue;
+            }
+
+            double dDist = groupDistance(vecPoleGroup, vecZeroGroups[j]);
+            if(dDist < dBestDist) {
+                dBestDist = dDist;
+                iBest = j;
+            }
+        }
+
+        m_matSos.block(i,3,1,3) = groupPolynomial(vecPoleGroup).transpose();
+
+        if(iBest >= 0) {
+            m_matSos.block(i,0,1,3) = groupPolynomial(vecZeroGroups[iBest]).transpose();
+            vecZeroGroups.erase(vecZeroGroups.begin() + iBest);
+        } else {
+            m_matSos.block(i,0,1,3) << 1.0, 0.0, 0.0;
+        }
+
+        for(const Complex& p : vecPoleGroup) {
+            dMaxRadius = std::max(dMaxRadius, std::abs(p));
+        }
+    }
+
+    m_matSos.block(0,0,1,3) *= dGain;
+
+    if(dMaxRadius >= 1.0) {
+        qWarning() << "[IirFilter::designFilter] Designed filter is unstable. Filter will pass the data unchanged.";
+        m_matSos.resize(0,6);
+        return;
+    }
+
+    m_iSettlingLength = dMaxRadius > 0.0 ? static_cast<int>(std::ceil(std::log(1e-4) / std::log(dMaxRadius))) : 1;
+}
+
+//=============================================================================================================
+
+void IirFilter::applySos(MatrixXd& matData,
+                         MatrixXd& matState,
+                         bool bBackward) const
+{
+    int iNCols = matData.cols();
+    int iNSections = m_matSos.rows();
+    VectorXd vecOut(matData.rows());
+
+    for(int iCol = 0; iCol < iNCols; ++iCol) {
+        auto vecSample = matData.col(bBackward ? iNCols - 1 - iCol : iCol);
+
+        for(int s = 0; s < iNSections; ++s) {
+            double b0 = m_matSos(s,0);
+            double b1 = m_matSos(s,1);
+            double b2 = m_matSos(s,2);
+            double a1 = m_matSos(s,4);
+            double a2 = m_matSos(s,5);
+
+            auto vecZ1 = matState.col(2*s);
+            auto vecZ2 = matState.col(2*s+1);
+
+            vecOut = b0 * vecSample + vecZ1;
+            vecZ1 = b1 * vecSample - a1 * vecOut + vecZ2;
+            vecZ2 = b2 * vecSample - a2 * vecOut;
+            vecSample = vecOut;
+        }
+    }
+}
+
+//=============================================================================================================
+
+RowVectorXd IirFilter::stepSteadyState() const
+{
+    RowVectorXd vecState(2 * m_matSos.rows());
+    double dInput = 1.0;
+
+    for(int s = 0; s < m_matSos.rows(); ++s) {
+        double b0 = m_matSos(s,0);
+        double b1 = m_matSos(s,1);
+        double b2 = m_matSos(s,2);
+        double a1 = m_matSos(s,4);
+        double a2 = m_matSos(s,5);
+
+        // Steady state output of the section for a constant input
+        double dOutput = dInput * (b0 + b1 + b2) / (1.0 + a1 + a2);
+
+        vecState(2*s+1) = b2 * dInput - a2 * dOutput;
+        vecState(2*s) = b1 * dInput - a1 * dOutput + vecState(2*s+1);
+
+        dInput = dOutput;
+    }
+
+    return vecState;
+}
@@ -0,0 +1,219 @@
+//=============================================================================================================
+/**
+ * @file     iirfilter.h
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Declaration of the IirFilter class.
+ *
+ *           The filter is designed from an analog Butterworth or Chebyshev type I prototype, which is transformed
+ *           to the requested filter type and mapped to the z-plane via the bilinear transform. The resulting poles
+ *           and zeros are grouped into cascaded second-order sections (biquads), which stay numerically stable for
+ *           high orders and narrow bands where a single transfer function polynomial would not.
+ *
+ *           The sections are applied in transposed direct form II. All channels of a data block are processed
+ *           together sample by sample, so the inner loop runs over contiguous channel vectors.
+ */
+
+#ifndef IIRFILTER_H
+#define IIRFILTER_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../rtprocessing_global.h"
+
+#include "filterkernel.h"
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QString>
+#include <QSharedPointer>
+
+//=============================================================================================================
+// DEFINE NAMESPACE RTPROCESSINGLIB
+//=============================================================================================================
+
+namespace RTPROCESSINGLIB
+{
+
+//=============================================================================================================
+/**
+ * The IirFilter class designs an IIR filter as cascaded second-order sections and applies it either causally
+ * to a continuous data stream or zero-phase (forward-backward) to a complete data block.
+ *
+ * @brief The IirFilter class provides an IIR filter in second-order section form.
+ */
+class RTPROCESINGSHARED_EXPORT IirFilter
+{
+
+public:
+    typedef QSharedPointer<IirFilter> SPtr;             /**< Shared pointer type for IirFilter. */
+    typedef QSharedPointer<const IirFilter> ConstSPtr;  /**< Const shared pointer type for IirFilter. */
+
+    enum DesignMethod {
+        Butterworth,
+        Chebyshev
+    };
+
+    //=========================================================================================================
+    /**
+     * @brief IirFilter creates a default IirFilter object which passes the data unchanged
+     */
+    IirFilter();
+
+    //=========================================================================================================
+    /**
+     * Constructs an IirFilter object
+     *
+     * @param [in] sFilterName      Defines the name of the generated filter
+     * @param [in] type             Type of the filter: LPF, HPF, BPF, NOTCH (from enum FilterKernel::FilterType)
+     * @param [in] iOrder           Order of the analog prototype. BPF and NOTCH filters have twice this order.
+     * @param [in] dCenterfreq      Determines the center of the frequency - normed to sFreq/2 (nyquist)
+     * @param [in] dBandwidth       Ignored if FilterType is set to LPF,HPF. if NOTCH/BPF: bandwidth of stop-/passband - normed to sFreq/2 (nyquist)
+     * @param [in] dSFreq           The sampling frequency
+     * @param [in] designMethod     Specifies the design method to use. Choose between Butterworth and Chebyshev. Default is Butterworth.
+     * @param [in] dRipple          The passband ripple in dB. Only used for the Chebyshev design. Default is 0.5 dB.
+     */
+    IirFilter(const QString &sFilterName,
+              FilterKernel::FilterType type,
+              int iOrder,
+              double dCenterfreq,
+              double dBandwidth,
+              double dSFreq,
+              DesignMethod designMethod = Butterworth,
+              double dRipple = 0.5);
+
+    //=========================================================================================================
+    /**
+     * Filters the data causally. The section states are kept between calls, so consecutive blocks of a
+     * continuous stream can be passed one after another. The states are reset whenever the number of rows changes.
+     *
+     * @param [in, out] matData     The data to filter (channels x samples). Gets overwritten with its filtered result.
+     */
+    void filter(Eigen::MatrixXd& matData);
+
+    //=========================================================================================================
+    /**
+     * Filters the data forward and backward, which cancels the phase response and squares the magnitude response.
+     * The data is extended at both ends by a point reflection and the section states are initialized to their step
+     * response steady state in order to suppress edge transients. The stream state used by filter() is not touched.
+     *
+     * @param [in] matData          The data to filter (channels x samples).
+     *
+     * @return The filtered data.
+     */
+    Eigen::MatrixXd filterZeroPhase(const Eigen::MatrixXd& matData) const;
+
+    //=========================================================================================================
+    /**
+     * Resets the stream state used by filter().
+     */
+    void reset();
+
+    //=========================================================================================================
+    /**
+     * Returns the number of samples after which the impulse response has decayed below 1e-4 of its initial
+     * amplitude. This is estimated from the pole closest to the unit circle and can be used as block margin.
+     *
+     * @return The settling length in samples.
+     */
+    int getSettlingLength() const;
+
+    QString getName() const;
+    void setName(const QString& sFilterName);
+
+    FilterKernel::FilterType getFilterType() const;
+    DesignMethod getDesignMethod() const;
+
+    double getSamplingFrequency() const;
+    int getFilterOrder() const;
+    double getCenterFrequency() const;
+    double getBandwidth() const;
+    double getRipple() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the second-order sections, one per row: b0 b1 b2 a0 a1 a2, with a0 = 1.
+     *
+     * @return The second-order sections.
+     */
+    Eigen::MatrixXd getSos() const;
+
+private:
+    //=========================================================================================================
+    /**
+     * Designs the actual filter with the given parameters
+     */
+    void designFilter();
+
+    //=========================================================================================================
+    /**
+     * Runs the cascade over the columns of the data in place.
+     *
+     * @param [in, out] matData     The data to filter.
+     * @param [in, out] matState    The section states, two columns per section.
+     * @param [in] bBackward        Whether to run from the last to the first column.
+     */
+    void applySos(Eigen::MatrixXd& matData,
+                  Eigen::MatrixXd& matState,
+                  bool bBackward) const;
+
+    //=========================================================================================================
+    /**
+     * Returns the section states for a constant unit input in steady state, two entries per section.
+     */
+    Eigen::RowVectorXd stepSteadyState() const;
+
+    FilterKernel::FilterType    m_type;                 /**< the filter type. */
+    DesignMethod                m_designMethod;         /**< the design method. */
+
+    double          m_sFreq;                /**< the sampling frequency. */
+    double          m_dCenterFreq;          /**< contains center freq of the filter - normed to nyquist. */
+    double          m_dBandwidth;           /**< contains bandwidth of the filter - normed to nyquist. */
+    double          m_dRipple;              /**< the passband ripple in dB for the Chebyshev design. */
+
+    int             m_iFilterOrder;         /**< the order of the analog prototype. */
+    int             m_iSettlingLength;      /**< number of samples until the impulse response has decayed. */
+
+    QString         m_sFilterName;          /**< contains name of the filter. */
+
+    Eigen::MatrixXd m_matSos;               /**< the second-order sections, one per row: b0 b1 b2 a0 a1 a2. */
+    Eigen::MatrixXd m_matState;             /**< the stream state, one row per channel and two columns per section. */
+};
+} // NAMESPACE RTPROCESSINGLIB
+
+#endif // IIRFILTER_H
@@ -0,0 +1,266 @@
+//=============================================================================================================
+/**
+ * @file     preprocessingpipeline.cpp
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    PreprocessingPipeline class definition.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "preprocessingpipeline.h"
+
+#include "filter.h"
+
+#include <algorithm>
+#include <vector>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+PreprocessingPipeline::PreprocessingPipeline()
+: m_bProjActive(false)
+, m_bCompActive(false)
+, m_bSpharaActive(false)
+, m_bFilterActive(false)
+, m_bComposed(false)
+, m_bPreFilter(false)
+, m_bPostFilter(false)
+, m_pFilter(FilterOverlapAdd::SPtr::create())
+{
+    resetStatistics();
+}
+
+//=============================================================================================================
+
+void PreprocessingPipeline::setProjector(const MatrixXd& matProj,
+                                         bool bActive)
+{
+    m_matSparseProj = matProj.sparseView();
+    m_bProjActive = bActive;
+    m_bComposed = false;
+}
+
+//=============================================================================================================
+
+void PreprocessingPipeline::setCompensator(const MatrixXd& matComp,
+                                           bool bActive)
+{
+    m_matSparseComp = matComp.sparseView();
+    m_bCompActive = bActive;
+    m_bComposed = false;
+}
+
+//=============================================================================================================
+
+void PreprocessingPipeline::setSpharaOperator(const SparseMatrix<double>& matSphara)
+{
+    m_matSparseSphara = matSphara;
+    m_bComposed = false;
+}
+
+//=============================================================================================================
+
+void PreprocessingPipeline::setSpharaActive(bool bActive)
+{
+    m_bSpharaActive = bActive;
+    m_bComposed = false;
+}
+
+//=============================================================================================================
+
+void PreprocessingPipeline::setBadChannels(const RowVectorXi& vecBadIdcs)
+{
+    m_vecBadIdcs = vecBadIdcs;
+    m_bComposed = false;
+}
+
+//=============================================================================================================
+
+void PreprocessingPipeline::setFilter(const FilterKernel& filterKernel,
+                                      const RowVectorXi& vecPicks)
+{
+    m_filterKernel = filterKernel;
+    m_vecFilterPicks = vecPicks;
+    m_pFilter->reset();
+}
+
+//=============================================================================================================
+
+void PreprocessingPipeline::setFilterActive(bool bActive)
+{
+    if(m_bFilterActive != bActive) {
+        m_bFilterActive = bActive;
+        m_bComposed = false;
+    }
+}
+
+//=============================================================================================================
+
+void PreprocessingPipeline::reset()
+{
+    m_pFilter->reset();
+}
+
+//=============================================================================================================
+
+void PreprocessingPipeline::process(const MatrixXd& matDataIn,
+                                    MatrixXd& matDataOut)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    if(m_bFilterActive) {
+        m_matBuffer.resize(matDataIn.rows(), matDataIn.cols());
+        applyPreFilter(matDataIn, m_matBuffer);
+
+        const qint64 iFilterStart = timer.nsecsElapsed();
+        matDataOut = m_pFilter->calculate(m_matBuffer,
+                                          m_filterKernel,
+                                          m_vecFilterPicks);
+        m_stats.iFilterNsecs += timer.nsecsElapsed() - iFilterStart;
+
+        applyPostFilter(matDataOut);
+    } else {
+        matDataOut.resize(matDataIn.rows(), matDataIn.cols());
+        applyPreFilter(matDataIn, matDataOut);
+    }
+
+    m_stats.iMaxBlockNsecs = std::max(m_stats.iMaxBlockNsecs, timer.nsecsElapsed());
+}
+
+//=============================================================================================================
+
+bool PreprocessingPipeline::hasPostFilterStage()
+{
+    compose();
+
+    return m_bPostFilter;
+}
+
+//=============================================================================================================
+
+PreprocessingPipeline::Statistics PreprocessingPipeline::statistics() const
+{
+    return m_stats;
+}
+
+//=============================================================================================================
+
+void PreprocessingPipeline::resetStatistics()
+{
+    m_stats.iBlocks = 0;
+    m_stats.iPreFilterNsecs = 0;
+    m_stats.iFilterNsecs = 0;
+    m_stats.iPostFilterNsecs = 0;
+    m_stats.iMaxBlockNsecs = 0;
+}
+
+//=============================================================================================================
+
+void PreprocessingPipeline::compose()
+{
+    if(m_bComposed) {
+        return;
+    }
+
+    m_bPreFilter = false;
+    m_bPostFilter = false;
+
+    // Compensator and projector
+    if(m_bCompActive && m_matSparseComp.size() > 0) {
+        m_matSparsePreFilter = m_matSparseComp;
+        m_bPreFilter = true;
+    }
+
+    if(m_bProjActive && m_matSparseProj.size() > 0) {
+        if(!m_bPreFilter) {
+            m_matSparsePreFilter = m_matSparseProj;
+            m_bPreFilter = true;
+        } else if(m_matSparseProj.cols() == m_matSparsePreFilter.rows()) {
+            m_matSparsePreFilter = (m_matSparseProj * m_matSparsePreFilter).pruned();
+        } else {
+            qWarning() << "[PreprocessingPipeline::compose] Projector and compensator dimensions do not match. Skipping projector.";
+        }
+    }
+
+    // Bad channel zeroing and SPHARA. Zeroing the bad channels before SPHARA equals dropping the corresponding
+    // operator columns.
+    if(m_bSpharaActive && m_matSparseSphara.size() > 0) {
+        m_matSparsePostFilter = m_matSparseSphara;
+
+        if(m_vecBadIdcs.size() > 0) {
+            std::vector<bool> vecIsBad(m_matSparsePostFilter.cols(), false);
+            for(int i = 0; i < m_vecBadIdcs.size(); ++i) {
+                if(m_vecBadIdcs[i] >= 0 && m_vecBadIdcs[i] < m_matSparsePostFilter.cols()) {
+                    vecIsBad[m_vecBadIdcs[i]] = true;
+                }
+            }
+
+            m_matSparsePostFilter.prune([&vecIsBad](const Index&, const Index& col, const double&) {
+                return !vecIsBad[col];
+            });
+        }
+
+        m_bPostFilter = true;
+    }
+
+    // Without a temporal filter in between all spatial stages collapse into one operator
+    if(!m_bFilterActive && m_bPostFilter) {
+        if(!m_bPreFilter) {
+            m_matSparsePreFilter = m_matSparsePostFilter;
+            m_bPreFilter = true;
+            m_bPostFilter = false;
+        } else if(m_matSparsePostFilter.cols() == m_matSparsePreFilter.rows()) {
+            m_matSparsePreFilter = (m_matSparsePostFilter * m_matSparsePreFilter).pruned();
+            m_bPostFilter = false;
+        } else {
+            qWarning() << "[PreprocessingPipeline::compose] SPHARA operator dimensions do not match. Skipping SPHARA.";
+            m_bPostFilter = false;
+        }
+    }
+
+    m_bComposed = true;
+}
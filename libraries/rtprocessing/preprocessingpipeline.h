@@ -0,0 +1,312 @@
+//=============================================================================================================
+/**
+ * @file     preprocessingpipeline.h
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    PreprocessingPipeline class declaration.
+ *
+ *           The pipeline applies compensation, SSP projection, temporal filtering and SPHARA to incoming data
+ *           blocks. The spatial operators are composed whenever a setting changes, so that a block is multiplied
+ *           with at most one operator before and one after the temporal filter.
+ */
+
+#ifndef PREPROCESSINGPIPELINE_RTPROCESSING_H
+#define PREPROCESSINGPIPELINE_RTPROCESSING_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rtprocessing_global.h"
+
+#include "helpers/filterkernel.h"
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QElapsedTimer>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+
+//=============================================================================================================
+// DEFINE NAMESPACE RTPROCESSINGLIB
+//=============================================================================================================
+
+namespace RTPROCESSINGLIB
+{
+
+//=============================================================================================================
+// RTPROCESSINGLIB FORWARD DECLARATIONS
+//=============================================================================================================
+
+class FilterOverlapAdd;
+
+//=============================================================================================================
+/**
+ * Preprocessing chain for continous data streams. The stages are applied in the order compensator, projector,
+ * temporal filter, bad channel zeroing and SPHARA. Since the temporal filter only works on the picked channels,
+ * the spatial operators before and after the filter are composed separately. If the filter is inactive all of
+ * them are composed into a single operator.
+ *
+ * The pipeline is not thread safe. Callers which change the settings from another thread need to guard it.
+ *
+ * @brief Preprocessing chain with precomposed spatial operators.
+ */
+class RTPROCESINGSHARED_EXPORT PreprocessingPipeline
+{
+public:
+    typedef QSharedPointer<PreprocessingPipeline> SPtr;             /**< Shared pointer type for PreprocessingPipeline. */
+    typedef QSharedPointer<const PreprocessingPipeline> ConstSPtr;  /**< Const shared pointer type for PreprocessingPipeline. */
+
+    struct Statistics {
+        qint64  iBlocks;            /**< Number of processed blocks. */
+        qint64  iPreFilterNsecs;    /**< Time spent applying the spatial operator before the filter. */
+        qint64  iFilterNsecs;       /**< Time spent in the temporal filter. */
+        qint64  iPostFilterNsecs;   /**< Time spent applying the spatial operator after the filter. */
+        qint64  iMaxBlockNsecs;     /**< Largest time spent on a single block. */
+    };
+
+    //=========================================================================================================
+    /**
+     * Constructs a PreprocessingPipeline with all stages deactivated.
+     */
+    PreprocessingPipeline();
+
+    //=========================================================================================================
+    /**
+     * Sets the SSP projector.
+     *
+     * @param[in] matProj        The projector.
+     * @param[in] bActive        Whether the projector is applied.
+     */
+    void setProjector(const Eigen::MatrixXd& matProj,
+                      bool bActive);
+
+    //=========================================================================================================
+    /**
+     * Sets the compensator.
+     *
+     * @param[in] matComp        The compensator.
+     * @param[in] bActive        Whether the compensator is applied.
+     */
+    void setCompensator(const Eigen::MatrixXd& matComp,
+                        bool bActive);
+
+    //=========================================================================================================
+    /**
+     * Sets the SPHARA operator.
+     *
+     * @param[in] matSphara      The SPHARA operator.
+     */
+    void setSpharaOperator(const Eigen::SparseMatrix<double>& matSphara);
+
+    //=========================================================================================================
+    /**
+     * Sets whether the SPHARA operator is applied.
+     *
+     * @param[in] bActive        The new activity flag.
+     */
+    void setSpharaActive(bool bActive);
+
+    //=========================================================================================================
+    /**
+     * Sets the channels which are set to zero before SPHARA is applied, so that they do not get smeared into
+     * the other channels.
+     *
+     * @param[in] vecBadIdcs     The indices of the bad channels.
+     */
+    void setBadChannels(const Eigen::RowVectorXi& vecBadIdcs);
+
+    //=========================================================================================================
+    /**
+     * Sets the filter kernel and the channels to filter. Resets the filter state.
+     *
+     * @param[in] filterKernel   The filter kernel.
+     * @param[in] vecPicks       The indices of the channels to filter. Default is filter all channels.
+     */
+    void setFilter(const RTPROCESSINGLIB::FilterKernel& filterKernel,
+                   const Eigen::RowVectorXi& vecPicks = Eigen::RowVectorXi());
+
+    //=========================================================================================================
+    /**
+     * Sets whether a temporal filter is applied between the spatial stages. Callers which do their own
+     * filtering between applyPreFilter and applyPostFilter set this as well, since it decides whether SPHARA
+     * is composed into the operator before the filter.
+     *
+     * @param[in] bActive        The new activity flag.
+     */
+    void setFilterActive(bool bActive);
+
+    //=========================================================================================================
+    /**
+     * Resets the filter state, e.g. after a gap in the data stream.
+     */
+    void reset();
+
+    //=========================================================================================================
+    /**
+     * Runs the data through all active stages.
+     *
+     * @param[in] matDataIn      The data block, one channel per row.
+     * @param[out] matDataOut    The processed data block. Its memory is reused if it has the right size already.
+     *                           Must not be the same object as matDataIn.
+     */
+    void process(const Eigen::MatrixXd& matDataIn,
+                 Eigen::MatrixXd& matDataOut);
+
+    //=========================================================================================================
+    /**
+     * Applies all spatial stages before the temporal filter. If the filter is inactive these are all spatial
+     * stages. Data with a channel count which does not match the operators is copied unchanged.
+     *
+     * @param[in] matDataIn      The data block, one channel per row.
+     * @param[out] matDataOut    The processed data block, with the same size as matDataIn. Must not overlap
+     *                           with matDataIn. Blocks of larger matrices can be passed directly.
+     */
+    template<typename DerivedIn, typename DerivedOut>
+    void applyPreFilter(const Eigen::MatrixBase<DerivedIn>& matDataIn,
+                        const Eigen::MatrixBase<DerivedOut>& matDataOut);
+
+    //=========================================================================================================
+    /**
+     * Applies all spatial stages after the temporal filter in place. Does nothing if the filter is inactive.
+     *
+     * @param[in, out] matData   The data block, one channel per row. Blocks of larger matrices can be passed
+     *                           directly.
+     */
+    template<typename Derived>
+    void applyPostFilter(const Eigen::MatrixBase<Derived>& matData);
+
+    //=========================================================================================================
+    /**
+     * Returns whether a spatial operator is applied after the temporal filter.
+     *
+     * @return True if applyPostFilter changes the data, false otherwise.
+     */
+    bool hasPostFilterStage();
+
+    //=========================================================================================================
+    /**
+     * Returns the per stage timings since construction or the last call to resetStatistics.
+     *
+     * @return The statistics.
+     */
+    Statistics statistics() const;
+
+    //=========================================================================================================
+    /**
+     * Resets the statistics.
+     */
+    void resetStatistics();
+
+private:
+    //=========================================================================================================
+    /**
+     * Composes the spatial operators from the current settings, if they changed.
+     */
+    void compose();
+
+    bool                                m_bProjActive;          /**< Whether the projector is applied. */
+    bool                                m_bCompActive;          /**< Whether the compensator is applied. */
+    bool                                m_bSpharaActive;        /**< Whether SPHARA is applied. */
+    bool                                m_bFilterActive;        /**< Whether the temporal filter is applied. */
+    bool                                m_bComposed;            /**< Whether the composed operators are up to date. */
+    bool                                m_bPreFilter;           /**< Whether an operator is applied before the filter. */
+    bool                                m_bPostFilter;          /**< Whether an operator is applied after the filter. */
+
+    Eigen::SparseMatrix<double>         m_matSparseProj;        /**< The SSP projector. */
+    Eigen::SparseMatrix<double>         m_matSparseComp;        /**< The compensator. */
+    Eigen::SparseMatrix<double>         m_matSparseSphara;      /**< The SPHARA operator. */
+    Eigen::SparseMatrix<double>         m_matSparsePreFilter;   /**< The composed operator before the filter. */
+    Eigen::SparseMatrix<double>         m_matSparsePostFilter;  /**< The composed operator after the filter. */
+    Eigen::RowVectorXi                  m_vecBadIdcs;           /**< The bad channels which are zeroed before SPHARA. */
+
+    Eigen::MatrixXd                     m_matBuffer;            /**< Scratch buffer which is reused between blocks. */
+
+    RTPROCESSINGLIB::FilterKernel       m_filterKernel;         /**< The filter kernel. */
+    Eigen::RowVectorXi                  m_vecFilterPicks;       /**< The channels to filter. */
+    QSharedPointer<FilterOverlapAdd>    m_pFilter;              /**< The overlap add filter which keeps the state between blocks. */
+
+    Statistics                          m_stats;                /**< The statistics. */
+};
+
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+template<typename DerivedIn, typename DerivedOut>
+void PreprocessingPipeline::applyPreFilter(const Eigen::MatrixBase<DerivedIn>& matDataIn,
+                                           const Eigen::MatrixBase<DerivedOut>& matDataOut)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    compose();
+
+    Eigen::MatrixBase<DerivedOut>& matOut = const_cast<Eigen::MatrixBase<DerivedOut>&>(matDataOut);
+
+    if(m_bPreFilter && m_matSparsePreFilter.cols() == matDataIn.rows()) {
+        matOut.noalias() = m_matSparsePreFilter * matDataIn;
+    } else {
+        matOut = matDataIn;
+    }
+
+    m_stats.iBlocks++;
+    m_stats.iPreFilterNsecs += timer.nsecsElapsed();
+}
+
+//=============================================================================================================
+
+template<typename Derived>
+void PreprocessingPipeline::applyPostFilter(const Eigen::MatrixBase<Derived>& matData)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    compose();
+
+    if(!m_bPostFilter || m_matSparsePostFilter.cols() != matData.rows()) {
+        return;
+    }
+
+    m_matBuffer.resize(matData.rows(), matData.cols());
+    m_matBuffer.noalias() = m_matSparsePostFilter * matData;
+    const_cast<Eigen::MatrixBase<Derived>&>(matData) = m_matBuffer;
+
+    m_stats.iPostFilterNsecs += timer.nsecsElapsed();
+}
+} // NAMESPACE RTPROCESSINGLIB
+
+#endif // PREPROCESSINGPIPELINE_RTPROCESSING_H
@@ -46,7 +46,6 @@
 //=============================================================================================================
 
 #include <QDebug>
-#include <QtConcurrent>
 
 //=============================================================================================================
 // USED NAMESPACES
@@ -61,9 +60,18 @@ using namespace Eigen;
 //=============================================================================================================
 
 RtCov::RtCov(QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo)
-: m_fiffInfo(*pFiffInfo)
-, m_iSamples(0)
+: m_iSamples(0)
+, m_dWeight(0.0)
+, m_dWeightSquared(0.0)
+, m_dForgettingFactor(1.0)
+, m_fiffInfo(*pFiffInfo)
 {
+    for(int i = 0; i < m_fiffInfo.chs.size(); i++) {
+        if(m_fiffInfo.chs.at(i).kind != FIFFV_MEG_CH &&
+           m_fiffInfo.chs.at(i).kind != FIFFV_EEG_CH) {
+            m_lExclude << m_fiffInfo.chs.at(i).ch_name;
+        }
+    }
 }
 
 //=============================================================================================================
@@ -76,93 +84,117 @@ FiffCov RtCov::estimateCovariance(const Eigen::MatrixXd& matData,
         return FiffCov();
     }
 
-    m_lData.append(matData);
+    accumulate(matData);
     m_iSamples += matData.cols();
 
     if(m_iSamples < iNewMaxSamples) {
         return FiffCov();
     }
 
-    QFuture<RtCovComputeResult> result = QtConcurrent::mappedReduced(m_lData,
-                                                                     compute,
-                                                                     reduce);
-
-    result.waitForFinished();
+    m_iSamples = 0;
 
-    RtCovComputeResult finalResult = result.result();
+    if(m_dWeight * m_dWeight <= m_dWeightSquared) {
+        qWarning() << "[RtCov::estimateCovariance] Number of samples too small. Regularization not possible. Returning empty covariance estimation.";
+        reset();
+        return FiffCov();
+    }
 
-    //Final computation
-    FiffCov computedCov;
-    computedCov.data = finalResult.matData;
+    FiffCov computedCov = computeCovariance();
 
-    QStringList exclude;
-    for(int i = 0; i<m_fiffInfo.chs.size(); i++) {
-        if(m_fiffInfo.chs.at(i).kind != FIFFV_MEG_CH &&
-           m_fiffInfo.chs.at(i).kind != FIFFV_EEG_CH) {
-            exclude << m_fiffInfo.chs.at(i).ch_name;
-        }
+    // Without forgetting each estimate is computed from fresh data only
+    if(m_dForgettingFactor >= 1.0) {
+        reset();
     }
-    bool doProj = true;
 
-    if(m_iSamples > 0) {
-        finalResult.mu /= (float)m_iSamples;
-        computedCov.data.array() -= m_iSamples * (finalResult.mu * finalResult.mu.transpose()).array();
-        computedCov.data.array() /= (m_iSamples - 1);
+    return computedCov;
+}
 
-        computedCov.kind = FIFFV_MNE_NOISE_COV;
-        computedCov.diag = false;
-        computedCov.dim = computedCov.data.rows();
+//=============================================================================================================
 
-        //ToDo do picks
-        computedCov.names = m_fiffInfo.ch_names;
-        computedCov.projs = m_fiffInfo.projs;
-        computedCov.bads = m_fiffInfo.bads;
-        computedCov.nfree = m_iSamples;
+void RtCov::setForgettingFactor(double dForgettingFactor)
+{
+    if(dForgettingFactor <= 0.0 || dForgettingFactor > 1.0) {
+        qWarning() << "[RtCov::setForgettingFactor] Forgetting factor must lie in (0, 1]. Returning.";
+        return;
+    }
 
-        // regularize noise covariance
-        computedCov = computedCov.regularize(m_fiffInfo, 0.05, 0.05, 0.1, doProj, exclude);
+    m_dForgettingFactor = dForgettingFactor;
+}
 
-//            qint32 samples = rawSegment.cols();
-//            VectorXf mu = rawSegment.rowwise().sum().array() / (float)samples;
+//=============================================================================================================
 
-//            MatrixXf noise_covariance = rawSegment * rawSegment.transpose();// noise_covariance == raw_covariance
-//            noise_covariance.array() -= samples * (mu * mu.transpose()).array();
-//            noise_covariance.array() /= (samples - 1);
+double RtCov::getForgettingFactor() const
+{
+    return m_dForgettingFactor;
+}
 
-//            std::cout << "Noise Covariance:\n" << noise_covariance.block(0,0,10,10) << std::endl;
+//=============================================================================================================
 
-//            printf("%d raw buffer (%d x %d) generated\r\n", count, tmp.rows(), tmp.cols());
+void RtCov::reset()
+{
+    m_dWeight = 0.0;
+    m_dWeightSquared = 0.0;
+    m_vecSum.setZero();
+    m_matOuterSum.setZero();
+}
 
-        m_lData.clear();
-        m_iSamples = 0;
+//=============================================================================================================
 
-        return computedCov;
-    } else {
-        qWarning() << "[RtCov::estimateCovariance] Number of samples equals zero. Regularization not possible. Returning empty covariance estimation.";
-        return FiffCov();
+void RtCov::accumulate(const MatrixXd &matData)
+{
+    if(m_vecSum.size() != matData.rows()) {
+        m_vecSum = VectorXd::Zero(matData.rows());
+        m_matOuterSum = MatrixXd::Zero(matData.rows(), matData.rows());
+        m_dWeight = 0.0;
+        m_dWeightSquared = 0.0;
     }
 
-}
+    if(m_dForgettingFactor >= 1.0) {
+        m_vecSum += matData.rowwise().sum();
+        m_matOuterSum.selfadjointView<Eigen::Lower>().rankUpdate(matData);
+        m_dWeight += matData.cols();
+        m_dWeightSquared += matData.cols();
+        return;
+    }
 
-//=============================================================================================================
+    // Sample j of a block with n samples is weighted by lambda^(n-1-j), the old state by lambda^n
+    const int iCols = matData.cols();
+    VectorXd vecWeights(iCols);
+    for(int j = 0; j < iCols; ++j) {
+        vecWeights[j] = std::pow(m_dForgettingFactor, iCols - 1 - j);
+    }
+    const double dDecay = std::pow(m_dForgettingFactor, iCols);
 
-RtCovComputeResult RtCov::compute(const MatrixXd &matData)
-{
-    RtCovComputeResult result;
-    result.mu = matData.rowwise().sum();
-    result.matData = matData * matData.transpose();
-    return result;
+    m_vecSum = dDecay * m_vecSum + matData * vecWeights;
+    m_matOuterSum *= dDecay;
+    m_matOuterSum.selfadjointView<Eigen::Lower>().rankUpdate(matData * vecWeights.cwiseSqrt().asDiagonal());
+    m_dWeight = dDecay * m_dWeight + vecWeights.sum();
+    m_dWeightSquared = dDecay * dDecay * m_dWeightSquared + vecWeights.squaredNorm();
 }
 
 //=============================================================================================================
 
-void RtCov::reduce(RtCovComputeResult& finalResult, const RtCovComputeResult &tempResult)
+FiffCov RtCov::computeCovariance() const
 {
-    if(finalResult.matData.size() == 0 || finalResult.mu.size() == 0) {
-        finalResult.mu = tempResult.mu;
-        finalResult.matData = tempResult.matData;
-    } else {
-        finalResult.mu += tempResult.mu;
-        finalResult.matData += tempResult.matData;
-    }
+    VectorXd mu = m_vecSum / m_dWeight;
+
+    FiffCov computedCov;
+    computedCov.data = m_matOuterSum.selfadjointView<Eigen::Lower>();
+    computedCov.data.noalias() -= m_dWeight * (mu * mu.transpose());
+    computedCov.data /= (m_dWeight - m_dWeightSquared / m_dWeight);
+
+    computedCov.kind = FIFFV_MNE_NOISE_COV;
+    computedCov.diag = false;
+    computedCov.dim = computedCov.data.rows();
+
+    //ToDo do picks
+    computedCov.names = m_fiffInfo.ch_names;
+    computedCov.projs = m_fiffInfo.projs;
+    computedCov.bads = m_fiffInfo.bads;
+    // the effective number of samples
+    computedCov.nfree = qRound(m_dWeight * m_dWeight / m_dWeightSquared);
+
+    // regularize noise covariance
+    bool doProj = true;
+    return computedCov.regularize(m_fiffInfo, 0.05, 0.05, 0.1, doProj, m_lExclude);
 }
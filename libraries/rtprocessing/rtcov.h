@@ -73,18 +73,15 @@ namespace FIFFLIB {
 namespace RTPROCESSINGLIB
 {
 
-//=============================================================================================================
-// RTPROCESSINGLIB FORWARD DECLARATIONS
-//=============================================================================================================
-
-struct RtCovComputeResult {
-    Eigen::VectorXd mu;
-    Eigen::MatrixXd matData;
-};
-
 //=============================================================================================================
 /**
- * Real-time covariance worker.
+ * Real-time covariance worker. Every incoming block is folded into running sum and outer product accumulators,
+ * so no raw data blocks are kept in memory. With a forgetting factor of 1 (default) the accumulators are reset
+ * after each estimate, yielding one covariance per iNewMaxSamples samples. With a forgetting factor smaller
+ * than 1 every sample is exponentially down-weighted per new sample and an updated covariance is emitted
+ * every iNewMaxSamples samples without resetting. The weighted covariance is normalized by W - sum(w^2)/W,
+ * with W the sum of the sample weights w, which is unbiased for these weights and reduces to n - 1 without
+ * forgetting.
  *
  * @brief Real-time covariance worker.
  */
@@ -99,36 +96,63 @@ public:
     /**
      * Perform actual covariance estimation.
      *
-     * @param[in] inputData  Data to estimate the covariance from.
+     * @param[in] matData          Data to estimate the covariance from.
+     * @param[in] iNewMaxSamples   Number of samples after which a new covariance estimate is returned.
+     *
+     * @return   The regularized covariance estimate or an empty covariance if no estimate is due.
      */
     FIFFLIB::FiffCov estimateCovariance(const Eigen::MatrixXd& matData,
                                         int iNewMaxSamples);
 
-protected:
     //=========================================================================================================
     /**
-     * Computer multiplication with transposed.
+     * Sets the per sample forgetting factor. A value of 1 disables forgetting.
      *
-     * @param[in] matData  Data to self multiply with.
+     * @param[in] dForgettingFactor  The forgetting factor in (0, 1].
+     */
+    void setForgettingFactor(double dForgettingFactor);
+
+    //=========================================================================================================
+    /**
+     * Returns the per sample forgetting factor.
+     *
+     * @return   The forgetting factor.
+     */
+    double getForgettingFactor() const;
+
+    //=========================================================================================================
+    /**
+     * Resets the running accumulators.
+     */
+    void reset();
+
+protected:
+    //=========================================================================================================
+    /**
+     * Folds a data block into the running accumulators.
      *
-     * @return   The multiplication result.
+     * @param[in] matData  Data block to accumulate.
      */
-    static RtCovComputeResult compute(const Eigen::MatrixXd &matData);
+    void accumulate(const Eigen::MatrixXd &matData);
 
     //=========================================================================================================
     /**
-     * Computer multiplication with transposed.
+     * Computes the regularized covariance from the current accumulator state.
      *
-     * @param[out]   finalResult     The final covariance estimation.
-     * @param[in]    tempResult      The intermediate result from the compute function
+     * @return   The regularized covariance estimate.
      */
-    static void reduce(RtCovComputeResult& finalResult, const RtCovComputeResult &tempResult);
+    FIFFLIB::FiffCov computeCovariance() const;
 
-    int                     m_iSamples;                 /**< The number of stored samples. */
+    int                     m_iSamples;                 /**< The number of samples since the last estimate. */
+    double                  m_dWeight;                  /**< The sum of the sample weights, the number of samples without forgetting. */
+    double                  m_dWeightSquared;           /**< The sum of the squared sample weights. */
+    double                  m_dForgettingFactor;        /**< The per sample forgetting factor. */
 
-    QList<Eigen::MatrixXd>  m_lData;                    /**< The stored data blocks. */
+    Eigen::VectorXd         m_vecSum;                   /**< The running (weighted) sum of the samples. */
+    Eigen::MatrixXd         m_matOuterSum;              /**< The running (weighted) sum of the outer products. Only the lower triangle is used. */
 
     FIFFLIB::FiffInfo       m_fiffInfo;                 /**< Holds the fiff measurement information. */
+    QStringList             m_lExclude;                 /**< The channels excluded from regularization. */
 };
 
 //=============================================================================================================
@@ -78,10 +78,12 @@ void RtHpiWorker::doWork(const Eigen::MatrixXd& matData,
         return;
     }
 
-    //Perform actual fitting
+    //Perform actual fitting, starting from the last result
     HpiFitResult fitResult;
+    fitResult.devHeadTrans = m_lastDevHeadTrans;
     fitResult.devHeadTrans.from = 1;
     fitResult.devHeadTrans.to = 4;
+    fitResult.errorDistances = m_lastErrorDistances;
 
     m_pHpiFit->fitHPI(matData,
                       matProjectors,
@@ -92,6 +94,12 @@ void RtHpiWorker::doWork(const Eigen::MatrixXd& matData,
                       fitResult.fittedCoils,
                       pFiffInfo);
 
+    m_pHpiFit->getLastFitReport(fitResult.vecNumIterations,
+                                fitResult.fFitDuration);
+
+    m_lastDevHeadTrans = fitResult.devHeadTrans;
+    m_lastErrorDistances = fitResult.errorDistances;
+
     emit resultReady(fitResult);
 }
 
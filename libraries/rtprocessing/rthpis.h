@@ -41,6 +41,8 @@
 
 #include "rtprocessing_global.h"
 
+#include <fiff/fiff_coord_trans.h>
+
 
 //=============================================================================================================
 // EIGEN INCLUDES
@@ -114,6 +116,8 @@ public:
 protected:
     //=========================================================================================================
     QSharedPointer<INVERSELIB::HPIFit>              m_pHpiFit;             /**< Holds the HpiFit object. */
+    FIFFLIB::FiffCoordTrans                         m_lastDevHeadTrans;    /**< The result of the last fit, used as starting point for the next one. */
+    QVector<double>                                 m_lastErrorDistances;  /**< The coil errors of the last fit. */
 
 signals:
     void resultReady(const INVERSELIB::HpiFitResult &fitResult);
@@ -89,9 +89,11 @@ SOURCES += \
     rtconnectivity.cpp \
     sphara.cpp \
     detecttrigger.cpp \
+    preprocessingpipeline.cpp \
     helpers/cosinefilter.cpp \
     helpers/parksmcclellan.cpp \
     helpers/filterkernel.cpp \
+    helpers/iirfilter.cpp \
     helpers/filterio.cpp \
 
 HEADERS +=  \
@@ -105,10 +107,12 @@ HEADERS +=  \
     filter.h \
     detecttrigger.h \
     sphara.h \
+    preprocessingpipeline.h \
     rtconnectivity.h \
     helpers/cosinefilter.h \
     helpers/parksmcclellan.h \
     helpers/filterkernel.h \
+    helpers/iirfilter.h \
     helpers/filterio.h \
 
 INCLUDEPATH += $${EIGEN_INCLUDE_DIR}
@@ -0,0 +1,569 @@
+//=============================================================================================================
+/**
+ * @file     ringbuffer.h
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Contains the declaration of the RingBuffer template.
+ *
+ */
+
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../utils_global.h"
+
+#include <atomic>
+#include <utility>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QThread>
+#include <QWaitCondition>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// DEFINE NAMESPACE IOBUFFER
+//=============================================================================================================
+
+namespace IOBUFFER
+{
+
+//=============================================================================================================
+/**
+ * TEMPLATE RING BUFFER
+ *
+ * Lock-free single-producer/single-consumer ring buffer. In contrast to CircularBuffer no semaphores are involved:
+ * producer and consumer only synchronize via two atomic indices. Only the Block wait strategy takes a mutex, to
+ * put a waiting thread to sleep until the other side signals progress. The mutex is only taken while a thread
+ * actually waits, pushing and popping on a buffer which is neither full nor empty stays lock-free. The slots are allocated once and reused. Popping
+ * swaps the slot content with the passed element, so that for dynamically sized types like Eigen matrices the
+ * memory of the consumer's previous element is handed back to the slot and reused by the next push of equal size.
+ * Exactly one thread may push and exactly one thread may pop at any time.
+ *
+ * @brief The TEMPLATE RING BUFFER provides a lock-free single-producer/single-consumer ring buffer.
+ */
+template<typename _Tp>
+class RingBuffer
+{
+public:
+    typedef QSharedPointer<RingBuffer> SPtr;              /**< Shared pointer type for RingBuffer. */
+    typedef QSharedPointer<const RingBuffer> ConstSPtr;   /**< Const shared pointer type for RingBuffer. */
+
+    //=========================================================================================================
+    /**
+     * The wait strategy used by the blocking push and pop functions.
+     */
+    enum WaitStrategy {
+        Block,      /**< Wait on a condition which is signalled by the other side. No CPU load while waiting. */
+        Spin,       /**< Busy wait. Lowest latency, occupies one core while waiting. */
+        Yield,      /**< Yield the time slice between retries. Occupies one core while waiting. */
+        Sleep       /**< Sleep between retries. */
+    };
+
+    //=========================================================================================================
+    /**
+     * Constructs a RingBuffer.
+     *
+     * @param [in] uiMaxNumElements  Length of the buffer.
+     * @param [in] waitStrategy      The wait strategy of the blocking push and pop functions. Spin and Yield
+     *                               should only be used where the latency matters more than an idle core.
+     */
+    explicit RingBuffer(unsigned int uiMaxNumElements,
+                        WaitStrategy waitStrategy = Block);
+
+    //=========================================================================================================
+    /**
+     * Destroys the RingBuffer.
+     */
+    ~RingBuffer();
+
+    //=========================================================================================================
+    /**
+     * Adds a whole array at the end of the buffer. Blocks until enough space is available or the timeout expired.
+     * Either all or none of the elements are added.
+     *
+     * @param [in] pArray    Pointer to the array which should be appended to the end.
+     * @param [in] size      Number of elements in the array.
+     *
+     * @return true if the elements were added, false if the timeout expired.
+     */
+    inline bool push(const _Tp* pArray, unsigned int size);
+
+    //=========================================================================================================
+    /**
+     * Adds an element at the end of the buffer. Blocks until space is available or the timeout expired.
+     *
+     * @param [in] newElement    The element which should be appended to the end.
+     *
+     * @return true if the element was added, false if the timeout expired.
+     */
+    inline bool push(const _Tp& newElement);
+
+    //=========================================================================================================
+    /**
+     * Moves an element to the end of the buffer. Blocks until space is available or the timeout expired.
+     *
+     * @param [in] newElement    The element which should be moved to the end.
+     *
+     * @return true if the element was added, false if the timeout expired.
+     */
+    inline bool push(_Tp&& newElement);
+
+    //=========================================================================================================
+    /**
+     * Adds an element at the end of the buffer without blocking.
+     *
+     * @param [in] newElement    The element which should be appended to the end.
+     *
+     * @return true if the element was added, false if the buffer is full.
+     */
+    inline bool tryPush(const _Tp& newElement);
+
+    //=========================================================================================================
+    /**
+     * Returns the first element (first in first out). Blocks until an element is available or the timeout expired.
+     * The previous content of element is handed to the buffer for reuse.
+     *
+     * @param [out] element  The popped element.
+     *
+     * @return true if an element was popped, false if the timeout expired.
+     */
+    inline bool pop(_Tp& element);
+
+    //=========================================================================================================
+    /**
+     * Returns the first size elements (first in first out). Blocks until size elements are available or the
+     * timeout expired. Either all or none of the elements are popped.
+     *
+     * @param [out] pArray   Pointer to the array the elements are written to.
+     * @param [in] size      Number of elements to pop.
+     *
+     * @return true if the elements were popped, false if the timeout expired.
+     */
+    inline bool pop(_Tp* pArray, unsigned int size);
+
+    //=========================================================================================================
+    /**
+     * Returns the first element (first in first out) without blocking.
+     *
+     * @param [out] element  The popped element.
+     *
+     * @return true if an element was popped, false if the buffer is empty.
+     */
+    inline bool tryPop(_Tp& element);
+
+    //=========================================================================================================
+    /**
+     * Clears the buffer. Must not be called while a producer or consumer is active.
+     */
+    void clear();
+
+    //=========================================================================================================
+    /**
+     * Sets the timeout of the blocking push and pop functions.
+     *
+     * @param [in] iTimeout  The timeout in milliseconds.
+     */
+    inline void setTimeout(int iTimeout);
+
+    //=========================================================================================================
+    /**
+     * Returns the number of elements which can be read.
+     */
+    inline int getFreeElementsRead() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the number of elements which can be written.
+     */
+    inline int getFreeElementsWrite() const;
+
+private:
+    //=========================================================================================================
+    /**
+     * Waits until at least size elements can be written.
+     *
+     * @param [in] size  The number of elements.
+     *
+     * @return true if the space is available, false if the timeout expired.
+     */
+    inline bool waitForWrite(unsigned int size);
+
+    //=========================================================================================================
+    /**
+     * Waits until at least size elements can be read.
+     *
+     * @param [in] size  The number of elements.
+     *
+     * @return true if the elements are available, false if the timeout expired.
+     */
+    inline bool waitForRead(unsigned int size);
+
+    //=========================================================================================================
+    /**
+     * Backs off according to the wait strategy.
+     */
+    inline void backOff() const;
+
+    //=========================================================================================================
+    /**
+     * Wakes the threads which wait on the given condition. Does nothing if no thread waits.
+     *
+     * @param [in] waitCondition     The condition to signal.
+     * @param [in] iWaiters          The number of threads waiting on waitCondition.
+     */
+    inline void signal(QWaitCondition& waitCondition,
+                       const std::atomic<int>& iWaiters);
+
+    unsigned int                m_uiMaxNumElements;     /**< Holds the maximal number of buffer elements.*/
+    _Tp*                        m_pBuffer;              /**< Holds the preallocated slots.*/
+    WaitStrategy                m_waitStrategy;         /**< Holds the wait strategy of the blocking functions.*/
+    int                         m_iTimeout;             /**< Holds the timeout value after which the blocking functions return false.*/
+
+    QMutex                      m_mutex;                /**< Guards the waits of the Block wait strategy.*/
+    QWaitCondition              m_waitNotEmpty;         /**< Signalled by the producer after elements were added.*/
+    QWaitCondition              m_waitNotFull;          /**< Signalled by the consumer after elements were removed.*/
+    std::atomic<int>            m_iWaitingReaders;      /**< Holds the number of threads waiting on m_waitNotEmpty.*/
+    std::atomic<int>            m_iWaitingWriters;      /**< Holds the number of threads waiting on m_waitNotFull.*/
+
+    std::atomic<unsigned long long> m_uiWriteIndex;     /**< Holds the number of elements written so far. Only modified by the producer.*/
+    char                            m_cPadding[64];     /**< Keeps the read and write index on different cache lines.*/
+    std::atomic<unsigned long long> m_uiReadIndex;      /**< Holds the number of elements read so far. Only modified by the consumer.*/
+};
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+template<typename _Tp>
+RingBuffer<_Tp>::RingBuffer(unsigned int uiMaxNumElements,
+                            WaitStrategy waitStrategy)
+: m_uiMaxNumElements(uiMaxNumElements)
+, m_pBuffer(new _Tp[m_uiMaxNumElements])
+, m_waitStrategy(waitStrategy)
+, m_iTimeout(1000)
+, m_iWaitingReaders(0)
+, m_iWaitingWriters(0)
+, m_uiWriteIndex(0)
+, m_uiReadIndex(0)
+{
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+RingBuffer<_Tp>::~RingBuffer()
+{
+    delete [] m_pBuffer;
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline bool RingBuffer<_Tp>::push(const _Tp* pArray, unsigned int size)
+{
+    if(size > m_uiMaxNumElements || !waitForWrite(size)) {
+        return false;
+    }
+
+    unsigned long long uiWriteIndex = m_uiWriteIndex.load(std::memory_order_relaxed);
+
+    for(unsigned int i = 0; i < size; ++i) {
+        m_pBuffer[(uiWriteIndex + i) % m_uiMaxNumElements] = pArray[i];
+    }
+
+    m_uiWriteIndex.store(uiWriteIndex + size, std::memory_order_release);
+    signal(m_waitNotEmpty, m_iWaitingReaders);
+
+    return true;
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline bool RingBuffer<_Tp>::push(const _Tp& newElement)
+{
+    return push(&newElement, 1);
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline bool RingBuffer<_Tp>::push(_Tp&& newElement)
+{
+    if(!waitForWrite(1)) {
+        return false;
+    }
+
+    unsigned long long uiWriteIndex = m_uiWriteIndex.load(std::memory_order_relaxed);
+    m_pBuffer[uiWriteIndex % m_uiMaxNumElements] = std::move(newElement);
+    m_uiWriteIndex.store(uiWriteIndex + 1, std::memory_order_release);
+    signal(m_waitNotEmpty, m_iWaitingReaders);
+
+    return true;
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline bool RingBuffer<_Tp>::tryPush(const _Tp& newElement)
+{
+    if(getFreeElementsWrite() < 1) {
+        return false;
+    }
+
+    unsigned long long uiWriteIndex = m_uiWriteIndex.load(std::memory_order_relaxed);
+    m_pBuffer[uiWriteIndex % m_uiMaxNumElements] = newElement;
+    m_uiWriteIndex.store(uiWriteIndex + 1, std::memory_order_release);
+    signal(m_waitNotEmpty, m_iWaitingReaders);
+
+    return true;
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline bool RingBuffer<_Tp>::pop(_Tp& element)
+{
+    return pop(&element, 1);
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline bool RingBuffer<_Tp>::pop(_Tp* pArray, unsigned int size)
+{
+    if(size > m_uiMaxNumElements || !waitForRead(size)) {
+        return false;
+    }
+
+    unsigned long long uiReadIndex = m_uiReadIndex.load(std::memory_order_relaxed);
+
+    for(unsigned int i = 0; i < size; ++i) {
+        std::swap(pArray[i], m_pBuffer[(uiReadIndex + i) % m_uiMaxNumElements]);
+    }
+
+    m_uiReadIndex.store(uiReadIndex + size, std::memory_order_release);
+    signal(m_waitNotFull, m_iWaitingWriters);
+
+    return true;
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline bool RingBuffer<_Tp>::tryPop(_Tp& element)
+{
+    if(getFreeElementsRead() < 1) {
+        return false;
+    }
+
+    unsigned long long uiReadIndex = m_uiReadIndex.load(std::memory_order_relaxed);
+    std::swap(element, m_pBuffer[uiReadIndex % m_uiMaxNumElements]);
+    m_uiReadIndex.store(uiReadIndex + 1, std::memory_order_release);
+    signal(m_waitNotFull, m_iWaitingWriters);
+
+    return true;
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline void RingBuffer<_Tp>::clear()
+{
+    m_uiWriteIndex.store(0);
+    m_uiReadIndex.store(0);
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline void RingBuffer<_Tp>::setTimeout(int iTimeout)
+{
+    m_iTimeout = iTimeout;
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline int RingBuffer<_Tp>::getFreeElementsRead() const
+{
+    return static_cast<int>(m_uiWriteIndex.load(std::memory_order_acquire) - m_uiReadIndex.load(std::memory_order_acquire));
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline int RingBuffer<_Tp>::getFreeElementsWrite() const
+{
+    return static_cast<int>(m_uiMaxNumElements - (m_uiWriteIndex.load(std::memory_order_acquire) - m_uiReadIndex.load(std::memory_order_acquire)));
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline bool RingBuffer<_Tp>::waitForWrite(unsigned int size)
+{
+    if(getFreeElementsWrite() >= static_cast<int>(size)) {
+        return true;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if(m_waitStrategy == Block) {
+        // Register as waiter before checking the index again. The other side updates its index before it looks
+        // at the waiter count, so either this thread sees the update or the other side sees the waiter and
+        // signals under the mutex.
+        QMutexLocker locker(&m_mutex);
+        m_iWaitingWriters.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool bReady = true;
+        while(getFreeElementsWrite() < static_cast<int>(size)) {
+            const qint64 iRemaining = m_iTimeout - timer.elapsed();
+            if(iRemaining <= 0) {
+                bReady = false;
+                break;
+            }
+            m_waitNotFull.wait(&m_mutex, static_cast<unsigned long>(iRemaining));
+        }
+        m_iWaitingWriters.fetch_sub(1);
+        return bReady;
+    }
+
+    while(getFreeElementsWrite() < static_cast<int>(size)) {
+        if(timer.elapsed() >= m_iTimeout) {
+            return false;
+        }
+        backOff();
+    }
+
+    return true;
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline bool RingBuffer<_Tp>::waitForRead(unsigned int size)
+{
+    if(getFreeElementsRead() >= static_cast<int>(size)) {
+        return true;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if(m_waitStrategy == Block) {
+        // Register as waiter before checking the index again. The other side updates its index before it looks
+        // at the waiter count, so either this thread sees the update or the other side sees the waiter and
+        // signals under the mutex.
+        QMutexLocker locker(&m_mutex);
+        m_iWaitingReaders.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool bReady = true;
+        while(getFreeElementsRead() < static_cast<int>(size)) {
+            const qint64 iRemaining = m_iTimeout - timer.elapsed();
+            if(iRemaining <= 0) {
+                bReady = false;
+                break;
+            }
+            m_waitNotEmpty.wait(&m_mutex, static_cast<unsigned long>(iRemaining));
+        }
+        m_iWaitingReaders.fetch_sub(1);
+        return bReady;
+    }
+
+    while(getFreeElementsRead() < static_cast<int>(size)) {
+        if(timer.elapsed() >= m_iTimeout) {
+            return false;
+        }
+        backOff();
+    }
+
+    return true;
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline void RingBuffer<_Tp>::backOff() const
+{
+    switch(m_waitStrategy) {
+        case Block:
+        case Spin:
+            break;
+        case Yield:
+            QThread::yieldCurrentThread();
+            break;
+        case Sleep:
+            QThread::usleep(50);
+            break;
+    }
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline void RingBuffer<_Tp>::signal(QWaitCondition& waitCondition,
+                                    const std::atomic<int>& iWaiters)
+{
+    if(m_waitStrategy != Block) {
+        return;
+    }
+
+    // Orders the index update before the waiter check, see waitForRead and waitForWrite
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(iWaiters.load(std::memory_order_relaxed) > 0) {
+        QMutexLocker locker(&m_mutex);
+        waitCondition.wakeAll();
+    }
+}
+
+//=============================================================================================================
+// TYPEDEF
+//=============================================================================================================
+
+typedef UTILSSHARED_EXPORT RingBuffer< Eigen::MatrixXd >        RingBuffer_Matrix_double;       /**< Defines RingBuffer of Eigen::MatrixXd type.*/
+typedef UTILSSHARED_EXPORT RingBuffer< Eigen::MatrixXf >        RingBuffer_Matrix_float;        /**< Defines RingBuffer of Eigen::MatrixXf type.*/
+} // NAMESPACE
+
+#endif // RINGBUFFER_H
@@ -0,0 +1,298 @@
+//=============================================================================================================
+/**
+ * @file     kdtree.cpp
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    KdTree class definition.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "kdtree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+KdTree::KdTree()
+{
+}
+
+//=============================================================================================================
+
+KdTree::KdTree(const MatrixX3f& matPoints,
+               int iLeafSize)
+: m_matPoints(matPoints.transpose())
+, m_vecIds(matPoints.rows())
+{
+    for(int i = 0; i < static_cast<int>(m_vecIds.size()); ++i) {
+        m_vecIds[i] = i;
+    }
+
+    if(m_vecIds.empty()) {
+        return;
+    }
+
+    m_vecNodes.reserve(2 * (m_vecIds.size() / std::max(iLeafSize, 1)) + 1);
+    build(0, static_cast<int>(m_vecIds.size()), std::max(iLeafSize, 1));
+
+    // store the points in tree order, so that the points of a leaf are next to each other
+    Matrix3Xf matSorted(3, m_matPoints.cols());
+    for(int i = 0; i < static_cast<int>(m_vecIds.size()); ++i) {
+        matSorted.col(i) = m_matPoints.col(m_vecIds[i]);
+    }
+    m_matPoints.swap(matSorted);
+}
+
+//=============================================================================================================
+
+int KdTree::size() const
+{
+    return static_cast<int>(m_vecIds.size());
+}
+
+//=============================================================================================================
+
+bool KdTree::isEmpty() const
+{
+    return m_vecIds.empty();
+}
+
+//=============================================================================================================
+
+int KdTree::findNearest(const Vector3f& vecPoint,
+                        float& fDist) const
+{
+    int iBest = -1;
+    float fBestDist2 = std::numeric_limits<float>::infinity();
+
+    if(!m_vecNodes.empty()) {
+        searchNearest(0, vecPoint, iBest, fBestDist2);
+    }
+
+    fDist = std::sqrt(fBestDist2);
+    return iBest;
+}
+
+//=============================================================================================================
+
+QVector<int> KdTree::findNearest(const Vector3f& vecPoint,
+                                 int iK,
+                                 QVector<float>& vecDists) const
+{
+    // max-heap on the squared distance, holds the best iK candidates found so far
+    std::vector<std::pair<float, int> > vecHeap;
+    iK = std::min(iK, size());
+
+    if(iK > 0) {
+        vecHeap.reserve(iK + 1);
+        searchKNearest(0, vecPoint, iK, vecHeap);
+    }
+
+    std::sort_heap(vecHeap.begin(), vecHeap.end());
+
+    QVector<int> vecResult(static_cast<int>(vecHeap.size()));
+    vecDists.resize(static_cast<int>(vecHeap.size()));
+    for(int i = 0; i < static_cast<int>(vecHeap.size()); ++i) {
+        vecResult[i] = vecHeap[i].second;
+        vecDists[i] = std::sqrt(vecHeap[i].first);
+    }
+
+    return vecResult;
+}
+
+//=============================================================================================================
+
+QVector<int> KdTree::findInRadius(const Vector3f& vecPoint,
+                                  float fRadius) const
+{
+    QVector<int> vecResult;
+
+    if(!m_vecNodes.empty() && fRadius >= 0.0f) {
+        searchRadius(0, vecPoint, fRadius * fRadius, vecResult);
+    }
+
+    std::sort(vecResult.begin(), vecResult.end());
+    return vecResult;
+}
+
+//=============================================================================================================
+
+int KdTree::build(int iBegin,
+                  int iEnd,
+                  int iLeafSize)
+{
+    const int iNode = static_cast<int>(m_vecNodes.size());
+    m_vecNodes.push_back(Node{-1, 0.0f, iBegin, iEnd, -1, -1});
+
+    if(iEnd - iBegin <= iLeafSize) {
+        return iNode;
+    }
+
+    // split the dimension with the largest extent at the median
+    Vector3f vecMin = m_matPoints.col(m_vecIds[iBegin]);
+    Vector3f vecMax = vecMin;
+    for(int i = iBegin + 1; i < iEnd; ++i) {
+        vecMin = vecMin.cwiseMin(m_matPoints.col(m_vecIds[i]));
+        vecMax = vecMax.cwiseMax(m_matPoints.col(m_vecIds[i]));
+    }
+
+    int iDim;
+    if((vecMax - vecMin).maxCoeff(&iDim) <= 0.0f) {
+        // all points coincide, no split possible
+        return iNode;
+    }
+
+    const int iMid = iBegin + (iEnd - iBegin) / 2;
+    std::nth_element(m_vecIds.begin() + iBegin,
+                     m_vecIds.begin() + iMid,
+                     m_vecIds.begin() + iEnd,
+                     [this, iDim](int a, int b) {
+                         return m_matPoints(iDim, a) < m_matPoints(iDim, b);
+                     });
+
+    const float fSplit = m_matPoints(iDim, m_vecIds[iMid]);
+    const int iLeft = build(iBegin, iMid, iLeafSize);
+    const int iRight = build(iMid, iEnd, iLeafSize);
+
+    // m_vecNodes may have been reallocated during the recursion
+    Node& node = m_vecNodes[iNode];
+    node.iDim = iDim;
+    node.fSplit = fSplit;
+    node.iLeft = iLeft;
+    node.iRight = iRight;
+
+    return iNode;
+}
+
+//=============================================================================================================
+
+void KdTree::searchNearest(int iNode,
+                           const Vector3f& vecPoint,
+                           int& iBest,
+                           float& fBestDist2) const
+{
+    const Node& node = m_vecNodes[iNode];
+
+    if(node.iDim < 0) {
+        for(int i = node.iBegin; i < node.iEnd; ++i) {
+            const float fDist2 = (m_matPoints.col(i) - vecPoint).squaredNorm();
+            if(fDist2 < fBestDist2 || (fDist2 == fBestDist2 && m_vecIds[i] < iBest)) {
+                fBestDist2 = fDist2;
+                iBest = m_vecIds[i];
+            }
+        }
+        return;
+    }
+
+    // descend into the side of the query point first, the other side only if it can hold a closer point
+    const float fDiff = vecPoint[node.iDim] - node.fSplit;
+    const int iNear = fDiff < 0.0f ? node.iLeft : node.iRight;
+    const int iFar = fDiff < 0.0f ? node.iRight : node.iLeft;
+
+    searchNearest(iNear, vecPoint, iBest, fBestDist2);
+    if(fDiff * fDiff <= fBestDist2) {
+        searchNearest(iFar, vecPoint, iBest, fBestDist2);
+    }
+}
+
+//=============================================================================================================
+
+void KdTree::searchKNearest(int iNode,
+                            const Vector3f& vecPoint,
+                            int iK,
+                            std::vector<std::pair<float, int> >& vecHeap) const
+{
+    const Node& node = m_vecNodes[iNode];
+
+    if(node.iDim < 0) {
+        for(int i = node.iBegin; i < node.iEnd; ++i) {
+            const std::pair<float, int> candidate((m_matPoints.col(i) - vecPoint).squaredNorm(), m_vecIds[i]);
+            if(static_cast<int>(vecHeap.size()) < iK) {
+                vecHeap.push_back(candidate);
+                std::push_heap(vecHeap.begin(), vecHeap.end());
+            } else if(candidate < vecHeap.front()) {
+                std::pop_heap(vecHeap.begin(), vecHeap.end());
+                vecHeap.back() = candidate;
+                std::push_heap(vecHeap.begin(), vecHeap.end());
+            }
+        }
+        return;
+    }
+
+    const float fDiff = vecPoint[node.iDim] - node.fSplit;
+    const int iNear = fDiff < 0.0f ? node.iLeft : node.iRight;
+    const int iFar = fDiff < 0.0f ? node.iRight : node.iLeft;
+
+    searchKNearest(iNear, vecPoint, iK, vecHeap);
+    if(static_cast<int>(vecHeap.size()) < iK || fDiff * fDiff <= vecHeap.front().first) {
+        searchKNearest(iFar, vecPoint, iK, vecHeap);
+    }
+}
+
+//=============================================================================================================
+
+void KdTree::searchRadius(int iNode,
+                          const Vector3f& vecPoint,
+                          float fRadius2,
+                          QVector<int>& vecResult) const
+{
+    const Node& node = m_vecNodes[iNode];
+
+    if(node.iDim < 0) {
+        for(int i = node.iBegin; i < node.iEnd; ++i) {
+            if((m_matPoints.col(i) - vecPoint).squaredNorm() <= fRadius2) {
+                vecResult.append(m_vecIds[i]);
+            }
+        }
+        return;
+    }
+
+    const float fDiff = vecPoint[node.iDim] - node.fSplit;
+
+    if(fDiff < 0.0f || fDiff * fDiff <= fRadius2) {
+        searchRadius(node.iLeft, vecPoint, fRadius2, vecResult);
+    }
+    if(fDiff >= 0.0f || fDiff * fDiff <= fRadius2) {
+        searchRadius(node.iRight, vecPoint, fRadius2, vecResult);
+    }
+}
@@ -0,0 +1,195 @@
+//=============================================================================================================
+/**
+ * @file     kdtree.h
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    KdTree class declaration.
+ *
+ *           The tree is built once over a fixed set of 3D points, e.g. the vertices of a surface, and answers
+ *           nearest neighbor, k-nearest neighbor and radius queries in logarithmic instead of linear time.
+ *           The points are stored in tree order so that the points of a leaf are contiguous in memory.
+ */
+
+#ifndef KDTREE_H
+#define KDTREE_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "utils_global.h"
+
+#include <vector>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QVector>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// DEFINE NAMESPACE UTILSLIB
+//=============================================================================================================
+
+namespace UTILSLIB
+{
+
+//=============================================================================================================
+/**
+ * Balanced k-d tree over a static set of 3D points. The tree can be copied and queried from several threads
+ * at the same time.
+ *
+ * @brief Spatial index for nearest neighbor and radius queries on 3D points.
+ */
+class UTILSSHARED_EXPORT KdTree
+{
+
+public:
+    typedef QSharedPointer<KdTree> SPtr;            /**< Shared pointer type for KdTree. */
+    typedef QSharedPointer<const KdTree> ConstSPtr; /**< Const shared pointer type for KdTree. */
+
+    //=========================================================================================================
+    /**
+     * Constructs an empty KdTree.
+     */
+    KdTree();
+
+    //=========================================================================================================
+    /**
+     * Constructs a KdTree over the given points. The returned indices refer to the rows of matPoints.
+     *
+     * @param[in] matPoints      The points, one per row.
+     * @param[in] iLeafSize      Maximal number of points in a leaf. Default is 16.
+     */
+    explicit KdTree(const Eigen::MatrixX3f& matPoints,
+                    int iLeafSize = 16);
+
+    //=========================================================================================================
+    /**
+     * Returns the number of indexed points.
+     *
+     * @return The number of points.
+     */
+    int size() const;
+
+    //=========================================================================================================
+    /**
+     * Returns whether the tree holds no points.
+     *
+     * @return True if empty, false otherwise.
+     */
+    bool isEmpty() const;
+
+    //=========================================================================================================
+    /**
+     * Finds the point closest to vecPoint. If several points have the same distance the one with the lowest
+     * index is returned, as a linear search would do.
+     *
+     * @param[in] vecPoint       The query point.
+     * @param[out] fDist         The distance to the closest point.
+     *
+     * @return The index of the closest point, -1 if the tree is empty.
+     */
+    int findNearest(const Eigen::Vector3f& vecPoint,
+                    float& fDist) const;
+
+    //=========================================================================================================
+    /**
+     * Finds the iK points closest to vecPoint.
+     *
+     * @param[in] vecPoint       The query point.
+     * @param[in] iK             The number of points to find.
+     * @param[out] vecDists      The distances to the found points.
+     *
+     * @return The indices of the found points, sorted by increasing distance.
+     */
+    QVector<int> findNearest(const Eigen::Vector3f& vecPoint,
+                             int iK,
+                             QVector<float>& vecDists) const;
+
+    //=========================================================================================================
+    /**
+     * Finds all points within fRadius of vecPoint.
+     *
+     * @param[in] vecPoint       The query point.
+     * @param[in] fRadius        The search radius.
+     *
+     * @return The indices of the found points in ascending order.
+     */
+    QVector<int> findInRadius(const Eigen::Vector3f& vecPoint,
+                              float fRadius) const;
+
+private:
+    struct Node {
+        int     iDim;           /**< Split dimension, -1 for a leaf. */
+        float   fSplit;         /**< Split value. */
+        int     iBegin;         /**< First point of the node in tree order. */
+        int     iEnd;           /**< One past the last point of the node in tree order. */
+        int     iLeft;          /**< Index of the child below the split, -1 for a leaf. */
+        int     iRight;         /**< Index of the child above the split, -1 for a leaf. */
+    };
+
+    //=========================================================================================================
+    /**
+     * Builds the subtree over the points iBegin to iEnd in tree order.
+     *
+     * @return The index of the subtree root in m_vecNodes.
+     */
+    int build(int iBegin,
+              int iEnd,
+              int iLeafSize);
+
+    void searchNearest(int iNode,
+                       const Eigen::Vector3f& vecPoint,
+                       int& iBest,
+                       float& fBestDist2) const;
+
+    void searchKNearest(int iNode,
+                        const Eigen::Vector3f& vecPoint,
+                        int iK,
+                        std::vector<std::pair<float, int> >& vecHeap) const;
+
+    void searchRadius(int iNode,
+                      const Eigen::Vector3f& vecPoint,
+                      float fRadius2,
+                      QVector<int>& vecResult) const;
+
+    Eigen::Matrix3Xf    m_matPoints;    /**< The points in tree order, one per column. */
+    std::vector<int>    m_vecIds;       /**< The original index of each point in tree order. */
+    std::vector<Node>   m_vecNodes;     /**< The tree nodes, the root comes first. */
+};
+} // NAMESPACE UTILSLIB
+
+#endif // KDTREE_H
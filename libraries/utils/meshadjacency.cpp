@@ -0,0 +1,189 @@
+//=============================================================================================================
+/**
+ * @file     meshadjacency.cpp
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    MeshAdjacency class definition.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "meshadjacency.h"
+
+#include <algorithm>
+#include <numeric>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtConcurrent>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+MeshAdjacency::MeshAdjacency()
+{
+}
+
+//=============================================================================================================
+
+MeshAdjacency::MeshAdjacency(const MatrixX3i& matTris,
+                             int iNumVertices)
+{
+    iNumVertices = std::max(iNumVertices, 0);
+    const int iNumTris = static_cast<int>(matTris.rows());
+
+    // vertex to triangle incidence: count, then fill in ascending triangle order
+    m_vecTriOffsets.assign(iNumVertices + 1, 0);
+    for(int p = 0; p < iNumTris; ++p) {
+        for(int k = 0; k < 3; ++k) {
+            const int iVert = matTris(p,k);
+            if(iVert >= 0 && iVert < iNumVertices) {
+                ++m_vecTriOffsets[iVert + 1];
+            }
+        }
+    }
+    std::partial_sum(m_vecTriOffsets.begin(), m_vecTriOffsets.end(), m_vecTriOffsets.begin());
+
+    m_vecTriIndices.resize(m_vecTriOffsets.back());
+    std::vector<int> vecCursor(m_vecTriOffsets.begin(), m_vecTriOffsets.end() - 1);
+    for(int p = 0; p < iNumTris; ++p) {
+        for(int k = 0; k < 3; ++k) {
+            const int iVert = matTris(p,k);
+            if(iVert >= 0 && iVert < iNumVertices) {
+                m_vecTriIndices[vecCursor[iVert]++] = p;
+            }
+        }
+    }
+
+    // vertex to vertex adjacency: each triangle adds at most two neighbors, so the candidates of a vertex fit
+    // into twice its triangle range. The vertices are independent of each other and collected in parallel.
+    std::vector<int> vecCandidates(2 * m_vecTriIndices.size());
+    std::vector<int> vecCounts(iNumVertices, 0);
+
+    const int iBlockSize = 4096;
+    std::vector<int> vecBlocks;
+    for(int iBegin = 0; iBegin < iNumVertices; iBegin += iBlockSize) {
+        vecBlocks.push_back(iBegin);
+    }
+
+    auto collectNeighbors = [&](int iBegin) {
+        const int iEnd = std::min(iBegin + iBlockSize, iNumVertices);
+        for(int k = iBegin; k < iEnd; ++k) {
+            int* pNeighbors = vecCandidates.data() + 2 * m_vecTriOffsets[k];
+            int iCount = 0;
+
+            for(int t = m_vecTriOffsets[k]; t < m_vecTriOffsets[k + 1]; ++t) {
+                for(int c = 0; c < 3; ++c) {
+                    const int iVert = matTris(m_vecTriIndices[t], c);
+                    // the lists are short, a linear search is cheaper than any set
+                    if(iVert != k
+                       && iVert >= 0 && iVert < iNumVertices
+                       && std::find(pNeighbors, pNeighbors + iCount, iVert) == pNeighbors + iCount) {
+                        pNeighbors[iCount++] = iVert;
+                    }
+                }
+            }
+
+            vecCounts[k] = iCount;
+        }
+    };
+
+    if(vecBlocks.size() > 1) {
+        QtConcurrent::blockingMap(vecBlocks, collectNeighbors);
+    } else if(!vecBlocks.empty()) {
+        collectNeighbors(vecBlocks.front());
+    }
+
+    m_vecVertOffsets.assign(iNumVertices + 1, 0);
+    std::partial_sum(vecCounts.begin(), vecCounts.end(), m_vecVertOffsets.begin() + 1);
+
+    m_vecVertIndices.resize(m_vecVertOffsets.back());
+    for(int k = 0; k < iNumVertices; ++k) {
+        std::copy(vecCandidates.begin() + 2 * m_vecTriOffsets[k],
+                  vecCandidates.begin() + 2 * m_vecTriOffsets[k] + vecCounts[k],
+                  m_vecVertIndices.begin() + m_vecVertOffsets[k]);
+    }
+}
+
+//=============================================================================================================
+
+MeshAdjacency::MeshAdjacency(const QVector<QVector<int> >& vecNeighborVertices)
+{
+    m_vecVertOffsets.assign(vecNeighborVertices.size() + 1, 0);
+    for(int k = 0; k < vecNeighborVertices.size(); ++k) {
+        m_vecVertOffsets[k + 1] = m_vecVertOffsets[k] + vecNeighborVertices[k].size();
+    }
+
+    m_vecVertIndices.resize(m_vecVertOffsets.back());
+    for(int k = 0; k < vecNeighborVertices.size(); ++k) {
+        std::copy(vecNeighborVertices[k].constBegin(),
+                  vecNeighborVertices[k].constEnd(),
+                  m_vecVertIndices.begin() + m_vecVertOffsets[k]);
+    }
+}
+
+//=============================================================================================================
+
+QVector<QVector<int> > MeshAdjacency::neighborVertexLists() const
+{
+    QVector<QVector<int> > vecLists(numVertices());
+
+    for(int k = 0; k < vecLists.size(); ++k) {
+        vecLists[k] = QVector<int>(neighborCount(k));
+        std::copy(neighborsBegin(k), neighborsEnd(k), vecLists[k].begin());
+    }
+
+    return vecLists;
+}
+
+//=============================================================================================================
+
+QVector<QVector<int> > MeshAdjacency::neighborTriangleLists() const
+{
+    QVector<QVector<int> > vecLists(m_vecTriOffsets.empty() ? 0 : numVertices());
+
+    for(int k = 0; k < vecLists.size(); ++k) {
+        vecLists[k] = QVector<int>(triangleCount(k));
+        std::copy(trianglesBegin(k), trianglesEnd(k), vecLists[k].begin());
+    }
+
+    return vecLists;
+}
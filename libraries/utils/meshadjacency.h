@@ -0,0 +1,274 @@
+//=============================================================================================================
+/**
+ * @file     meshadjacency.h
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    MeshAdjacency class declaration.
+ *
+ *
+ *           The neighbors of all vertices are stored in one index array in compressed sparse row form. The entries
+ *           of vertex k are found between offset k and offset k + 1. Compared to one vector per vertex this needs a
+ *           fraction of the memory, and walking the mesh, e.g. in a Dijkstra search, touches contiguous memory.
+ */
+
+#ifndef MESHADJACENCY_H
+#define MESHADJACENCY_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "utils_global.h"
+
+#include <vector>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QVector>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// DEFINE NAMESPACE UTILSLIB
+//=============================================================================================================
+
+namespace UTILSLIB
+{
+
+//=============================================================================================================
+/**
+ * Vertex to vertex adjacency and vertex to triangle incidence of a triangle mesh. The neighbors of a vertex are
+ * ordered as the former per vertex lists: by ascending triangle, and within a triangle by corner.
+ *
+ * @brief Compact neighborhood information of a triangle mesh.
+ */
+class UTILSSHARED_EXPORT MeshAdjacency
+{
+
+public:
+    typedef QSharedPointer<MeshAdjacency> SPtr;            /**< Shared pointer type for MeshAdjacency. */
+    typedef QSharedPointer<const MeshAdjacency> ConstSPtr; /**< Const shared pointer type for MeshAdjacency. */
+
+    //=========================================================================================================
+    /**
+     * Constructs an empty MeshAdjacency.
+     */
+    MeshAdjacency();
+
+    //=========================================================================================================
+    /**
+     * Constructs the MeshAdjacency of a triangle mesh in time linear to the number of triangles. Corners which
+     * are not a valid vertex index are ignored.
+     *
+     * @param[in] matTris        The triangles, one per row.
+     * @param[in] iNumVertices   The number of vertices.
+     */
+    MeshAdjacency(const Eigen::MatrixX3i& matTris,
+                  int iNumVertices);
+
+    //=========================================================================================================
+    /**
+     * Constructs the vertex adjacency from per vertex neighbor lists. No triangle incidence is available.
+     *
+     * @param[in] vecNeighborVertices    The neighbors of each vertex.
+     */
+    explicit MeshAdjacency(const QVector<QVector<int> >& vecNeighborVertices);
+
+    //=========================================================================================================
+    /**
+     * Returns the number of vertices.
+     *
+     * @return The number of vertices.
+     */
+    inline int numVertices() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the number of neighbors of a vertex.
+     *
+     * @param[in] iVertex        The vertex.
+     *
+     * @return The number of neighbors.
+     */
+    inline int neighborCount(int iVertex) const;
+
+    //=========================================================================================================
+    /**
+     * Returns a pointer to the first neighbor of a vertex. The neighbors end at neighborsEnd(iVertex).
+     *
+     * @param[in] iVertex        The vertex.
+     *
+     * @return Pointer to the first neighbor.
+     */
+    inline const int* neighborsBegin(int iVertex) const;
+
+    //=========================================================================================================
+    /**
+     * Returns a pointer past the last neighbor of a vertex.
+     *
+     * @param[in] iVertex        The vertex.
+     *
+     * @return Pointer past the last neighbor.
+     */
+    inline const int* neighborsEnd(int iVertex) const;
+
+    //=========================================================================================================
+    /**
+     * Returns the number of triangles a vertex is part of.
+     *
+     * @param[in] iVertex        The vertex.
+     *
+     * @return The number of triangles, 0 if the adjacency was not built from triangles.
+     */
+    inline int triangleCount(int iVertex) const;
+
+    //=========================================================================================================
+    /**
+     * Returns a pointer to the first triangle of a vertex, in ascending order. The triangles end at
+     * trianglesEnd(iVertex).
+     *
+     * @param[in] iVertex        The vertex.
+     *
+     * @return Pointer to the first triangle.
+     */
+    inline const int* trianglesBegin(int iVertex) const;
+
+    //=========================================================================================================
+    /**
+     * Returns a pointer past the last triangle of a vertex.
+     *
+     * @param[in] iVertex        The vertex.
+     *
+     * @return Pointer past the last triangle.
+     */
+    inline const int* trianglesEnd(int iVertex) const;
+
+    //=========================================================================================================
+    /**
+     * Returns the neighbors as one vector per vertex.
+     *
+     * @return The neighbors of each vertex.
+     */
+    QVector<QVector<int> > neighborVertexLists() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the triangles as one vector per vertex.
+     *
+     * @return The triangles of each vertex.
+     */
+    QVector<QVector<int> > neighborTriangleLists() const;
+
+    //=========================================================================================================
+    /**
+     * Overloaded == operator to compare two MeshAdjacency objects.
+     *
+     * @param[in] a      The first MeshAdjacency.
+     * @param[in] b      The second MeshAdjacency.
+     *
+     * @return true if both hold the same neighbors and triangles, false otherwise.
+     */
+    friend bool operator== (const MeshAdjacency &a, const MeshAdjacency &b);
+
+private:
+    std::vector<int>    m_vecVertOffsets;   /**< Offset of the neighbors of each vertex in m_vecVertIndices, one more than vertices. */
+    std::vector<int>    m_vecVertIndices;   /**< The neighbors of all vertices. */
+    std::vector<int>    m_vecTriOffsets;    /**< Offset of the triangles of each vertex in m_vecTriIndices, empty if there are no triangles. */
+    std::vector<int>    m_vecTriIndices;    /**< The triangles of all vertices. */
+};
+
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline int MeshAdjacency::numVertices() const
+{
+    return m_vecVertOffsets.empty() ? 0 : static_cast<int>(m_vecVertOffsets.size()) - 1;
+}
+
+//=============================================================================================================
+
+inline int MeshAdjacency::neighborCount(int iVertex) const
+{
+    return m_vecVertOffsets[iVertex + 1] - m_vecVertOffsets[iVertex];
+}
+
+//=============================================================================================================
+
+inline const int* MeshAdjacency::neighborsBegin(int iVertex) const
+{
+    return m_vecVertIndices.data() + m_vecVertOffsets[iVertex];
+}
+
+//=============================================================================================================
+
+inline const int* MeshAdjacency::neighborsEnd(int iVertex) const
+{
+    return m_vecVertIndices.data() + m_vecVertOffsets[iVertex + 1];
+}
+
+//=============================================================================================================
+
+inline int MeshAdjacency::triangleCount(int iVertex) const
+{
+    return m_vecTriOffsets.empty() ? 0 : m_vecTriOffsets[iVertex + 1] - m_vecTriOffsets[iVertex];
+}
+
+//=============================================================================================================
+
+inline const int* MeshAdjacency::trianglesBegin(int iVertex) const
+{
+    return m_vecTriOffsets.empty() ? m_vecTriIndices.data() : m_vecTriIndices.data() + m_vecTriOffsets[iVertex];
+}
+
+//=============================================================================================================
+
+inline const int* MeshAdjacency::trianglesEnd(int iVertex) const
+{
+    return m_vecTriOffsets.empty() ? m_vecTriIndices.data() : m_vecTriIndices.data() + m_vecTriOffsets[iVertex + 1];
+}
+
+//=============================================================================================================
+
+inline bool operator== (const MeshAdjacency &a, const MeshAdjacency &b)
+{
+    return (a.m_vecVertOffsets == b.m_vecVertOffsets &&
+            a.m_vecVertIndices == b.m_vecVertIndices &&
+            a.m_vecTriOffsets == b.m_vecTriOffsets &&
+            a.m_vecTriIndices == b.m_vecTriIndices);
+}
+} // NAMESPACE UTILSLIB
+
+#endif // MESHADJACENCY_H
@@ -63,6 +63,8 @@ contains(MNECPP_CONFIG, static) {
 
 SOURCES += \
     kmeans.cpp \
+    kdtree.cpp \
+    meshadjacency.cpp \
     mnemath.cpp \
     ioutils.cpp \
     layoutloader.cpp \
@@ -78,6 +80,8 @@ SOURCES += \
 
 HEADERS += \
     kmeans.h\
+    kdtree.h \
+    meshadjacency.h \
     utils_global.h \
     mnemath.h \
     ioutils.h \
@@ -90,6 +94,7 @@ HEADERS += \
     sphere.h \
     simplex_algorithm.h \
     generics/circularbuffer.h \
+    generics/ringbuffer.h \
     generics/commandpattern.h \
     generics/observerpattern.h \
     generics/typename_old.h \
@@ -42,7 +42,9 @@
 
 #include <fiff/fiff.h>
 
+#include <cmath>
 #include <iostream>
+#include <limits>
 
 //=============================================================================================================
 // QT INCLUDES
@@ -76,6 +78,8 @@ private slots:
     void compareData();
     void compareTimes();
     void compareInfo();
+    void compareMappedData();
+    void compareRawDataTypes();
     void cleanupTestCase();
 
 private:
@@ -308,6 +312,186 @@ void TestFiffRWR::compareInfo()
 
 //=============================================================================================================
 
+void TestFiffRWR::compareMappedData()
+{
+    QFile t_fileIn(QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/sample_audvis_trunc_raw.fif");
+    FiffRawData raw(t_fileIn);
+
+    fiff_int_t from = raw.first_samp + 100;
+    fiff_int_t to = raw.last_samp - 100;
+
+    RowVectorXi vSel(3);
+    vSel << 0, 5, raw.info.nchan - 1;
+
+    MatrixXd mData, mTimes, mSelData;
+    QVERIFY( raw.read_raw_segment(mData, mTimes, from, to) );
+    QVERIFY( raw.read_raw_segment(mSelData, mTimes, from, to, vSel) );
+
+    QVERIFY( raw.mapRawData() );
+    QVERIFY( raw.isRawDataMapped() );
+
+    MatrixXd mMappedData, mMappedTimes, mMappedSelData;
+    QVERIFY( raw.read_raw_segment(mMappedData, mMappedTimes, from, to) );
+    QVERIFY( raw.read_raw_segment(mMappedSelData, mMappedTimes, from, to, vSel) );
+
+    QVERIFY( (mData - mMappedData).cwiseAbs().maxCoeff() < dEpsilon );
+    QVERIFY( (mSelData - mMappedSelData).cwiseAbs().maxCoeff() < dEpsilon );
+
+    // a copy keeps the mapping alive after the original was cleared
+    FiffRawData* pRawCopy = new FiffRawData(raw);
+    QVERIFY( pRawCopy->isRawDataMapped() );
+    FiffRawData rawCopy(*pRawCopy);
+    pRawCopy->clear();
+    delete pRawCopy;
+
+    MatrixXd mCopyData;
+    QVERIFY( rawCopy.isRawDataMapped() );
+    QVERIFY( rawCopy.read_raw_segment(mCopyData, mMappedTimes, from, to) );
+    QVERIFY( (mData - mCopyData).cwiseAbs().maxCoeff() < dEpsilon );
+
+    raw.unmapRawData();
+    QVERIFY( !raw.isRawDataMapped() );
+    QVERIFY( rawCopy.isRawDataMapped() );
+
+    // a raw buffer which was moved outside of the mapping is not read
+    int k = 0;
+    while(rawCopy.rawdir[k].ent->kind == -1) {
+        ++k;
+    }
+    rawCopy.rawdir[k].ent = FiffDirEntry::SPtr(new FiffDirEntry(*rawCopy.rawdir[k].ent));
+    rawCopy.rawdir[k].ent->pos = std::numeric_limits<fiff_int_t>::max() - FIFFC_DATA_OFFSET;
+    QVERIFY( !rawCopy.read_raw_segment(mCopyData, mMappedTimes, rawCopy.rawdir[k].first, rawCopy.rawdir[k].last) );
+}
+
+//=============================================================================================================
+
+void TestFiffRWR::compareRawDataTypes()
+{
+    QFile t_fileIn(QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/sample_audvis_trunc_raw.fif");
+    FiffRawData raw(t_fileIn);
+
+    fiff_int_t first = raw.first_samp;
+    fiff_int_t last = raw.first_samp + 999;
+
+    MatrixXd mData, mTimes;
+    QVERIFY( raw.read_raw_segment(mData, mTimes, first, last) );
+
+    // samples outside of the range of all integer types, one outside of the 16 bit range only and a NaN
+    const double dStep0 = raw.info.chs[0].cal * raw.info.chs[0].range;
+    mData(0, 3) = 2.0e10 * dStep0;
+    mData(0, 4) = -2.0e10 * dStep0;
+    mData(0, 5) = 1.0e6 * dStep0;
+    mData(0, 6) = std::numeric_limits<double>::quiet_NaN();
+
+    QList<fiff_int_t> types;
+    types << FIFFT_FLOAT << FIFFT_INT << FIFFT_SHORT << FIFFT_DAU_PACK16;
+
+    for(fiff_int_t type : types) {
+        std::cout << "Data type " << type << std::endl;
+
+        QFile t_fileOut(QCoreApplication::applicationDirPath() + QString("/mne-cpp-test-data/MEG/sample/sample_audvis_trunc_raw_test_rwr_type_%1.fif").arg(type));
+
+        //
+        //   Floats are written with the range reset to 1.0, integers are scaled by 1/(cal*range)
+        //
+        RowVectorXd vCals;
+        FiffStream::SPtr outfid = FiffStream::start_writing_raw(t_fileOut,
+                                                                raw.info,
+                                                                vCals,
+                                                                defaultMatrixXi,
+                                                                type == FIFFT_FLOAT,
+                                                                type);
+        if(type != FIFFT_FLOAT) {
+            for(int k = 0; k < vCals.size(); ++k) {
+                vCals[k] *= raw.info.chs[k].range;
+            }
+        }
+
+        RowVectorXd vInvCals = vCals;
+        for(int k = 0; k < vInvCals.size(); ++k) {
+            vInvCals[k] = vInvCals[k] != 0.0 ? 1.0 / vInvCals[k] : 1.0;
+        }
+
+        outfid->write_int(FIFF_FIRST_SAMPLE, &first);
+
+        // write two buffers, so that the reader has to put several tags together
+        qint64 iClipped = 0;
+        QByteArray tag;
+        for(int iStart = 0; iStart < mData.cols(); iStart += 500) {
+            const qint64 iBufClipped = FiffStream::pack_raw_buffer(mData.middleCols(iStart, 500), vInvCals, type, tag);
+            QVERIFY( iBufClipped >= 0 );
+            iClipped += iBufClipped;
+            outfid->device()->write(tag);
+        }
+        outfid->finish_writing_raw();
+
+        //
+        //   Read back and compare within the quantization step
+        //
+        FiffRawData rawOut(t_fileOut);
+        MatrixXd mOutData, mOutTimes;
+        QVERIFY( rawOut.read_raw_segment(mOutData, mOutTimes, first, last) );
+        QCOMPARE( mOutData.rows(), mData.rows() );
+        QCOMPARE( mOutData.cols(), mData.cols() );
+
+        double dMin = 0.0, dMax = 0.0;
+        if(type == FIFFT_INT) {
+            dMin = std::numeric_limits<qint32>::min();
+            dMax = std::numeric_limits<qint32>::max();
+        } else if(type != FIFFT_FLOAT) {
+            dMin = std::numeric_limits<qint16>::min();
+            dMax = std::numeric_limits<qint16>::max();
+        }
+
+        qint64 iExpectedClipped = 0;
+        for(int r = 0; r < mData.rows(); ++r) {
+            const double dStep = vCals[r];
+
+            for(int c = 0; c < mData.cols(); ++c) {
+                const double dIn = mData(r, c);
+                const double dOut = mOutData(r, c);
+
+                if(type == FIFFT_FLOAT) {
+                    if(std::isnan(dIn)) {
+                        QVERIFY( std::isnan(dOut) );
+                    } else {
+                        QVERIFY( std::abs(dOut - dIn) <= dEpsilon * std::abs(dIn) );
+                    }
+                    continue;
+                }
+
+                // clipped and NaN samples are counted and stored as the range limit and zero respectively
+                const double dValue = std::round(dIn * vInvCals[r]);
+                double dExpected = dValue;
+                bool bClipped = true;
+                if(std::isnan(dValue)) {
+                    dExpected = 0.0;
+                } else if(dValue < dMin) {
+                    dExpected = dMin;
+                } else if(dValue > dMax) {
+                    dExpected = dMax;
+                } else {
+                    bClipped = false;
+                }
+
+                if(bClipped) {
+                    ++iExpectedClipped;
+                } else {
+                    QVERIFY( std::abs(dOut - dIn) <= 0.5 * std::abs(dStep) * (1.0 + dEpsilon) );
+                }
+                QVERIFY( std::abs(dOut - dExpected * dStep) <= dEpsilon * std::abs(dStep) );
+            }
+        }
+
+        QCOMPARE( iClipped, iExpectedClipped );
+        if(type != FIFFT_FLOAT) {
+            QVERIFY( iClipped >= 3 );
+        }
+    }
+}
+
+//=============================================================================================================
+
 void TestFiffRWR::cleanupTestCase()
 {
 }
@@ -44,6 +44,7 @@
 
 #include <fiff/fiff.h>
 #include <rtprocessing/helpers/filterkernel.h>
+#include <rtprocessing/helpers/iirfilter.h>
 #include <rtprocessing/filter.h>
 
 #include <Eigen/Dense>
@@ -53,8 +54,10 @@
 //=============================================================================================================
 
 #include <QtCore/QCoreApplication>
+#include <QBuffer>
 #include <QFile>
 #include <QCommandLineParser>
+#include <QThreadPool>
 #include <QtTest>
 
 //=============================================================================================================
@@ -84,6 +87,10 @@ private slots:
     void initTestCase();
     void compareData();
     void compareTimes();
+    void compareIirStreaming();
+    void compareFilterFileThreads();
+    void compareFilterFileSingleThreadPool();
+    void compareIirFilterFile();
     void cleanupTestCase();
 
 private:
@@ -231,6 +238,168 @@ void TestFiltering::compareTimes()
     QVERIFY( mTimesDiff.sum() < dEpsilon );
 }
 
+//=============================================================================================================
+
+void TestFiltering::compareIirStreaming()
+{
+    // Filtering the data in two blocks must give the same result as filtering it at once
+    IirFilter filter("iir_bpf", FilterKernel::BPF, 4, 0.1, 0.05, 1000.0);
+
+    MatrixXd matWhole = mFirstInData;
+    filter.filter(matWhole);
+    filter.reset();
+
+    int iSplit = mFirstInData.cols()/3;
+    MatrixXd matFirst = mFirstInData.leftCols(iSplit);
+    MatrixXd matSecond = mFirstInData.rightCols(mFirstInData.cols()-iSplit);
+    filter.filter(matFirst);
+    filter.filter(matSecond);
+
+    double dScale = matWhole.cwiseAbs().maxCoeff();
+    QVERIFY( (matWhole.leftCols(iSplit) - matFirst).cwiseAbs().maxCoeff() <= dEpsilon * dScale );
+    QVERIFY( (matWhole.rightCols(matSecond.cols()) - matSecond).cwiseAbs().maxCoeff() <= dEpsilon * dScale );
+
+    // The zero-phase filter must neither shift nor attenuate a sine in the passband
+    RowVectorXd vecSine(2000);
+    for(int i = 0; i < vecSine.cols(); ++i) {
+        vecSine(i) = sin(2.0 * M_PI * 50.0 * i / 1000.0);
+    }
+
+    MatrixXd matSineFiltered = filter.filterZeroPhase(vecSine);
+    QVERIFY( (matSineFiltered.middleCols(500,1000) - vecSine.segment(500,1000)).cwiseAbs().maxCoeff() < 1e-3 );
+}
+
+//=============================================================================================================
+
+void TestFiltering::compareFilterFileThreads()
+{
+    QFile t_fileIn(QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/sample_audvis_trunc_raw.fif");
+    QSharedPointer<FiffRawData> pRawIn = QSharedPointer<FiffRawData>::create(t_fileIn);
+
+    RowVectorXi vPicks = pRawIn->info.pick_types(true, true, false);
+    fiff_int_t from = pRawIn->first_samp;
+    fiff_int_t to = pRawIn->last_samp;
+    double dSFreq = pRawIn->info.sfreq;
+
+    // filterFile works on slices of 10 seconds. Lower the sampling frequency in the info, so that the file is
+    // split into several slices and the overlap add between them is part of the comparison.
+    pRawIn->info.sfreq = (to - from + 1) / 40.0;
+
+    QBuffer bufferThreads;
+    QBuffer bufferNoThreads;
+    QVERIFY( RTPROCESSINGLIB::filterFile(bufferThreads, pRawIn, FilterKernel::BPF, 10, 10, 1, dSFreq, iOrder, FilterKernel::Cosine, vPicks, true) );
+    QVERIFY( RTPROCESSINGLIB::filterFile(bufferNoThreads, pRawIn, FilterKernel::BPF, 10, 10, 1, dSFreq, iOrder, FilterKernel::Cosine, vPicks, false) );
+
+    FiffRawData rawThreads(bufferThreads);
+    FiffRawData rawNoThreads(bufferNoThreads);
+
+    MatrixXd mThreads, mNoThreads, mTimes;
+    QVERIFY( rawThreads.read_raw_segment(mThreads, mTimes, from, to, vPicks) );
+    QVERIFY( rawNoThreads.read_raw_segment(mNoThreads, mTimes, from, to, vPicks) );
+
+    QVERIFY( mThreads.cols() == mFirstFiltered.cols() );
+    QVERIFY( mNoThreads.cols() == mFirstFiltered.cols() );
+
+    // Threads must not change the result, the slices must line up with filtering all data at once
+    double dScale = mFirstFiltered.cwiseAbs().maxCoeff();
+    int iLength = mFirstFiltered.cols() - 2*iOrder;
+    QVERIFY( (mThreads - mNoThreads).cwiseAbs().maxCoeff() <= dEpsilon * dScale );
+    QVERIFY( (mThreads.middleCols(iOrder, iLength) - mFirstFiltered.middleCols(iOrder, iLength)).cwiseAbs().maxCoeff() <= 10 * dEpsilon * dScale );
+}
+
+//=============================================================================================================
+
+void TestFiltering::compareFilterFileSingleThreadPool()
+{
+    QFile t_fileIn(QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/sample_audvis_trunc_raw.fif");
+    QSharedPointer<FiffRawData> pRawIn = QSharedPointer<FiffRawData>::create(t_fileIn);
+
+    RowVectorXi vPicks = pRawIn->info.pick_types(true, true, false);
+    fiff_int_t from = pRawIn->first_samp;
+    fiff_int_t to = pRawIn->last_samp;
+    double dSFreq = pRawIn->info.sfreq;
+    pRawIn->info.sfreq = (to - from + 1) / 40.0;
+
+    // The read and write stage wait for each other, so they must not depend on free threads in the global pool
+    int iMaxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount(1);
+
+    QBuffer bufferThreads;
+    bool bSuccess = RTPROCESSINGLIB::filterFile(bufferThreads, pRawIn, FilterKernel::BPF, 10, 10, 1, dSFreq, iOrder, FilterKernel::Cosine, vPicks, true);
+
+    QThreadPool::globalInstance()->setMaxThreadCount(iMaxThreadCount);
+    QVERIFY( bSuccess );
+
+    FiffRawData rawThreads(bufferThreads);
+
+    MatrixXd mThreads, mTimes;
+    QVERIFY( rawThreads.read_raw_segment(mThreads, mTimes, from, to, vPicks) );
+    QVERIFY( mThreads.cols() == mFirstFiltered.cols() );
+
+    double dScale = mFirstFiltered.cwiseAbs().maxCoeff();
+    int iLength = mFirstFiltered.cols() - 2*iOrder;
+    QVERIFY( (mThreads.middleCols(iOrder, iLength) - mFirstFiltered.middleCols(iOrder, iLength)).cwiseAbs().maxCoeff() <= 10 * dEpsilon * dScale );
+}
+
+//=============================================================================================================
+
+void TestFiltering::compareIirFilterFile()
+{
+    IirFilter filter("iir_bpf", FilterKernel::BPF, 4, 0.1, 0.05, 1000.0);
+
+    // filterFile works on slices of 10 seconds. Write a short file with a sampling frequency such that the slices
+    // are at least the settling length of the filter and the last slice holds one sample only.
+    int iQuantum = 10 * ((std::max(filter.getSettlingLength(), 100) + 9) / 10);
+    int iNumSamples = 3 * iQuantum + 1;
+    QVERIFY( iNumSamples <= mFirstInData.cols() );
+
+    QFile t_fileIn(QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/sample_audvis_trunc_raw.fif");
+    FiffRawData rawIn(t_fileIn);
+    fiff_int_t from = rawIn.first_samp;
+    fiff_int_t to = from + iNumSamples - 1;
+
+    FiffInfo info = rawIn.info;
+    info.sfreq = iQuantum / 10;
+
+    QBuffer bufferShort;
+    RowVectorXd vCals;
+    FiffStream::SPtr outfid = FiffStream::start_writing_raw(bufferShort, info, vCals);
+    outfid->write_int(FIFF_FIRST_SAMPLE, &from);
+    QVERIFY( outfid->write_raw_buffer(mFirstInData.leftCols(iNumSamples), vCals) );
+    outfid->finish_writing_raw();
+
+    QSharedPointer<FiffRawData> pRawShort = QSharedPointer<FiffRawData>::create(bufferShort);
+    QVERIFY( pRawShort->first_samp == from );
+    QVERIFY( pRawShort->last_samp == to );
+
+    // Filter the whole short file at once as reference
+    RowVectorXi vPicks = pRawShort->info.pick_types(true, true, false);
+    MatrixXd mShortIn, mTimes;
+    QVERIFY( pRawShort->read_raw_segment(mShortIn, mTimes, from, to) );
+
+    MatrixXd mFilteredAll = RTPROCESSINGLIB::filterData(mShortIn, filter, vPicks);
+    MatrixXd mReference(vPicks.cols(), mFilteredAll.cols());
+    for(int i = 0; i < vPicks.cols(); ++i) {
+        mReference.row(i) = mFilteredAll.row(vPicks[i]);
+    }
+
+    QBuffer bufferFiltered;
+    QVERIFY( RTPROCESSINGLIB::filterFile(bufferFiltered, pRawShort, filter, vPicks) );
+
+    FiffRawData rawFiltered(bufferFiltered);
+    QVERIFY( rawFiltered.last_samp == to );
+
+    MatrixXd mFiltered;
+    QVERIFY( rawFiltered.read_raw_segment(mFiltered, mTimes, from, to, vPicks) );
+    QVERIFY( mFiltered.cols() == iNumSamples );
+
+    // The slices are read with the settling length in front and back, so they must line up with the reference
+    double dScale = mReference.cwiseAbs().maxCoeff();
+    QVERIFY( (mFiltered - mReference).cwiseAbs().maxCoeff() <= 1e-3 * dScale );
+}
+
+//=============================================================================================================
+
 void TestFiltering::cleanupTestCase()
 {
 }
@@ -46,6 +46,7 @@
 //=============================================================================================================
 
 #include <utils/generics/applicationlogger.h>
+#include <utils/meshadjacency.h>
 
 #include <disp3D/helpers/geometryinfo/geometryinfo.h>
 #include <mne/mne_bem.h>
@@ -65,6 +66,7 @@ using namespace DISP3DLIB;
 using namespace MNELIB;
 using namespace Eigen;
 using namespace FIFFLIB;
+using namespace UTILSLIB;
 
 //=============================================================================================================
 /**
@@ -86,6 +88,8 @@ private slots:
     void testEmptyInputsForProjecting();
     void testEmptyInputsForSCDC();
     void testDimensionsForSCDC();
+    void testSparseSCDC();
+    void testMeshAdjacency();
     void cleanupTestCase();
 
 private:
@@ -123,14 +127,16 @@ void TestGeometryInfo::initTestCase() {
     smallSurface.rr = mVertPos;
 
     // generate random adjacency, assume that every vertex has 4 neighbors
+    QVector<QVector<int> > vNeighborLists;
     for (int i = 0; i < 100; ++i) {
         QVector<int> vNeighborList;
         for (int a = 0; a < 4; ++a) {
             // this allows duplicates, probably is not a problem
             vNeighborList.push_back(rand() % 100);
         }
-        smallSurface.neighbor_vert.push_back(vNeighborList);
+        vNeighborLists.push_back(vNeighborList);
     }
+    smallSurface.adjacency = MeshAdjacency(vNeighborLists);
 
     //generate random subset of test mesh of size SubsetSize
     int iSubsetSize = rand() % 100;
@@ -162,7 +168,7 @@ void TestGeometryInfo::testBadChannelFiltering() {
     // projecting with MEG:
     QVector<int> mappedSubSet = GeometryInfo::projectSensors(realSurface.rr, vMegSensors);
     // SCDC with cancel distance 0.03:
-    QSharedPointer<MatrixXd> pDistanceMatrix = GeometryInfo::scdc(realSurface.rr, realSurface.neighbor_vert, mappedSubSet, 0.03);
+    QSharedPointer<MatrixXd> pDistanceMatrix = GeometryInfo::scdc(realSurface.rr, realSurface.adjacency, mappedSubSet, 0.03);
     // filter for bad MEG channels:
     QVector<int> vErasedColums = GeometryInfo::filterBadChannels(pDistanceMatrix, evoked.info, FIFFV_MEG_CH);
 
@@ -190,20 +196,75 @@ void TestGeometryInfo::testEmptyInputsForProjecting() {
 
 void TestGeometryInfo::testEmptyInputsForSCDC() {
     QVector<int> vVertSubset;
-    QSharedPointer<MatrixXd> pDistTable = GeometryInfo::scdc(smallSurface.rr, smallSurface.neighbor_vert, vVertSubset);
+    QSharedPointer<MatrixXd> pDistTable = GeometryInfo::scdc(smallSurface.rr, smallSurface.adjacency, vVertSubset);
     QVERIFY(pDistTable->rows() == pDistTable->cols());
 }
 
 //=============================================================================================================
 
 void TestGeometryInfo::testDimensionsForSCDC() {
-    QSharedPointer<MatrixXd> pDistTable = GeometryInfo::scdc(smallSurface.rr, smallSurface.neighbor_vert, vSmallSubset);
+    QSharedPointer<MatrixXd> pDistTable = GeometryInfo::scdc(smallSurface.rr, smallSurface.adjacency, vSmallSubset);
     QVERIFY(pDistTable->rows() == smallSurface.rr.rows());
     QVERIFY(pDistTable->cols() == vSmallSubset.size());
 }
 
 //=============================================================================================================
 
+void TestGeometryInfo::testSparseSCDC() {
+    const double dCancelDist = 0.5;
+    QSharedPointer<MatrixXd> pDenseTable = GeometryInfo::scdc(smallSurface.rr, smallSurface.adjacency, vSmallSubset, dCancelDist);
+    QSharedPointer<SparseMatrix<float> > pSparseTable = GeometryInfo::scdcSparse(smallSurface.rr, smallSurface.adjacency, vSmallSubset, dCancelDist);
+
+    QVERIFY(pSparseTable->rows() == pDenseTable->rows());
+    QVERIFY(pSparseTable->cols() == pDenseTable->cols());
+
+    // every distance within the cancel distance is stored, everything else is left out
+    qint64 iFiniteCount = 0;
+    for (qint32 col = 0; col < pDenseTable->cols(); ++col) {
+        for (qint32 row = 0; row < pDenseTable->rows(); ++row) {
+            if (pDenseTable->coeff(row, col) != FLOAT_INFINITY) {
+                QVERIFY(std::fabs(pSparseTable->coeff(row, col) - pDenseTable->coeff(row, col)) < 1e-5);
+                iFiniteCount++;
+            }
+        }
+    }
+    QVERIFY(pSparseTable->nonZeros() == iFiniteCount);
+}
+
+//=============================================================================================================
+
+void TestGeometryInfo::testMeshAdjacency() {
+    MeshAdjacency adjacency(realSurface.tris, realSurface.np);
+    QVERIFY(adjacency.numVertices() == realSurface.np);
+
+    // brute force reference: triangles in ascending order, neighbors in order of appearance
+    QVector<QVector<int> > vNeighborTri(realSurface.np);
+    QVector<QVector<int> > vNeighborVert(realSurface.np);
+    for (int t = 0; t < realSurface.tris.rows(); ++t) {
+        for (int k = 0; k < 3; ++k) {
+            const int v = realSurface.tris(t, k);
+            vNeighborTri[v].push_back(t);
+            for (int c = 0; c < 3; ++c) {
+                const int n = realSurface.tris(t, c);
+                if (n != v && !vNeighborVert[v].contains(n)) {
+                    vNeighborVert[v].push_back(n);
+                }
+            }
+        }
+    }
+
+    QVERIFY(adjacency.neighborTriangleLists() == vNeighborTri);
+    QVERIFY(adjacency.neighborVertexLists() == vNeighborVert);
+    QVERIFY(realSurface.adjacency == adjacency);
+
+    // the adjacency built from the lists holds the same neighbors
+    MeshAdjacency listAdjacency(vNeighborVert);
+    QVERIFY(listAdjacency.neighborVertexLists() == vNeighborVert);
+    QVERIFY(listAdjacency.triangleCount(0) == 0);
+}
+
+//=============================================================================================================
+
 void TestGeometryInfo::cleanupTestCase() {
 }
 
@@ -98,6 +98,7 @@ private slots:
     void compareMove();
     void compareDetect();
     void compareTime();
+    void compareLeadfieldGradient();
     void cleanupTestCase();
 
 private:
@@ -106,6 +107,7 @@ private:
     double dErrorTime = 0.00000001;
     double dErrorAngle = 0.1;
     double dErrorDetect = 0;
+    double dErrorGradient = 1e-10;
     MatrixXd mRefPos;
     MatrixXd mHpiPos;
     MatrixXd mRefResult;
@@ -319,6 +321,64 @@ void TestHpiFit::compareTime()
 
 //=============================================================================================================
 
+void TestHpiFit::compareLeadfieldGradient()
+{
+    // Synthetic helmet of radial magnetometers with four integration points each
+    SensorSet sensors;
+    sensors.ncoils = 50;
+    sensors.np = 4;
+    sensors.rmag.resize(sensors.ncoils * sensors.np, 3);
+    sensors.cosmag.resize(sensors.ncoils * sensors.np, 3);
+    sensors.w = RowVectorXd::Constant(sensors.ncoils * sensors.np, 0.25);
+
+    for(int i = 0; i < sensors.ncoils; ++i) {
+        double dTheta = 0.2 + 1.2 * i / sensors.ncoils;
+        double dPhi = 2.4 * i;
+        RowVector3d vecNormal(sin(dTheta) * cos(dPhi), sin(dTheta) * sin(dPhi), cos(dTheta));
+
+        for(int j = 0; j < sensors.np; ++j) {
+            sensors.rmag.row(i * sensors.np + j) = 0.12 * vecNormal + 0.005 * RowVector3d(j % 2 - 0.5, j / 2 - 0.5, 0.0);
+            sensors.cosmag.row(i * sensors.np + j) = vecNormal;
+        }
+    }
+
+    MatrixXd matPos(4,3);
+    matPos << 0.03, 0.0, 0.04,
+              -0.03, 0.01, 0.04,
+              0.0, 0.05, 0.02,
+              0.01, -0.04, 0.05;
+
+    MatrixXd matLf, matGrad, matLfPlus, matLfMinus, matGradUnused;
+    HPIFitData::dipoleFieldAndGradient(matPos, sensors, matLf, matGrad);
+
+    // Compare the analytic derivatives with central differences
+    double dStep = 1e-7;
+    double dMaxDiff = 0.0;
+
+    for(int k = 0; k < 3; ++k) {
+        MatrixXd matPosPlus = matPos;
+        MatrixXd matPosMinus = matPos;
+        matPosPlus.col(k).array() += dStep;
+        matPosMinus.col(k).array() -= dStep;
+
+        HPIFitData::dipoleFieldAndGradient(matPosPlus, sensors, matLfPlus, matGradUnused);
+        HPIFitData::dipoleFieldAndGradient(matPosMinus, sensors, matLfMinus, matGradUnused);
+
+        MatrixXd matDiff = (matLfPlus - matLfMinus) / (2.0 * dStep);
+
+        for(int i = 0; i < matPos.rows(); ++i) {
+            dMaxDiff = std::max(dMaxDiff, (matDiff.middleCols(3*i,3) - matGrad.middleCols(9*i+3*k,3)).cwiseAbs().maxCoeff());
+        }
+    }
+
+    double dRelDiff = dMaxDiff / matGrad.cwiseAbs().maxCoeff();
+
+    qDebug() << "ErrorGradient: " << dRelDiff;
+    QVERIFY(dRelDiff < dErrorGradient);
+}
+
+//=============================================================================================================
+
 void TestHpiFit::cleanupTestCase()
 {
 }
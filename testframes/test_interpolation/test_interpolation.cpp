@@ -44,6 +44,7 @@
 //=============================================================================================================
 
 #include <utils/generics/applicationlogger.h>
+#include <utils/meshadjacency.h>
 
 #include <disp3D/helpers/geometryinfo/geometryinfo.h>
 #include <disp3D/helpers/interpolation/interpolation.h>
@@ -65,6 +66,7 @@ using namespace DISP3DLIB;
 using namespace MNELIB;
 using namespace Eigen;
 using namespace FIFFLIB;
+using namespace UTILSLIB;
 
 //=============================================================================================================
 /**
@@ -139,14 +141,16 @@ void TestInterpolation::initTestCase()
     smallSurface.rr = vVertPos;
 
     // generate random adjacency, assume that every vertex has 4 neighbors
+    QVector<QVector<int> > vNeighborLists;
     for (int i = 0; i < 100; ++i) {
         QVector<int> vNeighborList;
         for (int a = 0; a < 4; ++a) {
             // this allows duplicates, probably is not a problem
             vNeighborList.push_back(rand() % 100);
         }
-        smallSurface.neighbor_vert.push_back(vNeighborList);
+        vNeighborLists.push_back(vNeighborList);
     }
+    smallSurface.adjacency = MeshAdjacency(vNeighborLists);
 
     // generate random subset of test mesh of size iSubsetSize
     int iSubsetSize = rand() % 100;
@@ -161,7 +165,7 @@ void TestInterpolation::initTestCase()
 void TestInterpolation::testDimensionsForInterpolation()
 {
     // create weight matrix from distance table
-    QSharedPointer<MatrixXd> pDistTable = GeometryInfo::scdc(smallSurface.rr, smallSurface.neighbor_vert, vSmallSubset);
+    QSharedPointer<MatrixXd> pDistTable = GeometryInfo::scdc(smallSurface.rr, smallSurface.adjacency, vSmallSubset);
     QSharedPointer<SparseMatrix<float> > pTestWeightMatrix = Interpolation::createInterpolationMat(vSmallSubset,
                                                                                  pDistTable,
                                                                                  Interpolation::linear);
@@ -191,7 +195,7 @@ void TestInterpolation::testSumOfRow()
 
     // SCDC with cancel distance 0.20 m:
     QSharedPointer<MatrixXd> pDistanceMatrix = GeometryInfo::scdc(realSurface.rr,
-                                                 realSurface.neighbor_vert,
+                                                 realSurface.adjacency,
                                                  vMappedSubSet,
                                                  0.20);
 
@@ -227,7 +231,7 @@ void TestInterpolation::testSumOfRow()
 void TestInterpolation::testEmptyInputsForWeightMatrix()
 {
     // SCDC with cancel distance 0.03:
-    QSharedPointer<MatrixXd> pDistTable = GeometryInfo::scdc(smallSurface.rr, smallSurface.neighbor_vert, vSmallSubset, 0.03);
+    QSharedPointer<MatrixXd> pDistTable = GeometryInfo::scdc(smallSurface.rr, smallSurface.adjacency, vSmallSubset, 0.03);
 
     // ---------- empty sensor indices ----------
     QVector<int> vEmptySensors;
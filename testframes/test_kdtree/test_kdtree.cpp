@@ -0,0 +1,254 @@
+//=============================================================================================================
+/**
+ * @file     test_kdtree.cpp
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Test for the KdTree spatial index
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <utils/generics/applicationlogger.h>
+#include <utils/kdtree.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+/**
+ * DECLARE CLASS TestKdTree
+ *
+ * @brief The TestKdTree class compares the KdTree queries against a linear scan
+ *
+ */
+class TestKdTree: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestKdTree();
+
+private slots:
+    void initTestCase();
+    void compareNearest();
+    void compareKNearest();
+    void compareRadius();
+    void compareEmpty();
+    void cleanupTestCase();
+
+private:
+    //=========================================================================================================
+    /**
+     * Returns the squared distances and indices of all points to vecPoint, sorted by distance and index.
+     */
+    std::vector<std::pair<float, int> > linearScan(const Vector3f& vecPoint) const;
+
+    double dEpsilon;
+
+    Matrix3Xf       m_matPoints;    /**< The indexed points, one per column. */
+    Matrix3Xf       m_matQueries;   /**< The query points, one per column. */
+    KdTree          m_kdTree;       /**< The tree over m_matPoints. */
+};
+
+//=============================================================================================================
+
+TestKdTree::TestKdTree()
+: dEpsilon(0.000001)
+{
+}
+
+//=============================================================================================================
+
+void TestKdTree::initTestCase()
+{
+    qInstallMessageHandler(UTILSLIB::ApplicationLogger::customLogWriter);
+    qDebug() << "Epsilon" << dEpsilon;
+
+    std::srand(42);
+
+    // random points with a block of duplicates at the end, so that ties have to be resolved by index
+    const int iNumRandom = 1000;
+    const int iNumDuplicates = 50;
+    m_matPoints.resize(3, iNumRandom + iNumDuplicates);
+    m_matPoints.leftCols(iNumRandom) = Matrix3Xf::Random(3, iNumRandom);
+    for(int i = 0; i < iNumDuplicates; ++i) {
+        m_matPoints.col(iNumRandom + i) = m_matPoints.col((i * 7) % 10);
+    }
+
+    // random queries plus queries placed exactly on duplicated points
+    const int iNumQueries = 200;
+    m_matQueries.resize(3, iNumQueries + 10);
+    m_matQueries.leftCols(iNumQueries) = 1.2f * Matrix3Xf::Random(3, iNumQueries);
+    m_matQueries.rightCols(10) = m_matPoints.leftCols(10);
+
+    m_kdTree = KdTree(m_matPoints.transpose(), 8);
+    QCOMPARE(m_kdTree.size(), static_cast<int>(m_matPoints.cols()));
+    QVERIFY(!m_kdTree.isEmpty());
+}
+
+//=============================================================================================================
+
+void TestKdTree::compareNearest()
+{
+    for(int q = 0; q < m_matQueries.cols(); ++q) {
+        const Vector3f vecQuery = m_matQueries.col(q);
+        const std::vector<std::pair<float, int> > vecRef = linearScan(vecQuery);
+
+        float fDist;
+        const int iNearest = m_kdTree.findNearest(vecQuery, fDist);
+
+        QCOMPARE(iNearest, vecRef.front().second);
+        QVERIFY(std::abs(fDist - std::sqrt(vecRef.front().first)) < dEpsilon);
+    }
+}
+
+//=============================================================================================================
+
+void TestKdTree::compareKNearest()
+{
+    const int iNumPoints = static_cast<int>(m_matPoints.cols());
+    const QVector<int> vecKs = QVector<int>() << 1 << 5 << 17 << 64 << iNumPoints << iNumPoints + 25;
+
+    for(int k : vecKs) {
+        for(int q = 0; q < m_matQueries.cols(); q += 5) {
+            const Vector3f vecQuery = m_matQueries.col(q);
+            const std::vector<std::pair<float, int> > vecRef = linearScan(vecQuery);
+
+            QVector<float> vecDists;
+            const QVector<int> vecIdx = m_kdTree.findNearest(vecQuery, k, vecDists);
+
+            // k is clamped to the number of points
+            const int iExpected = std::min(k, iNumPoints);
+            QCOMPARE(vecIdx.size(), iExpected);
+            QCOMPARE(vecDists.size(), iExpected);
+
+            for(int i = 0; i < iExpected; ++i) {
+                QCOMPARE(vecIdx[i], vecRef[i].second);
+                QVERIFY(std::abs(vecDists[i] - std::sqrt(vecRef[i].first)) < dEpsilon);
+            }
+        }
+    }
+}
+
+//=============================================================================================================
+
+void TestKdTree::compareRadius()
+{
+    const QVector<float> vecRadii = QVector<float>() << 0.0f << 0.05f << 0.2f << 0.5f << 4.0f;
+
+    for(float fRadius : vecRadii) {
+        for(int q = 0; q < m_matQueries.cols(); q += 3) {
+            const Vector3f vecQuery = m_matQueries.col(q);
+            const std::vector<std::pair<float, int> > vecRef = linearScan(vecQuery);
+
+            QVector<int> vecExpected;
+            for(const std::pair<float, int>& ref : vecRef) {
+                if(ref.first <= fRadius * fRadius) {
+                    vecExpected.append(ref.second);
+                }
+            }
+            std::sort(vecExpected.begin(), vecExpected.end());
+
+            QCOMPARE(m_kdTree.findInRadius(vecQuery, fRadius), vecExpected);
+        }
+    }
+}
+
+//=============================================================================================================
+
+void TestKdTree::compareEmpty()
+{
+    KdTree kdTree;
+    QVERIFY(kdTree.isEmpty());
+    QCOMPARE(kdTree.size(), 0);
+
+    float fDist;
+    QCOMPARE(kdTree.findNearest(Vector3f::Zero(), fDist), -1);
+
+    QVector<float> vecDists;
+    QVERIFY(kdTree.findNearest(Vector3f::Zero(), 3, vecDists).isEmpty());
+    QVERIFY(vecDists.isEmpty());
+    QVERIFY(kdTree.findInRadius(Vector3f::Zero(), 1.0f).isEmpty());
+
+    // all points coincide, the tree can not be split
+    KdTree kdTreeSame(MatrixX3f::Ones(40, 3), 4);
+    QCOMPARE(kdTreeSame.findNearest(Vector3f::Ones(), fDist), 0);
+    QCOMPARE(kdTreeSame.findNearest(Vector3f::Zero(), 3, vecDists), QVector<int>() << 0 << 1 << 2);
+    QCOMPARE(kdTreeSame.findInRadius(Vector3f::Zero(), 1.0f).size(), 0);
+    QCOMPARE(kdTreeSame.findInRadius(Vector3f::Ones(), 0.0f).size(), 40);
+}
+
+//=============================================================================================================
+
+void TestKdTree::cleanupTestCase()
+{
+}
+
+//=============================================================================================================
+
+std::vector<std::pair<float, int> > TestKdTree::linearScan(const Vector3f& vecPoint) const
+{
+    std::vector<std::pair<float, int> > vecResult(m_matPoints.cols());
+    for(int i = 0; i < m_matPoints.cols(); ++i) {
+        vecResult[i] = std::make_pair((m_matPoints.col(i) - vecPoint).squaredNorm(), i);
+    }
+    std::sort(vecResult.begin(), vecResult.end());
+
+    return vecResult;
+}
+
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestKdTree)
+#include "test_kdtree.moc"
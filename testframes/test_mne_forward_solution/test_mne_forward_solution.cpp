@@ -48,6 +48,12 @@
 #include <fiff/fiff_info.h>
 #include <fiff/fiff_named_matrix.h>
 
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Geometry>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
@@ -79,6 +85,7 @@ private slots:
     void initTestCase();
     void computeForward();
     void compareForward();
+    void compareHeadPosExpansion();
     void cleanupTestCase();
 
 private:
@@ -186,6 +193,88 @@ void TestMneForwardSolution::compareForward()
 
 //=============================================================================================================
 
+void TestMneForwardSolution::compareHeadPosExpansion()
+{
+    printf(">>>>>>>>>>>>>>>>>>>>>>>>> Compare MEG Head Position Expansion >>>>>>>>>>>>>>>>>>>>>>>>>\n");
+
+    QFile t_name(QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/sample_audvis_trunc_raw.fif");
+    FIFFLIB::FiffRawData raw(t_name);
+    QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo = QSharedPointer<FIFFLIB::FiffInfo>(new FIFFLIB::FiffInfo(raw.info));
+
+    auto createSettings = [&](bool bFastHeadPosUpdate) {
+        ComputeFwdSettings::SPtr pSettings = ComputeFwdSettings::SPtr(new ComputeFwdSettings);
+        pSettings->include_meg = true;
+        pSettings->include_eeg = false;
+        pSettings->accurate = true;
+        pSettings->srcname = QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/subjects/sample/bem/sample-oct-6-src.fif";
+        pSettings->measname = t_name.fileName();
+        pSettings->mriname = QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/all-trans.fif";
+        pSettings->transname.clear();
+        pSettings->bemname = QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/subjects/sample/bem/sample-1280-1280-1280-bem.fif";
+        pSettings->mindist = 5.0f/1000.0f;
+        pSettings->pFiffInfo = pFiffInfo;
+        pSettings->fast_head_pos_update = bFastHeadPosUpdate;
+        pSettings->fast_head_pos_tol = 0.05f;
+        pSettings->checkIntegrity();
+        return pSettings;
+    };
+
+    // Rotate about the sphere model origin, then translate
+    auto moveHead = [](const FIFFLIB::FiffCoordTransOld& t, const Eigen::Vector3f& r0, float fDegrees, const Eigen::Vector3f& move) {
+        FIFFLIB::FiffCoordTransOld res(t);
+        Eigen::Matrix3f rot = Eigen::AngleAxisf(fDegrees*float(EIGEN_PI)/180.0f, Eigen::Vector3f(1.0f,1.0f,1.0f).normalized()).toRotationMatrix();
+        res.rot = rot*t.rot;
+        res.move = rot*(t.move - r0) + r0 + move;
+        FIFFLIB::FiffCoordTransOld::add_inverse(&res);
+        return res;
+    };
+
+    ComputeFwdSettings::SPtr pSettingsFast = createSettings(true);
+    ComputeFwdSettings::SPtr pSettingsFull = createSettings(false);
+
+    ComputeFwd fwdFast(pSettingsFast);
+    ComputeFwd fwdFull(pSettingsFull);
+    fwdFast.calculateFwd();
+    fwdFull.calculateFwd();
+
+    FIFFLIB::FiffCoordTransOld meg_head_t = pFiffInfo->dev_head_t.toOld();
+    Eigen::Vector3f r0 = pSettingsFast->r0;
+    double dRelErr;
+
+    // A small movement is taken from the expansion. A full recompute would give exactly the same result.
+    FIFFLIB::FiffCoordTransOld meg_head_t_small = moveHead(meg_head_t, r0, 1.0f, Eigen::Vector3f(0.002f,-0.001f,0.001f));
+    fwdFast.updateHeadPos(&meg_head_t_small);
+    fwdFull.updateHeadPos(&meg_head_t_small);
+
+    dRelErr = (fwdFast.sol->data - fwdFull.sol->data).norm()/fwdFull.sol->data.norm();
+    printf("Relative error of the expansion after a small movement: %g\n", dRelErr);
+    QVERIFY(dRelErr > 0.0);
+    QVERIFY(dRelErr <= pSettingsFast->fast_head_pos_tol);
+
+    // A large movement falls back to the full recompute
+    FIFFLIB::FiffCoordTransOld meg_head_t_large = moveHead(meg_head_t, r0, 2.0f, Eigen::Vector3f(0.015f,0.0f,0.0f));
+    fwdFast.updateHeadPos(&meg_head_t_large);
+    fwdFull.updateHeadPos(&meg_head_t_large);
+
+    dRelErr = (fwdFast.sol->data - fwdFull.sol->data).norm()/fwdFull.sol->data.norm();
+    printf("Relative error after a large movement: %g\n", dRelErr);
+    QVERIFY(dRelErr < dEpsilon);
+
+    // The expansion is set up again around the recomputed position for the next small movement
+    FIFFLIB::FiffCoordTransOld meg_head_t_next = moveHead(meg_head_t_large, r0, -1.0f, Eigen::Vector3f(-0.001f,0.002f,0.0f));
+    fwdFast.updateHeadPos(&meg_head_t_next);
+    fwdFull.updateHeadPos(&meg_head_t_next);
+
+    dRelErr = (fwdFast.sol->data - fwdFull.sol->data).norm()/fwdFull.sol->data.norm();
+    printf("Relative error of the expansion after the next small movement: %g\n", dRelErr);
+    QVERIFY(dRelErr > 0.0);
+    QVERIFY(dRelErr <= pSettingsFast->fast_head_pos_tol);
+
+    printf("<<<<<<<<<<<<<<<<<<<<<<<<< Compare MEG Head Position Expansion Finished <<<<<<<<<<<<<<<<<<<<<<<<<\n");
+}
+
+//=============================================================================================================
+
 void TestMneForwardSolution::cleanupTestCase()
 {
 }
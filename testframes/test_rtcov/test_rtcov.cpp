@@ -0,0 +1,302 @@
+//=============================================================================================================
+/**
+ * @file     test_rtcov.cpp
+ * @author   MNE-CPP Authors
+ * @since    0.1.6
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Test for the streaming covariance accumulator RtCov
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <utils/generics/applicationlogger.h>
+
+#include <fiff/fiff.h>
+#include <rtprocessing/rtcov.h>
+
+#include <cmath>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Dense>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+using namespace RTPROCESSINGLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+/**
+ * DECLARE CLASS TestRtCov
+ *
+ * @brief The TestRtCov class compares the streaming covariance of RtCov with a batch computation
+ *
+ */
+class TestRtCov: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRtCov();
+
+private slots:
+    void initTestCase();
+    void compareBatch();
+    void compareForgetting();
+    void compareReset();
+    void cleanupTestCase();
+
+private:
+    //=========================================================================================================
+    /**
+     * Computes the covariance of the data with the sample weights vecWeights in one pass over the whole matrix and
+     * regularizes it the same way RtCov does.
+     */
+    FiffCov batchCovariance(const MatrixXd& matData,
+                            const VectorXd& vecWeights) const;
+
+    //=========================================================================================================
+    /**
+     * Feeds the data block by block to rtCov and returns the estimate emitted after the last block.
+     */
+    FiffCov streamCovariance(RtCov& rtCov,
+                             const MatrixXd& matData,
+                             int iBlockSize) const;
+
+    //=========================================================================================================
+    /**
+     * Returns the largest difference of the two covariances, relative to the standard deviations of the
+     * respective channel pair.
+     */
+    double maxRelativeError(const MatrixXd& matCov,
+                            const MatrixXd& matRef) const;
+
+    double dEpsilon;
+
+    FiffInfo::SPtr  m_pFiffInfo;    /**< The measurement info of the test data. */
+    MatrixXd        m_matData;      /**< The test data, all channels. */
+};
+
+//=============================================================================================================
+
+TestRtCov::TestRtCov()
+: dEpsilon(0.000001)
+{
+}
+
+//=============================================================================================================
+
+void TestRtCov::initTestCase()
+{
+    qInstallMessageHandler(UTILSLIB::ApplicationLogger::customLogWriter);
+    qDebug() << "Epsilon" << dEpsilon;
+
+    QFile t_fileIn(QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/sample_audvis_trunc_raw.fif");
+    FiffRawData raw(t_fileIn);
+    m_pFiffInfo = FiffInfo::SPtr::create(raw.info);
+
+    MatrixXd matTimes;
+    QVERIFY(raw.read_raw_segment(m_matData, matTimes, raw.first_samp, raw.first_samp + 2999));
+}
+
+//=============================================================================================================
+
+void TestRtCov::compareBatch()
+{
+    // Without forgetting RtCov has to match the unbiased sample covariance, independent of the block size
+    RtCov rtCov(m_pFiffInfo);
+    QCOMPARE(rtCov.getForgettingFactor(), 1.0);
+
+    const FiffCov covRef = batchCovariance(m_matData, VectorXd::Ones(m_matData.cols()));
+
+    for(int iBlockSize : {1, 37, 200, static_cast<int>(m_matData.cols())}) {
+        const FiffCov cov = streamCovariance(rtCov, m_matData, iBlockSize);
+
+        QVERIFY(!cov.isEmpty());
+        QCOMPARE(cov.nfree, static_cast<int>(m_matData.cols()));
+        QCOMPARE(cov.names, covRef.names);
+        QVERIFY(maxRelativeError(cov.data, covRef.data) < dEpsilon);
+    }
+}
+
+//=============================================================================================================
+
+void TestRtCov::compareForgetting()
+{
+    // Sample j of n is weighted by lambda^(n-1-j), the estimate is normalized by W - sum(w^2)/W
+    const double dLambda = 0.999;
+    const int iNumSamples = m_matData.cols();
+
+    VectorXd vecWeights(iNumSamples);
+    for(int j = 0; j < iNumSamples; ++j) {
+        vecWeights[j] = std::pow(dLambda, iNumSamples - 1 - j);
+    }
+    const FiffCov covRef = batchCovariance(m_matData, vecWeights);
+
+    for(int iBlockSize : {1, 200, iNumSamples}) {
+        RtCov rtCov(m_pFiffInfo);
+        rtCov.setForgettingFactor(dLambda);
+        QCOMPARE(rtCov.getForgettingFactor(), dLambda);
+
+        const FiffCov cov = streamCovariance(rtCov, m_matData, iBlockSize);
+
+        QVERIFY(!cov.isEmpty());
+        QCOMPARE(cov.nfree, qRound(vecWeights.sum() * vecWeights.sum() / vecWeights.squaredNorm()));
+        QVERIFY(maxRelativeError(cov.data, covRef.data) < dEpsilon);
+    }
+
+    // Invalid factors are ignored
+    RtCov rtCov(m_pFiffInfo);
+    rtCov.setForgettingFactor(0.0);
+    rtCov.setForgettingFactor(1.5);
+    QCOMPARE(rtCov.getForgettingFactor(), 1.0);
+}
+
+//=============================================================================================================
+
+void TestRtCov::compareReset()
+{
+    // Without forgetting every estimate only uses the samples since the previous one
+    const int iHalf = m_matData.cols() / 2;
+    RtCov rtCov(m_pFiffInfo);
+
+    QVERIFY(!rtCov.estimateCovariance(m_matData.leftCols(iHalf), iHalf).isEmpty());
+
+    const MatrixXd matSecond = m_matData.rightCols(iHalf);
+    const FiffCov cov = rtCov.estimateCovariance(matSecond, iHalf);
+    const FiffCov covRef = batchCovariance(matSecond, VectorXd::Ones(iHalf));
+
+    QVERIFY(!cov.isEmpty());
+    QCOMPARE(cov.nfree, iHalf);
+    QVERIFY(maxRelativeError(cov.data, covRef.data) < dEpsilon);
+
+    // A single sample does not give an estimate
+    RtCov rtCovSingle(m_pFiffInfo);
+    QVERIFY(rtCovSingle.estimateCovariance(m_matData.leftCols(1), 1).isEmpty());
+}
+
+//=============================================================================================================
+
+void TestRtCov::cleanupTestCase()
+{
+}
+
+//=============================================================================================================
+
+FiffCov TestRtCov::batchCovariance(const MatrixXd& matData,
+                                   const VectorXd& vecWeights) const
+{
+    const double dWeight = vecWeights.sum();
+    const VectorXd vecMean = matData * vecWeights / dWeight;
+    const MatrixXd matCentered = matData.colwise() - vecMean;
+
+    FiffCov cov;
+    cov.data = matCentered * vecWeights.asDiagonal() * matCentered.transpose();
+    cov.data /= (dWeight - vecWeights.squaredNorm() / dWeight);
+    cov.kind = FIFFV_MNE_NOISE_COV;
+    cov.diag = false;
+    cov.dim = cov.data.rows();
+    cov.names = m_pFiffInfo->ch_names;
+    cov.projs = m_pFiffInfo->projs;
+    cov.bads = m_pFiffInfo->bads;
+    cov.nfree = qRound(dWeight * dWeight / vecWeights.squaredNorm());
+
+    QStringList lExclude;
+    for(int i = 0; i < m_pFiffInfo->chs.size(); ++i) {
+        if(m_pFiffInfo->chs.at(i).kind != FIFFV_MEG_CH && m_pFiffInfo->chs.at(i).kind != FIFFV_EEG_CH) {
+            lExclude << m_pFiffInfo->chs.at(i).ch_name;
+        }
+    }
+
+    return cov.regularize(*m_pFiffInfo, 0.05, 0.05, 0.1, true, lExclude);
+}
+
+//=============================================================================================================
+
+FiffCov TestRtCov::streamCovariance(RtCov& rtCov,
+                                    const MatrixXd& matData,
+                                    int iBlockSize) const
+{
+    FiffCov cov;
+
+    for(int iFirst = 0; iFirst < matData.cols(); iFirst += iBlockSize) {
+        const int iCols = std::min(iBlockSize, static_cast<int>(matData.cols()) - iFirst);
+
+        // only the last block completes an estimate
+        cov = rtCov.estimateCovariance(matData.middleCols(iFirst, iCols), matData.cols());
+        if(iFirst + iCols < matData.cols() && !cov.isEmpty()) {
+            return FiffCov();
+        }
+    }
+
+    return cov;
+}
+
+//=============================================================================================================
+
+double TestRtCov::maxRelativeError(const MatrixXd& matCov,
+                                   const MatrixXd& matRef) const
+{
+    if(matCov.rows() != matRef.rows() || matCov.cols() != matRef.cols()) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    const VectorXd vecStd = matRef.diagonal().cwiseAbs().cwiseSqrt();
+    double dMaxError = 0.0;
+
+    for(int i = 0; i < matRef.rows(); ++i) {
+        for(int j = 0; j < matRef.cols(); ++j) {
+            const double dScale = vecStd[i] * vecStd[j];
+            if(dScale > 0.0) {
+                dMaxError = std::max(dMaxError, std::abs(matCov(i,j) - matRef(i,j)) / dScale);
+            }
+        }
+    }
+
+    return dMaxError;
+}
+
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestRtCov)
+#include "test_rtcov.moc"
@@ -55,6 +55,8 @@ SUBDIRS += \
     test_fiff_cov \
     test_fiff_digitizer \
     test_mne_msh_display_surface_set \
+    test_kdtree \
+    test_rtcov \
 
     qtHaveModule(charts) {
         SUBDIRS += \